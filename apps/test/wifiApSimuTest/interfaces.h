@@ -0,0 +1,10 @@
+/**
+ * This module contains the interfaces of the WiFi access point simulation test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "le_wifiAp_interface.h"
+#include "le_wifiApExt_interface.h"
+#include "le_cfg_interface.h"
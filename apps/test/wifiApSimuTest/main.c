@@ -0,0 +1,173 @@
+/**
+ * This module implements the test of the simulated stations of the WiFi access point PA: bursts
+ * larger than the event ring of a real access point are delivered without loss.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_wifi_ap.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings of the access point under test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SSID               "wifiApSimuTest"
+#define TEST_CHANNEL            6
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of simulated stations, all joining or leaving in each burst. Larger than the 32 events
+ * of the event ring of a real access point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_STATION_COUNT      "100"
+#define TEST_BURST_INTERVAL_SEC "1"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of join bursts before the access point is stopped: the first stations leave in a burst,
+ * the second ones at stop.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_JOIN_BURST_COUNT   2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time left to unexpected events once all the stations left, and time limit of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SETTLE_MS          500
+#define TEST_TIMEOUT_MS         10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station events received.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ConnectCount = 0;
+static uint32_t DisconnectCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of stations of each burst.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t StationCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that each connection had its disconnection, once no event is left.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckCounts
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_ASSERT((TEST_JOIN_BURST_COUNT * StationCount) == ConnectCount);
+    LE_ASSERT(ConnectCount == DisconnectCount);
+
+    LE_INFO("======== Test of the WiFi access point simulation SUCCESS ========");
+
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the access point once the last burst joined: all the stations leave at once.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopAccessPoint
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    LE_ASSERT(LE_OK == pa_wifiAp_Stop());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station event handler, called on the main thread from the PA event ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StationEventHandler
+(
+    const pa_wifiAp_StationEvent_t *stationEventPtr,
+    void *contextPtr
+)
+{
+    if (LE_WIFIAP_EVENT_CLIENT_CONNECTED == stationEventPtr->event)
+    {
+        ConnectCount++;
+        LE_ASSERT(ConnectCount <= (TEST_JOIN_BURST_COUNT * StationCount));
+        if ((TEST_JOIN_BURST_COUNT * StationCount) == ConnectCount)
+        {
+            le_event_QueueFunction(StopAccessPoint, NULL, NULL);
+        }
+    }
+    else if (LE_WIFIAP_EVENT_CLIENT_DISCONNECTED == stationEventPtr->event)
+    {
+        DisconnectCount++;
+        LE_ASSERT(DisconnectCount <= ConnectCount);
+        if ((TEST_JOIN_BURST_COUNT * StationCount) == DisconnectCount)
+        {
+            le_timer_Ref_t timerRef = le_timer_Create("WifiApSimuSettle");
+
+            le_timer_SetMsInterval(timerRef, TEST_SETTLE_MS);
+            le_timer_SetHandler(timerRef, CheckCounts);
+            le_timer_Start(timerRef);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time limit of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimeoutHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_FATAL("Timeout: %u connections, %u disconnections", ConnectCount, DisconnectCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * main of the test
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    le_timer_Ref_t timerRef;
+
+    // Only bursts: joining and leaving in turn, with all the stations.
+    LE_ASSERT(0 == setenv("WIFI_SIMU_STATIONS", TEST_STATION_COUNT, 1));
+    LE_ASSERT(0 == setenv("WIFI_SIMU_ARRIVAL_RATE", "0", 1));
+    LE_ASSERT(0 == setenv("WIFI_SIMU_DEPARTURE_RATE", "0", 1));
+    LE_ASSERT(0 == setenv("WIFI_SIMU_BURST", "mixed", 1));
+    LE_ASSERT(0 == setenv("WIFI_SIMU_BURST_SIZE", TEST_STATION_COUNT, 1));
+    LE_ASSERT(0 == setenv("WIFI_SIMU_BURST_INTERVAL", TEST_BURST_INTERVAL_SEC, 1));
+    LE_ASSERT(0 == setenv("WIFI_SIMU_SEED", "1", 1));
+    StationCount = (uint32_t)atoi(TEST_STATION_COUNT);
+
+    LE_INFO("======== Start test of the WiFi access point simulation ========");
+
+    LE_ASSERT(LE_OK == pa_wifiAp_Init());
+    LE_ASSERT(LE_OK == pa_wifiAp_AddStationEventHandler(StationEventHandler, NULL));
+    LE_ASSERT(LE_OK == pa_wifiAp_SetSsid((const uint8_t *)TEST_SSID, strlen(TEST_SSID)));
+    LE_ASSERT(LE_OK == pa_wifiAp_SetChannel(TEST_CHANNEL));
+    LE_ASSERT(LE_OK == pa_wifiAp_Start());
+
+    timerRef = le_timer_Create("WifiApSimuTimeout");
+    le_timer_SetMsInterval(timerRef, TEST_TIMEOUT_MS);
+    le_timer_SetHandler(timerRef, TimeoutHandler);
+    le_timer_Start(timerRef);
+}
@@ -0,0 +1,128 @@
+/**
+ * This module contains function prototype for the WiFi access point unit test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "le_wifiAp_interface.h"
+#include "le_wifiApExt_interface.h"
+#include "le_cfg_interface.h"
+
+#undef LE_KILL_CLIENT
+#define LE_KILL_CLIENT LE_WARN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Associate a station with the access point: the station is added to the driver station list and
+ * its "new station" event line is reported to the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_ConnectStation
+(
+    const char *macAddressPtr       ///< [IN] Station MAC address, lower case.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disassociate a station: the station is removed from the driver station list and its
+ * "del station" event line is reported to the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_DisconnectStation
+(
+    const char *macAddressPtr,      ///< [IN] Station MAC address, lower case.
+    uint16_t reason                 ///< [IN] Reason code of the event line, 0 for none.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a station from the driver station list without event line, as when it leaves out of
+ * range.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_DropStation
+(
+    const char *macAddressPtr       ///< [IN] Station MAC address, lower case.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of runs of the hostapd start command.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdStartCount
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the next runs of the hostapd start command fail, or succeed again.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_SetHostapdStartFailure
+(
+    bool isFailing                  ///< [IN] true to make the command fail.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of hostapd terminations.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdTerminateCount
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of parameters set through the hostapd control interface.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdSetCount
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of reloads of hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdReloadCount
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of updates of the MAC address lists of hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetAclUpdateCount
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the result of the next updates of the MAC address lists of hostapd (ex: LE_UNSUPPORTED for
+ * an old hostapd).
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_SetAclUpdateResult
+(
+    le_result_t result              ///< [IN] Result of the updates.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of runs of the dnsmasq start command.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetDnsmasqStartCount
+(
+    void
+);
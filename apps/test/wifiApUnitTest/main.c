@@ -0,0 +1,1200 @@
+/**
+ * This module implements the unit tests for WiFi access point API
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include "legato.h"
+#include "interfaces.h"
+#include "wifiService.h"
+#include "pa_wifi_dhcp.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings of the access point under test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SSID               "wifiApUnitTest"
+#define TEST_SSID_2             "wifiApUnitTest2"
+#define TEST_CHANNEL            6
+#define TEST_BEACON_INTERVAL    200
+#define TEST_BEACON_DEFAULT     100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stations associated through the driver stub.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_STATION_1          "02:00:00:00:00:0a"
+#define TEST_STATION_2          "02:00:00:00:00:0b"
+#define TEST_STATION_3          "02:00:00:00:00:0c"
+#define TEST_STATION_4          "02:00:00:00:00:0d"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path and node of the refresh period of the station table, and the period used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_CFG_PATH_AP        "wifiService:/wifi/ap"
+#define TEST_CFG_NODE_REFRESH   "stationRefreshMs"
+#define TEST_STATION_REFRESH_MS 300
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * hostapd.conf and the deny list generated by the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_HOSTAPD_FILE       "/tmp/hostapd.conf"
+#define TEST_DENY_FILE          "/tmp/hostapd.deny"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Additional BSS served by the DHCP server, and the dnsmasq configuration file of the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_BSS_INDEX          1
+#define TEST_BSS_SSID           "wifiApUnitTestBss"
+#define TEST_BSS_IP_AP          "192.168.20.1"
+#define TEST_BSS_IP_START       "192.168.20.10"
+#define TEST_BSS_IP_STOP        "192.168.20.20"
+#define TEST_DNSMASQ_FILE       "/tmp/dnsmasq.wlan.conf"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * dnsmasq lease file written by the test, and the time left to the inotify event of a rewrite.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_LEASE_FILE         "/tmp/wifiApUnitTest.leases"
+#define TEST_LEASE_WAIT_MS      100
+#define TEST_LEASE_MAX_COUNT    8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of station events recorded, and of stations read from the station table.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_EVENT_MAX_COUNT    16
+#define TEST_STATION_MAX_COUNT  8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test step run from the event loop. Each step ends by calling EndStep().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*TestStep_t)(void);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station events received since the last ExpectStationEvents(), and the check run once the
+ * expected number of events is received.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiApExt_EventInd_t StationEvents[TEST_EVENT_MAX_COUNT];
+static uint32_t                StationEventCount = 0;
+static uint32_t                StationEventExpectedCount = 0;
+static le_event_DeferredFunc_t StationEventCheckFunc = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * hostapd start commands and terminations before the restart under test.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HostapdStartCountBefore = 0;
+static uint32_t HostapdTerminateCountBefore = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expiry of the leases written by TestWifiAp_Leases().
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t LeaseExpiry = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current test step: the next one is run from the event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndStep
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station event handler: record the event, and run the check once the expected number of events
+ * is received. The station events are delivered from the event loop, after the PA event ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StationEventHandler
+(
+    const le_wifiApExt_EventInd_t *eventIndPtr,
+    void *contextPtr
+)
+{
+    LE_INFO("Station event %d, station %s, reason %u",
+            eventIndPtr->event, eventIndPtr->macAddress, eventIndPtr->reason);
+
+    // No event is expected but the ones of the current check.
+    LE_ASSERT(StationEventCount < StationEventExpectedCount);
+
+    StationEvents[StationEventCount++] = *eventIndPtr;
+    if (StationEventCount == StationEventExpectedCount)
+    {
+        le_event_QueueFunction(StationEventCheckFunc, NULL, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for station events: the check function is run once they are received.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpectStationEvents
+(
+    uint32_t count,
+    le_event_DeferredFunc_t checkFunc
+)
+{
+    LE_ASSERT(count <= TEST_EVENT_MAX_COUNT);
+
+    StationEventCount = 0;
+    StationEventExpectedCount = count;
+    StationEventCheckFunc = checkFunc;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a received station event.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStationEvent
+(
+    uint32_t index,
+    le_wifiAp_Event_t event,
+    const char *macAddressPtr,
+    uint16_t reason
+)
+{
+    LE_ASSERT(index < StationEventCount);
+    LE_ASSERT(event == StationEvents[index].event);
+    LE_ASSERT(0 == strcmp(macAddressPtr, StationEvents[index].macAddress));
+    LE_ASSERT(0 == strcmp("wlan0", StationEvents[index].ifName));
+    LE_ASSERT(0 == StationEvents[index].bssIndex);
+    LE_ASSERT(reason == StationEvents[index].reason);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of stations in the station table, and check if a station is one of them.
+ *
+ * @return The number of stations.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetStations
+(
+    const char *macAddressPtr,      ///< Station to look for, or NULL.
+    bool *isFoundPtr                ///< Set if the station is in the table, if not NULL.
+)
+{
+    le_wifiApExt_Station_t stations[TEST_STATION_MAX_COUNT];
+    size_t                 size = NUM_ARRAY_MEMBERS(stations);
+    uint32_t               totalCount = 0;
+    size_t                 i;
+
+    LE_ASSERT(LE_OK == le_wifiApExt_GetStations(0, stations, &size, &totalCount));
+    LE_ASSERT(size == totalCount);
+
+    if (NULL != isFoundPtr)
+    {
+        *isFoundPtr = false;
+        for (i = 0; i < size; i++)
+        {
+            if (0 == strcmp(macAddressPtr, stations[i].macAddress))
+            {
+                *isFoundPtr = true;
+            }
+        }
+    }
+    return totalCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the lease file, as dnsmasq would.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteLeaseFile
+(
+    const char *contentPtr
+)
+{
+    FILE *filePtr = fopen(TEST_LEASE_FILE, "w");
+
+    LE_ASSERT(NULL != filePtr);
+    LE_ASSERT(EOF != fputs(contentPtr, filePtr));
+    LE_ASSERT(0 == fclose(filePtr));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the leases from the startIndex one.
+ *
+ * @return The number of leases.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetLeases
+(
+    uint32_t startIndex,
+    le_wifiApExt_Lease_t *leasesPtr,
+    size_t *sizePtr                 ///< Size of the leases array, number of leases returned.
+)
+{
+    uint32_t totalCount = 0;
+
+    LE_ASSERT(LE_OK == le_wifiApExt_GetLeases(startIndex, leasesPtr, sizePtr, &totalCount));
+    return totalCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the IP address of a station in the station table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetStationIpAddress
+(
+    const char *macAddressPtr,
+    char *ipAddressPtr,
+    size_t ipAddressSize
+)
+{
+    le_wifiApExt_Station_t stations[TEST_STATION_MAX_COUNT];
+    size_t                 size = NUM_ARRAY_MEMBERS(stations);
+    uint32_t               totalCount = 0;
+    size_t                 i;
+
+    LE_ASSERT(LE_OK == le_wifiApExt_GetStations(0, stations, &size, &totalCount));
+    for (i = 0; i < size; i++)
+    {
+        if (0 == strcmp(macAddressPtr, stations[i].macAddress))
+        {
+            LE_ASSERT(LE_OK == le_utf8_Copy(ipAddressPtr, stations[i].ipAddress, ipAddressSize,
+                                            NULL));
+            return;
+        }
+    }
+    LE_FATAL("Station %s not found", macAddressPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the disconnection of the station of the lease tests.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLeaseCleanup
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_1, 0);
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the leases once the rewrite of the lease file is notified: the leases which are not in
+ * the file any more are removed, the new ones are added after the others.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLeaseUpdate
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_wifiApExt_Lease_t leases[TEST_LEASE_MAX_COUNT];
+    size_t               size = NUM_ARRAY_MEMBERS(leases);
+    char                 ipAddress[LE_WIFIAPEXT_MAX_IP_ADDRESS_BYTES];
+
+    le_timer_Delete(timerRef);
+
+    LE_ASSERT(2 == GetLeases(0, leases, &size));
+    LE_ASSERT(2 == size);
+    LE_ASSERT(0 == strcmp(TEST_STATION_2, leases[0].macAddress));
+    LE_ASSERT(0 == strcmp("192.168.10.21", leases[0].ipAddress));
+    LE_ASSERT(0 == strcmp(TEST_STATION_4, leases[1].macAddress));
+    LE_ASSERT(0 == strcmp("station-4", leases[1].hostname));
+    LE_ASSERT(LeaseExpiry == leases[1].expiry);
+
+    LE_ASSERT(LE_NOT_FOUND == le_wifiApExt_GetIpAddress(TEST_STATION_1, ipAddress,
+                                                        sizeof(ipAddress)));
+    GetStationIpAddress(TEST_STATION_1, ipAddress, sizeof(ipAddress));
+    LE_ASSERT('\0' == ipAddress[0]);
+
+    // The DHCP server stopped: no lease any more.
+    LE_ASSERT(LE_OK == pa_wifiDhcp_SetLeaseFile(NULL));
+    size = NUM_ARRAY_MEMBERS(leases);
+    LE_ASSERT(0 == GetLeases(0, leases, &size));
+    LE_ASSERT(0 == size);
+    LE_ASSERT(0 == unlink(TEST_LEASE_FILE));
+
+    ExpectStationEvents(1, CheckLeaseCleanup);
+    stubs_DisconnectStation(TEST_STATION_1, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the leases parsed from the lease file, and their association with the station table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLeases
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    le_wifiApExt_Lease_t leases[TEST_LEASE_MAX_COUNT];
+    size_t               size = NUM_ARRAY_MEMBERS(leases);
+    char                 ipAddress[LE_WIFIAPEXT_MAX_IP_ADDRESS_BYTES];
+    char                 content[512];
+    le_timer_Ref_t       timerRef;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_1, 0);
+
+    // The expired lease and the other lines are skipped, the MAC addresses are in lower case.
+    LE_ASSERT(2 == GetLeases(0, leases, &size));
+    LE_ASSERT(2 == size);
+    LE_ASSERT(0 == strcmp(TEST_STATION_1, leases[0].macAddress));
+    LE_ASSERT(0 == strcmp("192.168.10.20", leases[0].ipAddress));
+    LE_ASSERT(0 == strcmp("station-1", leases[0].hostname));
+    LE_ASSERT(LeaseExpiry == leases[0].expiry);
+    LE_ASSERT(leases[0].isAssociated);
+    LE_ASSERT(0 == strcmp(TEST_STATION_2, leases[1].macAddress));
+    LE_ASSERT(0 == strcmp("192.168.10.21", leases[1].ipAddress));
+    LE_ASSERT('\0' == leases[1].hostname[0]);
+    LE_ASSERT(0 == leases[1].expiry);
+    LE_ASSERT(!leases[1].isAssociated);
+
+    // Second page.
+    size = 1;
+    LE_ASSERT(2 == GetLeases(1, leases, &size));
+    LE_ASSERT(1 == size);
+    LE_ASSERT(0 == strcmp(TEST_STATION_2, leases[0].macAddress));
+
+    LE_ASSERT(LE_OK == le_wifiApExt_GetIpAddress("02:00:00:00:00:0B", ipAddress,
+                                                 sizeof(ipAddress)));
+    LE_ASSERT(0 == strcmp("192.168.10.21", ipAddress));
+    LE_ASSERT(LE_OVERFLOW == le_wifiApExt_GetIpAddress(TEST_STATION_2, ipAddress, 4));
+    LE_ASSERT(LE_NOT_FOUND == le_wifiApExt_GetIpAddress(TEST_STATION_3, ipAddress,
+                                                        sizeof(ipAddress)));
+    GetStationIpAddress(TEST_STATION_1, ipAddress, sizeof(ipAddress));
+    LE_ASSERT(0 == strcmp("192.168.10.20", ipAddress));
+
+    // dnsmasq rewrites the file: the first lease is released, another one is added.
+    snprintf(content, sizeof(content),
+             "0 " TEST_STATION_2 " 192.168.10.21 * *\n"
+             "%" PRIu64 " " TEST_STATION_4 " 192.168.10.23 station-4 *\n",
+             LeaseExpiry);
+    WriteLeaseFile(content);
+
+    timerRef = le_timer_Create("LeaseUpdateCheck");
+    le_timer_SetHandler(timerRef, CheckLeaseUpdate);
+    le_timer_SetMsInterval(timerRef, TEST_LEASE_WAIT_MS);
+    le_timer_Start(timerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: DHCP leases of the stations, read from the lease file of dnsmasq.
+ *
+ * API tested:
+ * - le_wifiApExt_GetLeases
+ * - le_wifiApExt_GetIpAddress
+ * - le_wifiApExt_GetStations
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_Leases
+(
+    void
+)
+{
+    char content[512];
+
+    LE_INFO("======== Test: Leases ========");
+
+    LeaseExpiry = (uint64_t)time(NULL) + 3600;
+    snprintf(content, sizeof(content),
+             "%" PRIu64 " 02:00:00:00:00:0A 192.168.10.20 station-1 01:02:00:00:00:00:0a\n"
+             "0 " TEST_STATION_2 " 192.168.10.21 * *\n"
+             "%" PRIu64 " " TEST_STATION_3 " 192.168.10.22 station-3 *\n"
+             "duid 00:01:00:01:2a:2b:2c:2d:02:00:00:00:00:01\n",
+             LeaseExpiry,
+             (uint64_t)time(NULL) - 60);
+    WriteLeaseFile(content);
+    LE_ASSERT(LE_OK == pa_wifiDhcp_SetLeaseFile(TEST_LEASE_FILE));
+
+    ExpectStationEvents(1, CheckLeases);
+    stubs_ConnectStation(TEST_STATION_1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a file generated by the PA has a line.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInFile
+(
+    const char *pathPtr,
+    const char *linePtr             ///< Line, with its end of line.
+)
+{
+    FILE *filePtr = fopen(pathPtr, "r");
+    char  line[256];
+    bool  isFound = false;
+
+    LE_ASSERT(NULL != filePtr);
+    while ((!isFound) && (NULL != fgets(line, sizeof(line), filePtr)))
+    {
+        isFound = (0 == strcmp(line, linePtr));
+    }
+    fclose(filePtr);
+    return isFound;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the lines of a file generated by the PA which start with a prefix.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CountInFile
+(
+    const char *pathPtr,
+    const char *prefixPtr           ///< Start of the lines, ex: a parameter name and its '='.
+)
+{
+    FILE     *filePtr = fopen(pathPtr, "r");
+    char      line[256];
+    uint32_t  count = 0;
+
+    LE_ASSERT(NULL != filePtr);
+    while (NULL != fgets(line, sizeof(line), filePtr))
+    {
+        if (0 == strncmp(line, prefixPtr, strlen(prefixPtr)))
+        {
+            count++;
+        }
+    }
+    fclose(filePtr);
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if hostapd.conf is the file of a previous stat().
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHostapdFileUnchanged
+(
+    const struct stat *statPtr
+)
+{
+    struct stat st;
+
+    LE_ASSERT(0 == stat(TEST_HOSTAPD_FILE, &st));
+    return ((st.st_ino == statPtr->st_ino) &&
+            (st.st_mtim.tv_sec == statPtr->st_mtim.tv_sec) &&
+            (st.st_mtim.tv_nsec == statPtr->st_mtim.tv_nsec));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: hostapd.conf is only written, and a parameter only applied to the running hostapd, when
+ * the generated configuration or the file changed.
+ *
+ * API tested:
+ * - le_wifiAp_SetSsid
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_ConfSkip
+(
+    void
+)
+{
+    struct stat st;
+    uint32_t    setCount = stubs_GetHostapdSetCount();
+    uint32_t    reloadCount = stubs_GetHostapdReloadCount();
+
+    LE_INFO("======== Test: ConfSkip ========");
+
+    LE_ASSERT(0 == stat(TEST_HOSTAPD_FILE, &st));
+
+    // Same SSID: hostapd.conf is not written, hostapd is left alone.
+    LE_ASSERT(LE_OK == le_wifiAp_SetSsid((const uint8_t *)TEST_SSID, strlen(TEST_SSID)));
+    LE_ASSERT(IsHostapdFileUnchanged(&st));
+    LE_ASSERT(setCount == stubs_GetHostapdSetCount());
+    LE_ASSERT(reloadCount == stubs_GetHostapdReloadCount());
+
+    // New SSID: hostapd.conf is replaced and the SSID applied.
+    LE_ASSERT(LE_OK == le_wifiAp_SetSsid((const uint8_t *)TEST_SSID_2, strlen(TEST_SSID_2)));
+    LE_ASSERT(!IsHostapdFileUnchanged(&st));
+    LE_ASSERT(IsInFile(TEST_HOSTAPD_FILE, "ssid=" TEST_SSID_2 "\n"));
+    LE_ASSERT((setCount + 1) == stubs_GetHostapdSetCount());
+    LE_ASSERT((reloadCount + 1) == stubs_GetHostapdReloadCount());
+
+    // Removed hostapd.conf: written again, even with the same configuration.
+    LE_ASSERT(0 == unlink(TEST_HOSTAPD_FILE));
+    LE_ASSERT(LE_OK == le_wifiAp_SetSsid((const uint8_t *)TEST_SSID_2, strlen(TEST_SSID_2)));
+    LE_ASSERT(IsInFile(TEST_HOSTAPD_FILE, "ssid=" TEST_SSID_2 "\n"));
+    LE_ASSERT((setCount + 2) == stubs_GetHostapdSetCount());
+
+    // Back to the SSID of the access point for the next steps.
+    LE_ASSERT(LE_OK == le_wifiAp_SetSsid((const uint8_t *)TEST_SSID, strlen(TEST_SSID)));
+    LE_ASSERT(IsInFile(TEST_HOSTAPD_FILE, "ssid=" TEST_SSID "\n"));
+    LE_ASSERT((setCount + 3) == stubs_GetHostapdSetCount());
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the DHCP server serves the range of an additional BSS, and is stopped once the last range
+ * is removed with its BSS.
+ *
+ * API tested:
+ * - le_wifiApExt_SetBss
+ * - le_wifiApExt_SetBssIpRange
+ * - le_wifiApExt_RemoveBss
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_BssDhcp
+(
+    void
+)
+{
+    uint32_t startCount = stubs_GetDnsmasqStartCount();
+    char     ifName[LE_WIFIAPEXT_MAX_IFNAME_BYTES];
+    char     line[128];
+
+    LE_INFO("======== Test: BssDhcp ========");
+
+    LE_ASSERT(LE_OK == le_wifiApExt_SetBss(TEST_BSS_INDEX, (const uint8_t *)TEST_BSS_SSID,
+                                           strlen(TEST_BSS_SSID), LE_WIFIAP_SECURITY_NONE, "", 1,
+                                           true));
+    LE_ASSERT(LE_OK == le_wifiApExt_SetBssIpRange(TEST_BSS_INDEX, TEST_BSS_IP_AP,
+                                                  TEST_BSS_IP_START, TEST_BSS_IP_STOP));
+    LE_ASSERT((startCount + 1) == stubs_GetDnsmasqStartCount());
+    LE_ASSERT(LE_OK == le_wifiApExt_GetBssInterface(TEST_BSS_INDEX, ifName, sizeof(ifName)));
+    snprintf(line, sizeof(line), "dhcp-range=set:%s," TEST_BSS_IP_START "," TEST_BSS_IP_STOP
+             ",24h\n", ifName);
+    LE_ASSERT(IsInFile(TEST_DNSMASQ_FILE, line));
+
+    // Last range removed: the DHCP server is stopped and its configuration removed.
+    LE_ASSERT(LE_OK == le_wifiApExt_RemoveBss(TEST_BSS_INDEX));
+    LE_ASSERT(0 != access(TEST_DNSMASQ_FILE, F_OK));
+
+    // A new range starts it again.
+    LE_ASSERT(LE_OK == le_wifiApExt_SetBss(TEST_BSS_INDEX, (const uint8_t *)TEST_BSS_SSID,
+                                           strlen(TEST_BSS_SSID), LE_WIFIAP_SECURITY_NONE, "", 1,
+                                           true));
+    LE_ASSERT(LE_OK == le_wifiApExt_SetBssIpRange(TEST_BSS_INDEX, TEST_BSS_IP_AP,
+                                                  TEST_BSS_IP_START, TEST_BSS_IP_STOP));
+    LE_ASSERT((startCount + 2) == stubs_GetDnsmasqStartCount());
+
+    // No BSS left for the next steps.
+    LE_ASSERT(LE_OK == le_wifiApExt_RemoveBss(TEST_BSS_INDEX));
+    LE_ASSERT(0 != access(TEST_DNSMASQ_FILE, F_OK));
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the station table once the last station is disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStationTableCleanup
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_3, 0);
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the late disconnection of a station already removed by the refresh was skipped: the
+ * PA events are delivered in order, so only the connection which followed it is received.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLateDisconnection
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    bool isFound;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_3, 0);
+    LE_ASSERT(1 == GetStations(TEST_STATION_3, &isFound));
+    LE_ASSERT(isFound);
+
+    ExpectStationEvents(1, CheckStationTableCleanup);
+    stubs_DisconnectStation(TEST_STATION_3, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the removal by the refresh of the station the driver does not report any more, then
+ * report its disconnection late.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStationRefresh
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_1, 0);
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+
+    ExpectStationEvents(1, CheckLateDisconnection);
+    stubs_DisconnectStation(TEST_STATION_1, 0);
+    stubs_ConnectStation(TEST_STATION_3);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the disconnection of a station with its reason code, then make the other one leave
+ * without disconnection event.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStationDisconnection
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    bool isFound;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_2, 8);
+    LE_ASSERT(1 == GetStations(TEST_STATION_2, &isFound));
+    LE_ASSERT(!isFound);
+    LE_ASSERT(1 == GetStations(TEST_STATION_1, &isFound));
+    LE_ASSERT(isFound);
+
+    // Removed by the next refresh of the station table.
+    ExpectStationEvents(1, CheckStationRefresh);
+    stubs_DropStation(TEST_STATION_1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a station connecting again is not added twice, then disconnect the other one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStationReconnection
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_1, 0);
+    LE_ASSERT(2 == GetStations(NULL, NULL));
+
+    ExpectStationEvents(1, CheckStationDisconnection);
+    stubs_DisconnectStation(TEST_STATION_2, 8);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the stations added to the table, in the order they connected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStationConnections
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    le_wifiApExt_Station_t stations[TEST_STATION_MAX_COUNT];
+    size_t                 size = NUM_ARRAY_MEMBERS(stations);
+    uint32_t               totalCount = 0;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_1, 0);
+    CheckStationEvent(1, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_2, 0);
+
+    LE_ASSERT(LE_OK == le_wifiApExt_GetStations(0, stations, &size, &totalCount));
+    LE_ASSERT(2 == totalCount);
+    LE_ASSERT(2 == size);
+    LE_ASSERT(0 == strcmp(TEST_STATION_1, stations[0].macAddress));
+    LE_ASSERT(0 == strcmp("wlan0", stations[0].ifName));
+    LE_ASSERT(0 == stations[0].bssIndex);
+    LE_ASSERT(0 == strcmp(TEST_STATION_2, stations[1].macAddress));
+
+    // Second page.
+    size = NUM_ARRAY_MEMBERS(stations);
+    LE_ASSERT(LE_OK == le_wifiApExt_GetStations(1, stations, &size, &totalCount));
+    LE_ASSERT(2 == totalCount);
+    LE_ASSERT(1 == size);
+    LE_ASSERT(0 == strcmp(TEST_STATION_2, stations[0].macAddress));
+
+    ExpectStationEvents(1, CheckStationReconnection);
+    stubs_ConnectStation(TEST_STATION_1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: station table, kept from the station events and refreshed from the driver.
+ *
+ * API tested:
+ * - le_wifiApExt_AddStationEventHandler
+ * - le_wifiApExt_GetStations
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_StationTable
+(
+    void
+)
+{
+    LE_INFO("======== Test: StationTable ========");
+
+    ExpectStationEvents(2, CheckStationConnections);
+    stubs_ConnectStation(TEST_STATION_1);
+    stubs_ConnectStation(TEST_STATION_2);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the station table once the last station of the access control tests is disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckAclCleanup
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_1, 0);
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the policy deauthenticated the station not in the accept list, then go back to the
+ * default access control.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckAcceptPolicy
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    bool isFound;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_3, 0);
+    LE_ASSERT(1 == GetStations(TEST_STATION_1, &isFound));
+    LE_ASSERT(isFound);
+
+    LE_ASSERT(LE_OK == le_wifiApExt_SetMacAclPolicy(LE_WIFIAPEXT_MAC_ACL_ACCEPT_UNLESS_DENIED));
+    LE_ASSERT(LE_OK == le_wifiApExt_ClearMacAcl(LE_WIFIAPEXT_MAC_ACL_ACCEPT_LIST));
+    LE_ASSERT(0 == CountInFile(TEST_HOSTAPD_FILE, "macaddr_acl="));
+
+    ExpectStationEvents(1, CheckAclCleanup);
+    stubs_DisconnectStation(TEST_STATION_1, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deny the stations not in the accept list: the associated station which is not in it is
+ * deauthenticated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestAcceptPolicy
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_1, 0);
+    CheckStationEvent(1, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_3, 0);
+
+    ExpectStationEvents(1, CheckAcceptPolicy);
+    LE_ASSERT(LE_OK == le_wifiApExt_SetMacAclPolicy(LE_WIFIAPEXT_MAC_ACL_DENY_UNLESS_ACCEPTED));
+    LE_ASSERT(IsInFile(TEST_HOSTAPD_FILE, "macaddr_acl=1\n"));
+    LE_ASSERT(1 == CountInFile(TEST_HOSTAPD_FILE, "macaddr_acl="));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the deauthentication of the denied station, then remove it from the deny list with an
+ * hostapd which does not support the list updates: hostapd.conf is reloaded instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDenyList
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    uint32_t reloadCount = stubs_GetHostapdReloadCount();
+    uint32_t aclUpdateCount = stubs_GetAclUpdateCount();
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_2, 0);
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+
+    stubs_SetAclUpdateResult(LE_UNSUPPORTED);
+    LE_ASSERT(LE_OK == le_wifiApExt_RemoveMacAcl(LE_WIFIAPEXT_MAC_ACL_DENY_LIST, TEST_STATION_2));
+    LE_ASSERT(LE_NOT_FOUND == le_wifiApExt_RemoveMacAcl(LE_WIFIAPEXT_MAC_ACL_DENY_LIST,
+                                                        TEST_STATION_2));
+    stubs_SetAclUpdateResult(LE_OK);
+    LE_ASSERT((aclUpdateCount + 1) == stubs_GetAclUpdateCount());
+    LE_ASSERT((reloadCount + 1) == stubs_GetHostapdReloadCount());
+    LE_ASSERT(!IsInFile(TEST_DENY_FILE, TEST_STATION_2 "\n"));
+
+    LE_ASSERT(LE_OK == le_wifiApExt_AddMacAcl(LE_WIFIAPEXT_MAC_ACL_ACCEPT_LIST, TEST_STATION_1));
+    ExpectStationEvents(2, TestAcceptPolicy);
+    stubs_ConnectStation(TEST_STATION_1);
+    stubs_ConnectStation(TEST_STATION_3);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the deauthentication of a station with its reason code, then deny the other one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestDenyList
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    uint32_t aclUpdateCount = stubs_GetAclUpdateCount();
+    bool     isFound;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_1, 3);
+    LE_ASSERT(1 == GetStations(TEST_STATION_2, &isFound));
+    LE_ASSERT(isFound);
+
+    // The running hostapd gets the new list, and the station is deauthenticated.
+    ExpectStationEvents(1, CheckDenyList);
+    LE_ASSERT(LE_OK == le_wifiApExt_AddMacAcl(LE_WIFIAPEXT_MAC_ACL_DENY_LIST,
+                                              "02:00:00:00:00:0B"));
+    LE_ASSERT((aclUpdateCount + 1) == stubs_GetAclUpdateCount());
+    LE_ASSERT(IsInFile(TEST_DENY_FILE, TEST_STATION_2 "\n"));
+    LE_ASSERT(IsInFile(TEST_HOSTAPD_FILE, "deny_mac_file=" TEST_DENY_FILE "\n"));
+
+    // Already in the list: nothing to update.
+    LE_ASSERT(LE_OK == le_wifiApExt_AddMacAcl(LE_WIFIAPEXT_MAC_ACL_DENY_LIST, TEST_STATION_2));
+    LE_ASSERT((aclUpdateCount + 1) == stubs_GetAclUpdateCount());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate an associated station.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestDeauthenticate
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_1, 0);
+    CheckStationEvent(1, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_2, 0);
+
+    ExpectStationEvents(1, TestDenyList);
+    LE_ASSERT(LE_OK == le_wifiApExt_Deauthenticate(TEST_STATION_1, 3));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: deauthentication of the stations, and MAC address access control.
+ *
+ * API tested:
+ * - le_wifiApExt_Deauthenticate
+ * - le_wifiApExt_SetMacAclPolicy
+ * - le_wifiApExt_AddMacAcl
+ * - le_wifiApExt_RemoveMacAcl
+ * - le_wifiApExt_ClearMacAcl
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_DeauthenticateAcl
+(
+    void
+)
+{
+    LE_INFO("======== Test: DeauthenticateAcl ========");
+
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiApExt_Deauthenticate("02:00:00:00:00", 0));
+    LE_ASSERT(LE_NOT_FOUND == le_wifiApExt_Deauthenticate(TEST_STATION_3, 0));
+    LE_ASSERT(LE_BAD_PARAMETER == le_wifiApExt_AddMacAcl(LE_WIFIAPEXT_MAC_ACL_DENY_LIST,
+                                                         "02:00:00:00:00"));
+
+    ExpectStationEvents(2, TestDeauthenticate);
+    stubs_ConnectStation(TEST_STATION_1);
+    stubs_ConnectStation(TEST_STATION_2);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the access point stopped when hostapd could not be started again: the station was
+ * disconnected, and the access point can not be used any more.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRestartFailure
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_2, 0);
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+
+    LE_ASSERT(LE_FAULT == le_wifiApExt_Deauthenticate(TEST_STATION_2, 0));
+    LE_ASSERT(LE_FAULT == le_wifiApExt_Restart());
+    LE_ASSERT(0 != access(TEST_HOSTAPD_FILE, F_OK));
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restart with a failing hostapd start: the access point is stopped and the station disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestRestartFailure
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_2, 0);
+
+    HostapdStartCountBefore = stubs_GetHostapdStartCount();
+    LE_ASSERT(LE_OK == le_wifiApExt_SetBeaconInterval(TEST_BEACON_DEFAULT));
+
+    stubs_SetHostapdStartFailure(true);
+    ExpectStationEvents(1, CheckRestartFailure);
+    LE_ASSERT(LE_FAULT == le_wifiApExt_Restart());
+    stubs_SetHostapdStartFailure(false);
+
+    LE_ASSERT((HostapdStartCountBefore + 1) == stubs_GetHostapdStartCount());
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the disconnection of the station by the restart, then associate another one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRestartDisconnection
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, TEST_STATION_1, 0);
+
+    ExpectStationEvents(1, TestRestartFailure);
+    stubs_ConnectStation(TEST_STATION_2);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restart without change, which keeps hostapd and the station, then restart after a change of a
+ * parameter hostapd only reads at startup, which disconnects the station.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestRestartUnchanged
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    bool isFound;
+
+    CheckStationEvent(0, LE_WIFIAP_EVENT_CLIENT_CONNECTED, TEST_STATION_1, 0);
+
+    HostapdStartCountBefore = stubs_GetHostapdStartCount();
+    HostapdTerminateCountBefore = stubs_GetHostapdTerminateCount();
+
+    // hostapd.conf unchanged: nothing to restart.
+    LE_ASSERT(LE_OK == le_wifiApExt_Restart());
+    LE_ASSERT(HostapdStartCountBefore == stubs_GetHostapdStartCount());
+    LE_ASSERT(HostapdTerminateCountBefore == stubs_GetHostapdTerminateCount());
+    LE_ASSERT(1 == GetStations(TEST_STATION_1, &isFound));
+    LE_ASSERT(isFound);
+
+    // The beacon interval is only read at startup.
+    LE_ASSERT(LE_OK == le_wifiApExt_SetBeaconInterval(TEST_BEACON_INTERVAL));
+    ExpectStationEvents(1, CheckRestartDisconnection);
+    LE_ASSERT(LE_OK == le_wifiApExt_Restart());
+    LE_ASSERT((HostapdStartCountBefore + 1) == stubs_GetHostapdStartCount());
+    LE_ASSERT((HostapdTerminateCountBefore + 1) == stubs_GetHostapdTerminateCount());
+    LE_ASSERT(0 == GetStations(NULL, NULL));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: soft restart of the access point. The access point is stopped at the end.
+ *
+ * API tested:
+ * - le_wifiApExt_Restart
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_Restart
+(
+    void
+)
+{
+    LE_INFO("======== Test: Restart ========");
+
+    ExpectStationEvents(1, TestRestartUnchanged);
+    stubs_ConnectStation(TEST_STATION_1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: range of the contention window exponents of the WMM parameters. The access point is
+ * stopped, the parameters are only checked and saved.
+ *
+ * API tested:
+ * - le_wifiApExt_SetWmmParameters
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiAp_WmmParams
+(
+    void
+)
+{
+    LE_INFO("======== Test: WmmParams ========");
+
+    // An exponent of 0, for a contention window of 0, is valid for the minimum and the maximum.
+    LE_ASSERT(LE_OK == le_wifiApExt_SetWmmParameters(LE_WIFIAPEXT_WMM_AC_VO, 2, 0, 0, 47));
+    LE_ASSERT(LE_OK == le_wifiApExt_SetWmmParameters(LE_WIFIAPEXT_WMM_AC_VO, 2, 0, 15, 47));
+    LE_ASSERT(LE_OK == le_wifiApExt_SetWmmParameters(LE_WIFIAPEXT_WMM_AC_VO, 2, 2, 3, 47));
+
+    LE_ASSERT(LE_BAD_PARAMETER ==
+              le_wifiApExt_SetWmmParameters(LE_WIFIAPEXT_WMM_AC_VO, 2, 4, 3, 47));
+    LE_ASSERT(LE_BAD_PARAMETER ==
+              le_wifiApExt_SetWmmParameters(LE_WIFIAPEXT_WMM_AC_VO, 2, 0, 16, 47));
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test steps run from the event loop, in order, once the access point is started.
+ */
+//--------------------------------------------------------------------------------------------------
+static const TestStep_t TestSteps[] =
+{
+    TestWifiAp_StationTable,
+    TestWifiAp_DeauthenticateAcl,
+    TestWifiAp_Leases,
+    TestWifiAp_ConfSkip,
+    TestWifiAp_BssDhcp,
+    TestWifiAp_Restart,
+    TestWifiAp_WmmParams,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the next test step.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestStepIndex = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the next test step, or end the test when all the steps are done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunNextStep
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    if (TestStepIndex < NUM_ARRAY_MEMBERS(TestSteps))
+    {
+        TestSteps[TestStepIndex++]();
+        return;
+    }
+
+    LE_INFO ("======== UnitTest of WiFi access point SUCCESS ========");
+
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current test step: the next one is run from the event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndStep
+(
+    void
+)
+{
+    le_event_QueueFunction(RunNextStep, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the refresh period of the station table, or remove it when 0.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetStationRefresh
+(
+    uint32_t refreshMs
+)
+{
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateWriteTxn(TEST_CFG_PATH_AP);
+
+    if (refreshMs > 0)
+    {
+        le_cfg_SetInt(cfg, TEST_CFG_NODE_REFRESH, refreshMs);
+    }
+    else
+    {
+        le_cfg_DeleteNode(cfg, TEST_CFG_NODE_REFRESH);
+    }
+    le_cfg_CommitTxn(cfg);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * main of the test
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    // The refresh period of the station table is only read at startup.
+    SetStationRefresh(TEST_STATION_REFRESH_MS);
+    le_wifiAp_Init();
+    SetStationRefresh(0);
+
+    LE_INFO ("======== Start UnitTest of WiFi access point ========");
+
+    le_wifiApExt_AddStationEventHandler(StationEventHandler, NULL);
+
+    LE_ASSERT(LE_OK == le_wifiAp_SetSsid((const uint8_t *)TEST_SSID, strlen(TEST_SSID)));
+    LE_ASSERT(LE_OK == le_wifiAp_SetSecurityProtocol(LE_WIFIAP_SECURITY_NONE));
+    LE_ASSERT(LE_OK == le_wifiAp_SetChannel(TEST_CHANNEL));
+    LE_ASSERT(LE_OK == le_wifiAp_Start());
+
+    // The station events need the event loop.
+    EndStep();
+}
@@ -0,0 +1,741 @@
+/**
+ * @file stubs.c
+ *
+ * Stub functions required for WiFi access point unit test: the radio, hostapd, the PA script
+ * and the driver are replaced by a station list driven by the test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_wifi_acs.h"
+#include "pa_wifi_ap.h"
+#include "pa_wifi_cmd.h"
+#include "pa_wifi_hostapd.h"
+#include "pa_wifi_nl80211.h"
+#include "pa_wifi_proc.h"
+#include "pa_wifi_radio.h"
+#include "pa_wifi_stats.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interface of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STUB_AP_IFNAME              "wlan0"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PA script command starting hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STUB_COMMAND_HOSTAPD_START  "WIFIAP_HOSTAPD_START"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PA script command starting the dnsmasq instance of the WLAN.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STUB_COMMAND_DNSMASQ_START  "DNSMASQ_WLAN_START"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of stations in the driver station list.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STUB_MAX_STATIONS           8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stations associated with the access point, as the driver reports them.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiAp_Station_t Stations[STUB_MAX_STATIONS];
+static size_t              StationCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the event lines of the access point, set by pa_wifiRadio_Start().
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiRadio_EventHandlerFunc_t ApEventHandlerFunc = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * hostapd start commands and terminations, and whether the start command fails.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HostapdStartCount = 0;
+static uint32_t HostapdTerminateCount = 0;
+static bool     IsHostapdStartFailing = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameters set through the hostapd control interface, and reloads of hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HostapdSetCount = 0;
+static uint32_t HostapdReloadCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates of the MAC address lists of hostapd, and their result.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t    AclUpdateCount = 0;
+static le_result_t AclUpdateResult = LE_OK;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts of the dnsmasq instance of the WLAN.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t DnsmasqStartCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a station in the driver station list.
+ *
+ * @return The station, or NULL if it is not associated.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiAp_Station_t *FindStation
+(
+    const char *ifNamePtr,
+    const char *macAddressPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < StationCount; i++)
+    {
+        if ((0 == strcmp(Stations[i].ifName, ifNamePtr)) &&
+            (0 == strcasecmp(Stations[i].macAddress, macAddressPtr)))
+        {
+            return &Stations[i];
+        }
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report an event line of the access point interface, as the event thread would.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportEventLine
+(
+    const char *keywordPtr,
+    const char *macAddressPtr,
+    uint16_t reason                 ///< Reason code appended to the line, 0 for none.
+)
+{
+    char line[128];
+    int  length;
+
+    LE_ASSERT(NULL != ApEventHandlerFunc);
+
+    length = snprintf(line, sizeof(line), STUB_AP_IFNAME " (phy #0): %s %s",
+                      keywordPtr, macAddressPtr);
+    if (0 != reason)
+    {
+        snprintf(line + length, sizeof(line) - length, " reason: %u", reason);
+    }
+    ApEventHandlerFunc(line, le_clk_GetRelativeTime());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a station from the driver station list, if it is in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveStation
+(
+    const char *ifNamePtr,
+    const char *macAddressPtr
+)
+{
+    pa_wifiAp_Station_t *stationPtr = FindStation(ifNamePtr, macAddressPtr);
+
+    if (NULL != stationPtr)
+    {
+        *stationPtr = Stations[--StationCount];
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Associate a station with the access point: the station is added to the driver station list and
+ * its "new station" event line is reported to the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_ConnectStation
+(
+    const char *macAddressPtr       ///< [IN] Station MAC address, lower case.
+)
+{
+    pa_wifiAp_Station_t *stationPtr;
+
+    // A station associating again is already in the list.
+    if (NULL == FindStation(STUB_AP_IFNAME, macAddressPtr))
+    {
+        LE_ASSERT(StationCount < NUM_ARRAY_MEMBERS(Stations));
+
+        stationPtr = &Stations[StationCount++];
+        memset(stationPtr, 0, sizeof(pa_wifiAp_Station_t));
+        le_utf8_Copy(stationPtr->macAddress, macAddressPtr, sizeof(stationPtr->macAddress), NULL);
+        le_utf8_Copy(stationPtr->ifName, STUB_AP_IFNAME, sizeof(stationPtr->ifName), NULL);
+    }
+
+    ReportEventLine("new station", macAddressPtr, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disassociate a station: the station is removed from the driver station list and its
+ * "del station" event line is reported to the PA.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_DisconnectStation
+(
+    const char *macAddressPtr,      ///< [IN] Station MAC address, lower case.
+    uint16_t reason                 ///< [IN] Reason code of the event line, 0 for none.
+)
+{
+    RemoveStation(STUB_AP_IFNAME, macAddressPtr);
+    ReportEventLine("del station", macAddressPtr, reason);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a station from the driver station list without event line, as when it leaves out of
+ * range.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_DropStation
+(
+    const char *macAddressPtr       ///< [IN] Station MAC address, lower case.
+)
+{
+    RemoveStation(STUB_AP_IFNAME, macAddressPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of runs of the hostapd start command.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdStartCount
+(
+    void
+)
+{
+    return HostapdStartCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the next runs of the hostapd start command fail, or succeed again.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_SetHostapdStartFailure
+(
+    bool isFailing                  ///< [IN] true to make the command fail.
+)
+{
+    IsHostapdStartFailing = isFailing;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of hostapd terminations.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdTerminateCount
+(
+    void
+)
+{
+    return HostapdTerminateCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of parameters set through the hostapd control interface.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdSetCount
+(
+    void
+)
+{
+    return HostapdSetCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of reloads of hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetHostapdReloadCount
+(
+    void
+)
+{
+    return HostapdReloadCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of updates of the MAC address lists of hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetAclUpdateCount
+(
+    void
+)
+{
+    return AclUpdateCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the result of the next updates of the MAC address lists of hostapd (ex: LE_UNSUPPORTED for
+ * an old hostapd).
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_SetAclUpdateResult
+(
+    le_result_t result              ///< [IN] Result of the updates.
+)
+{
+    AclUpdateResult = result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of runs of the dnsmasq start command.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t stubs_GetDnsmasqStartCount
+(
+    void
+)
+{
+    return DnsmasqStartCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the native commands (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiCmd_Init
+(
+    void
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command (STUBBED FUNCTION)
+ *
+ * All the commands succeed, except the hostapd start when it is made to fail.
+ */
+//--------------------------------------------------------------------------------------------------
+int pa_wifiCmd_Run
+(
+    const char *commandPtr,
+    char *outputPtr,
+    size_t outputSize
+)
+{
+    if ((NULL != outputPtr) && (0 < outputSize))
+    {
+        outputPtr[0] = '\0';
+    }
+
+    if (0 == strncmp(commandPtr, STUB_COMMAND_HOSTAPD_START, strlen(STUB_COMMAND_HOSTAPD_START)))
+    {
+        HostapdStartCount++;
+        if (IsHostapdStartFailing)
+        {
+            // Exit status 1, in the format of system().
+            return 1 << 8;
+        }
+    }
+    else if (0 == strncmp(commandPtr, STUB_COMMAND_DNSMASQ_START,
+                          strlen(STUB_COMMAND_DNSMASQ_START)))
+    {
+        DnsmasqStartCount++;
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the duration of a command (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiStats_Record
+(
+    const char *commandPtr,
+    le_clk_Time_t startTime,
+    int status
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the duration of an operation (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiStats_RecordResult
+(
+    const char *namePtr,
+    le_clk_Time_t startTime,
+    le_result_t result
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the radio module (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiRadio_Init
+(
+    void
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the interface of a role (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+const char *pa_wifiRadio_GetInterface
+(
+    pa_wifiRadio_Role_t role
+)
+{
+    return STUB_AP_IFNAME;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the access point on a virtual interface or not (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_SetConcurrent
+(
+    bool isConcurrent
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the access point runs on a virtual interface (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_wifiRadio_IsConcurrent
+(
+    void
+)
+{
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a role: the event lines are then reported by the test (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_Start
+(
+    pa_wifiRadio_Role_t role,
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc
+)
+{
+    ApEventHandlerFunc = handlerFunc;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop a role (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_Stop
+(
+    pa_wifiRadio_Role_t role
+)
+{
+    ApEventHandlerFunc = NULL;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel of a role (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_GetChannel
+(
+    pa_wifiRadio_Role_t role,
+    uint16_t *channelPtr,
+    bool *is5GHzPtr
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the least congested channel (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAcs_SelectChannel
+(
+    const char *ifNamePtr,
+    bool is5GHz,
+    const char *countryCodePtr,
+    pa_wifiAcs_ChannelScore_t *scoresPtr,
+    size_t *scoreCountPtr,
+    uint16_t *channelPtr
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the capabilities of a band (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetBandCapa
+(
+    const char *ifNamePtr,
+    bool is5GHz,
+    pa_wifiNl80211_BandCapa_t *capaPtr
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the stations of an interface from the driver station list (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetStations
+(
+    const char *ifNamePtr,
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+    void *contextPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < StationCount; i++)
+    {
+        if (0 == strcmp(Stations[i].ifName, ifNamePtr))
+        {
+            handlerPtr(&Stations[i], contextPtr);
+        }
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the stations of an interface from hostapd (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_GetStations
+(
+    const char *ifNamePtr,
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+    void *contextPtr
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request to hostapd: it answers the pings (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Request
+(
+    const char *ifNamePtr,
+    const char *requestPtr,
+    char *replyPtr,
+    size_t replySize
+)
+{
+    return le_utf8_Copy(replyPtr, (0 == strcmp(requestPtr, "PING")) ? "PONG" : "OK", replySize,
+                        NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a parameter of hostapd (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Set
+(
+    const char *ifNamePtr,
+    const char *namePtr,
+    const char *valuePtr
+)
+{
+    HostapdSetCount++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the beacon of hostapd (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_UpdateBeacon
+(
+    const char *ifNamePtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reload hostapd.conf (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Reload
+(
+    const char *ifNamePtr
+)
+{
+    HostapdReloadCount++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Terminate hostapd: the stations are disassociated without event lines (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Terminate
+(
+    const char *ifNamePtr
+)
+{
+    HostapdTerminateCount++;
+    StationCount = 0;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a station is associated with hostapd (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_HasStation
+(
+    const char *ifNamePtr,
+    const char *macAddressPtr
+)
+{
+    return (NULL != FindStation(ifNamePtr, macAddressPtr)) ? LE_OK : LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate a station: it is disassociated with an event line (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Deauthenticate
+(
+    const char *ifNamePtr,
+    const char *macAddressPtr,
+    uint16_t reason
+)
+{
+    if (NULL == FindStation(ifNamePtr, macAddressPtr))
+    {
+        return LE_FAULT;
+    }
+
+    RemoveStation(ifNamePtr, macAddressPtr);
+    ReportEventLine("del station", macAddressPtr, reason);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a MAC address list of hostapd (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_UpdateAcl
+(
+    const char *ifNamePtr,
+    pa_wifiAcl_List_t list,
+    pa_wifiHostapd_AclAction_t action,
+    const char *macAddressPtr
+)
+{
+    AclUpdateCount++;
+    return AclUpdateResult;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a pid file: hostapd and dnsmasq have none (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiProc_ReadPidFile
+(
+    const char *pathPtr,
+    const char *namePtr,
+    pid_t *pidPtr
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a process to exit (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiProc_Wait
+(
+    pid_t pid,
+    uint32_t timeoutMs
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop a process (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiProc_Stop
+(
+    pid_t pid,
+    uint32_t timeoutMs
+)
+{
+    return LE_OK;
+}
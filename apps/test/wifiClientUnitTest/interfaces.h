@@ -6,6 +6,7 @@
  */
 
 #include "le_wifiClient_interface.h"
+#include "le_wifiClientExt_interface.h"
 #include "le_cfg_interface.h"
 #include "le_secStore_interface.h"
 
@@ -45,3 +46,17 @@ le_msg_SessionEventHandlerRef_t MyAddServiceCloseHandler
     le_msg_SessionEventHandler_t    handlerFunc,///< [IN] Handler function.
     void*                           contextPtr  ///< [IN] Opaque pointer value to pass to handler.
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report an event indication to the service as the PA would, synchronously.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_ReportEventInd
+(
+    le_wifiClient_Event_t event,    ///< [IN] Event to report.
+    const char *ifNamePtr,          ///< [IN] WLAN interface name.
+    const char *apBssidPtr,         ///< [IN] AP BSSID.
+    uint32_t droppedCount,          ///< [IN] Events dropped by the PA before this one.
+    bool isLocal                    ///< [IN] Generated on the main thread.
+);
@@ -8,6 +8,142 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "wifiService.h"
+#include "pa_wifi_ring.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interfaces and BSSIDs of the events injected through the PA stub.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_IFNAME         "wlan0"
+#define TEST_IFNAME_2       "wlan1"
+#define TEST_BSSID          "02:00:00:00:00:01"
+#define TEST_BSSID_2        "02:00:00:00:00:02"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path and node of the WiFi client event settings.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_CFG_PATH_CLIENT        "wifiService:/wifi/client"
+#define TEST_CFG_NODE_REPLAY        "replayLastState"
+#define TEST_CFG_NODE_COALESCE      "coalesceWindowMs"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coalescing window of the connection events, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_COALESCE_WINDOW_MS     50
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of slots of the test ring, and the capacity asked for (rounded up to the slot count).
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_RING_SLOT_COUNT        4
+#define TEST_RING_CAPACITY          3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of elements popped from the test ring.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_RING_VALUE_MAX_COUNT   16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of events recorded by a test handler.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_EVENT_MAX_COUNT    16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events received by a test handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_wifiClientExt_TimedEventInd_t events[TEST_EVENT_MAX_COUNT];
+    uint32_t                         count;
+}
+EventLog_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test step run from the event loop. Each step ends by calling EndStep().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*TestStep_t)(void);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events received by the timed connection event handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventLog_t TimedEvents;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timed connection event handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClientExt_TimedConnectionEventHandlerRef_t TimedHandlerRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Second timed connection event handler of TestWifiClient_EventSequence(), and its events.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClientExt_TimedConnectionEventHandlerRef_t SecondHandlerRef = NULL;
+static EventLog_t SecondEvents;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events replayed to the handlers registered by TestWifiClient_LastStateReplay().
+ */
+//--------------------------------------------------------------------------------------------------
+static EventLog_t ReplayedEvents;
+static EventLog_t CancelledEvents;
+static uint32_t   ConnectionEventCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handlers registered by TestWifiClient_LastStateReplay().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClientExt_TimedConnectionEventHandlerRef_t ReplayHandlerRef = NULL;
+static le_wifiClient_ConnectionEventHandlerRef_t ConnectionHandlerRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of coalesced events before TestWifiClient_Coalescing().
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CoalescedCountBefore = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring of TestWifiClient_EventRing(), the elements popped from it and the count of elements
+ * expected before the next check.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiRing_Ref_t TestRingRef = NULL;
+static uint32_t RingValues[TEST_RING_VALUE_MAX_COUNT];
+static uint32_t RingValueCount = 0;
+static uint32_t RingExpectedCount = 0;
+static le_event_DeferredFunc_t RingCheckFunc = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current test step: the next one is run from the event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndStep
+(
+    void
+);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -421,6 +557,553 @@ static void TestWifiClient_ConfigureSecurity_NegTests
     LE_ASSERT(ret == LE_BAD_PARAMETER);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read and reset the event latency counters
+ *
+ * API tested:
+ * - le_wifiClientExt_GetEventLatency
+ * - le_wifiClientExt_ResetEventLatency
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_EventLatency
+(
+    void
+)
+{
+    uint32_t count;
+    uint64_t averageUs;
+    uint64_t maxUs;
+
+    le_wifiClientExt_ResetEventLatency();
+
+    LE_ASSERT(LE_OK == le_wifiClientExt_GetEventLatency(LE_WIFICLIENTEXT_HOP_PA_PARSE,
+                                                        &count, &averageUs, &maxUs));
+    LE_ASSERT(0 == count);
+    LE_ASSERT(0 == averageUs);
+    LE_ASSERT(0 == maxUs);
+    LE_ASSERT(LE_OK == le_wifiClientExt_GetEventLatency(LE_WIFICLIENTEXT_HOP_SERVICE_QUEUE,
+                                                        &count, &averageUs, &maxUs));
+    LE_ASSERT(LE_BAD_PARAMETER ==
+              le_wifiClientExt_GetEventLatency(LE_WIFICLIENTEXT_HOP_SERVICE_QUEUE + 1,
+                                               &count, &averageUs, &maxUs));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record an event received by a timed connection event handler. The context is the EventLog_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimedEventHandler
+(
+    const le_wifiClientExt_TimedEventInd_t *eventPtr,
+    void *contextPtr
+)
+{
+    EventLog_t *logPtr = contextPtr;
+
+    LE_INFO("Event %d on %s/%s: seqNum %u, coalesced %u",
+            eventPtr->event, eventPtr->ifName, eventPtr->apBssid,
+            eventPtr->seqNum, eventPtr->coalescedCount);
+
+    LE_ASSERT(logPtr->count < TEST_EVENT_MAX_COUNT);
+    logPtr->events[logPtr->count++] = *eventPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the events reported by TestWifiClient_EventSequence().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckEventSequence
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    uint32_t count;
+    uint64_t averageUs;
+    uint64_t maxUs;
+    uint32_t coalescedCount;
+    uint32_t droppedCount;
+
+    LE_ASSERT(4 == TimedEvents.count);
+    LE_ASSERT(4 == SecondEvents.count);
+    le_wifiClientExt_RemoveTimedConnectionEventHandler(SecondHandlerRef);
+    SecondHandlerRef = NULL;
+
+    // Each interface has its own sequence, the dropped events leave a gap.
+    LE_ASSERT(0 == strcmp(TEST_IFNAME, TimedEvents.events[0].ifName));
+    LE_ASSERT(1 == TimedEvents.events[0].seqNum);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME, TimedEvents.events[1].ifName));
+    LE_ASSERT(4 == TimedEvents.events[1].seqNum);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME_2, TimedEvents.events[2].ifName));
+    LE_ASSERT(1 == TimedEvents.events[2].seqNum);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME, TimedEvents.events[3].ifName));
+    LE_ASSERT(5 == TimedEvents.events[3].seqNum);
+
+    LE_ASSERT(0 != TimedEvents.events[0].captureTimeUs);
+    LE_ASSERT(TimedEvents.events[0].captureTimeUs <= TimedEvents.events[3].captureTimeUs);
+
+    le_wifiClientExt_GetEventDropStats(&coalescedCount, &droppedCount);
+    LE_ASSERT(2 == droppedCount);
+
+    // The local event did not go through the PA hops.
+    LE_ASSERT(LE_OK == le_wifiClientExt_GetEventLatency(LE_WIFICLIENTEXT_HOP_PA_PARSE,
+                                                        &count, &averageUs, &maxUs));
+    LE_ASSERT(3 == count);
+    LE_ASSERT(LE_OK == le_wifiClientExt_GetEventLatency(LE_WIFICLIENTEXT_HOP_PA_QUEUE,
+                                                        &count, &averageUs, &maxUs));
+    LE_ASSERT(3 == count);
+    // Once per event, not per handler.
+    LE_ASSERT(LE_OK == le_wifiClientExt_GetEventLatency(LE_WIFICLIENTEXT_HOP_SERVICE_QUEUE,
+                                                        &count, &averageUs, &maxUs));
+    LE_ASSERT(4 == count);
+    LE_ASSERT(averageUs <= maxUs);
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report events on two interfaces, with dropped events, to two handlers and check their sequence
+ * numbers and latency counters.
+ *
+ * API tested:
+ * - le_wifiClientExt_AddTimedConnectionEventHandler
+ * - le_wifiClientExt_GetEventDropStats
+ * - le_wifiClientExt_GetEventLatency
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_EventSequence
+(
+    void
+)
+{
+    le_wifiClientExt_ResetEventLatency();
+    memset(&TimedEvents, 0, sizeof(TimedEvents));
+
+    TimedHandlerRef = le_wifiClientExt_AddTimedConnectionEventHandler(TimedEventHandler,
+                                                                      &TimedEvents);
+    LE_ASSERT(NULL != TimedHandlerRef);
+    memset(&SecondEvents, 0, sizeof(SecondEvents));
+    SecondHandlerRef = le_wifiClientExt_AddTimedConnectionEventHandler(TimedEventHandler,
+                                                                       &SecondEvents);
+    LE_ASSERT(NULL != SecondHandlerRef);
+
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_SCAN_DONE, TEST_IFNAME, "", 0, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_SCAN_DONE, TEST_IFNAME, "", 2, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_SCAN_DONE, TEST_IFNAME_2, "", 0, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_SCAN_DONE, TEST_IFNAME, "", 0, true);
+
+    // The events are delivered by the event loop, in order, before the check.
+    le_event_QueueFunction(CheckEventSequence, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the events received by a connection event handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConnectionEventHandler
+(
+    const le_wifiClient_EventInd_t *eventPtr,
+    void *contextPtr
+)
+{
+    LE_INFO("Event %d on %s/%s", eventPtr->event, eventPtr->ifName, eventPtr->apBssid);
+
+    LE_ASSERT(LE_WIFICLIENT_EVENT_CONNECTED == eventPtr->event);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME, eventPtr->ifName));
+    ConnectionEventCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the replay of the last state to the new connection event handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetLastStateReplay
+(
+    bool isEnabled
+)
+{
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateWriteTxn(TEST_CFG_PATH_CLIENT);
+
+    if (isEnabled)
+    {
+        le_cfg_SetBool(cfg, TEST_CFG_NODE_REPLAY, true);
+    }
+    else
+    {
+        le_cfg_DeleteNode(cfg, TEST_CFG_NODE_REPLAY);
+    }
+    le_cfg_CommitTxn(cfg);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the events replayed by TestWifiClient_LastStateReplay().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckLastStateReplay
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    // Only the interface with a connection state is replayed, with the cached sequence number.
+    LE_ASSERT(1 == ReplayedEvents.count);
+    LE_ASSERT(LE_WIFICLIENT_EVENT_CONNECTED == ReplayedEvents.events[0].event);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME, ReplayedEvents.events[0].ifName));
+    LE_ASSERT(0 == strcmp(TEST_BSSID, ReplayedEvents.events[0].apBssid));
+    LE_ASSERT(TimedEvents.events[0].seqNum == ReplayedEvents.events[0].seqNum);
+    LE_ASSERT(TimedEvents.events[0].captureTimeUs == ReplayedEvents.events[0].captureTimeUs);
+    LE_ASSERT(1 == ConnectionEventCount);
+
+    // Nothing is replayed to a handler removed before the replay, or to the existing handlers.
+    LE_ASSERT(0 == CancelledEvents.count);
+    LE_ASSERT(1 == TimedEvents.count);
+
+    le_wifiClientExt_RemoveTimedConnectionEventHandler(ReplayHandlerRef);
+    le_wifiClient_RemoveConnectionEventHandler(ConnectionHandlerRef);
+    SetLastStateReplay(false);
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register new handlers once the connection event has been delivered.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RegisterReplayHandlers
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    le_wifiClientExt_TimedConnectionEventHandlerRef_t cancelledHandlerRef;
+
+    LE_ASSERT(1 == TimedEvents.count);
+
+    memset(&ReplayedEvents, 0, sizeof(ReplayedEvents));
+    memset(&CancelledEvents, 0, sizeof(CancelledEvents));
+    ConnectionEventCount = 0;
+
+    ReplayHandlerRef = le_wifiClientExt_AddTimedConnectionEventHandler(TimedEventHandler,
+                                                                       &ReplayedEvents);
+    ConnectionHandlerRef = le_wifiClient_AddConnectionEventHandler(ConnectionEventHandler, NULL);
+    cancelledHandlerRef = le_wifiClientExt_AddTimedConnectionEventHandler(TimedEventHandler,
+                                                                          &CancelledEvents);
+    le_wifiClientExt_RemoveTimedConnectionEventHandler(cancelledHandlerRef);
+
+    // The replays are queued to the event loop before the check.
+    le_event_QueueFunction(CheckLastStateReplay, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a connection and check that its state is replayed to the handlers registered later.
+ *
+ * API tested:
+ * - le_wifiClientExt_AddTimedConnectionEventHandler
+ * - le_wifiClientExt_RemoveTimedConnectionEventHandler
+ * - le_wifiClient_AddConnectionEventHandler
+ * - le_wifiClient_RemoveConnectionEventHandler
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_LastStateReplay
+(
+    void
+)
+{
+    SetLastStateReplay(true);
+    memset(&TimedEvents, 0, sizeof(TimedEvents));
+
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_CONNECTED, TEST_IFNAME, TEST_BSSID, 0, false);
+
+    le_event_QueueFunction(RegisterReplayHandlers, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the coalescing window of the connection events, read by le_wifiClient_Init(). 0 removes the
+ * setting.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetCoalesceWindow
+(
+    uint32_t windowMs
+)
+{
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateWriteTxn(TEST_CFG_PATH_CLIENT);
+
+    if (windowMs > 0)
+    {
+        le_cfg_SetInt(cfg, TEST_CFG_NODE_COALESCE, windowMs);
+    }
+    else
+    {
+        le_cfg_DeleteNode(cfg, TEST_CFG_NODE_COALESCE);
+    }
+    le_cfg_CommitTxn(cfg);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the events delivered once the coalescing windows of TestWifiClient_Coalescing() expired.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckCoalescing
+(
+    le_timer_Ref_t timerRef
+)
+{
+    uint32_t coalescedCount;
+    uint32_t droppedCount;
+
+    le_timer_Delete(timerRef);
+
+    // The first event of a burst is delivered at once, the latest one closes the burst.
+    LE_ASSERT(3 == TimedEvents.count);
+    LE_ASSERT(LE_WIFICLIENT_EVENT_CONNECTED == TimedEvents.events[0].event);
+    LE_ASSERT(0 == strcmp(TEST_BSSID_2, TimedEvents.events[0].apBssid));
+    LE_ASSERT(0 == TimedEvents.events[0].coalescedCount);
+
+    // Another (interface, BSSID) pair has its own window.
+    LE_ASSERT(LE_WIFICLIENT_EVENT_CONNECTED == TimedEvents.events[1].event);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME_2, TimedEvents.events[1].ifName));
+    LE_ASSERT(0 == TimedEvents.events[1].coalescedCount);
+
+    // The summary replaces the 3 held events and keeps the sequence number of the latest one.
+    LE_ASSERT(LE_WIFICLIENT_EVENT_DISCONNECTED == TimedEvents.events[2].event);
+    LE_ASSERT(0 == strcmp(TEST_IFNAME, TimedEvents.events[2].ifName));
+    LE_ASSERT(0 == strcmp(TEST_BSSID_2, TimedEvents.events[2].apBssid));
+    LE_ASSERT(2 == TimedEvents.events[2].coalescedCount);
+    LE_ASSERT((TimedEvents.events[0].seqNum + 3) == TimedEvents.events[2].seqNum);
+
+    le_wifiClientExt_GetEventDropStats(&coalescedCount, &droppedCount);
+    LE_ASSERT(2 == (coalescedCount - CoalescedCountBefore));
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a burst of connection events and check that they are coalesced into a summary event.
+ *
+ * API tested:
+ * - le_wifiClientExt_AddTimedConnectionEventHandler
+ * - le_wifiClientExt_GetEventDropStats
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_Coalescing
+(
+    void
+)
+{
+    uint32_t droppedCount;
+    le_timer_Ref_t timerRef;
+
+    memset(&TimedEvents, 0, sizeof(TimedEvents));
+    le_wifiClientExt_GetEventDropStats(&CoalescedCountBefore, &droppedCount);
+
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_CONNECTED, TEST_IFNAME, TEST_BSSID_2, 0, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_CONNECTED, TEST_IFNAME_2, TEST_BSSID, 0, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_DISCONNECTED, TEST_IFNAME, TEST_BSSID_2, 0, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_CONNECTED, TEST_IFNAME, TEST_BSSID_2, 0, false);
+    stubs_ReportEventInd(LE_WIFICLIENT_EVENT_DISCONNECTED, TEST_IFNAME, TEST_BSSID_2, 0, false);
+
+    // Let the window expire, then a quiet window closes the burst.
+    timerRef = le_timer_Create("CoalescingCheck");
+    le_timer_SetHandler(timerRef, CheckCoalescing);
+    le_timer_SetMsInterval(timerRef, 4 * TEST_COALESCE_WINDOW_MS);
+    le_timer_Start(timerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record an element popped from the test ring, and queue the check once all the expected elements
+ * are popped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingConsumer
+(
+    void *elemPtr,
+    void *contextPtr
+)
+{
+    LE_ASSERT(RingValueCount < RingExpectedCount);
+    RingValues[RingValueCount++] = *(uint32_t *)elemPtr;
+
+    if (RingValueCount == RingExpectedCount)
+    {
+        le_event_QueueFunction(RingCheckFunc, NULL, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push values into the test ring, all of them expected to fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushRingValues
+(
+    uint32_t firstValue,
+    uint32_t count
+)
+{
+    uint32_t value;
+
+    for (value = firstValue; value < (firstValue + count); value++)
+    {
+        LE_ASSERT(LE_OK == pa_wifiRing_Push(TestRingRef, &value));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the elements popped after the wraparound, in push order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRingWraparound
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    pa_wifiRing_Stats_t stats;
+    uint32_t i;
+
+    for (i = 0; i < TEST_RING_SLOT_COUNT; i++)
+    {
+        LE_ASSERT(i == RingValues[i]);
+    }
+    for (i = TEST_RING_SLOT_COUNT; i < RingValueCount; i++)
+    {
+        LE_ASSERT((100 + i) == RingValues[i]);
+    }
+
+    pa_wifiRing_GetStats(TestRingRef, &stats);
+    LE_ASSERT(0 == stats.depth);
+    LE_ASSERT(TEST_RING_SLOT_COUNT == stats.maxDepth);
+    LE_ASSERT(1 == stats.dropCount);
+
+    EndStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Once the full ring is drained, push again so that the slots wrap around.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRingOverflow
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    pa_wifiRing_Stats_t stats;
+
+    pa_wifiRing_GetStats(TestRingRef, &stats);
+    LE_ASSERT(0 == stats.depth);
+
+    // The slots used from now on are the first ones again.
+    RingExpectedCount = TEST_RING_SLOT_COUNT + 3;
+    RingCheckFunc = CheckRingWraparound;
+    PushRingValues(100 + TEST_RING_SLOT_COUNT, 3);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a ring beyond its capacity, then drain it and fill it again past the end of the slots.
+ *
+ * API tested:
+ * - pa_wifiRing_Create
+ * - pa_wifiRing_Push
+ * - pa_wifiRing_GetStats
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWifiClient_EventRing
+(
+    void
+)
+{
+    pa_wifiRing_Stats_t stats;
+    uint32_t value = TEST_RING_SLOT_COUNT;
+
+    TestRingRef = pa_wifiRing_Create("TestRing", sizeof(uint32_t), TEST_RING_CAPACITY,
+                                     RingConsumer, NULL);
+    RingValueCount = 0;
+    RingExpectedCount = TEST_RING_SLOT_COUNT;
+    RingCheckFunc = CheckRingOverflow;
+
+    // The ring is only drained by the event loop: the element beyond the slot count is dropped.
+    PushRingValues(0, TEST_RING_SLOT_COUNT);
+    LE_ASSERT(LE_OVERFLOW == pa_wifiRing_Push(TestRingRef, &value));
+
+    pa_wifiRing_GetStats(TestRingRef, &stats);
+    LE_ASSERT(TEST_RING_SLOT_COUNT == stats.capacity);
+    LE_ASSERT(TEST_RING_SLOT_COUNT == stats.depth);
+    LE_ASSERT(TEST_RING_SLOT_COUNT == stats.maxDepth);
+    LE_ASSERT(1 == stats.dropCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test steps run from the event loop, in order, after the synchronous tests.
+ */
+//--------------------------------------------------------------------------------------------------
+static const TestStep_t TestSteps[] =
+{
+    TestWifiClient_EventSequence,
+    TestWifiClient_LastStateReplay,
+    TestWifiClient_Coalescing,
+    TestWifiClient_EventRing,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the next test step.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestStepIndex = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the next test step, or end the test when all the steps are done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunNextStep
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    if (TestStepIndex < NUM_ARRAY_MEMBERS(TestSteps))
+    {
+        TestSteps[TestStepIndex++]();
+        return;
+    }
+
+    LE_INFO ("======== UnitTest of WiFi client SUCCESS ========");
+
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current test step: the next one is run from the event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndStep
+(
+    void
+)
+{
+    le_event_QueueFunction(RunNextStep, NULL, NULL);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -430,7 +1113,10 @@ static void TestWifiClient_ConfigureSecurity_NegTests
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
 {
+    // The coalescing window is only read at startup.
+    SetCoalesceWindow(TEST_COALESCE_WINDOW_MS);
     le_wifiClient_Init();
+    SetCoalesceWindow(0);
 
     LE_INFO ("======== Start UnitTest of WiFi client ========");
 
@@ -446,7 +1132,8 @@ COMPONENT_INIT
 
     TestWifiClient_ConfigureSecurity_NegTests();
 
-    LE_INFO ("======== UnitTest of WiFi client SUCCESS ========");
+    TestWifiClient_EventLatency();
 
-    exit(EXIT_SUCCESS);
+    // The event tests need the event loop.
+    EndStep();
 }
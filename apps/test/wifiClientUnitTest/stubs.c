@@ -8,69 +8,47 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "pa_wifi.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Event handler for PA WiFi access point changes.
- *
- * Handles the PA WiFi events.
+ * Event indication handler registered by the service, and its context.
  */
 //--------------------------------------------------------------------------------------------------
-typedef void (*pa_wifiClient_NewEventHandlerFunc_t)
-(
-    le_wifiClient_Event_t event,
-        ///< [IN]
-        ///< WiFi event to process
-    void *contextPtr
-        ///< [IN]
-        ///< Associated WiFi event context
-);
+static pa_wifiClient_EventIndHandlerFunc_t EventIndHandlerPtr = NULL;
+static void *EventIndContextPtr = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Event handler for PA WiFi connection changes.
- *
- * Handles the PA WiFi events.
+ * Report an event indication to the service as the PA would, synchronously.
  */
 //--------------------------------------------------------------------------------------------------
-typedef void (*pa_wifiClient_EventIndHandlerFunc_t)
+void stubs_ReportEventInd
 (
-    le_wifiClient_EventInd_t* wifiEventIndPtr,
-        ///< [IN]
-        ///< WiFi event pointer to process
-    void *contextPtr
-        ///< [IN]
-        ///< Associated WiFi event context
-);
-
-//--------------------------------------------------------------------------------------------------
-/**
- * AccessPoint structure.
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    int16_t  signalStrength;                        ///< LE_WIFICLIENT_NO_SIGNAL_STRENGTH means
-                                                    ///< value was not found.
-    uint8_t  ssidLength;                            ///< The number of bytes in the ssidBytes.
-    uint8_t  ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES]; ///< Contains ssidLength number of bytes.
-    char     bssid[LE_WIFIDEFS_MAX_BSSID_BYTES];    ///< Contains the bssid.
-    uint64_t rx;                                    ///< Rx of access point (bytes).
-    uint64_t tx;                                    ///< Tx of access point (bytes).
-} pa_wifiClient_AccessPoint_t;
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Struct to hold the AccessPoint from the Scan's data.
- *
- */
-//-------------------------------------------------------------------------------------------------
-typedef struct
+    le_wifiClient_Event_t event,    ///< [IN] Event to report.
+    const char *ifNamePtr,          ///< [IN] WLAN interface name.
+    const char *apBssidPtr,         ///< [IN] AP BSSID.
+    uint32_t droppedCount,          ///< [IN] Events dropped by the PA before this one.
+    bool isLocal                    ///< [IN] Generated on the main thread.
+)
 {
-    pa_wifiClient_AccessPoint_t accessPoint;
-    bool                        foundInLatestScan;
+    pa_wifiClient_TimedEventInd_t timedEvent;
+
+    LE_ASSERT(NULL != EventIndHandlerPtr);
+
+    memset(&timedEvent, 0, sizeof(timedEvent));
+    timedEvent.indication.event = event;
+    le_utf8_Copy(timedEvent.indication.ifName, ifNamePtr, sizeof(timedEvent.indication.ifName),
+                 NULL);
+    le_utf8_Copy(timedEvent.indication.apBssid, apBssidPtr,
+                 sizeof(timedEvent.indication.apBssid), NULL);
+    timedEvent.captureTime = le_clk_GetRelativeTime();
+    timedEvent.reportTime = timedEvent.captureTime;
+    timedEvent.droppedCount = droppedCount;
+    timedEvent.isLocal = isLocal;
+
+    EventIndHandlerPtr(&timedEvent.indication, EventIndContextPtr);
 }
-FoundAccessPoint_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -348,10 +326,14 @@ le_result_t pa_wifiClient_Scan
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiClient_GetScanResult
 (
-    pa_wifiClient_AccessPoint_t *accessPointPtr
+    pa_wifiClient_AccessPoint_t *accessPointPtr,
     ///< [IN][OUT]
     ///< Structure provided by calling function.
     ///< Results filled out if result was LE_OK.
+    char scanIfName[]
+    ///< [IN][OUT]
+    ///< Array provided by calling function.
+    ///< Store WLAN interface used for scan.
 )
 {
     return LE_OK;
@@ -486,9 +468,35 @@ LE_SHARED le_result_t pa_wifiClient_AddEventIndHandler
         ///< Associated event context.
 )
 {
+    EventIndHandlerPtr = handlerPtr;
+    EventIndContextPtr = contextPtr;
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the occupancy of the queue carrying the event indications from the PA thread to the main
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_GetEventQueueStats
+(
+    uint32_t *depthPtr,
+        ///< [OUT]
+        ///< Number of events currently queued.
+    uint32_t *maxDepthPtr,
+        ///< [OUT]
+        ///< Highest number of events queued since startup.
+    uint32_t *capacityPtr
+        ///< [OUT]
+        ///< Queue capacity.
+)
+{
+    *depthPtr = 0;
+    *maxDepthPtr = 0;
+    *capacityPtr = 0;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the server service reference
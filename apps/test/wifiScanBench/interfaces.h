@@ -0,0 +1,60 @@
+/**
+ * Interfaces of the WiFi client scan benchmark, with the stubbed service functions.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "le_wifiClient_interface.h"
+#include "le_wifiClientExt_interface.h"
+#include "le_cfg_interface.h"
+#include "le_secStore_interface.h"
+
+#undef LE_KILL_CLIENT
+#define LE_KILL_CLIENT LE_WARN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_wifiClient_GetClientSessionRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_wifiClient_GetServiceRef
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registers a function to be called whenever one of this service's sessions is closed by
+ * the client.  (STUBBED FUNCTION)
+
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t MyAddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef, ///< [IN] Reference to the service.
+    le_msg_SessionEventHandler_t    handlerFunc,///< [IN] Handler function.
+    void*                           contextPtr  ///< [IN] Opaque pointer value to pass to handler.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the synthetic results of the next scans: the first scan returns apCount access points, then
+ * each scan replaces churnPercent % of them by new ones.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_SetScanResults
+(
+    uint32_t apCount,           ///< [IN] Number of access points of a scan.
+    uint32_t churnPercent       ///< [IN] Share of the access points replaced at each scan.
+);
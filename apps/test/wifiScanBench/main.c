@@ -0,0 +1,511 @@
+/**
+ * This module implements the benchmark of the WiFi client scan path, against synthetic PA results:
+ * le_wifiClient_Scan(), the scan thread, the merge of the results into the access point list on
+ * the main thread, then le_wifiClient_GetFirstAccessPoint() and le_wifiClient_GetNextAccessPoint().
+ *
+ * For each number of access points and churn rate, the first scan fills the list and the next
+ * ones merge the results where a share of the access points is replaced. One CSV row is printed
+ * per scenario:
+ *  - aps, churn_pct:   scenario.
+ *  - first_scan_us:    time from le_wifiClient_Scan() to the end of scan event, first scan.
+ *  - scan_merge_us:    same time, average of the next scans.
+ *  - entries:          access points kept in the list at the end of the scenario.
+ *  - bytes_per_entry:  size of an access point object, without the block overhead of the pool
+ *                      which depends on the framework build.
+ *  - pool_growth:      access points added to the pool during the scenario.
+ *  - iter_per_s:       access points returned per second by GetFirst/GetNext.
+ *
+ * Usage: wifiScanBench [<baseline.csv> [--record]]
+ * With --record, the results are written to the baseline. Otherwise they are compared with it: a
+ * time worse than the baseline by more than WIFI_SCAN_BENCH_TOLERANCE percent (default: 25), or
+ * more entries, bytes or pool growth, fails the benchmark. A baseline without rows is not checked,
+ * and an empty field of a row is not checked: the committed baseline only holds the columns which
+ * do not depend on the machine.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <ctype.h>
+#include <inttypes.h>
+
+#include "legato.h"
+#include "interfaces.h"
+#include "wifiService.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scenarios: every number of access points with every churn rate.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t ApCounts[] = { 10, 100, 1000, 10000 };
+static const uint32_t ChurnPercents[] = { 0, 10, 50 };
+
+#define SCENARIO_COUNT      (NUM_ARRAY_MEMBERS(ApCounts) * NUM_ARRAY_MEMBERS(ChurnPercents))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scans of a scenario, and iterations over the access points at its end.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SCANS_PER_SCENARIO  5
+#define ITERATION_ROUNDS    10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default tolerance on the times, in percent of the baseline.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_TOLERANCE   25
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of an empty field of the baseline: not checked.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BASELINE_UNCHECKED  UINT64_MAX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CSV header, same order as the fields of Result_t.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CSV_HEADER  "aps,churn_pct,first_scan_us,scan_merge_us,entries,bytes_per_entry," \
+                    "pool_growth,iter_per_s"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of a scenario.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t apCount;           ///< Access points of a scan.
+    uint64_t churnPercent;      ///< Share of the access points replaced at each scan.
+    uint64_t firstScanUs;       ///< Time of the first scan.
+    uint64_t scanMergeUs;       ///< Average time of the next scans.
+    uint64_t entryCount;        ///< Access points kept in the list.
+    uint64_t bytesPerEntry;     ///< Object size of an access point.
+    uint64_t poolGrowth;        ///< Access points added to the pool.
+    uint64_t iterPerSec;        ///< Access points returned per second by GetFirst/GetNext.
+}
+Result_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark state, only used by the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static Result_t         Results[SCENARIO_COUNT];
+static size_t           ScenarioIndex = 0;
+static uint32_t         ScanCount = 0;
+static uint64_t         ScanStartUs = 0;
+static uint64_t         ScanMergeTotalUs = 0;
+static size_t           PoolObjectCount = 0;    ///< Pool objects at the start of the scenario.
+static le_mem_PoolRef_t AccessPointPool = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time in us.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeUs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000000) + (uint64_t)now.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a result as a CSV row.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintResult
+(
+    FILE *filePtr,
+    const Result_t *resultPtr
+)
+{
+    fprintf(filePtr, "%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+            ",%" PRIu64 ",%" PRIu64 "\n",
+            resultPtr->apCount, resultPtr->churnPercent, resultPtr->firstScanUs,
+            resultPtr->scanMergeUs, resultPtr->entryCount, resultPtr->bytesPerEntry,
+            resultPtr->poolGrowth, resultPtr->iterPerSec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the next field of a baseline row, empty or unsigned integer, and move past its comma.
+ *
+ * @return false if the field is not a number, as in the header.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseField
+(
+    const char **fieldPtrPtr,
+    uint64_t *valuePtr
+)
+{
+    const char *fieldPtr = *fieldPtrPtr;
+    char       *endPtr = (char *)fieldPtr;
+
+    if ((',' == *fieldPtr) || ('\0' == *fieldPtr) || ('\n' == *fieldPtr) || ('\r' == *fieldPtr))
+    {
+        *valuePtr = BASELINE_UNCHECKED;
+    }
+    else
+    {
+        if (!isdigit((unsigned char)*fieldPtr))
+        {
+            return false;
+        }
+        *valuePtr = strtoull(fieldPtr, &endPtr, 10);
+    }
+
+    if (',' == *endPtr)
+    {
+        endPtr++;
+    }
+    else if (('\0' != *endPtr) && ('\n' != *endPtr) && ('\r' != *endPtr))
+    {
+        return false;
+    }
+    *fieldPtrPtr = endPtr;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a value against its baseline, if the baseline has one.
+ *
+ * @return false if the value is a regression.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckValue
+(
+    const Result_t *resultPtr,
+    const char *namePtr,
+    uint64_t value,
+    uint64_t baseline,
+    uint32_t tolerancePercent,
+    bool isHigherBetter
+)
+{
+    bool isRegression;
+
+    if (BASELINE_UNCHECKED == baseline)
+    {
+        return true;
+    }
+
+    isRegression = isHigherBetter ?
+                        ((value * (100 + tolerancePercent)) < (baseline * 100)) :
+                        ((value * 100) > (baseline * (100 + tolerancePercent)));
+
+    if (isRegression)
+    {
+        LE_ERROR("Regression with %" PRIu64 " APs, %" PRIu64 "%% churn: %s %" PRIu64
+                 ", baseline %" PRIu64,
+                 resultPtr->apCount, resultPtr->churnPercent, namePtr, value, baseline);
+    }
+    return !isRegression;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare the results with the baseline.
+ *
+ * @return false if a result is a regression.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CompareWithBaseline
+(
+    const char *pathPtr
+)
+{
+    const char *tolerancePtr = getenv("WIFI_SCAN_BENCH_TOLERANCE");
+    uint32_t    tolerance = (NULL != tolerancePtr) ? (uint32_t)atoi(tolerancePtr) :
+                                                     DEFAULT_TOLERANCE;
+    char        line[256];
+    size_t      rowCount = 0;
+    bool        isOk = true;
+    FILE       *filePtr = fopen(pathPtr, "r");
+
+    if (NULL == filePtr)
+    {
+        LE_WARN("No baseline %s", pathPtr);
+        return true;
+    }
+
+    while (NULL != fgets(line, sizeof(line), filePtr))
+    {
+        Result_t    base;
+        const char *fieldPtr = line;
+        size_t      i;
+
+        if (!ParseField(&fieldPtr, &base.apCount) ||
+            !ParseField(&fieldPtr, &base.churnPercent) ||
+            !ParseField(&fieldPtr, &base.firstScanUs) ||
+            !ParseField(&fieldPtr, &base.scanMergeUs) ||
+            !ParseField(&fieldPtr, &base.entryCount) ||
+            !ParseField(&fieldPtr, &base.bytesPerEntry) ||
+            !ParseField(&fieldPtr, &base.poolGrowth) ||
+            !ParseField(&fieldPtr, &base.iterPerSec) ||
+            (BASELINE_UNCHECKED == base.apCount) || (BASELINE_UNCHECKED == base.churnPercent))
+        {
+            // Header or comment
+            continue;
+        }
+        rowCount++;
+
+        for (i = 0; i < SCENARIO_COUNT; i++)
+        {
+            const Result_t *resultPtr = &Results[i];
+
+            if ((resultPtr->apCount != base.apCount) ||
+                (resultPtr->churnPercent != base.churnPercent))
+            {
+                continue;
+            }
+
+            // The access point counts do not depend on the machine: no tolerance.
+            isOk &= CheckValue(resultPtr, "first_scan_us", resultPtr->firstScanUs,
+                               base.firstScanUs, tolerance, false);
+            isOk &= CheckValue(resultPtr, "scan_merge_us", resultPtr->scanMergeUs,
+                               base.scanMergeUs, tolerance, false);
+            isOk &= CheckValue(resultPtr, "entries", resultPtr->entryCount,
+                               base.entryCount, 0, false);
+            isOk &= CheckValue(resultPtr, "bytes_per_entry", resultPtr->bytesPerEntry,
+                               base.bytesPerEntry, 0, false);
+            isOk &= CheckValue(resultPtr, "pool_growth", resultPtr->poolGrowth,
+                               base.poolGrowth, 0, false);
+            isOk &= CheckValue(resultPtr, "iter_per_s", resultPtr->iterPerSec,
+                               base.iterPerSec, tolerance, true);
+        }
+    }
+    fclose(filePtr);
+
+    LE_INFO("%zu baseline rows checked, tolerance %u%%", rowCount, tolerance);
+    return isOk;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the results to the baseline.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordBaseline
+(
+    const char *pathPtr
+)
+{
+    FILE  *filePtr = fopen(pathPtr, "w");
+    size_t i;
+
+    LE_ASSERT(NULL != filePtr);
+    fprintf(filePtr, "# WiFi client scan benchmark baseline, recorded by wifiScanBench --record\n");
+    fprintf(filePtr, "%s\n", CSV_HEADER);
+    for (i = 0; i < SCENARIO_COUNT; i++)
+    {
+        PrintResult(filePtr, &Results[i]);
+    }
+    fclose(filePtr);
+    LE_INFO("Baseline %s recorded", pathPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End of the benchmark: record or check the baseline.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Finish
+(
+    void
+)
+{
+    const char *baselinePtr = (le_arg_NumArgs() > 0) ? le_arg_GetArg(0) : NULL;
+    const char *modePtr = (le_arg_NumArgs() > 1) ? le_arg_GetArg(1) : NULL;
+
+    if (NULL == baselinePtr)
+    {
+        exit(EXIT_SUCCESS);
+    }
+    if ((NULL != modePtr) && (0 == strcmp(modePtr, "--record")))
+    {
+        RecordBaseline(baselinePtr);
+        exit(EXIT_SUCCESS);
+    }
+
+    if (!CompareWithBaseline(baselinePtr))
+    {
+        LE_ERROR("======== WiFi client scan benchmark REGRESSION ========");
+        exit(EXIT_FAILURE);
+    }
+    LE_INFO("======== WiFi client scan benchmark SUCCESS ========");
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a scan of the current scenario.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartScan
+(
+    void
+)
+{
+    ScanStartUs = GetTimeUs();
+    LE_ASSERT(LE_OK == le_wifiClient_Scan());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the current scenario.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartScenario
+(
+    void
+)
+{
+    Result_t *resultPtr = &Results[ScenarioIndex];
+
+    memset(resultPtr, 0, sizeof(*resultPtr));
+    resultPtr->apCount = ApCounts[ScenarioIndex / NUM_ARRAY_MEMBERS(ChurnPercents)];
+    resultPtr->churnPercent = ChurnPercents[ScenarioIndex % NUM_ARRAY_MEMBERS(ChurnPercents)];
+
+    LE_ASSERT(LE_OK == le_wifiClient_Start());
+    stubs_SetScanResults((uint32_t)resultPtr->apCount, (uint32_t)resultPtr->churnPercent);
+    PoolObjectCount = le_mem_GetObjectCount(AccessPointPool);
+    ScanCount = 0;
+    ScanMergeTotalUs = 0;
+    StartScan();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current scenario: iterate over the access points and measure the list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndScenario
+(
+    void
+)
+{
+    Result_t           *resultPtr = &Results[ScenarioIndex];
+    le_mem_PoolStats_t  stats;
+    uint64_t            foundCount = 0;
+    uint64_t            startUs;
+    uint64_t            elapsedUs;
+    int                 round;
+
+    resultPtr->scanMergeUs = ScanMergeTotalUs / (SCANS_PER_SCENARIO - 1);
+
+    startUs = GetTimeUs();
+    for (round = 0; round < ITERATION_ROUNDS; round++)
+    {
+        le_wifiClient_AccessPointRef_t apRef;
+
+        for (apRef = le_wifiClient_GetFirstAccessPoint();
+             NULL != apRef;
+             apRef = le_wifiClient_GetNextAccessPoint())
+        {
+            foundCount++;
+        }
+    }
+    elapsedUs = GetTimeUs() - startUs;
+
+    // Every access point of the last scan is returned, and only those.
+    LE_ASSERT(foundCount == (resultPtr->apCount * ITERATION_ROUNDS));
+    resultPtr->iterPerSec = (foundCount * 1000000) / ((0 != elapsedUs) ? elapsedUs : 1);
+
+    le_mem_GetStats(AccessPointPool, &stats);
+    resultPtr->entryCount = stats.numBlocksInUse;
+    resultPtr->bytesPerEntry = le_mem_GetObjectSize(AccessPointPool);
+    resultPtr->poolGrowth = le_mem_GetObjectCount(AccessPointPool) - PoolObjectCount;
+
+    PrintResult(stdout, resultPtr);
+    fflush(stdout);
+
+    // The access points are released when the client stops.
+    LE_ASSERT(LE_OK == le_wifiClient_Stop());
+
+    ScenarioIndex++;
+    if (ScenarioIndex < SCENARIO_COUNT)
+    {
+        StartScenario();
+    }
+    else
+    {
+        Finish();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the WiFi client events: times the scans and chains them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScanEventHandler
+(
+    le_wifiClient_Event_t event,
+    void *contextPtr
+)
+{
+    uint64_t elapsedUs;
+
+    if (LE_WIFICLIENT_EVENT_SCAN_FAILED == event)
+    {
+        LE_FATAL("Scan failed");
+    }
+    if (LE_WIFICLIENT_EVENT_SCAN_DONE != event)
+    {
+        return;
+    }
+
+    elapsedUs = GetTimeUs() - ScanStartUs;
+    if (0 == ScanCount)
+    {
+        Results[ScenarioIndex].firstScanUs = elapsedUs;
+    }
+    else
+    {
+        ScanMergeTotalUs += elapsedUs;
+    }
+
+    ScanCount++;
+    if (ScanCount < SCANS_PER_SCENARIO)
+    {
+        StartScan();
+    }
+    else
+    {
+        EndScenario();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * main of the benchmark
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    le_wifiClient_Init();
+
+    AccessPointPool = le_mem_FindPool("le_wifi_FoundAccessPointPool");
+    LE_ASSERT(NULL != AccessPointPool);
+    le_wifiClient_AddNewEventHandler(ScanEventHandler, NULL);
+
+    LE_INFO("======== Start WiFi client scan benchmark ========");
+    printf("%s\n", CSV_HEADER);
+
+    // The scenarios run on the event loop, chained by the end of scan events.
+    StartScenario();
+}
@@ -0,0 +1,436 @@
+/**
+ * @file stubs.c
+ *
+ * Stub functions required for the WiFi client scan benchmark. The PA scan returns synthetic access
+ * points, so that only the scan path of the service is measured.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_wifi.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of access points of a scan.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SCAN_MAX_APS    10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synthetic scan results. Each access point is identified by a number, which gives its BSSID and
+ * SSID. Set by the main thread before the scan, read by the scan thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ScanApIds[SCAN_MAX_APS];
+static uint32_t ScanApCount = 0;
+static uint32_t ScanChurnPercent = 0;
+static uint32_t ScanNextId = 0;         ///< Identifier of the next new access point.
+static uint32_t ScanChurnOffset = 0;    ///< First access point replaced by the next scan.
+static uint32_t ScanIndex = 0;          ///< Next access point returned by the current scan.
+static bool     IsScanPopulated = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the synthetic results of the next scans: the first scan returns apCount access points, then
+ * each scan replaces churnPercent % of them by new ones.
+ */
+//--------------------------------------------------------------------------------------------------
+void stubs_SetScanResults
+(
+    uint32_t apCount,           ///< [IN] Number of access points of a scan.
+    uint32_t churnPercent       ///< [IN] Share of the access points replaced at each scan.
+)
+{
+    uint32_t i;
+
+    LE_ASSERT(apCount <= SCAN_MAX_APS);
+    LE_ASSERT(churnPercent <= 100);
+
+    for (i = 0; i < apCount; i++)
+    {
+        ScanApIds[i] = i;
+    }
+    ScanApCount = apCount;
+    ScanChurnPercent = churnPercent;
+    ScanNextId = apCount;
+    ScanChurnOffset = 0;
+    ScanIndex = 0;
+    IsScanPopulated = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for PA EVENT 'le_wifiClient_Event_t'
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_AddEventHandler
+(
+    pa_wifiClient_NewEventHandlerFunc_t handlerPtr,
+    void *contextPtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for PA EVENT 'le_wifiClient_EventInd_t'
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_AddEventIndHandler
+(
+    pa_wifiClient_EventIndHandlerFunc_t handlerPtr,
+    void *contextPtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the occupancy of the PA event queue.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_GetEventQueueStats
+(
+    uint32_t *depthPtr,
+    uint32_t *maxDepthPtr,
+    uint32_t *capacityPtr
+)
+{
+    *depthPtr = 0;
+    *maxDepthPtr = 0;
+    *capacityPtr = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the PA WiFi Module.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Init
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the scan: the access points of the previous scan are replaced according to the churn.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Scan
+(
+    void
+)
+{
+    if (IsScanPopulated && (0 != ScanApCount))
+    {
+        uint32_t churnCount = (ScanApCount * ScanChurnPercent) / 100;
+        uint32_t i;
+
+        for (i = 0; i < churnCount; i++)
+        {
+            ScanApIds[(ScanChurnOffset + i) % ScanApCount] = ScanNextId++;
+        }
+        ScanChurnOffset = (ScanChurnOffset + churnCount) % ScanApCount;
+    }
+    IsScanPopulated = true;
+    ScanIndex = 0;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next synthetic access point of the scan.
+ *
+ * @return LE_NOT_FOUND  There is no more AP:s found.
+ * @return LE_OK         The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetScanResult
+(
+    pa_wifiClient_AccessPoint_t *accessPointPtr,
+    char scanIfName[]
+)
+{
+    uint32_t id;
+
+    if (ScanIndex >= ScanApCount)
+    {
+        return LE_NOT_FOUND;
+    }
+    id = ScanApIds[ScanIndex++];
+
+    memset(accessPointPtr, 0, sizeof(*accessPointPtr));
+    accessPointPtr->signalStrength = -30 - (int16_t)(id % 60);
+    accessPointPtr->ssidLength = (uint8_t)snprintf((char *)accessPointPtr->ssidBytes,
+                                                   sizeof(accessPointPtr->ssidBytes),
+                                                   "bench_%u", id);
+    snprintf(accessPointPtr->bssid, sizeof(accessPointPtr->bssid),
+             "02:00:%02x:%02x:%02x:%02x",
+             (id >> 24) & 0xFF, (id >> 16) & 0xFF, (id >> 8) & 0xFF, id & 0xFF);
+    le_utf8_Copy(scanIfName, "wlan0", LE_WIFIDEFS_MAX_IFNAME_BYTES, NULL);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the scan results.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ScanDone
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the link of the access point the client is connected to.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_GetLinkResult
+(
+    pa_wifiClient_AccessPoint_t *accessPointPtr,
+    char scanIfName[]
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect a wifiClient.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Connect
+(
+    uint8_t ssidBytes[LE_WIFIDEFS_MAX_SSID_BYTES],
+    uint8_t ssidLength
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disconnect a wifiClient.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Disconnect
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the username and password (WPA-Entreprise).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetUserCredentials
+(
+    const char *usernamePtr,
+    const char *passwordPtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the PassPhrase used to create PSK (WPA-Personal).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetPassphrase
+(
+    const char *passphrasePtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the WiFi pre-shared key (WPA-Personal).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetPreSharedKey
+(
+    const char *preSharedKeyPtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set whether the target Access Point is hidden.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_SetHiddenNetworkAttribute
+(
+    bool hidden
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the WEP key (Wired Equivalent Privacy).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetWepKey
+(
+    const char *wepKeyPtr
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol for communication.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_SetSecurityProtocol
+(
+    const le_wifiClient_SecurityProtocol_t securityProtocol
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear all the credentials.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_ClearAllCredentials
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start WiFi Client PA
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Start
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop WiFi Client PA
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiClient_Stop
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_wifiClient_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_wifiClient_GetClientSessionRef
+(
+    void
+)
+{
+    return (le_msg_SessionRef_t)0x1001;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registers a function to be called whenever one of this service's sessions is closed by
+ * the client.  (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t MyAddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef, ///< [IN] Reference to the service.
+    le_msg_SessionEventHandler_t    handlerFunc,///< [IN] Handler function.
+    void*                           contextPtr  ///< [IN] Opaque pointer value to pass to handler.
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub for reading an item from secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Read
+(
+    const char* name,               ///< [IN] Name of the secure storage item.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    size_t* bufNumElementsPtr       ///< [INOUT] Size of buffer.
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub for writing an item to secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Write
+(
+    const char* name,               ///< [IN] Name of the secure storage item.
+    const uint8_t* bufPtr,          ///< [IN] Buffer contain the data to store.
+    size_t bufNumElements           ///< [IN] Size of buffer.
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stub for deleting an item from secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_secStore_Delete
+(
+    const char* name               ///< [IN] Name of the secure storage item.
+)
+{
+    return LE_OK;
+}
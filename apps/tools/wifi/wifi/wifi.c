@@ -29,6 +29,8 @@ static void PrintHelp(void)
         "\twifi client help\n"
         "To run WiFi access point:\n"
         "\twifi ap help\n"
+        "To display the WiFi diagnostics:\n"
+        "\twifi diag help\n"
         "\n");
 }
 
@@ -37,7 +39,11 @@ static void PrintHelp(void)
 COMPONENT_INIT
 {
     // calling just "WiFi client/ap" without arguments will give helpmenu
-    if (le_arg_NumArgs() <= 1)
+    if ((le_arg_NumArgs() == 1) && (0 == strcmp(le_arg_GetArg(0), "diag")))
+    {
+        ExecuteWifiDiagCommand(NULL, le_arg_NumArgs());
+    }
+    else if (le_arg_NumArgs() <= 1)
     {
         PrintHelp();
         exit(EXIT_SUCCESS);
@@ -64,6 +70,10 @@ COMPONENT_INIT
             {
                 ExecuteWifiApCommand(commandPtr, le_arg_NumArgs());
             }
+            else if (strcmp(servicePtr, "diag") == 0)
+            {
+                ExecuteWifiDiagCommand(commandPtr, le_arg_NumArgs());
+            }
             else
             {
                 PrintHelp();
@@ -32,6 +32,9 @@ void PrintApHelp(void)
         "To stop the WiFi access point:\n"
         "\twifi ap stop\n"
 
+        "To restart the WiFi access point with the current settings, keeping the driver loaded:\n"
+        "\twifi ap restart\n"
+
         "To set the SSID of the WiFi access point:\n"
         "\twifi ap setssid [\"SSID\"]\n"
 
@@ -60,6 +63,15 @@ void PrintApHelp(void)
         "\tbetween 1 and 6   for IEEE 802.11ad\n"
         "\tSome legal restrictions might apply for your region\n"
 
+        "To select the least congested channel at each start of the WiFi access point:\n"
+        "\twifi ap setautochannel [0/1]\n"
+
+        "To get the channel scores of the last automatic channel selection:\n"
+        "\twifi ap getchannelscores\n"
+
+        "To set the channel width (MHz) and the HT/VHT options, applied at the next start:\n"
+        "\twifi ap sethtconfig [20/40/80] [shortgi] [ldpc] [maxampdu]\n"
+
         "To set the countrycode of the WiFi access point:\n"
         "\twifi ap setcountrycode [CountryCode]\n"
 
@@ -81,10 +93,44 @@ void PrintApHelp(void)
         "To maximum nbr of clients for the WiFi access point:\n"
         "\twifi ap setmaxclients [MAXNBR]\n"
 
+        "To set the beacon interval (TU) and the DTIM period, applied at the next start:\n"
+        "\twifi ap setbeaconinterval [Interval]\n"
+        "\twifi ap setdtim [Period]\n"
+
+        "To set the WMM parameters of an access category:\n"
+        "\twifi ap setwmm [be/bk/vi/vo] [AIFS] [ECWmin] [ECWmax] [TXOP limit]\n"
+        "\tECW are exponents (CW = 2^ECW - 1), the TXOP limit is in units of 32 us\n"
+
+        "To set the time after which an inactive station is disconnected (s):\n"
+        "\twifi ap setmaxinactivity [Seconds]\n"
+
+        "To disconnect a station, with an optional IEEE 802.11 reason code:\n"
+        "\twifi ap deauth [MAC] [Reason]\n"
+
+        "To accept the stations unless denied (default), or deny them unless accepted:\n"
+        "\twifi ap setaclpolicy [accept/deny]\n"
+
+        "To change the list of the stations accepted or denied:\n"
+        "\twifi ap acl [accept/deny] [add/remove] [MAC]\n"
+        "\twifi ap acl [accept/deny] clear\n"
+
         "To define the address of the AP and the IP addresses range as well:\n"
         "WARNING: Only IPv4 addresses are supported.\n"
         "\twifi ap setiprange [IP AP] [IP START] [IP STOP]\n"
 
+        "To add or change an additional BSS, applied at the next start or restart:\n"
+        "\twifi ap setbss [BssIndex] [\"SSID\"] [SecuProto] [MAXNBR] [passphrase]\n"
+        "\tBssIndex between 1 and 3, SecuProto 0 (no security) or 1 (WPA2)\n"
+
+        "To remove an additional BSS:\n"
+        "\twifi ap removebss [BssIndex]\n"
+
+        "To define the address of an additional BSS and its IP addresses range:\n"
+        "\twifi ap setbssiprange [BssIndex] [IP AP] [IP START] [IP STOP]\n"
+
+        "To run the WiFi access point next to the WiFi client, applied at the next start:\n"
+        "\twifi ap setconcurrent [0/1]\n"
+
         "\n");
 }
 
@@ -134,6 +180,145 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "restart") == 0)
+    {
+        if (LE_OK == (result = le_wifiApExt_Restart()))
+        {
+            printf("Restarted.\n");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR:le_wifiApExt_Restart returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setautochannel") == 0)
+    {
+        // wifi ap setautochannel [0/1]
+        const char *enableStr = le_arg_GetArg(2);
+
+        if ((NULL == enableStr) || ((strcmp(enableStr, "0") != 0) && (strcmp(enableStr, "1") != 0)))
+        {
+            printf("ERROR: Missing or bad argument. Valid value is 0 or 1.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiApExt_SetAutoChannel(strcmp(enableStr, "1") == 0)))
+        {
+            printf("Automatic channel selection %s.\n",
+                   (strcmp(enableStr, "1") == 0) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetAutoChannel returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "sethtconfig") == 0)
+    {
+        // wifi ap sethtconfig [20/40/80] [shortgi] [ldpc] [maxampdu]
+        const char                 *widthStr = le_arg_GetArg(2);
+        le_wifiApExt_ChannelWidth_t width;
+        le_wifiApExt_HtOption_t     options = 0;
+        size_t                      i;
+
+        if ((NULL != widthStr) && (strcmp(widthStr, "20") == 0))
+        {
+            width = LE_WIFIAPEXT_CHANNEL_WIDTH_20_MHZ;
+        }
+        else if ((NULL != widthStr) && (strcmp(widthStr, "40") == 0))
+        {
+            width = LE_WIFIAPEXT_CHANNEL_WIDTH_40_MHZ;
+        }
+        else if ((NULL != widthStr) && (strcmp(widthStr, "80") == 0))
+        {
+            width = LE_WIFIAPEXT_CHANNEL_WIDTH_80_MHZ;
+        }
+        else
+        {
+            printf("ERROR: Missing or bad channel width. Valid values are 20, 40, 80.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (i = 3; i < le_arg_NumArgs(); i++)
+        {
+            const char *optionStr = le_arg_GetArg(i);
+
+            if (strcmp(optionStr, "shortgi") == 0)
+            {
+                options |= LE_WIFIAPEXT_HT_OPTION_SHORT_GI;
+            }
+            else if (strcmp(optionStr, "ldpc") == 0)
+            {
+                options |= LE_WIFIAPEXT_HT_OPTION_LDPC;
+            }
+            else if (strcmp(optionStr, "maxampdu") == 0)
+            {
+                options |= LE_WIFIAPEXT_HT_OPTION_MAX_AMPDU;
+            }
+            else
+            {
+                printf("ERROR: Bad option: %s.\n", optionStr);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        result = le_wifiApExt_SetHtConfig(width, options);
+        if (LE_OK == result)
+        {
+            printf("Channel width %s MHz, options 0x%x.\n", widthStr, (unsigned int)options);
+            exit(EXIT_SUCCESS);
+        }
+        else if (LE_UNSUPPORTED == result)
+        {
+            printf("ERROR: Not supported by the WiFi radio.\n");
+            exit(EXIT_FAILURE);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetHtConfig returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "getchannelscores") == 0)
+    {
+        // wifi ap getchannelscores
+        le_wifiApExt_ChannelScore_t scores[LE_WIFIAPEXT_MAX_CHANNEL_SCORES];
+        size_t                      count = NUM_ARRAY_MEMBERS(scores);
+        uint16_t                    channel;
+        size_t                      i;
+
+        result = le_wifiApExt_GetChannelScores(scores, &count, &channel);
+        if (LE_NOT_FOUND == result)
+        {
+            printf("No channel selected automatically.\n");
+            exit(EXIT_FAILURE);
+        }
+        else if (LE_OK != result)
+        {
+            printf("ERROR: le_wifiApExt_GetChannelScores returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+
+        printf("Selected channel: %d\n", channel);
+        printf("%-8s %-6s %-8s %-6s %s\n", "channel", "bss", "overlap", "busy", "score");
+        for (i = 0; i < count; i++)
+        {
+            if (LE_WIFIAPEXT_BUSY_UNKNOWN == scores[i].busyPercent)
+            {
+                printf("%-8u %-6u %-8u %-6s %u\n", scores[i].channel, scores[i].bssCount,
+                       scores[i].overlap, "-", scores[i].score);
+            }
+            else
+            {
+                printf("%-8u %-6u %-8u %-5u%% %u\n", scores[i].channel, scores[i].bssCount,
+                       scores[i].overlap, scores[i].busyPercent, scores[i].score);
+            }
+        }
+        exit(EXIT_SUCCESS);
+    }
     else if (strcmp(commandPtr, "setssid") == 0)
     {
         // wifi ap setssid "SSID"
@@ -456,6 +641,247 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if ((strcmp(commandPtr, "setbeaconinterval") == 0) ||
+             (strcmp(commandPtr, "setdtim") == 0) ||
+             (strcmp(commandPtr, "setmaxinactivity") == 0))
+    {
+        // wifi ap setbeaconinterval [Interval]
+        // wifi ap setdtim [Period]
+        // wifi ap setmaxinactivity [Seconds]
+        const char   *valuePtr = le_arg_GetArg(2);
+        char         *endPtr;
+        unsigned long value;
+
+        if (NULL == valuePtr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        errno = 0;
+        value = strtoul(valuePtr, &endPtr, 10);
+        if ((ERANGE == errno) || ('\0' != *endPtr) || (value > UINT32_MAX))
+        {
+            printf("ERROR: Bad argument value. Should be a positive decimal value.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (strcmp(commandPtr, "setbeaconinterval") == 0)
+        {
+            result = (value > UINT16_MAX) ? LE_OUT_OF_RANGE :
+                                            le_wifiApExt_SetBeaconInterval((uint16_t)value);
+        }
+        else if (strcmp(commandPtr, "setdtim") == 0)
+        {
+            result = (value > UINT8_MAX) ? LE_OUT_OF_RANGE :
+                                           le_wifiApExt_SetDtimPeriod((uint8_t)value);
+        }
+        else
+        {
+            result = le_wifiApExt_SetMaxInactivity((uint32_t)value);
+        }
+
+        if (LE_OK == result)
+        {
+            printf("%s done: %lu.\n", commandPtr, value);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: %s returns %d.\n", commandPtr, result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setwmm") == 0)
+    {
+        // wifi ap setwmm [be/bk/vi/vo] [AIFS] [ECWmin] [ECWmax] [TXOP limit]
+        static const char *acNames[] = { "be", "bk", "vi", "vo" };
+        static const le_wifiApExt_WmmAc_t acs[] =
+        {
+            LE_WIFIAPEXT_WMM_AC_BE, LE_WIFIAPEXT_WMM_AC_BK,
+            LE_WIFIAPEXT_WMM_AC_VI, LE_WIFIAPEXT_WMM_AC_VO
+        };
+        const char   *acStr = le_arg_GetArg(2);
+        unsigned long values[4];
+        size_t        ac;
+        size_t        i;
+
+        for (ac = 0; (NULL != acStr) && (ac < NUM_ARRAY_MEMBERS(acNames)); ac++)
+        {
+            if (strcmp(acStr, acNames[ac]) == 0)
+            {
+                break;
+            }
+        }
+        if ((NULL == acStr) || (ac == NUM_ARRAY_MEMBERS(acNames)))
+        {
+            printf("ERROR: Missing or bad access category. Valid values are be, bk, vi, vo.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (i = 0; i < NUM_ARRAY_MEMBERS(values); i++)
+        {
+            const char *valueStr = le_arg_GetArg(3 + i);
+            char       *endPtr;
+
+            if (NULL == valueStr)
+            {
+                printf("ERROR: Missing argument(s).\n");
+                exit(EXIT_FAILURE);
+            }
+            errno = 0;
+            values[i] = strtoul(valueStr, &endPtr, 10);
+            if ((ERANGE == errno) || ('\0' != *endPtr) ||
+                (values[i] > ((i < 3) ? UINT8_MAX : UINT16_MAX)))
+            {
+                printf("ERROR: Bad argument value: %s.\n", valueStr);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        result = le_wifiApExt_SetWmmParameters(acs[ac], (uint8_t)values[0], (uint8_t)values[1],
+                                               (uint8_t)values[2], (uint16_t)values[3]);
+        if (LE_OK == result)
+        {
+            printf("AC_%s: AIFS %lu, ECWmin %lu, ECWmax %lu, TXOP limit %lu\n",
+                   acStr, values[0], values[1], values[2], values[3]);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetWmmParameters returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "deauth") == 0)
+    {
+        // wifi ap deauth [MAC] [Reason]
+        const char   *macStr = le_arg_GetArg(2);
+        const char   *reasonStr = le_arg_GetArg(3);
+        unsigned long reason = 0;
+
+        if (NULL == macStr)
+        {
+            printf("ERROR: Missing MAC address.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (NULL != reasonStr)
+        {
+            char *endPtr;
+
+            errno = 0;
+            reason = strtoul(reasonStr, &endPtr, 10);
+            if ((ERANGE == errno) || ('\0' != *endPtr) || (reason > UINT16_MAX))
+            {
+                printf("ERROR: Bad reason code: %s.\n", reasonStr);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        result = le_wifiApExt_Deauthenticate(macStr, (uint16_t)reason);
+        if (LE_OK == result)
+        {
+            printf("Station %s deauthenticated.\n", macStr);
+            exit(EXIT_SUCCESS);
+        }
+        else if (LE_NOT_FOUND == result)
+        {
+            printf("ERROR: Station %s not associated.\n", macStr);
+            exit(EXIT_FAILURE);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_Deauthenticate returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setaclpolicy") == 0)
+    {
+        // wifi ap setaclpolicy [accept/deny]
+        const char *policyStr = le_arg_GetArg(2);
+
+        if ((NULL != policyStr) && (strcmp(policyStr, "accept") == 0))
+        {
+            result = le_wifiApExt_SetMacAclPolicy(LE_WIFIAPEXT_MAC_ACL_ACCEPT_UNLESS_DENIED);
+        }
+        else if ((NULL != policyStr) && (strcmp(policyStr, "deny") == 0))
+        {
+            result = le_wifiApExt_SetMacAclPolicy(LE_WIFIAPEXT_MAC_ACL_DENY_UNLESS_ACCEPTED);
+        }
+        else
+        {
+            printf("ERROR: Missing or bad policy. Valid values are accept, deny.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == result)
+        {
+            printf("Access control policy: %s.\n", policyStr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetMacAclPolicy returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "acl") == 0)
+    {
+        // wifi ap acl [accept/deny] [add/remove] [MAC]
+        // wifi ap acl [accept/deny] clear
+        const char               *listStr = le_arg_GetArg(2);
+        const char               *actionStr = le_arg_GetArg(3);
+        const char               *macStr = le_arg_GetArg(4);
+        le_wifiApExt_MacAclList_t list;
+
+        if ((NULL != listStr) && (strcmp(listStr, "accept") == 0))
+        {
+            list = LE_WIFIAPEXT_MAC_ACL_ACCEPT_LIST;
+        }
+        else if ((NULL != listStr) && (strcmp(listStr, "deny") == 0))
+        {
+            list = LE_WIFIAPEXT_MAC_ACL_DENY_LIST;
+        }
+        else
+        {
+            printf("ERROR: Missing or bad list. Valid values are accept, deny.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if ((NULL != actionStr) && (strcmp(actionStr, "clear") == 0))
+        {
+            result = le_wifiApExt_ClearMacAcl(list);
+        }
+        else if ((NULL != actionStr) && (NULL != macStr) && (strcmp(actionStr, "add") == 0))
+        {
+            result = le_wifiApExt_AddMacAcl(list, macStr);
+        }
+        else if ((NULL != actionStr) && (NULL != macStr) && (strcmp(actionStr, "remove") == 0))
+        {
+            result = le_wifiApExt_RemoveMacAcl(list, macStr);
+        }
+        else
+        {
+            printf("ERROR: Missing or bad argument(s).\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == result)
+        {
+            printf("%s list updated.\n", listStr);
+            exit(EXIT_SUCCESS);
+        }
+        else if (LE_NO_MEMORY == result)
+        {
+            printf("ERROR: The %s list is full.\n", listStr);
+            exit(EXIT_FAILURE);
+        }
+        else
+        {
+            printf("ERROR: acl %s returns %d.\n", actionStr, result);
+            exit(EXIT_FAILURE);
+        }
+    }
     else if (strcmp(commandPtr, "setiprange") == 0)
     {
         // Only IPv4 addresses are supported.
@@ -482,6 +908,116 @@ void ExecuteWifiApCommand
             exit(EXIT_FAILURE);
         }
     }
+    else if (strcmp(commandPtr, "setbss") == 0)
+    {
+        // wifi ap setbss [BssIndex] ["SSID"] [SecuProto] [MAXNBR] [passphrase]
+        const char *indexStr      = le_arg_GetArg(2);
+        const char *ssidPtr       = le_arg_GetArg(3);
+        const char *secuProtoStr  = le_arg_GetArg(4);
+        const char *maxClientsStr = le_arg_GetArg(5);
+        const char *passphrasePtr = le_arg_GetArg(6);
+
+        if ((NULL == indexStr) || (NULL == ssidPtr) || (NULL == secuProtoStr) ||
+            (NULL == maxClientsStr))
+        {
+            printf("ERROR: Missing or bad argument(s).\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiApExt_SetBss((uint8_t)strtoul(indexStr, NULL, 10),
+                                     (const uint8_t *)ssidPtr, strlen(ssidPtr),
+                                     (le_wifiAp_SecurityProtocol_t)strtol(secuProtoStr, NULL, 10),
+                                     (NULL != passphrasePtr) ? passphrasePtr : "",
+                                     (uint16_t)strtoul(maxClientsStr, NULL, 10),
+                                     true);
+        if (LE_OK == result)
+        {
+            printf("BSS %s set.\n", indexStr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetBss returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "removebss") == 0)
+    {
+        // wifi ap removebss [BssIndex]
+        const char *indexStr = le_arg_GetArg(2);
+
+        if (NULL == indexStr)
+        {
+            printf("ERROR: Missing or bad argument.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiApExt_RemoveBss((uint8_t)strtoul(indexStr, NULL, 10))))
+        {
+            printf("BSS %s removed.\n", indexStr);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_RemoveBss returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setbssiprange") == 0)
+    {
+        // wifi ap setbssiprange [BssIndex] [IP AP] [IP START] [IP STOP]
+        const char *indexStr = le_arg_GetArg(2);
+        const char *ipAp     = le_arg_GetArg(3);
+        const char *ipStart  = le_arg_GetArg(4);
+        const char *ipStop   = le_arg_GetArg(5);
+
+        if ((NULL == indexStr) || (NULL == ipAp) || (NULL == ipStart) || (NULL == ipStop))
+        {
+            printf("ERROR: Missing or bad argument(s).\n");
+            exit(EXIT_FAILURE);
+        }
+
+        result = le_wifiApExt_SetBssIpRange((uint8_t)strtoul(indexStr, NULL, 10),
+                                            ipAp, ipStart, ipStop);
+        if (LE_OK == result)
+        {
+            printf("BSS %s: IP AP@=%s, Start@=%s, Stop@=%s\n", indexStr, ipAp, ipStart, ipStop);
+            exit(EXIT_SUCCESS);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetBssIpRange returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(commandPtr, "setconcurrent") == 0)
+    {
+        // wifi ap setconcurrent [0/1]
+        const char *enableStr = le_arg_GetArg(2);
+
+        if ((NULL == enableStr) || ((strcmp(enableStr, "0") != 0) && (strcmp(enableStr, "1") != 0)))
+        {
+            printf("ERROR: Missing or bad argument. Valid value is 0 or 1.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (LE_OK == (result = le_wifiApExt_SetConcurrent(strcmp(enableStr, "1") == 0)))
+        {
+            printf("Concurrent mode %s.\n",
+                   (strcmp(enableStr, "1") == 0) ? "enabled" : "disabled");
+            exit(EXIT_SUCCESS);
+        }
+        else if (LE_BUSY == result)
+        {
+            printf("ERROR: The WiFi access point is started.\n");
+            exit(EXIT_FAILURE);
+        }
+        else
+        {
+            printf("ERROR: le_wifiApExt_SetConcurrent returns %d.\n", result);
+            exit(EXIT_FAILURE);
+        }
+    }
     else
     {
         printf("Invalid command for WiFi service.\n");
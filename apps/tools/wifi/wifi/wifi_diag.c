@@ -0,0 +1,147 @@
+//-------------------------------------------------------------------------------------------------
+/**
+ * @file wifi_diag.c
+ *
+ * WiFi Service Command line: diagnostics.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//-------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "wifi_internal.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print help for WiFi diagnostics
+ */
+//--------------------------------------------------------------------------------------------------
+void PrintDiagHelp(void)
+{
+    printf("WiFi command line diagnostics usage\n"
+        "==========\n\n"
+        "To display the duration and exit statuses of the platform adaptor commands:\n"
+        "\twifi diag\n"
+        "To clear the platform adaptor command statistics:\n"
+        "\twifi diag reset\n"
+        "\n");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print an exit status of the command statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintExitCode
+(
+    int32_t exitCode,
+    uint32_t count
+)
+{
+    if (LE_WIFIDIAG_EXIT_NOT_RUN == exitCode)
+    {
+        printf(" notrun:%u", count);
+    }
+    else if (LE_WIFIDIAG_EXIT_OTHER == exitCode)
+    {
+        printf(" other:%u", count);
+    }
+    else if (LE_WIFIDIAG_EXIT_FAILED == exitCode)
+    {
+        printf(" failed:%u", count);
+    }
+    else if (exitCode >= LE_WIFIDIAG_EXIT_SIGNALED)
+    {
+        printf(" sig%d:%u", exitCode - LE_WIFIDIAG_EXIT_SIGNALED, count);
+    }
+    else
+    {
+        printf(" %d:%u", exitCode, count);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Display the platform adaptor command statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintCommandStats(void)
+{
+    char     name[LE_WIFIDIAG_MAX_COMMAND_NAME_LENGTH + 1];
+    uint32_t count;
+    uint64_t p50Us;
+    uint64_t p90Us;
+    uint64_t p99Us;
+    uint64_t maxUs;
+    uint32_t index;
+
+    printf("%-24s %7s %10s %10s %10s %10s  %s\n",
+           "Command", "Count", "p50(ms)", "p90(ms)", "p99(ms)", "max(ms)", "Exit:count");
+
+    for (index = 0;
+         LE_OK == le_wifiDiag_GetCommandLatency(index, name, sizeof(name), &count,
+                                                &p50Us, &p90Us, &p99Us, &maxUs);
+         index++)
+    {
+        int32_t  exitCodes[LE_WIFIDIAG_MAX_EXIT_CODES];
+        uint32_t counts[LE_WIFIDIAG_MAX_EXIT_CODES];
+        size_t   exitCodeCount = NUM_ARRAY_MEMBERS(exitCodes);
+        size_t   countCount = NUM_ARRAY_MEMBERS(counts);
+
+        printf("%-24s %7u %10.1f %10.1f %10.1f %10.1f ",
+               name, count,
+               p50Us / 1000.0, p90Us / 1000.0, p99Us / 1000.0, maxUs / 1000.0);
+
+        if (LE_OK == le_wifiDiag_GetCommandExitCodes(index, exitCodes, &exitCodeCount,
+                                                     counts, &countCount))
+        {
+            for (size_t i = 0; (i < exitCodeCount) && (i < countCount); i++)
+            {
+                PrintExitCode(exitCodes[i], counts[i]);
+            }
+        }
+        printf("\n");
+    }
+
+    if (0 == index)
+    {
+        printf("No command run\n");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process commands for WiFi diagnostics.
+ */
+//--------------------------------------------------------------------------------------------------
+void ExecuteWifiDiagCommand
+(
+    const char *commandPtr, ///< [IN] Command to execute (NULL = run default command)
+    size_t numArgs          ///< [IN] Number of arguments
+)
+{
+    if ((NULL == commandPtr) || (0 == strcmp(commandPtr, "show")))
+    {
+        PrintCommandStats();
+        exit(EXIT_SUCCESS);
+    }
+    else if (0 == strcmp(commandPtr, "reset"))
+    {
+        le_wifiDiag_ResetCommandStats();
+        printf("Statistics cleared\n");
+        exit(EXIT_SUCCESS);
+    }
+    else if (0 == strcmp(commandPtr, "help"))
+    {
+        PrintDiagHelp();
+        exit(EXIT_SUCCESS);
+    }
+    else
+    {
+        printf("Invalid command for WiFi diagnostics\n");
+        PrintDiagHelp();
+        exit(EXIT_FAILURE);
+    }
+}
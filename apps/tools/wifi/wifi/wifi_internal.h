@@ -51,4 +51,22 @@ void ExecuteWifiApCommand
     size_t numArgs          ///< [IN] Number of arguments
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print help for WiFi diagnostics
+ */
+//--------------------------------------------------------------------------------------------------
+void PrintDiagHelp(void);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process commands for WiFi diagnostics.
+ */
+//--------------------------------------------------------------------------------------------------
+void ExecuteWifiDiagCommand
+(
+    const char *commandPtr, ///< [IN] Command to execute (NULL = run default command)
+    size_t numArgs          ///< [IN] Number of arguments
+);
+
 #endif //WIFI_INTERNAL_H
@@ -11,7 +11,65 @@
 #include "interfaces.h"
 
 #include "pa_wifi_ap.h"
+#include "pa_wifi_dhcp.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree paths and nodes of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_TREE_ROOT_DIR           "wifiService:"
+#define CFG_PATH_WIFI_AP            "wifi/ap"
+#define CFG_NODE_STATION_REFRESH    "stationRefreshMs"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default period of the station table refresh from the driver, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STATION_REFRESH_DEFAULT_MS  10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of station entries allocated at startup.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INIT_STATION_COUNT          10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station associated with the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char          macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];  ///< MAC address, key of the table.
+    char          ifName[LE_WIFIAPEXT_MAX_IFNAME_BYTES];    ///< WLAN interface name.
+    uint8_t       bssIndex;                                 ///< BSS of the interface.
+    le_clk_Time_t assocTime;                                ///< Association time.
+    le_clk_Time_t lastActivityTime;                         ///< Time of the last activity.
+    int8_t        signal;                                   ///< Signal strength (dBm).
+    uint64_t      rxBytes;                                  ///< Bytes received from the station.
+    uint64_t      txBytes;                                  ///< Bytes sent to the station.
+    uint32_t      refreshCount;                             ///< Last refresh reporting it.
+    le_dls_Link_t link;                                     ///< Link in StationList.
+}
+Station_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Page of leases requested by le_wifiApExt_GetLeases().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t              startIndex;   ///< Index of the first lease to return.
+    uint32_t              index;        ///< Index of the next lease.
+    le_wifiApExt_Lease_t *leasesPtr;    ///< Leases returned.
+    size_t                size;         ///< Size of the leases array.
+    size_t                count;        ///< Number of leases returned.
+}
+LeasePage_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -21,6 +79,314 @@
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t NewWifiApEventId;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event ID and pool of the reference counted station event indications.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t    StationEventIndicationId;
+static le_mem_PoolRef_t StationEventPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station table: entries allocated from the pool, indexed by MAC address in the map and listed
+ * in association order.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StationPool;
+static le_hashmap_Ref_t StationMap;
+static le_dls_List_t    StationList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station table refresh timer, period (0 if disabled) and number of refreshes.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t   StationRefreshTimer;
+static uint32_t         StationRefreshMs = STATION_REFRESH_DEFAULT_MS;
+static uint32_t         StationRefreshCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a relative time to microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t TimeToUs
+(
+    le_clk_Time_t time
+)
+{
+    return ((uint64_t)time.sec * 1000000) + time.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the entry of a station, adding it to the table if needed.
+ *
+ * @return The station entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static Station_t *GetStation
+(
+    const char *macAddressPtr,
+    const char *ifNamePtr,
+    le_clk_Time_t assocTime
+)
+{
+    Station_t *stationPtr = le_hashmap_Get(StationMap, macAddressPtr);
+
+    if (NULL == stationPtr)
+    {
+        stationPtr = le_mem_ForceAlloc(StationPool);
+        memset(stationPtr, 0, sizeof(Station_t));
+        le_utf8_Copy(stationPtr->macAddress, macAddressPtr, sizeof(stationPtr->macAddress), NULL);
+        stationPtr->assocTime = assocTime;
+        stationPtr->lastActivityTime = assocTime;
+        stationPtr->link = LE_DLS_LINK_INIT;
+        le_hashmap_Put(StationMap, stationPtr->macAddress, stationPtr);
+        le_dls_Queue(&StationList, &stationPtr->link);
+        LE_DEBUG("Station %s added", stationPtr->macAddress);
+    }
+    le_utf8_Copy(stationPtr->ifName, ifNamePtr, sizeof(stationPtr->ifName), NULL);
+    // Kept, as the BSS may be removed before its stations.
+    stationPtr->bssIndex = pa_wifiAp_GetBssIndex(ifNamePtr);
+    return stationPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a station from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveStation
+(
+    Station_t *stationPtr
+)
+{
+    LE_DEBUG("Station %s removed", stationPtr->macAddress);
+    le_hashmap_Remove(StationMap, stationPtr->macAddress);
+    le_dls_Remove(&StationList, &stationPtr->link);
+    le_mem_Release(stationPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a station event to the le_wifiApExt_StationEvent handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportStationEvent
+(
+    const pa_wifiAp_StationEvent_t *stationEventPtr
+)
+{
+    le_wifiApExt_EventInd_t *eventIndPtr = le_mem_ForceAlloc(StationEventPool);
+
+    memset(eventIndPtr, 0, sizeof(le_wifiApExt_EventInd_t));
+    eventIndPtr->event = stationEventPtr->event;
+    le_utf8_Copy(eventIndPtr->macAddress, stationEventPtr->macAddress,
+                 sizeof(eventIndPtr->macAddress), NULL);
+    le_utf8_Copy(eventIndPtr->ifName, stationEventPtr->ifName, sizeof(eventIndPtr->ifName), NULL);
+    eventIndPtr->bssIndex = stationEventPtr->bssIndex;
+    eventIndPtr->reason = stationEventPtr->reason;
+    eventIndPtr->captureTimeUs = TimeToUs(stationEventPtr->captureTime);
+
+    le_event_ReportWithRefCounting(StationEventIndicationId, eventIndPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a station which left without a disconnection event from the PA (ex: access point stopped)
+ * from the table, and report its disconnection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DisconnectStation
+(
+    Station_t *stationPtr
+)
+{
+    pa_wifiAp_StationEvent_t stationEvent;
+
+    memset(&stationEvent, 0, sizeof(stationEvent));
+    stationEvent.event = LE_WIFIAP_EVENT_CLIENT_DISCONNECTED;
+    le_utf8_Copy(stationEvent.ifName, stationPtr->ifName, sizeof(stationEvent.ifName), NULL);
+    stationEvent.bssIndex = stationPtr->bssIndex;
+    le_utf8_Copy(stationEvent.macAddress, stationPtr->macAddress, sizeof(stationEvent.macAddress),
+                 NULL);
+    stationEvent.captureTime = le_clk_GetRelativeTime();
+
+    RemoveStation(stationPtr);
+    ReportStationEvent(&stationEvent);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the stations from the table, reporting their disconnection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveAllStations
+(
+    void
+)
+{
+    le_dls_Link_t *linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Peek(&StationList)))
+    {
+        DisconnectStation(CONTAINER_OF(linkPtr, Station_t, link));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CallBack for PA station events: add or remove the station and report the event. The
+ * disconnection of a station no longer in the table was already reported when it was removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PaStationEventHandler
+(
+    const pa_wifiAp_StationEvent_t *stationEventPtr,
+    void *contextPtr
+)
+{
+    Station_t *stationPtr;
+
+    if ('\0' == stationEventPtr->macAddress[0])
+    {
+        LE_WARN("Station event %d without MAC address", stationEventPtr->event);
+        ReportStationEvent(stationEventPtr);
+        return;
+    }
+
+    if ((LE_WIFIAP_EVENT_CLIENT_DISCONNECTED == stationEventPtr->event) &&
+        (NULL == le_hashmap_Get(StationMap, stationEventPtr->macAddress)))
+    {
+        LE_DEBUG("Station %s already removed", stationEventPtr->macAddress);
+        return;
+    }
+
+    ReportStationEvent(stationEventPtr);
+
+    if (LE_WIFIAP_EVENT_CLIENT_CONNECTED == stationEventPtr->event)
+    {
+        stationPtr = GetStation(stationEventPtr->macAddress,
+                                stationEventPtr->ifName,
+                                stationEventPtr->captureTime);
+        // A station connecting again starts with new counters.
+        stationPtr->assocTime = stationEventPtr->captureTime;
+        stationPtr->lastActivityTime = stationEventPtr->captureTime;
+        stationPtr->signal = 0;
+        stationPtr->rxBytes = 0;
+        stationPtr->txBytes = 0;
+        stationPtr->refreshCount = StationRefreshCount;
+    }
+    else if (LE_WIFIAP_EVENT_CLIENT_DISCONNECTED == stationEventPtr->event)
+    {
+        stationPtr = le_hashmap_Get(StationMap, stationEventPtr->macAddress);
+        if (NULL != stationPtr)
+        {
+            RemoveStation(stationPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a station from the driver information.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StationDumpHandler
+(
+    const pa_wifiAp_Station_t *infoPtr,
+    void *contextPtr
+)
+{
+    le_clk_Time_t  now = *(le_clk_Time_t *)contextPtr;
+    le_clk_Time_t  connectedTime = { (time_t)infoPtr->connectedSec, 0 };
+    le_clk_Time_t  inactiveTime = { (time_t)(infoPtr->inactiveMs / 1000),
+                                    (long)(infoPtr->inactiveMs % 1000) * 1000 };
+    Station_t     *stationPtr;
+
+    stationPtr = GetStation(infoPtr->macAddress, infoPtr->ifName, le_clk_Sub(now, connectedTime));
+    stationPtr->lastActivityTime = le_clk_Sub(now, inactiveTime);
+    stationPtr->signal = infoPtr->signal;
+    stationPtr->rxBytes = infoPtr->rxBytes;
+    stationPtr->txBytes = infoPtr->txBytes;
+    stationPtr->refreshCount = StationRefreshCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Refresh the station table from the driver. The stations which the driver does not report any
+ * more left without a disconnection event: they are removed and their disconnection is reported.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RefreshStations
+(
+    void
+)
+{
+    le_clk_Time_t  now = le_clk_GetRelativeTime();
+    le_dls_Link_t *linkPtr;
+
+    StationRefreshCount++;
+    if (LE_OK != pa_wifiAp_GetStations(StationDumpHandler, &now))
+    {
+        return;
+    }
+
+    linkPtr = le_dls_Peek(&StationList);
+    while (NULL != linkPtr)
+    {
+        Station_t *stationPtr = CONTAINER_OF(linkPtr, Station_t, link);
+
+        linkPtr = le_dls_PeekNext(&StationList, linkPtr);
+        if (stationPtr->refreshCount != StationRefreshCount)
+        {
+            DisconnectStation(stationPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station table refresh timer handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StationRefreshTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    RefreshStations();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a lease to the page requested by le_wifiApExt_GetLeases().
+ */
+//--------------------------------------------------------------------------------------------------
+static void LeasePageHandler
+(
+    const pa_wifiDhcp_Lease_t *leasePtr,
+    void *contextPtr
+)
+{
+    LeasePage_t          *pagePtr = contextPtr;
+    le_wifiApExt_Lease_t *outPtr;
+
+    if ((pagePtr->index++ < pagePtr->startIndex) || (pagePtr->count >= pagePtr->size))
+    {
+        return;
+    }
+
+    outPtr = &pagePtr->leasesPtr[pagePtr->count++];
+    le_utf8_Copy(outPtr->macAddress, leasePtr->macAddress, sizeof(outPtr->macAddress), NULL);
+    le_utf8_Copy(outPtr->ipAddress, leasePtr->ipAddress, sizeof(outPtr->ipAddress), NULL);
+    le_utf8_Copy(outPtr->hostname, leasePtr->hostname, sizeof(outPtr->hostname), NULL);
+    outPtr->expiry = leasePtr->expiry;
+    outPtr->isAssociated = (NULL != le_hashmap_Get(StationMap, leasePtr->macAddress));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * CallBack for PA Access Point Events.
@@ -66,6 +432,33 @@ static void FirstLayerWifiApEventHandler
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer station event handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerStationEventHandler
+(
+    void *reportPtr,
+    void *secondLayerHandlerFunc
+)
+{
+    le_wifiApExt_StationEventHandlerFunc_t clientHandlerFunc = secondLayerHandlerFunc;
+    le_wifiApExt_EventInd_t               *eventIndPtr = reportPtr;
+
+    if (NULL != eventIndPtr)
+    {
+        LE_DEBUG("Station event: %d, station: %s", eventIndPtr->event, eventIndPtr->macAddress);
+        clientHandlerFunc(eventIndPtr, le_event_GetContextPtr());
+    }
+    else
+    {
+        LE_ERROR("Event is NULL");
+    }
+    // The reportPtr is a reference counted object, so need to release it
+    le_mem_Release(reportPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add handler function for EVENT 'le_wifiAp_NewEvent'
@@ -73,365 +466,1189 @@ static void FirstLayerWifiApEventHandler
  * These events provide information on WiFi Access Point
  */
 //--------------------------------------------------------------------------------------------------
-le_wifiAp_NewEventHandlerRef_t le_wifiAp_AddNewEventHandler
+le_wifiAp_NewEventHandlerRef_t le_wifiAp_AddNewEventHandler
+(
+    le_wifiAp_EventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handler function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    LE_DEBUG("Add new event handler");
+    if (handlerFuncPtr == NULL)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("NewWiFiApEventHandler",
+        NewWifiApEventId,
+        FirstLayerWifiApEventHandler,
+        (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_wifiAp_NewEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiAp_NewEvent'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiAp_RemoveNewEventHandler
+(
+    le_wifiAp_NewEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Event handler function to remove.
+)
+{
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_wifiApExt_StationEvent'
+ *
+ * These events provide the station connections and disconnections, with the station MAC address.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiApExt_StationEventHandlerRef_t le_wifiApExt_AddStationEventHandler
+(
+    le_wifiApExt_StationEventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handler function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    if (NULL == handlerFuncPtr)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("WifiApStationEventHandler",
+                                            StationEventIndicationId,
+                                            FirstLayerStationEventHandler,
+                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return (le_wifiApExt_StationEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiApExt_StationEvent'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiApExt_RemoveStationEventHandler
+(
+    le_wifiApExt_StationEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Event handler function to remove.
+)
+{
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts the WiFi Access Point.
+ * Note that all settings, if to be used, such as security, username, password must set prior to
+ * starting the Access Point.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ * @return LE_NOT_FOUND     The WiFi card is absent.
+ * @return LE_UNAVAILABLE   The WiFi card may not work.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_Start
+(
+    void
+)
+{
+    le_result_t result = pa_wifiAp_Start();
+
+    if ((LE_OK == result) && (0 != StationRefreshMs))
+    {
+        le_timer_Start(StationRefreshTimer);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function stops the WiFi Access Point.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_Stop
+(
+    void
+)
+{
+    le_result_t result = pa_wifiAp_Stop();
+
+    if (LE_OK == result)
+    {
+        le_timer_Stop(StationRefreshTimer);
+        RemoveAllStations();
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function restarts hostapd with the current settings, keeping the driver loaded, the
+ * DHCP server and the firewall rule. The stations are disconnected.
+ *
+ * @return LE_FAULT         The access point is not started, or the restart failed.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_Restart
+(
+    void
+)
+{
+    switch (pa_wifiAp_Restart())
+    {
+        case LE_DUPLICATE:
+            // hostapd kept running, so did the stations.
+            return LE_OK;
+
+        case LE_OK:
+            // The stations reassociate with the new hostapd.
+            RemoveAllStations();
+            return LE_OK;
+
+        case LE_TERMINATED:
+            // hostapd is down and the access point stopped.
+            le_timer_Stop(StationRefreshTimer);
+            RemoveAllStations();
+            return LE_FAULT;
+
+        default:
+            // hostapd was not stopped: the stations are still associated.
+            return LE_FAULT;
+    }
+}
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the Service Set IDentification (SSID) of the access point
+ *
+ * @note The SSID does not have to be human readable ASCII values, but often is.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetSsid
+(
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID to set as a octet array.
+
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The length of the SSID in octets.
+)
+{
+    return pa_wifiAp_SetSsid(ssidPtr, ssidNumElements);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol to use.
+ *
+ * @note that the SSID does not have to be human readable ASCII values, but often has.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetSecurityProtocol
+(
+    le_wifiAp_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< The security protocol used to communicate with the access point.
+)
+{
+    return pa_wifiAp_SetSecurityProtocol(securityProtocol);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK.
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * le_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ *
+ * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetPassPhrase
+(
+    const char *passphrasePtr
+        ///< [IN]
+        ///< Passphrase to authenticate against the access point.
+)
+{
+    return pa_wifiAp_SetPassPhrase(passphrasePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pre-shared key (PSK).
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * le_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ *
+ * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetPreSharedKey
+(
+    const char *preSharedKeyPtr
+        ///< [IN]
+        ///< Pre-shared key used to authenticate against the access point.
+)
+{
+    return pa_wifiAp_SetPreSharedKey(preSharedKeyPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set if the Access Point should announce its presence.
+ * Default value is TRUE.
+ * If the value is set to FALSE, the Access Point will be hidden.
+ *
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetDiscoverable
+(
+    bool isDiscoverable
+        ///< [IN]
+        ///< If TRUE the Access Point shows up on scans, else it is hidden.
+)
+{
+    return pa_wifiAp_SetDiscoverable(isDiscoverable);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which WiFi channel to use.
+ * Default number is 7.
+ * Some legal restrictions might apply for your region.
+ * The channel number must be between 1 and 14 for IEEE 802.11b/g.
+ * The channel number must be between 7 and 196 for IEEE 802.11a.
+ * The channel number must be between 1 and 6 for IEEE 802.11ad.
+ * @return
+ *      - LE_OUT_OF_RANGE if requested channel number is out of range.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetChannel
+(
+    uint16_t channelNumber
+        ///< [IN]
+        ///< the channel number.
+)
+{
+    return pa_wifiAp_SetChannel(channelNumber);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which IEEE standard to use.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t stdMask
+        ///< [IN]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    return pa_wifiAp_SetIeeeStandard(stdMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get which IEEE standard was set.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_GetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
+        ///< [OUT]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    if ( NULL == stdMaskPtr )
+    {
+        LE_WARN("stdMaskPtr is NULL.");
+        return LE_FAULT;
+    }
+    return pa_wifiAp_GetIeeeStandard(stdMaskPtr);
+}
+
+/**
+ * Set what country code to use for regulatory domain.
+ * ISO/IEC 3166-1 Alpha-2 code is used.
+ * Default country code is US.
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetCountryCode
+(
+    const char *countryCodePtr
+        ///< [IN]
+        ///< the country code.
+)
+{
+    return pa_wifiAp_SetCountryCode(countryCodePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  WiFi access point component initialization.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiAp_Init
+(
+    void
+)
+{
+    LE_DEBUG("WiFi Access Point Service is ready");
+
+    pa_wifiAp_Init();
+
+    // Create an event Id for new WiFi Events
+    NewWifiApEventId = le_event_CreateId("WiFiApEventId", sizeof(le_wifiAp_Event_t));
+
+    // Create the event indication Id and pool of the station events.
+    StationEventIndicationId = le_event_CreateIdWithRefCounting("WifiApStationEvent");
+    StationEventPool = le_mem_CreatePool("WifiApStationEventPool",
+                                         sizeof(le_wifiApExt_EventInd_t));
+
+    // Create the station table.
+    StationPool = le_mem_CreatePool("WifiApStationPool", sizeof(Station_t));
+    le_mem_ExpandPool(StationPool, INIT_STATION_COUNT);
+    StationMap = le_hashmap_Create("WifiApStations",
+                                   INIT_STATION_COUNT,
+                                   le_hashmap_HashString,
+                                   le_hashmap_EqualsString);
+
+    // Read the refresh period of the station table.
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateReadTxn(CFG_TREE_ROOT_DIR CFG_PATH_WIFI_AP);
+    int32_t refreshMs = le_cfg_GetInt(cfg, CFG_NODE_STATION_REFRESH, STATION_REFRESH_DEFAULT_MS);
+    le_cfg_CancelTxn(cfg);
+    StationRefreshMs = (refreshMs > 0) ? (uint32_t)refreshMs : 0;
+    LE_DEBUG("Station refresh period: %u ms", StationRefreshMs);
+
+    StationRefreshTimer = le_timer_Create("WifiApStationRefresh");
+    le_timer_SetHandler(StationRefreshTimer, StationRefreshTimerHandler);
+    if (0 != StationRefreshMs)
+    {
+        le_timer_SetMsInterval(StationRefreshTimer, StationRefreshMs);
+        le_timer_SetRepeat(StationRefreshTimer, 0);
+    }
+
+    // register for events from PA.
+    pa_wifiAp_AddEventHandler(PaEventApHandler, NULL);
+    pa_wifiAp_AddStationEventHandler(PaStationEventHandler, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set number of maximally allowed clients to connect to the Access Point at the same time.
+ *
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetMaxNumberOfClients
+(
+    int8_t maxNumberOfClients
+        ///< [IN]
+        ///< the maximum number of clients
+)
+{
+    if (0 == maxNumberOfClients)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+    return pa_wifiAp_SetMaxNumberClients(maxNumberOfClients);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Defines the IP adresses range for the host AP.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiAp_SetIpRange
+(
+    const char *ip_ap,
+        ///< [IN]
+        ///< the IP address of the Access Point.
+    const char *ip_start,
+        ///< [IN]
+        ///< the start IP address of the Access Point.
+    const char *ip_stop
+        ///< [IN]
+        ///< the stop IP address of the Access Point.
+)
+{
+    return pa_wifiAp_SetIpRange(ip_ap, ip_start, ip_stop);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stations associated with the access point.
+ *
+ * The stations are returned from the startIndex one. The table can change between two calls.
+ *
+ * @return
+ *      - LE_OK             Function succeeded, even if no station is returned.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_GetStations
+(
+    uint32_t startIndex,
+        ///< [IN]
+        ///< Index of the first station to return.
+    le_wifiApExt_Station_t *stationsPtr,
+        ///< [OUT]
+        ///< Stations.
+    size_t *stationsSizePtr,
+        ///< [INOUT]
+        ///< Size of the stations array, number of stations returned.
+    uint32_t *totalCountPtr
+        ///< [OUT]
+        ///< Number of stations in the table.
+)
+{
+    le_dls_Link_t *linkPtr;
+    uint32_t       index = 0;
+    size_t         count = 0;
+
+    if ((NULL == stationsPtr) || (NULL == stationsSizePtr) || (NULL == totalCountPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    for (linkPtr = le_dls_Peek(&StationList);
+         (NULL != linkPtr) && (count < *stationsSizePtr);
+         linkPtr = le_dls_PeekNext(&StationList, linkPtr), index++)
+    {
+        const Station_t           *stationPtr = CONTAINER_OF(linkPtr, Station_t, link);
+        le_wifiApExt_Station_t    *outPtr = &stationsPtr[count];
+        const pa_wifiDhcp_Lease_t *leasePtr;
+
+        if (index < startIndex)
+        {
+            continue;
+        }
+
+        le_utf8_Copy(outPtr->macAddress, stationPtr->macAddress, sizeof(outPtr->macAddress), NULL);
+        le_utf8_Copy(outPtr->ifName, stationPtr->ifName, sizeof(outPtr->ifName), NULL);
+        outPtr->bssIndex       = pa_wifiAp_GetBssIndex(stationPtr->ifName);
+        outPtr->assocTimeUs    = TimeToUs(stationPtr->assocTime);
+        outPtr->lastActivityUs = TimeToUs(stationPtr->lastActivityTime);
+        outPtr->signal         = stationPtr->signal;
+        outPtr->rxBytes        = stationPtr->rxBytes;
+        outPtr->txBytes        = stationPtr->txBytes;
+        leasePtr = pa_wifiDhcp_GetLease(stationPtr->macAddress);
+        le_utf8_Copy(outPtr->ipAddress, (NULL != leasePtr) ? leasePtr->ipAddress : "",
+                     sizeof(outPtr->ipAddress), NULL);
+        count++;
+    }
+
+    *stationsSizePtr = count;
+    *totalCountPtr = (uint32_t)le_hashmap_Size(StationMap);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the DHCP leases of the access point.
+ *
+ * The leases are returned from the startIndex one. The leases can change between two calls.
+ *
+ * @return
+ *      - LE_OK             Function succeeded, even if no lease is returned.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_GetLeases
+(
+    uint32_t startIndex,
+        ///< [IN]
+        ///< Index of the first lease to return.
+    le_wifiApExt_Lease_t *leasesPtr,
+        ///< [OUT]
+        ///< Leases.
+    size_t *leasesSizePtr,
+        ///< [INOUT]
+        ///< Size of the leases array, number of leases returned.
+    uint32_t *totalCountPtr
+        ///< [OUT]
+        ///< Number of leases.
+)
+{
+    LeasePage_t page;
+
+    if ((NULL == leasesPtr) || (NULL == leasesSizePtr) || (NULL == totalCountPtr))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_BAD_PARAMETER;
+    }
+
+    page.startIndex = startIndex;
+    page.index = 0;
+    page.leasesPtr = leasesPtr;
+    page.size = *leasesSizePtr;
+    page.count = 0;
+    pa_wifiDhcp_GetLeases(LeasePageHandler, &page);
+
+    *leasesSizePtr = page.count;
+    *totalCountPtr = page.index;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the IP address leased to a station.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      The station has no lease.
+ *      - LE_OVERFLOW       The IP address buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_GetIpAddress
+(
+    const char *macAddressPtr,
+        ///< [IN]
+        ///< Station MAC address.
+    char *ipAddressPtr,
+        ///< [OUT]
+        ///< IP address.
+    size_t ipAddressSize
+        ///< [IN]
+)
+{
+    const pa_wifiDhcp_Lease_t *leasePtr = pa_wifiDhcp_GetLease(macAddressPtr);
+
+    if (NULL == leasePtr)
+    {
+        return LE_NOT_FOUND;
+    }
+    return le_utf8_Copy(ipAddressPtr, leasePtr->ipAddress, ipAddressSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the automatic channel selection at the start of the access point.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_SetAutoChannel
+(
+    bool enable
+        ///< [IN]
+        ///< true to select the channel automatically.
+)
+{
+    return pa_wifiAp_SetAutoChannel(enable);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel scores of the last automatic channel selection, and the channel selected.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      No channel was selected automatically since the automatic channel
+ *                          selection was enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_GetChannelScores
+(
+    le_wifiApExt_ChannelScore_t *scoresPtr,
+        ///< [OUT]
+        ///< Channel scores.
+    size_t *scoresNumElementsPtr,
+        ///< [INOUT]
+    uint16_t *channelPtr
+        ///< [OUT]
+        ///< Selected channel.
+)
+{
+    pa_wifiAcs_ChannelScore_t scores[PA_WIFIACS_MAX_CHANNELS];
+    size_t                    count = NUM_ARRAY_MEMBERS(scores);
+    size_t                    i;
+    le_result_t               result;
+
+    result = pa_wifiAp_GetChannelScores(scores, &count, channelPtr);
+    if (LE_OK != result)
+    {
+        *scoresNumElementsPtr = 0;
+        return result;
+    }
+
+    if (count > *scoresNumElementsPtr)
+    {
+        count = *scoresNumElementsPtr;
+    }
+    for (i = 0; i < count; i++)
+    {
+        scoresPtr[i].channel = scores[i].channel;
+        scoresPtr[i].bssCount = scores[i].bssCount;
+        scoresPtr[i].overlap = scores[i].overlap;
+        scoresPtr[i].busyPercent = scores[i].busyPercent;
+        scoresPtr[i].score = scores[i].score;
+    }
+    *scoresNumElementsPtr = count;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add or change an additional BSS of the access point, applied at the next start or restart.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiApExt_SetBss
 (
-    le_wifiAp_EventHandlerFunc_t handlerFuncPtr,
+    uint8_t bssIndex,
         ///< [IN]
-        ///< Event handler function
-
-    void *contextPtr
+        ///< BSS, 1 to MAX_BSS - 1.
+    const uint8_t *ssidPtr,
         ///< [IN]
-        ///< Associated event context
+        ///< SSID.
+    size_t ssidSize,
+        ///< [IN]
+    le_wifiAp_SecurityProtocol_t securityProtocol,
+        ///< [IN]
+        ///< Security protocol.
+    const char *passphrasePtr,
+        ///< [IN]
+        ///< WPA2 passphrase.
+    uint16_t maxNumClients,
+        ///< [IN]
+        ///< Maximum clients.
+    bool isDiscoverable
+        ///< [IN]
+        ///< SSID broadcast.
 )
 {
-    le_event_HandlerRef_t handlerRef;
+    pa_wifiAp_BssConfig_t config;
 
-    LE_DEBUG("Add new event handler");
-    if (handlerFuncPtr == NULL)
+    if ((NULL == ssidPtr) || (ssidSize > LE_WIFIDEFS_MAX_SSID_LENGTH) || (NULL == passphrasePtr))
     {
-        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
-        return NULL;
+        return LE_BAD_PARAMETER;
     }
 
-    handlerRef = le_event_AddLayeredHandler("NewWiFiApEventHandler",
-        NewWifiApEventId,
-        FirstLayerWifiApEventHandler,
-        (le_event_HandlerFunc_t)handlerFuncPtr);
-
-    le_event_SetContextPtr(handlerRef, contextPtr);
+    memset(&config, 0, sizeof(config));
+    memcpy(config.ssid, ssidPtr, ssidSize);
+    config.ssidLength = ssidSize;
+    config.securityProtocol = securityProtocol;
+    if (LE_OK != le_utf8_Copy(config.passphrase, passphrasePtr, sizeof(config.passphrase), NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    config.maxNumClients = maxNumClients;
+    config.isDiscoverable = isDiscoverable;
 
-    return (le_wifiAp_NewEventHandlerRef_t)(handlerRef);
+    return pa_wifiAp_SetBss(bssIndex, &config);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove handler function for EVENT 'le_wifiAp_NewEvent'
+ * Remove an additional BSS of the access point, applied at the next start or restart.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid BSS index.
  */
 //--------------------------------------------------------------------------------------------------
-void le_wifiAp_RemoveNewEventHandler
+le_result_t le_wifiApExt_RemoveBss
 (
-    le_wifiAp_NewEventHandlerRef_t handlerRef
+    uint8_t bssIndex
         ///< [IN]
-        ///< Event handler function to remove.
+        ///< BSS, 1 to MAX_BSS - 1.
 )
 {
-    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+    return pa_wifiAp_SetBss(bssIndex, NULL);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function starts the WiFi Access Point.
- * Note that all settings, if to be used, such as security, username, password must set prior to
- * starting the Access Point.
- *
- * @return LE_FAULT         The function failed.
- * @return LE_OK            The function succeeded.
- * @return LE_NOT_FOUND     The WiFi card is absent.
- * @return LE_UNAVAILABLE   The WiFi card may not work.
+ * Define the IP address of an additional BSS and the client IP addresses range served on it.
+ * If the access point is not started, the range is applied when it starts.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  The BSS does not exist, or an IP address is invalid.
+ *      - LE_FAULT          The DHCP server could not be updated.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_Start
+le_result_t le_wifiApExt_SetBssIpRange
 (
-    void
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS, 1 to MAX_BSS - 1.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< IP address of the BSS interface.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< First client IP address.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< Last client IP address.
 )
 {
-    return pa_wifiAp_Start();
+    return pa_wifiAp_SetBssIpRange(bssIndex, ipApPtr, ipStartPtr, ipStopPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function stops the WiFi Access Point.
+ * Get the interface name of a BSS.
  *
- * @return LE_FAULT         The function failed.
- * @return LE_OK            The function succeeded.
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      The BSS does not exist.
+ *      - LE_OVERFLOW       The interface name buffer is too small.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_Stop
+le_result_t le_wifiApExt_GetBssInterface
 (
-    void
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS, 0 for the main one.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< Interface name.
+    size_t ifNameSize
+        ///< [IN]
 )
 {
-    return pa_wifiAp_Stop();
+    return pa_wifiAp_GetBssInterface(bssIndex, ifNamePtr, ifNameSize);
 }
 
-
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the Service Set IDentification (SSID) of the access point
- *
- * @note The SSID does not have to be human readable ASCII values, but often is.
+ * Enable or disable the concurrent mode, in which the access point runs on a virtual interface
+ * next to the client. Applied at the next start of the access point.
  *
- * @return LE_BAD_PARAMETER Some parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BUSY           The access point is started.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetSsid
+le_result_t le_wifiApExt_SetConcurrent
 (
-    const uint8_t *ssidPtr,
-        ///< [IN]
-        ///< The SSID to set as a octet array.
-
-    size_t ssidNumElements
+    bool enable
         ///< [IN]
-        ///< The length of the SSID in octets.
+        ///< true to run the access point next to the client.
 )
 {
-    return pa_wifiAp_SetSsid(ssidPtr, ssidNumElements);
+    return pa_wifiAp_SetConcurrent(enable);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the security protocol to use.
- *
- * @note that the SSID does not have to be human readable ASCII values, but often has.
+ * Set the beacon interval, applied at the next start or restart.
  *
- * @return LE_BAD_PARAMETER Some parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_OUT_OF_RANGE   The interval is lower than 15.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetSecurityProtocol
+le_result_t le_wifiApExt_SetBeaconInterval
 (
-    le_wifiAp_SecurityProtocol_t securityProtocol
+    uint16_t beaconInterval
         ///< [IN]
-        ///< The security protocol used to communicate with the access point.
+        ///< Beacon interval, in time units of 1024 us.
 )
 {
-    return pa_wifiAp_SetSecurityProtocol(securityProtocol);
+    return pa_wifiAp_SetBeaconInterval(beaconInterval);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the passphrase used to generate the PSK.
- *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * le_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
- *
- * @return LE_BAD_PARAMETER Parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * Set the DTIM period, applied at the next start or restart.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_OUT_OF_RANGE   The period is 0.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetPassPhrase
+le_result_t le_wifiApExt_SetDtimPeriod
 (
-    const char *passphrasePtr
+    uint8_t dtimPeriod
         ///< [IN]
-        ///< Passphrase to authenticate against the access point.
+        ///< DTIM period, in beacon intervals.
 )
 {
-    return pa_wifiAp_SetPassPhrase(passphrasePtr);
+    return pa_wifiAp_SetDtimPeriod(dtimPeriod);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the pre-shared key (PSK).
- *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * le_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
- *
- * @return LE_BAD_PARAMETER Parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * Set the EDCA parameters of a WMM access category.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetPreSharedKey
+le_result_t le_wifiApExt_SetWmmParameters
 (
-    const char *preSharedKeyPtr
+    le_wifiApExt_WmmAc_t ac,
         ///< [IN]
-        ///< Pre-shared key used to authenticate against the access point.
+        ///< Access category.
+    uint8_t aifs,
+        ///< [IN]
+        ///< Arbitration inter-frame space number.
+    uint8_t ecwMin,
+        ///< [IN]
+        ///< Minimum contention window exponent.
+    uint8_t ecwMax,
+        ///< [IN]
+        ///< Maximum contention window exponent.
+    uint16_t txopLimit
+        ///< [IN]
+        ///< Transmit opportunity limit, in units of 32 us.
 )
 {
-    return pa_wifiAp_SetPreSharedKey(preSharedKeyPtr);
-}
+    pa_wifiAp_WmmParams_t params = { aifs, ecwMin, ecwMax, txopLimit };
+    pa_wifiAp_WmmAc_t     paAc;
 
+    switch (ac)
+    {
+        case LE_WIFIAPEXT_WMM_AC_BE:
+            paAc = PA_WIFIAP_WMM_AC_BE;
+            break;
+        case LE_WIFIAPEXT_WMM_AC_BK:
+            paAc = PA_WIFIAP_WMM_AC_BK;
+            break;
+        case LE_WIFIAPEXT_WMM_AC_VI:
+            paAc = PA_WIFIAP_WMM_AC_VI;
+            break;
+        case LE_WIFIAPEXT_WMM_AC_VO:
+            paAc = PA_WIFIAP_WMM_AC_VO;
+            break;
+        default:
+            return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_SetWmmParams(paAc, &params);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set if the Access Point should announce its presence.
- * Default value is TRUE.
- * If the value is set to FALSE, the Access Point will be hidden.
- *
- * @return LE_OK            Function succeeded.
+ * Set the time after which an inactive station is disconnected.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_OUT_OF_RANGE   The time is 0.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetDiscoverable
+le_result_t le_wifiApExt_SetMaxInactivity
 (
-    bool isDiscoverable
+    uint32_t maxInactivity
         ///< [IN]
-        ///< If TRUE the Access Point shows up on scans, else it is hidden.
+        ///< Maximum inactivity, in seconds.
 )
 {
-    return pa_wifiAp_SetDiscoverable(isDiscoverable);
+    return pa_wifiAp_SetMaxInactivity(maxInactivity);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which WiFi channel to use.
- * Default number is 7.
- * Some legal restrictions might apply for your region.
- * The channel number must be between 1 and 14 for IEEE 802.11b/g.
- * The channel number must be between 7 and 196 for IEEE 802.11a.
- * The channel number must be between 1 and 6 for IEEE 802.11ad.
- * @return
- *      - LE_OUT_OF_RANGE if requested channel number is out of range.
- *      - LE_OK if the function succeeded.
+ * Set the channel width and the HT/VHT options, applied at the next start or restart.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid parameter.
+ *      - LE_UNSUPPORTED    The radio does not support the settings.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetChannel
+le_result_t le_wifiApExt_SetHtConfig
 (
-    uint16_t channelNumber
+    le_wifiApExt_ChannelWidth_t width,
         ///< [IN]
-        ///< the channel number.
+        ///< Channel width.
+    le_wifiApExt_HtOption_t options
+        ///< [IN]
+        ///< HT and VHT options.
 )
 {
-    return pa_wifiAp_SetChannel(channelNumber);
-}
+    pa_wifiAp_ChannelWidth_t paWidth;
+    uint32_t                 paOptions = 0;
+
+    switch (width)
+    {
+        case LE_WIFIAPEXT_CHANNEL_WIDTH_20_MHZ:
+            paWidth = PA_WIFIAP_CHANNEL_WIDTH_20;
+            break;
+        case LE_WIFIAPEXT_CHANNEL_WIDTH_40_MHZ:
+            paWidth = PA_WIFIAP_CHANNEL_WIDTH_40;
+            break;
+        case LE_WIFIAPEXT_CHANNEL_WIDTH_80_MHZ:
+            paWidth = PA_WIFIAP_CHANNEL_WIDTH_80;
+            break;
+        default:
+            return LE_BAD_PARAMETER;
+    }
+
+    if (options & ~(LE_WIFIAPEXT_HT_OPTION_SHORT_GI | LE_WIFIAPEXT_HT_OPTION_LDPC |
+                    LE_WIFIAPEXT_HT_OPTION_MAX_AMPDU))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (options & LE_WIFIAPEXT_HT_OPTION_SHORT_GI)
+    {
+        paOptions |= PA_WIFIAP_HT_SHORT_GI;
+    }
+    if (options & LE_WIFIAPEXT_HT_OPTION_LDPC)
+    {
+        paOptions |= PA_WIFIAP_HT_LDPC;
+    }
+    if (options & LE_WIFIAPEXT_HT_OPTION_MAX_AMPDU)
+    {
+        paOptions |= PA_WIFIAP_HT_MAX_AMPDU;
+    }
 
+    return pa_wifiAp_SetHtConfig(paWidth, paOptions);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which IEEE standard to use.
- * Default hardware mode is IEEE 802.11g.
+ * Convert an access control list of the API to the PA one.
  *
  * @return
- *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
- *      - LE_OK if the function succeeded.
- *
+ *      - LE_OK             The list is converted.
+ *      - LE_BAD_PARAMETER  Invalid list.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetIeeeStandard
+static le_result_t GetPaAclList
 (
-    le_wifiAp_IeeeStdBitMask_t stdMask
-        ///< [IN]
-        ///< Bit mask for the IEEE standard.
+    le_wifiApExt_MacAclList_t list,
+    pa_wifiAcl_List_t *paListPtr
 )
 {
-    return pa_wifiAp_SetIeeeStandard(stdMask);
+    switch (list)
+    {
+        case LE_WIFIAPEXT_MAC_ACL_ACCEPT_LIST:
+            *paListPtr = PA_WIFIACL_LIST_ACCEPT;
+            return LE_OK;
+        case LE_WIFIAPEXT_MAC_ACL_DENY_LIST:
+            *paListPtr = PA_WIFIACL_LIST_DENY;
+            return LE_OK;
+        default:
+            return LE_BAD_PARAMETER;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get which IEEE standard was set.
- * Default hardware mode is IEEE 802.11g.
+ * Deauthenticate a station from the access point.
  *
  * @return
- *      - LE_FAULT if the function failed.
- *      - LE_OK if the function succeeded.
- *
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid MAC address.
+ *      - LE_NOT_FOUND      The station is not associated.
+ *      - LE_FAULT          The access point is not started or the request failed.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_GetIeeeStandard
+le_result_t le_wifiApExt_Deauthenticate
 (
-    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
-        ///< [OUT]
-        ///< Bit mask for the IEEE standard.
+    const char *macAddressPtr,
+        ///< [IN]
+        ///< Station MAC address.
+    uint16_t reason
+        ///< [IN]
+        ///< IEEE 802.11 reason code, 0 for the default one.
 )
 {
-    if ( NULL == stdMaskPtr )
-    {
-        LE_WARN("stdMaskPtr is NULL.");
-        return LE_FAULT;
-    }
-    return pa_wifiAp_GetIeeeStandard(stdMaskPtr);
+    return pa_wifiAp_Deauthenticate(macAddressPtr, reason);
 }
 
+//--------------------------------------------------------------------------------------------------
 /**
- * Set what country code to use for regulatory domain.
- * ISO/IEC 3166-1 Alpha-2 code is used.
- * Default country code is US.
- * @return
- *      - LE_FAULT if the function failed.
- *      - LE_OK if the function succeeded.
+ * Set the MAC address access control policy.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid policy.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetCountryCode
+le_result_t le_wifiApExt_SetMacAclPolicy
 (
-    const char *countryCodePtr
+    le_wifiApExt_MacAclPolicy_t policy
         ///< [IN]
-        ///< the country code.
+        ///< Access control policy.
 )
 {
-    return pa_wifiAp_SetCountryCode(countryCodePtr);
+    switch (policy)
+    {
+        case LE_WIFIAPEXT_MAC_ACL_ACCEPT_UNLESS_DENIED:
+            return pa_wifiAp_SetMacAclPolicy(PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED);
+        case LE_WIFIAPEXT_MAC_ACL_DENY_UNLESS_ACCEPTED:
+            return pa_wifiAp_SetMacAclPolicy(PA_WIFIACL_POLICY_DENY_UNLESS_ACCEPTED);
+        default:
+            return LE_BAD_PARAMETER;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  WiFi access point component initialization.
+ * Add a station MAC address to an access control list.
+ *
+ * @return
+ *      - LE_OK             Function succeeded, or the address was already in the list.
+ *      - LE_BAD_PARAMETER  Invalid list or MAC address.
+ *      - LE_NO_MEMORY      The list is full.
  */
 //--------------------------------------------------------------------------------------------------
-void le_wifiAp_Init
+le_result_t le_wifiApExt_AddMacAcl
 (
-    void
+    le_wifiApExt_MacAclList_t list,
+        ///< [IN]
+        ///< Access control list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< Station MAC address.
 )
 {
-    LE_DEBUG("WiFi Access Point Service is ready");
-
-    pa_wifiAp_Init();
-
-    // Create an event Id for new WiFi Events
-    NewWifiApEventId = le_event_CreateId("WiFiApEventId", sizeof(le_wifiAp_Event_t));
-
-    // register for events from PA.
-    pa_wifiAp_AddEventHandler(PaEventApHandler, NULL);
+    pa_wifiAcl_List_t paList;
 
+    if (LE_OK != GetPaAclList(list, &paList))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_AddMacAcl(paList, macAddressPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set number of maximally allowed clients to connect to the Access Point at the same time.
- *
- * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
- * @return LE_OK            Function succeeded.
+ * Remove a station MAC address from an access control list.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid list or MAC address.
+ *      - LE_NOT_FOUND      The address is not in the list.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetMaxNumberOfClients
+le_result_t le_wifiApExt_RemoveMacAcl
 (
-    int8_t maxNumberOfClients
+    le_wifiApExt_MacAclList_t list,
         ///< [IN]
-        ///< the maximum number of clients
+        ///< Access control list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< Station MAC address.
 )
 {
-    if (0 == maxNumberOfClients)
+    pa_wifiAcl_List_t paList;
+
+    if (LE_OK != GetPaAclList(list, &paList))
     {
-        return LE_OUT_OF_RANGE;
+        return LE_BAD_PARAMETER;
     }
-    return pa_wifiAp_SetMaxNumberClients(maxNumberOfClients);
+    return pa_wifiAp_RemoveMacAcl(paList, macAddressPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Defines the IP adresses range for the host AP.
- *
- * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
- * @return LE_FAULT         A system call has failed.
- * @return LE_OK            Function succeeded.
+ * Remove all the station MAC addresses of an access control list.
  *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid list.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_wifiAp_SetIpRange
+le_result_t le_wifiApExt_ClearMacAcl
 (
-    const char *ip_ap,
-        ///< [IN]
-        ///< the IP address of the Access Point.
-    const char *ip_start,
-        ///< [IN]
-        ///< the start IP address of the Access Point.
-    const char *ip_stop
+    le_wifiApExt_MacAclList_t list
         ///< [IN]
-        ///< the stop IP address of the Access Point.
+        ///< Access control list.
 )
 {
-    return pa_wifiAp_SetIpRange(ip_ap, ip_start, ip_stop);
-}
+    pa_wifiAcl_List_t paList;
 
+    if (LE_OK != GetPaAclList(list, &paList))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    return pa_wifiAp_ClearMacAcl(paList);
+}
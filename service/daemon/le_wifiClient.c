@@ -11,6 +11,7 @@
 #include "interfaces.h"
 
 #include "pa_wifi.h"
+#include "pa_wifi_ring.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -22,6 +23,9 @@
 #define CFG_PATH_WIFI               "wifi/channel"
 #define CFG_NODE_HIDDEN_SSID        "hidden"
 #define CFG_NODE_SECPROTOCOL        "secProtocol"
+#define CFG_PATH_WIFI_CLIENT        "wifi/client"
+#define CFG_NODE_REPLAY_LAST_STATE  "replayLastState"
+#define CFG_NODE_COALESCE_WINDOW    "coalesceWindowMs"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -74,7 +78,7 @@ static le_mem_PoolRef_t AccessPointPool;
 //--------------------------------------------------------------------------------------------------
 /**
  * The number of found AP:s from the scan used for informative traces.
- *
+ * Only used by the main thread.
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t FoundWifiApCount = 0;
@@ -98,17 +102,52 @@ static le_msg_SessionRef_t GetFirstSessionRef = NULL;
 //--------------------------------------------------------------------------------------------------
 /**
  * If the Scan is running in a seperate thread, this variable will have a value != NULL.
- * The thread destructor will clear the
+ * It is cleared when the end of scan is received from the scan ring.
  */
 //--------------------------------------------------------------------------------------------------
 static le_thread_Ref_t ScanThreadRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Result of completed scan
+ * Capacity of the ring carrying the scan results from the scan thread to the main thread.
+ * The scan thread waits when the ring is full, scan results are never dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SCAN_QUEUE_MAX_COUNT    64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of the scan ring entries.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SCAN_ENTRY_START,   ///< The scan succeeded, results follow.
+    SCAN_ENTRY_AP,      ///< One access point found.
+    SCAN_ENTRY_DONE     ///< End of scan.
+}
+ScanEntryType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan ring entry.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ScanResult = LE_OK;
+typedef struct
+{
+    ScanEntryType_t             type;                                 ///< Entry type.
+    le_result_t                 result;                               ///< Scan result (DONE).
+    pa_wifiClient_AccessPoint_t accessPoint;                          ///< Access point (AP).
+    char                        ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];  ///< Interface (DONE).
+}
+ScanEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring carrying the scan results from the scan thread to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiRing_Ref_t ScanRing;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -126,6 +165,18 @@ static le_event_Id_t WifiEventId;
 //--------------------------------------------------------------------------------------------------
 static le_event_Id_t WifiEventIndicationId;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event reported to the client handlers, shared by all of them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiClient_TimedEventInd_t timedEvent;           ///< Event. Must be first.
+    bool                          isLatencyRecorded;    ///< Service queue hop already measured.
+}
+DispatchedEvent_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pool for WifiClient state events reporting.
@@ -154,10 +205,381 @@ static le_wifiClient_AccessPointRef_t CurrentConnection = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WLAN interface being used to do WiFi scan.
+ * Maximum number of WLAN interfaces for which event sequence numbers are tracked.
+ * Events on additional interfaces share the last entry.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_IF_MAX_COUNT  4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-interface event tracking.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];  ///< WLAN interface name.
+    uint32_t seqNum;                                ///< Sequence number of the last event.
+    bool     hasState;                              ///< A connection event has been cached.
+    pa_wifiClient_TimedEventInd_t lastState;        ///< Last connection event (state cache).
+}
+EventInterface_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last state replay pending for a newly registered connection event handler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_event_HandlerRef_t  handlerRef;      ///< Handler registered by the client.
+    le_event_HandlerFunc_t handlerFuncPtr;  ///< Client handler function.
+    void                  *contextPtr;      ///< Client handler context.
+    bool                   isTimed;         ///< Handler of le_wifiClientExt_TimedConnectionEvent.
+    le_dls_Link_t          link;            ///< Link in PendingReplayList.
+}
+PendingReplay_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queueing delay counters of one hop of the event reporting chain.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;     ///< Number of measurements.
+    uint64_t totalUs;   ///< Sum of the measured delays (us).
+    uint64_t maxUs;     ///< Maximum measured delay (us).
+}
+HopLatency_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event tracking table, indexed in order of first appearance of the interfaces.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventInterface_t EventInterfaces[EVENT_IF_MAX_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of used entries in EventInterfaces.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t EventInterfaceCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queueing delay counters, indexed by le_wifiClientExt_EventHop_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static HopLatency_t HopLatency[LE_WIFICLIENTEXT_HOP_SERVICE_QUEUE + 1];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for PendingReplay_t objects.
  */
 //--------------------------------------------------------------------------------------------------
-static char scanIfName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = {0};
+static le_mem_PoolRef_t PendingReplayPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last state replays queued to the event loop and not delivered yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t PendingReplayList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of (interface, BSSID) pairs with an open coalescing window.
+ * Events of additional pairs are not coalesced.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COALESCE_MAX_COUNT  16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coalescing window of one (interface, BSSID) pair.
+ *
+ * The first event of a burst is delivered immediately and opens the window. The following events
+ * are held back, only the latest one being kept. When the window expires, the latest event is
+ * delivered as a summary with the count of events it replaces and the window is reopened.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                           inUse;                                ///< Window is open.
+    char                           ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];  ///< Interface name.
+    char                           apBssid[LE_WIFIDEFS_MAX_BSSID_BYTES];  ///< AP BSSID.
+    le_timer_Ref_t                 timer;                                ///< Window timer.
+    pa_wifiClient_TimedEventInd_t  pending;                              ///< Latest held event.
+    uint32_t                       heldCount;                            ///< Held events count.
+}
+CoalesceEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coalescing windows. Only used by the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static CoalesceEntry_t CoalesceEntries[COALESCE_MAX_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Coalescing window duration in ms, read from the config tree at startup. 0 disables coalescing.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CoalesceWindowMs = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of events merged into summary events since startup.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CoalescedEventCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of events dropped by the PA since startup.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t DroppedEventCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the event tracking entry of an interface, creating it if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventInterface_t *GetEventInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < EventInterfaceCount; i++)
+    {
+        if (0 == strncmp(EventInterfaces[i].ifName, ifNamePtr, LE_WIFIDEFS_MAX_IFNAME_BYTES))
+        {
+            return &EventInterfaces[i];
+        }
+    }
+
+    if (EventInterfaceCount < EVENT_IF_MAX_COUNT)
+    {
+        i = EventInterfaceCount++;
+        memset(&EventInterfaces[i], 0, sizeof(EventInterface_t));
+        le_utf8_Copy(EventInterfaces[i].ifName, ifNamePtr, LE_WIFIDEFS_MAX_IFNAME_BYTES, NULL);
+    }
+    else
+    {
+        LE_WARN("Too many interfaces, '%s' shares sequence numbers of '%s'",
+                ifNamePtr, EventInterfaces[EVENT_IF_MAX_COUNT - 1].ifName);
+        i = EVENT_IF_MAX_COUNT - 1;
+    }
+
+    return &EventInterfaces[i];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a monotonic time to microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t TimeToUs
+(
+    le_clk_Time_t time
+)
+{
+    return ((uint64_t)time.sec * 1000000) + (uint64_t)time.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the queueing delay of an event on one hop.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordHopLatency
+(
+    le_wifiClientExt_EventHop_t hop,
+        ///< [IN]
+        ///< Hop of the event reporting chain.
+    le_clk_Time_t startTime,
+        ///< [IN]
+        ///< Time the event entered the hop.
+    le_clk_Time_t endTime
+        ///< [IN]
+        ///< Time the event left the hop.
+)
+{
+    uint64_t startUs = TimeToUs(startTime);
+    uint64_t endUs   = TimeToUs(endTime);
+    uint64_t delayUs = (endUs > startUs) ? (endUs - startUs) : 0;
+
+    HopLatency[hop].count++;
+    HopLatency[hop].totalUs += delayUs;
+    if (delayUs > HopLatency[hop].maxUs)
+    {
+        HopLatency[hop].maxUs = delayUs;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report an event indication to the client handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DispatchEventInd
+(
+    const pa_wifiClient_TimedEventInd_t *timedEventPtr
+        ///< [IN]
+        ///< Event to report.
+)
+{
+    // One copy is shared by all the client handlers, as they are called later by the event loop.
+    DispatchedEvent_t *reportPtr = le_mem_ForceAlloc(WifiEventPool);
+
+    reportPtr->timedEvent = *timedEventPtr;
+    reportPtr->timedEvent.dispatchTime = le_clk_GetRelativeTime();
+    reportPtr->isLatencyRecorded = false;
+    le_event_ReportWithRefCounting(WifiEventIndicationId, reportPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the service queue hop of a reported event when the event loop dequeues it: by the first
+ * client handler called, the others being called in the same pass.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordServiceQueueLatency
+(
+    DispatchedEvent_t *reportPtr
+        ///< [IN]
+        ///< Event being delivered.
+)
+{
+    if (!reportPtr->isLatencyRecorded)
+    {
+        RecordHopLatency(LE_WIFICLIENTEXT_HOP_SERVICE_QUEUE,
+                         reportPtr->timedEvent.dispatchTime,
+                         le_clk_GetRelativeTime());
+        reportPtr->isLatencyRecorded = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expiry of a coalescing window: deliver the latest held event as a summary, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CoalesceTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    CoalesceEntry_t *entryPtr = le_timer_GetContextPtr(timerRef);
+    pa_wifiClient_TimedEventInd_t *timedEventPtr = &entryPtr->pending;
+
+    if (0 == entryPtr->heldCount)
+    {
+        // Quiet window, the burst is over.
+        entryPtr->inUse = false;
+        return;
+    }
+
+    timedEventPtr->coalescedCount = entryPtr->heldCount - 1;
+    entryPtr->heldCount = 0;
+
+    LE_DEBUG("Summary event %d on %s/%s replaces %u event(s)",
+             timedEventPtr->indication.event,
+             entryPtr->ifName,
+             entryPtr->apBssid,
+             timedEventPtr->coalescedCount);
+
+    DispatchEventInd(timedEventPtr);
+
+    // Reopen the window, the burst may go on.
+    le_timer_Start(timerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit a connection event to coalescing.
+ *
+ * @return true if the event is held back (it is copied), false if it must be delivered now.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CoalesceEvent
+(
+    pa_wifiClient_TimedEventInd_t *timedEventPtr
+        ///< [IN]
+        ///< Connection event.
+)
+{
+    CoalesceEntry_t *freeEntryPtr = NULL;
+    uint32_t i;
+
+    if (0 == CoalesceWindowMs)
+    {
+        return false;
+    }
+
+    for (i = 0; i < COALESCE_MAX_COUNT; i++)
+    {
+        CoalesceEntry_t *entryPtr = &CoalesceEntries[i];
+
+        if (!entryPtr->inUse)
+        {
+            if (NULL == freeEntryPtr)
+            {
+                freeEntryPtr = entryPtr;
+            }
+            continue;
+        }
+
+        if ((0 == strncmp(entryPtr->ifName, timedEventPtr->indication.ifName,
+                          LE_WIFIDEFS_MAX_IFNAME_BYTES)) &&
+            (0 == strncmp(entryPtr->apBssid, timedEventPtr->indication.apBssid,
+                          LE_WIFIDEFS_MAX_BSSID_BYTES)))
+        {
+            // Window open: hold the event back, it replaces the previous held one.
+            if (0 != entryPtr->heldCount)
+            {
+                CoalescedEventCount++;
+            }
+            entryPtr->pending = *timedEventPtr;
+            entryPtr->heldCount++;
+            return true;
+        }
+    }
+
+    if (NULL == freeEntryPtr)
+    {
+        LE_WARN("No coalescing window available for %s/%s",
+                timedEventPtr->indication.ifName, timedEventPtr->indication.apBssid);
+        return false;
+    }
+
+    // First event of a burst: deliver it now and open the window.
+    le_utf8_Copy(freeEntryPtr->ifName, timedEventPtr->indication.ifName,
+                 sizeof(freeEntryPtr->ifName), NULL);
+    le_utf8_Copy(freeEntryPtr->apBssid, timedEventPtr->indication.apBssid,
+                 sizeof(freeEntryPtr->apBssid), NULL);
+    freeEntryPtr->heldCount = 0;
+    freeEntryPtr->inUse = true;
+
+    if (NULL == freeEntryPtr->timer)
+    {
+        freeEntryPtr->timer = le_timer_Create("WifiEventCoalesce");
+        le_timer_SetHandler(freeEntryPtr->timer, CoalesceTimerHandler);
+        le_timer_SetContextPtr(freeEntryPtr->timer, freeEntryPtr);
+    }
+    le_timer_SetMsInterval(freeEntryPtr->timer, CoalesceWindowMs);
+    le_timer_Start(freeEntryPtr->timer);
+
+    return false;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -180,7 +602,45 @@ static void PaEventIndicationHandler
         LE_DEBUG("disconnectCause: %d", wifiEventIndicationPtr->disconnectionCause);
     }
 
-    le_event_ReportWithRefCounting(WifiEventIndicationId, wifiEventIndicationPtr);
+    // Event indications are always timed events, see pa_wifiClient_TimedEventInd_t. The event is
+    // only valid during the call.
+    pa_wifiClient_TimedEventInd_t *timedEventPtr =
+        (pa_wifiClient_TimedEventInd_t *)wifiEventIndicationPtr;
+    bool isConnectionEvent = (LE_WIFICLIENT_EVENT_CONNECTED == wifiEventIndicationPtr->event) ||
+                             (LE_WIFICLIENT_EVENT_DISCONNECTED == wifiEventIndicationPtr->event);
+
+    // Events generated on the main thread did not go through the PA hops: they would only pull
+    // the averages towards zero.
+    if (!timedEventPtr->isLocal)
+    {
+        RecordHopLatency(LE_WIFICLIENTEXT_HOP_PA_PARSE,
+                         timedEventPtr->captureTime,
+                         timedEventPtr->reportTime);
+        RecordHopLatency(LE_WIFICLIENTEXT_HOP_PA_QUEUE,
+                         timedEventPtr->reportTime,
+                         le_clk_GetRelativeTime());
+    }
+
+    EventInterface_t *interfacePtr = GetEventInterface(wifiEventIndicationPtr->ifName);
+    // Dropped events consume sequence numbers so that clients see the gap.
+    interfacePtr->seqNum += 1 + timedEventPtr->droppedCount;
+    timedEventPtr->seqNum = interfacePtr->seqNum;
+    DroppedEventCount += timedEventPtr->droppedCount;
+    // Only connection state changes are cached, scan results are not a link state.
+    if (isConnectionEvent)
+    {
+        interfacePtr->lastState = *timedEventPtr;
+        interfacePtr->hasState = true;
+    }
+
+    LE_DEBUG("seqNum: %u, dropped: %u", timedEventPtr->seqNum, timedEventPtr->droppedCount);
+
+    if (isConnectionEvent && CoalesceEvent(timedEventPtr))
+    {
+        return;
+    }
+
+    DispatchEventInd(timedEventPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -472,8 +932,8 @@ static void MarkAllAccessPointsOld
  * Will result in an event LE_WIFICLIENT_EVENT_SCAN_DONE when the scan results are available or
  * an event LE_WIFICLIENT_EVENT_SCAN_FAILED if there was an error while scanning.
  *
- * @return LE_FAULT         Function failed.
- * @return LE_OK            Function succeeded.
+ * The results are handed over to the main thread through the scan ring, this thread does not
+ * touch the access point list.
  */
 //--------------------------------------------------------------------------------------------------
 static void *ScanThread
@@ -481,59 +941,67 @@ static void *ScanThread
     void *contextPtr
 )
 {
-    pa_wifiClient_AccessPoint_t accessPoint;
-    le_result_t                 *scanResultPtr = contextPtr;
-    le_result_t                 paResult    = pa_wifiClient_Scan();
+    ScanEntry_t  entry;
+    le_result_t  paResult = pa_wifiClient_Scan();
+
+    memset(&entry, 0, sizeof(entry));
 
     if (LE_OK != paResult)
     {
         LE_ERROR("Scan failed (%d)", paResult);
-        *scanResultPtr = LE_FAULT;
+        entry.type = SCAN_ENTRY_DONE;
+        entry.result = LE_FAULT;
+        pa_wifiRing_PushWait(ScanRing, &entry);
         return NULL;
     }
 
-    FoundWifiApCount = 0;
+    entry.type = SCAN_ENTRY_START;
+    pa_wifiRing_PushWait(ScanRing, &entry);
 
-    MarkAllAccessPointsOld();
-    memset(scanIfName, 0, LE_WIFIDEFS_MAX_IFNAME_BYTES);
-    while (LE_OK == (paResult = pa_wifiClient_GetScanResult(&accessPoint, scanIfName)))
+    entry.type = SCAN_ENTRY_AP;
+    while (LE_OK == (paResult = pa_wifiClient_GetScanResult(&entry.accessPoint, entry.ifName)))
     {
-        if (AddAccessPointToApRefMap(&accessPoint) == NULL)
-        {
-            LE_ERROR("pa_wifiClient_ScanDone() failed");
-            paResult = LE_FAULT;
-            break;
-        }
+        pa_wifiRing_PushWait(ScanRing, &entry);
     }
 
-    *scanResultPtr = ((paResult == LE_OK) || (paResult == LE_NOT_FOUND)) ? LE_OK : paResult;
+    entry.type = SCAN_ENTRY_DONE;
+    entry.result = ((paResult == LE_OK) || (paResult == LE_NOT_FOUND)) ? LE_OK : paResult;
 
     paResult = pa_wifiClient_ScanDone();
     if (LE_OK != paResult)
     {
         LE_ERROR("pa_wifiClient_ScanDone() failed (%d)", paResult);
-        *scanResultPtr = paResult;
+        entry.result = paResult;
     }
 
+    pa_wifiRing_PushWait(ScanRing, &entry);
+
     return NULL;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Thread Destructor for scan
+ * Report the end of scan to the client handlers.
  */
 //--------------------------------------------------------------------------------------------------
-static void ScanThreadDestructor
+static void ReportScanDone
 (
-    void *context
+    le_result_t scanResult,
+        ///< [IN]
+        ///< Scan result.
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface used to scan.
 )
 {
-    le_result_t scanResult = *((le_result_t*)context);
+    pa_wifiClient_TimedEventInd_t timedEvent;
+    le_wifiClient_EventInd_t* wifiEventIndicationPtr = &timedEvent.indication;
 
-    LE_DEBUG("Destruct scan thread");
-    ScanThreadRef = NULL;
-    le_wifiClient_EventInd_t* wifiEventIndicationPtr = le_mem_ForceAlloc(WifiEventPool);
+    memset(&timedEvent, 0, sizeof(pa_wifiClient_TimedEventInd_t));
+    timedEvent.captureTime = le_clk_GetRelativeTime();
+    timedEvent.reportTime = timedEvent.captureTime;
+    timedEvent.isLocal = true;
 
     if (scanResult == LE_OK)
     {
@@ -546,7 +1014,7 @@ static void ScanThreadDestructor
     }
 
     wifiEventIndicationPtr->disconnectionCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
-    strncpy(wifiEventIndicationPtr->ifName, scanIfName, LE_WIFIDEFS_MAX_IFNAME_LENGTH);
+    strncpy(wifiEventIndicationPtr->ifName, ifNamePtr, LE_WIFIDEFS_MAX_IFNAME_LENGTH);
     wifiEventIndicationPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
     wifiEventIndicationPtr->apBssid[0] = '\0';
     PaEventIndicationHandler(wifiEventIndicationPtr, NULL);
@@ -555,6 +1023,47 @@ static void ScanThreadDestructor
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main thread side of the scan ring: merge the scan results into the access point list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScanRingHandler
+(
+    void *elemPtr,
+    void *contextPtr
+)
+{
+    ScanEntry_t *entryPtr = elemPtr;
+
+    switch (entryPtr->type)
+    {
+        case SCAN_ENTRY_START:
+            FoundWifiApCount = 0;
+            MarkAllAccessPointsOld();
+            break;
+
+        case SCAN_ENTRY_AP:
+            if (AddAccessPointToApRefMap(&entryPtr->accessPoint) == NULL)
+            {
+                LE_ERROR("Failed to add AP %s", entryPtr->accessPoint.bssid);
+            }
+            break;
+
+        case SCAN_ENTRY_DONE:
+            LE_DEBUG("Scan done, %u new AP", FoundWifiApCount);
+            // The scan thread is exiting, a new scan can be started.
+            ScanThreadRef = NULL;
+            ReportScanDone(entryPtr->result, entryPtr->ifName);
+            break;
+
+        default:
+            LE_ERROR("Unknown scan entry type %d", entryPtr->type);
+            break;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function to the close session service to detect if the application crashed.
@@ -614,6 +1123,166 @@ static void FirstLayerWifiClientEventHandler
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deliver a connection event to a client handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeliverEvent
+(
+    const pa_wifiClient_TimedEventInd_t *timedEventPtr,
+        ///< [IN]
+        ///< Event to deliver.
+    bool isTimed,
+        ///< [IN]
+        ///< The handler is a le_wifiClientExt_TimedConnectionEventHandlerFunc_t.
+    le_event_HandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Client handler function.
+    void *contextPtr
+        ///< [IN]
+        ///< Client handler context.
+)
+{
+    if (isTimed)
+    {
+        le_wifiClientExt_TimedConnectionEventHandlerFunc_t clientHandlerFunc =
+            (le_wifiClientExt_TimedConnectionEventHandlerFunc_t)handlerFuncPtr;
+        le_wifiClientExt_TimedEventInd_t timedEventInd;
+
+        memset(&timedEventInd, 0, sizeof(timedEventInd));
+        timedEventInd.event = timedEventPtr->indication.event;
+        timedEventInd.disconnectionCause = timedEventPtr->indication.disconnectionCause;
+        le_utf8_Copy(timedEventInd.ifName, timedEventPtr->indication.ifName,
+                     sizeof(timedEventInd.ifName), NULL);
+        le_utf8_Copy(timedEventInd.apBssid, timedEventPtr->indication.apBssid,
+                     sizeof(timedEventInd.apBssid), NULL);
+        timedEventInd.seqNum = timedEventPtr->seqNum;
+        timedEventInd.captureTimeUs = TimeToUs(timedEventPtr->captureTime);
+        timedEventInd.coalescedCount = timedEventPtr->coalescedCount;
+
+        clientHandlerFunc(&timedEventInd, contextPtr);
+    }
+    else
+    {
+        le_wifiClient_ConnectionEventHandlerFunc_t clientHandlerFunc =
+            (le_wifiClient_ConnectionEventHandlerFunc_t)handlerFuncPtr;
+
+        clientHandlerFunc(&timedEventPtr->indication, contextPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deliver the cached state of every interface to a newly registered handler.
+ * Queued to the event loop by QueueLastStateReplay().
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplayLastState
+(
+    void *param1Ptr,
+    void *param2Ptr
+)
+{
+    PendingReplay_t *replayPtr = param1Ptr;
+    uint32_t         i;
+
+    le_dls_Remove(&PendingReplayList, &replayPtr->link);
+
+    if (NULL == replayPtr->handlerFuncPtr)
+    {
+        LE_DEBUG("Replay cancelled for handler %p", replayPtr->handlerRef);
+        le_mem_Release(replayPtr);
+        return;
+    }
+
+    for (i = 0; i < EventInterfaceCount; i++)
+    {
+        if (EventInterfaces[i].hasState)
+        {
+            LE_DEBUG("Replay event %d on %s to handler %p",
+                     EventInterfaces[i].lastState.indication.event,
+                     EventInterfaces[i].ifName,
+                     replayPtr->handlerRef);
+            DeliverEvent(&EventInterfaces[i].lastState, replayPtr->isTimed,
+                         replayPtr->handlerFuncPtr, replayPtr->contextPtr);
+        }
+    }
+
+    le_mem_Release(replayPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the delivery of the cached state to a newly registered handler, if enabled in the config
+ * tree. The delivery is deferred so that the client receives the handler reference first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueLastStateReplay
+(
+    le_event_HandlerRef_t handlerRef,
+        ///< [IN]
+        ///< Handler registered by the client.
+    le_event_HandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Client handler function.
+    void *contextPtr,
+        ///< [IN]
+        ///< Client handler context.
+    bool isTimed
+        ///< [IN]
+        ///< The handler is a le_wifiClientExt_TimedConnectionEventHandlerFunc_t.
+)
+{
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateReadTxn(CFG_TREE_ROOT_DIR CFG_PATH_WIFI_CLIENT);
+    bool replay = le_cfg_GetBool(cfg, CFG_NODE_REPLAY_LAST_STATE, false);
+
+    le_cfg_CancelTxn(cfg);
+
+    if (!replay)
+    {
+        return;
+    }
+
+    PendingReplay_t *replayPtr = le_mem_ForceAlloc(PendingReplayPool);
+
+    replayPtr->handlerRef = handlerRef;
+    replayPtr->handlerFuncPtr = handlerFuncPtr;
+    replayPtr->contextPtr = contextPtr;
+    replayPtr->isTimed = isTimed;
+    replayPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&PendingReplayList, &replayPtr->link);
+
+    le_event_QueueFunction(ReplayLastState, replayPtr, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel the pending replay of a handler being removed. The queued function then releases the
+ * replay without delivering anything.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelLastStateReplay
+(
+    le_event_HandlerRef_t handlerRef
+        ///< [IN]
+        ///< Handler being removed.
+)
+{
+    le_dls_Link_t *linkPtr = le_dls_Peek(&PendingReplayList);
+
+    while (NULL != linkPtr)
+    {
+        PendingReplay_t *replayPtr = CONTAINER_OF(linkPtr, PendingReplay_t, link);
+
+        if (replayPtr->handlerRef == handlerRef)
+        {
+            replayPtr->handlerFuncPtr = NULL;
+        }
+        linkPtr = le_dls_PeekNext(&PendingReplayList, linkPtr);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The first-layer WiFi Client Connection Event Handler.
@@ -626,13 +1295,15 @@ static void FirstLayerWifiClientConnectionEventHandler
     void *secondLayerHandlerFunc
 )
 {
-    le_wifiClient_EventInd_t*  wifiEventPtr = reportPtr;
+    DispatchedEvent_t*  dispatchedEventPtr = reportPtr;
     le_wifiClient_ConnectionEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
 
 
-    if (NULL != wifiEventPtr)
+    if (NULL != dispatchedEventPtr)
     {
-        clientHandlerFunc(wifiEventPtr, le_event_GetContextPtr());
+        RecordServiceQueueLatency(dispatchedEventPtr);
+        DeliverEvent(&dispatchedEventPtr->timedEvent, false,
+                     (le_event_HandlerFunc_t)clientHandlerFunc, le_event_GetContextPtr());
     }
     else
     {
@@ -642,6 +1313,35 @@ static void FirstLayerWifiClientConnectionEventHandler
     le_mem_Release(reportPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The first-layer WiFi Client Timed Connection Event Handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FirstLayerWifiClientTimedEventHandler
+(
+    void *reportPtr,
+    void *secondLayerHandlerFunc
+)
+{
+    DispatchedEvent_t*  dispatchedEventPtr = reportPtr;
+    le_wifiClientExt_TimedConnectionEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFunc;
+
+    if (NULL != dispatchedEventPtr)
+    {
+        RecordServiceQueueLatency(dispatchedEventPtr);
+        DeliverEvent(&dispatchedEventPtr->timedEvent, true,
+                     (le_event_HandlerFunc_t)clientHandlerFunc, le_event_GetContextPtr());
+    }
+    else
+    {
+        LE_WARN("dispatchedEventPtr is NULL");
+    }
+    // The reportPtr is a reference counted object, so need to release it
+    le_mem_Release(reportPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * returns the value of the field "foundInLatestScan"
@@ -748,6 +1448,8 @@ le_wifiClient_ConnectionEventHandlerRef_t le_wifiClient_AddConnectionEventHandle
 
     le_event_SetContextPtr(handlerRef, contextPtr);
 
+    QueueLastStateReplay(handlerRef, (le_event_HandlerFunc_t)handlerFuncPtr, contextPtr, false);
+
     return (le_wifiClient_ConnectionEventHandlerRef_t)(handlerRef);
 }
 
@@ -784,9 +1486,164 @@ void le_wifiClient_RemoveConnectionEventHandler
 )
 {
     LE_DEBUG("Remove event handler");
+    CancelLastStateReplay((le_event_HandlerRef_t)handlerRef);
     le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for WiFi connection state change, with
+ * event sequence number and capture time.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_wifiClientExt_TimedConnectionEventHandlerRef_t le_wifiClientExt_AddTimedConnectionEventHandler
+(
+    le_wifiClientExt_TimedConnectionEventHandlerFunc_t handlerFuncPtr,
+        ///< [IN]
+        ///< Event handling function
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    le_event_HandlerRef_t handlerRef;
+
+    LE_DEBUG("Add wifi timed connection event handler");
+
+    if (handlerFuncPtr == NULL)
+    {
+        LE_KILL_CLIENT("handlerFuncPtr is NULL !");
+        return NULL;
+    }
+
+    handlerRef = le_event_AddLayeredHandler("WiFiClientTimedMsgHandler",
+                                            WifiEventIndicationId,
+                                            FirstLayerWifiClientTimedEventHandler,
+                                            (le_event_HandlerFunc_t)handlerFuncPtr);
+
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    QueueLastStateReplay(handlerRef, (le_event_HandlerFunc_t)handlerFuncPtr, contextPtr, true);
+
+    return (le_wifiClientExt_TimedConnectionEventHandlerRef_t)(handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove handler function for EVENT 'le_wifiClientExt_TimedConnectionEvent'
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClientExt_RemoveTimedConnectionEventHandler
+(
+    le_wifiClientExt_TimedConnectionEventHandlerRef_t handlerRef
+        ///< [IN]
+        ///< Reference of the event handler to remove
+)
+{
+    LE_DEBUG("Remove timed event handler");
+    CancelLastStateReplay((le_event_HandlerRef_t)handlerRef);
+    le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the queueing delay counters of one hop of the event reporting chain.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_BAD_PARAMETER  Invalid hop.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiClientExt_GetEventLatency
+(
+    le_wifiClientExt_EventHop_t hop,
+        ///< [IN]
+        ///< Hop of the event reporting chain.
+    uint32_t *countPtr,
+        ///< [OUT]
+        ///< Number of measurements.
+    uint64_t *averageUsPtr,
+        ///< [OUT]
+        ///< Average delay (us).
+    uint64_t *maxUsPtr
+        ///< [OUT]
+        ///< Maximum delay (us).
+)
+{
+    if ((hop < LE_WIFICLIENTEXT_HOP_PA_PARSE) || (hop > LE_WIFICLIENTEXT_HOP_SERVICE_QUEUE))
+    {
+        LE_ERROR("Invalid hop %d", hop);
+        return LE_BAD_PARAMETER;
+    }
+
+    *countPtr = HopLatency[hop].count;
+    *averageUsPtr = (HopLatency[hop].count > 0) ?
+                    (HopLatency[hop].totalUs / HopLatency[hop].count) : 0;
+    *maxUsPtr = HopLatency[hop].maxUs;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of events merged into summary events and dropped because the event queue was
+ * full, since the service started.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClientExt_GetEventDropStats
+(
+    uint32_t *coalescedCountPtr,
+        ///< [OUT]
+        ///< Number of events merged into summary events.
+    uint32_t *droppedCountPtr
+        ///< [OUT]
+        ///< Number of events dropped.
+)
+{
+    *coalescedCountPtr = CoalescedEventCount;
+    *droppedCountPtr = DroppedEventCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the occupancy of the queue carrying the events from the platform adaptor thread to the
+ * WiFi service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClientExt_GetEventQueueStats
+(
+    uint32_t *depthPtr,
+        ///< [OUT]
+        ///< Number of events currently queued.
+    uint32_t *maxDepthPtr,
+        ///< [OUT]
+        ///< Highest number of events queued since startup.
+    uint32_t *capacityPtr
+        ///< [OUT]
+        ///< Queue capacity.
+)
+{
+    pa_wifiClient_GetEventQueueStats(depthPtr, maxDepthPtr, capacityPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the queueing delay counters of all hops.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiClientExt_ResetEventLatency
+(
+    void
+)
+{
+    memset(HopLatency, 0, sizeof(HopLatency));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts the WIFI device.
@@ -902,9 +1759,7 @@ le_result_t le_wifiClient_Scan
         LE_DEBUG("Scan started");
 
         // Start the thread
-        ScanResult = LE_OK;
-        ScanThreadRef = le_thread_Create("WiFi Client Scan Thread", ScanThread, &ScanResult);
-        le_thread_AddChildDestructor(ScanThreadRef, ScanThreadDestructor, &ScanResult);
+        ScanThreadRef = le_thread_Create("WiFi Client Scan Thread", ScanThread, NULL);
 
         le_thread_Start(ScanThreadRef);
         return LE_OK;
@@ -932,14 +1787,15 @@ static le_result_t GetLinkResult
         ///< The data of access point
 )
 {
+    char ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = {0};
+
     if (!accessPoint)
     {
         LE_KILL_CLIENT("accessPoint is NULL !");
         return LE_FAULT;
     }
 
-    memset(scanIfName, 0, LE_WIFIDEFS_MAX_IFNAME_BYTES);
-    if (LE_OK != pa_wifiClient_GetLinkResult(accessPoint,scanIfName))
+    if (LE_OK != pa_wifiClient_GetLinkResult(accessPoint, ifName))
     {
         LE_ERROR("ERORR: Failed to get data from iw command");
         return LE_FAULT;
@@ -1663,11 +2519,14 @@ le_result_t le_wifiClient_Delete
  * Connect to the WiFi Access Point.
  * All authentication must be set prior to calling this function.
  *
+ * The function returns once the connection request is started. The connection is reported by a
+ * LE_WIFICLIENT_EVENT_CONNECTED event, a failure or a time out by a
+ * LE_WIFICLIENT_EVENT_DISCONNECTED event.
+ *
  * @return
  *      - LE_OK             Function succeeded.
  *      - LE_BAD_PARAMETER  Invalid parameter.
- *      - LE_DUPLICATE      Duplicated request.
- *      - LE_TIMEOUT        Connection request time out.
+ *      - LE_DUPLICATE      A connection request is in progress.
  *      - LE_FAULT          The function failed.
  *
  * @note For PSK credentials see le_wifiClient_SetPassphrase() or le_wifiClient_SetPreSharedKey() .
@@ -2530,7 +3389,21 @@ void le_wifiClient_Init
 
     // Create an event indication Id for WiFi Events
     WifiEventIndicationId = le_event_CreateIdWithRefCounting("WifiConnectState");
-    WifiEventPool = le_mem_CreatePool("WifiConnectStatePool", sizeof(le_wifiClient_EventInd_t));
+    WifiEventPool = le_mem_CreatePool("WifiConnectStatePool", sizeof(DispatchedEvent_t));
+    PendingReplayPool = le_mem_CreatePool("WifiPendingReplayPool", sizeof(PendingReplay_t));
+    // The scan thread hands its results over to this thread through the ring.
+    ScanRing = pa_wifiRing_Create("WifiClientScan",
+                                  sizeof(ScanEntry_t),
+                                  SCAN_QUEUE_MAX_COUNT,
+                                  ScanRingHandler,
+                                  NULL);
+
+    // Read the coalescing window of connection events.
+    le_cfg_IteratorRef_t cfg = le_cfg_CreateReadTxn(CFG_TREE_ROOT_DIR CFG_PATH_WIFI_CLIENT);
+    int32_t windowMs = le_cfg_GetInt(cfg, CFG_NODE_COALESCE_WINDOW, 0);
+    le_cfg_CancelTxn(cfg);
+    CoalesceWindowMs = (windowMs > 0) ? (uint32_t)windowMs : 0;
+    LE_DEBUG("Event coalescing window: %u ms", CoalesceWindowMs);
     // register for events from PA.
     pa_wifiClient_AddEventIndHandler(PaEventIndicationHandler, NULL);
 
@@ -0,0 +1,132 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Legato WiFi Diagnostics
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+#include "interfaces.h"
+
+#include "pa_wifi_stats.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the duration statistics of a command.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      No command at this index.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiDiag_GetCommandLatency
+(
+    uint32_t index,
+        ///< [IN]
+        ///< Command index.
+    char *namePtr,
+        ///< [OUT]
+        ///< Command name.
+    size_t nameSize,
+        ///< [IN]
+        ///< Size of the name buffer.
+    uint32_t *countPtr,
+        ///< [OUT]
+        ///< Number of runs.
+    uint64_t *p50UsPtr,
+        ///< [OUT]
+        ///< Median duration (us).
+    uint64_t *p90UsPtr,
+        ///< [OUT]
+        ///< 90th percentile of the duration (us).
+    uint64_t *p99UsPtr,
+        ///< [OUT]
+        ///< 99th percentile of the duration (us).
+    uint64_t *maxUsPtr
+        ///< [OUT]
+        ///< Maximum duration (us).
+)
+{
+    pa_wifiStats_Command_t stats;
+
+    if (LE_OK != pa_wifiStats_Get(index, &stats))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    le_utf8_Copy(namePtr, stats.name, nameSize, NULL);
+    *countPtr = stats.count;
+    *p50UsPtr = stats.p50Us;
+    *p90UsPtr = stats.p90Us;
+    *p99UsPtr = stats.p99Us;
+    *maxUsPtr = stats.maxUs;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the exit status breakdown of a command.
+ *
+ * @return
+ *      - LE_OK             Function succeeded.
+ *      - LE_NOT_FOUND      No command at this index.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wifiDiag_GetCommandExitCodes
+(
+    uint32_t index,
+        ///< [IN]
+        ///< Command index.
+    int32_t *exitCodesPtr,
+        ///< [OUT]
+        ///< Exit statuses.
+    size_t *exitCodesSizePtr,
+        ///< [INOUT]
+        ///< Number of elements of exitCodesPtr.
+    uint32_t *countsPtr,
+        ///< [OUT]
+        ///< Number of runs per exit status.
+    size_t *countsSizePtr
+        ///< [INOUT]
+        ///< Number of elements of countsPtr.
+)
+{
+    pa_wifiStats_Command_t stats;
+    size_t                 count;
+
+    if (LE_OK != pa_wifiStats_Get(index, &stats))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    count = stats.exitCodeCount;
+    if (count > *exitCodesSizePtr)
+    {
+        count = *exitCodesSizePtr;
+    }
+    if (count > *countsSizePtr)
+    {
+        count = *countsSizePtr;
+    }
+
+    memcpy(exitCodesPtr, stats.exitCodes, count * sizeof(int32_t));
+    memcpy(countsPtr, stats.exitCounts, count * sizeof(uint32_t));
+    *exitCodesSizePtr = count;
+    *countsSizePtr = count;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the statistics of all commands.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_wifiDiag_ResetCommandStats
+(
+    void
+)
+{
+    pa_wifiStats_Reset();
+}
@@ -0,0 +1,80 @@
+#!/bin/sh
+# Copyright (C) Sierra Wireless Inc.
+#
+# Measure the per-command latency of the WiFi PA script, when a new script instance runs each
+# command (system() mode) and when the commands are sent to a single instance started in command
+# server mode.
+#
+# $1: PA script (default: the script of the installed wifiService app)
+# $2: Number of commands (default: 100)
+# $3: Command (default: PING, which measures the command overhead only)
+
+PA_SCRIPT=${1:-/legato/systems/current/apps/wifiService/read-only/pa_wifi}
+COUNT=${2:-100}
+COMMAND=${3:-PING}
+FIFO_DIR=/tmp/pa_cmd_bench.$$
+
+# Current time in microseconds
+NowUs()
+{
+    echo $(( $(date +%s%N) / 1000 ))
+}
+
+# Print the result of one mode
+# $1: Mode
+# $2: Total duration in microseconds
+PrintResult()
+{
+    echo "$1: ${COUNT} x ${COMMAND} in $(( $2 / 1000 )) ms, $(( $2 / COUNT )) us/command"
+}
+
+if [ ! -x "${PA_SCRIPT}" ]; then
+    echo "PA script ${PA_SCRIPT} not found"
+    exit 1
+fi
+
+if [ "$(date +%N)" = "%N" ]; then
+    echo "date does not support nanoseconds"
+    exit 1
+fi
+
+# One script instance per command
+start=$(NowUs)
+i=0
+while [ ${i} -lt ${COUNT} ]
+do
+    ${PA_SCRIPT} ${COMMAND} >/dev/null 2>&1
+    i=$((i + 1))
+done
+PrintResult "system" $(( $(NowUs) - start ))
+
+# Command server
+mkdir -p ${FIFO_DIR} || exit 1
+mkfifo ${FIFO_DIR}/in ${FIFO_DIR}/out || exit 1
+${PA_SCRIPT} SERVE <${FIFO_DIR}/in >${FIFO_DIR}/out &
+exec 3>${FIFO_DIR}/in 4<${FIFO_DIR}/out
+
+read -r ready <&4
+if [ "${ready}" != "=READY" ]; then
+    echo "PA script has no command server mode"
+else
+    start=$(NowUs)
+    i=0
+    while [ ${i} -lt ${COUNT} ]
+    do
+        echo "${COMMAND}" >&3
+        # Skip the output lines up to the status line
+        while read -r line <&4
+        do
+            case "${line}" in
+                =*) break ;;
+            esac
+        done
+        i=$((i + 1))
+    done
+    PrintResult "server" $(( $(NowUs) - start ))
+fi
+
+exec 3>&- 4<&-
+wait
+rm -rf ${FIFO_DIR}
@@ -0,0 +1,360 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter MAC address access control
+ *
+ *  The lists are small and bounded: they are kept in arrays, searched linearly. The MAC addresses
+ *  are stored in lower case, as hostapd reports them.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <ctype.h>
+
+#include "legato.h"
+
+#include "pa_wifi_acl.h"
+#include "pa_wifi_conf.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a MAC address, xx:xx:xx:xx:xx:xx.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAC_ADDRESS_LENGTH  17
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * MAC address list.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char        *pathPtr;                                         ///< File given to hostapd.
+    pa_wifiConf_File_t file;                                            ///< Last write of the file.
+    size_t             count;                                           ///< Number of addresses.
+    char               macs[PA_WIFIACL_MAX_MACS][MAC_ADDRESS_LENGTH + 1]; ///< Addresses.
+}
+MacList_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Accept and deny lists.
+ */
+//--------------------------------------------------------------------------------------------------
+static MacList_t MacLists[PA_WIFIACL_LIST_COUNT] =
+{
+    [PA_WIFIACL_LIST_ACCEPT] = { "/tmp/hostapd.accept", PA_WIFICONF_FILE_INIT, 0, { { 0 } } },
+    [PA_WIFIACL_LIST_DENY]   = { "/tmp/hostapd.deny",   PA_WIFICONF_FILE_INIT, 0, { { 0 } } },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Access control policy.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiAcl_Policy_t Policy = PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the format of a MAC address and copy it in lower case.
+ *
+ * @return true if the address is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool NormalizeMacAddress
+(
+    char *destPtr,
+    const char *srcPtr
+)
+{
+    size_t i;
+
+    if ((NULL == srcPtr) || (MAC_ADDRESS_LENGTH != strlen(srcPtr)))
+    {
+        return false;
+    }
+
+    for (i = 0; i < MAC_ADDRESS_LENGTH; i++)
+    {
+        bool isSeparator = (2 == (i % 3));
+
+        if (isSeparator ? (':' != srcPtr[i]) : (!isxdigit((unsigned char)srcPtr[i])))
+        {
+            return false;
+        }
+        destPtr[i] = (char)tolower((unsigned char)srcPtr[i]);
+    }
+    destPtr[MAC_ADDRESS_LENGTH] = '\0';
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a normalized MAC address in a list.
+ *
+ * @return The index of the address, or -1 if it is not in the list.
+ */
+//--------------------------------------------------------------------------------------------------
+static int FindMac
+(
+    const MacList_t *listPtr,
+    const char *macAddressPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < listPtr->count; i++)
+    {
+        if (0 == strcmp(listPtr->macs[i], macAddressPtr))
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the access control policy. Default is PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiAcl_SetPolicy
+(
+    pa_wifiAcl_Policy_t policy
+        ///< [IN]
+        ///< Access control policy.
+)
+{
+    Policy = policy;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the access control policy.
+ *
+ * @return The access control policy.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_wifiAcl_Policy_t pa_wifiAcl_GetPolicy
+(
+    void
+)
+{
+    return Policy;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a MAC address to a list.
+ *
+ * @return
+ *      - LE_OK             The address is added.
+ *      - LE_DUPLICATE      The address is already in the list.
+ *      - LE_BAD_PARAMETER  Invalid list or MAC address.
+ *      - LE_NO_MEMORY      The list is full.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAcl_Add
+(
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+)
+{
+    char       macAddress[MAC_ADDRESS_LENGTH + 1];
+    MacList_t *listPtr;
+
+    if ((list < 0) || (list >= PA_WIFIACL_LIST_COUNT) ||
+        (!NormalizeMacAddress(macAddress, macAddressPtr)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    listPtr = &MacLists[list];
+    if (-1 != FindMac(listPtr, macAddress))
+    {
+        return LE_DUPLICATE;
+    }
+    if (listPtr->count >= PA_WIFIACL_MAX_MACS)
+    {
+        LE_WARN("%s full", listPtr->pathPtr);
+        return LE_NO_MEMORY;
+    }
+
+    memcpy(listPtr->macs[listPtr->count], macAddress, sizeof(macAddress));
+    listPtr->count++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a MAC address from a list.
+ *
+ * @return
+ *      - LE_OK             The address is removed.
+ *      - LE_NOT_FOUND      The address is not in the list.
+ *      - LE_BAD_PARAMETER  Invalid list or MAC address.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAcl_Remove
+(
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+)
+{
+    char       macAddress[MAC_ADDRESS_LENGTH + 1];
+    MacList_t *listPtr;
+    int        index;
+
+    if ((list < 0) || (list >= PA_WIFIACL_LIST_COUNT) ||
+        (!NormalizeMacAddress(macAddress, macAddressPtr)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    listPtr = &MacLists[list];
+    index = FindMac(listPtr, macAddress);
+    if (-1 == index)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    // Keep the order of the addresses in the file.
+    listPtr->count--;
+    memmove(listPtr->macs[index], listPtr->macs[index + 1],
+            (listPtr->count - (size_t)index) * sizeof(listPtr->macs[0]));
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the MAC addresses of a list.
+ *
+ * @return
+ *      - LE_OK             The list is empty.
+ *      - LE_BAD_PARAMETER  Invalid list.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAcl_Clear
+(
+    pa_wifiAcl_List_t list
+        ///< [IN]
+        ///< MAC address list.
+)
+{
+    if ((list < 0) || (list >= PA_WIFIACL_LIST_COUNT))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    MacLists[list].count = 0;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a station is allowed by the policy and the lists.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_wifiAcl_IsAllowed
+(
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+)
+{
+    char macAddress[MAC_ADDRESS_LENGTH + 1];
+
+    if (!NormalizeMacAddress(macAddress, macAddressPtr))
+    {
+        return false;
+    }
+
+    if (PA_WIFIACL_POLICY_DENY_UNLESS_ACCEPTED == Policy)
+    {
+        return (-1 != FindMac(&MacLists[PA_WIFIACL_LIST_ACCEPT], macAddress));
+    }
+    return (-1 == FindMac(&MacLists[PA_WIFIACL_LIST_DENY], macAddress));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the access control is used: a list is not empty or the policy is not the default
+ * one.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_wifiAcl_IsUsed
+(
+    void
+)
+{
+    return ((PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED != Policy) ||
+            (0 != MacLists[PA_WIFIACL_LIST_ACCEPT].count) ||
+            (0 != MacLists[PA_WIFIACL_LIST_DENY].count));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of the file of a list, for hostapd.conf.
+ *
+ * @return The path.
+ */
+//--------------------------------------------------------------------------------------------------
+const char *pa_wifiAcl_GetFile
+(
+    pa_wifiAcl_List_t list
+        ///< [IN]
+        ///< MAC address list.
+)
+{
+    LE_ASSERT((list >= 0) && (list < PA_WIFIACL_LIST_COUNT));
+    return MacLists[list].pathPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the files of the lists, unless unchanged.
+ *
+ * @return
+ *      - LE_OK             The files are up to date.
+ *      - LE_FAULT          A file can not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAcl_WriteFiles
+(
+    void
+)
+{
+    int list;
+
+    for (list = 0; list < PA_WIFIACL_LIST_COUNT; list++)
+    {
+        MacList_t           *listPtr = &MacLists[list];
+        pa_wifiConf_Buffer_t content = PA_WIFICONF_BUFFER_INIT;
+        le_result_t          result;
+        size_t               i;
+
+        // hostapd reads one address per line.
+        pa_wifiConf_Append(&content, "# Generated by the WiFi service\n");
+        for (i = 0; i < listPtr->count; i++)
+        {
+            pa_wifiConf_Append(&content, "%s\n", listPtr->macs[i]);
+        }
+
+        result = pa_wifiConf_Write(&listPtr->file, listPtr->pathPtr, &content);
+        pa_wifiConf_Release(&content);
+        if (LE_FAULT == result)
+        {
+            return LE_FAULT;
+        }
+    }
+    return LE_OK;
+}
@@ -0,0 +1,421 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter automatic channel selection
+ *
+ *  Each BSS found by the scan adds to the overlap of the channels it interferes with its signal
+ *  strength above -95 dBm (1 to 60), times 5 on its own channel, decreasing by 1 per channel of
+ *  distance in the 2.4 GHz band, where 20 MHz channels 5 apart do not overlap. The busy time comes
+ *  from the channel survey, when the driver gives it.
+ *
+ *  The candidate channels are the channels of the survey, if any. Else they are 1 to 11 (US, CA)
+ *  or 1 to 13 in the 2.4 GHz band, and the non-DFS channels 36 to 48, and 149 to 165 (US, CA), in
+ *  the 5 GHz band. The channels which the regulatory domain of the radio disables, or on which it
+ *  forbids beaconing or requires radar detection, are then removed: the survey lists them too.
+ *  Ties go to channels 1, 6 and 11, then to the lowest channel.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+#include "pa_wifi_acs.h"
+#include "pa_wifi_nl80211.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of BSS taken into account.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_BSS                     64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Distance from which 2.4 GHz channels do not overlap.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OVERLAP_DISTANCE            5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength weight: dBm above SIGNAL_FLOOR_DBM, between 1 and SIGNAL_WEIGHT_MAX. A BSS of
+ * unknown signal strength gets SIGNAL_WEIGHT_UNKNOWN.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SIGNAL_FLOOR_DBM            (-95)
+#define SIGNAL_WEIGHT_MAX           60
+#define SIGNAL_WEIGHT_UNKNOWN       30
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Score weights of the BSS count and of the busy time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BSS_COUNT_WEIGHT            10
+#define BUSY_PERCENT_WEIGHT         4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default candidate channels.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint16_t Channels5GHz[] = { 36, 40, 44, 48, 149, 153, 157, 161, 165 };
+#define CHANNELS_5GHZ_LOW_COUNT     4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Channel selection context.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                       is5GHz;          ///< Band of the selection.
+    pa_wifiAcs_ChannelScore_t *scoresPtr;       ///< Channel scores.
+    size_t                     count;           ///< Number of channels.
+    pa_wifiNl80211_Bss_t       bss[MAX_BSS];    ///< BSS found by the scan.
+    size_t                     bssCount;        ///< Number of BSS.
+}
+Selection_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a frequency to a channel number of a band.
+ *
+ * @return The channel number, 0 if the frequency is not in the band.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t FrequencyToChannel
+(
+    uint32_t frequency,
+    bool is5GHz
+)
+{
+    if (is5GHz)
+    {
+        return ((frequency >= 5000) && (frequency < 5900)) ? (uint16_t)((frequency - 5000) / 5) : 0;
+    }
+    if (2484 == frequency)
+    {
+        return 14;
+    }
+    return ((frequency >= 2412) && (frequency <= 2472)) ? (uint16_t)((frequency - 2407) / 5) : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a candidate channel, if not already there.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddChannel
+(
+    Selection_t *selectionPtr,
+    uint16_t channel
+)
+{
+    size_t i;
+
+    for (i = 0; i < selectionPtr->count; i++)
+    {
+        if (channel == selectionPtr->scoresPtr[i].channel)
+        {
+            return;
+        }
+    }
+    if (selectionPtr->count < PA_WIFIACS_MAX_CHANNELS)
+    {
+        pa_wifiAcs_ChannelScore_t *scorePtr = &selectionPtr->scoresPtr[selectionPtr->count++];
+
+        memset(scorePtr, 0, sizeof(*scorePtr));
+        scorePtr->channel = channel;
+        scorePtr->busyPercent = PA_WIFIACS_BUSY_UNKNOWN;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the channels of the survey as candidates.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SurveyChannelHandler
+(
+    const pa_wifiNl80211_Survey_t *surveyPtr,
+    void *contextPtr
+)
+{
+    Selection_t *selectionPtr = contextPtr;
+    uint16_t     channel = FrequencyToChannel(surveyPtr->frequency, selectionPtr->is5GHz);
+
+    // Channel 14 is only allowed for 802.11b in Japan.
+    if ((0 != channel) && (14 != channel))
+    {
+        AddChannel(selectionPtr, channel);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a candidate channel on which the access point must not start: disabled, no beaconing
+ * allowed, or radar detection required.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FrequencyHandler
+(
+    const pa_wifiNl80211_Frequency_t *frequencyPtr,
+    void *contextPtr
+)
+{
+    Selection_t *selectionPtr = contextPtr;
+    uint16_t     channel = FrequencyToChannel(frequencyPtr->frequency, selectionPtr->is5GHz);
+    size_t       i;
+
+    if ((0 == channel) ||
+        !(frequencyPtr->isDisabled || frequencyPtr->isNoIr || frequencyPtr->isRadar))
+    {
+        return;
+    }
+    for (i = 0; i < selectionPtr->count; i++)
+    {
+        if (channel == selectionPtr->scoresPtr[i].channel)
+        {
+            LE_DEBUG("Channel %u excluded:%s%s%s", channel,
+                     frequencyPtr->isDisabled ? " disabled" : "",
+                     frequencyPtr->isNoIr ? " no-IR" : "",
+                     frequencyPtr->isRadar ? " radar" : "");
+            selectionPtr->count--;
+            memmove(&selectionPtr->scoresPtr[i], &selectionPtr->scoresPtr[i + 1],
+                    (selectionPtr->count - i) * sizeof(pa_wifiAcs_ChannelScore_t));
+            return;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the busy time of a candidate channel from the survey.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SurveyBusyHandler
+(
+    const pa_wifiNl80211_Survey_t *surveyPtr,
+    void *contextPtr
+)
+{
+    Selection_t *selectionPtr = contextPtr;
+    uint16_t     channel = FrequencyToChannel(surveyPtr->frequency, selectionPtr->is5GHz);
+    size_t       i;
+
+    if (0 == surveyPtr->activeMs)
+    {
+        return;
+    }
+    for (i = 0; i < selectionPtr->count; i++)
+    {
+        if (channel == selectionPtr->scoresPtr[i].channel)
+        {
+            uint64_t busyMs = (surveyPtr->busyMs < surveyPtr->activeMs) ?
+                              surveyPtr->busyMs : surveyPtr->activeMs;
+
+            selectionPtr->scoresPtr[i].busyPercent = (uint8_t)((busyMs * 100) /
+                                                               surveyPtr->activeMs);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keep a BSS found by the scan.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BssHandler
+(
+    const pa_wifiNl80211_Bss_t *bssPtr,
+    void *contextPtr
+)
+{
+    Selection_t *selectionPtr = contextPtr;
+
+    if (selectionPtr->bssCount < MAX_BSS)
+    {
+        selectionPtr->bss[selectionPtr->bssCount++] = *bssPtr;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a BSS to the overlap of the candidate channels.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddBssOverlap
+(
+    Selection_t *selectionPtr,
+    const pa_wifiNl80211_Bss_t *bssPtr
+)
+{
+    uint16_t     bssChannel = FrequencyToChannel(bssPtr->frequency, selectionPtr->is5GHz);
+    int32_t      weight = SIGNAL_WEIGHT_UNKNOWN;
+    size_t       i;
+
+    if (0 == bssChannel)
+    {
+        return;
+    }
+    if (PA_WIFINL80211_SIGNAL_UNKNOWN != bssPtr->signalMbm)
+    {
+        weight = (bssPtr->signalMbm / 100) - SIGNAL_FLOOR_DBM;
+        if (weight < 1)
+        {
+            weight = 1;
+        }
+        else if (weight > SIGNAL_WEIGHT_MAX)
+        {
+            weight = SIGNAL_WEIGHT_MAX;
+        }
+    }
+
+    for (i = 0; i < selectionPtr->count; i++)
+    {
+        pa_wifiAcs_ChannelScore_t *scorePtr = &selectionPtr->scoresPtr[i];
+        int32_t distance = abs((int32_t)scorePtr->channel - (int32_t)bssChannel);
+
+        if (0 == distance)
+        {
+            scorePtr->bssCount++;
+            scorePtr->overlap += (uint32_t)(weight * OVERLAP_DISTANCE);
+        }
+        else if ((!selectionPtr->is5GHz) && (distance < OVERLAP_DISTANCE))
+        {
+            scorePtr->overlap += (uint32_t)(weight * (OVERLAP_DISTANCE - distance));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a channel is one of the non-overlapping 2.4 GHz channels.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPreferredChannel
+(
+    uint16_t channel,
+    bool is5GHz
+)
+{
+    return is5GHz || (1 == channel) || (6 == channel) || (11 == channel);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan, score the allowed channels and select the least congested one.
+ *
+ * @return
+ *      - LE_OK             A channel is selected.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The scan failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAcs_SelectChannel
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    bool is5GHz,
+        ///< [IN]
+        ///< Select a 5 GHz channel, else a 2.4 GHz one.
+    const char *countryCodePtr,
+        ///< [IN]
+        ///< ISO country code.
+    pa_wifiAcs_ChannelScore_t *scoresPtr,
+        ///< [OUT]
+        ///< Channel scores, PA_WIFIACS_MAX_CHANNELS entries.
+    size_t *scoreCountPtr,
+        ///< [OUT]
+        ///< Number of scored channels.
+    uint16_t *channelPtr
+        ///< [OUT]
+        ///< Selected channel.
+)
+{
+    static Selection_t               selection;     // Main thread only, kept off the stack.
+    bool                             isNorthAmerica = ((0 == strcmp(countryCodePtr, "US")) ||
+                                                       (0 == strcmp(countryCodePtr, "CA")));
+    const pa_wifiAcs_ChannelScore_t *bestPtr = NULL;
+    le_result_t                      result;
+    size_t                           i;
+
+    memset(&selection, 0, sizeof(selection));
+    selection.is5GHz = is5GHz;
+    selection.scoresPtr = scoresPtr;
+
+    result = pa_wifiNl80211_Scan(ifNamePtr, PA_WIFIACS_SCAN_TIMEOUT_MS, BssHandler, &selection);
+    if (LE_OK != result)
+    {
+        LE_ERROR("Unable to scan on %s", ifNamePtr);
+        return result;
+    }
+
+    pa_wifiNl80211_GetSurvey(ifNamePtr, SurveyChannelHandler, &selection);
+    if (0 == selection.count)
+    {
+        if (is5GHz)
+        {
+            size_t count = isNorthAmerica ? NUM_ARRAY_MEMBERS(Channels5GHz) :
+                                            CHANNELS_5GHZ_LOW_COUNT;
+
+            for (i = 0; i < count; i++)
+            {
+                AddChannel(&selection, Channels5GHz[i]);
+            }
+        }
+        else
+        {
+            uint16_t channel;
+
+            for (channel = 1; channel <= (isNorthAmerica ? 11 : 13); channel++)
+            {
+                AddChannel(&selection, channel);
+            }
+        }
+    }
+    if (LE_OK != pa_wifiNl80211_GetFrequencies(ifNamePtr, is5GHz, FrequencyHandler, &selection))
+    {
+        LE_WARN("Regulatory restrictions of the channels unknown");
+    }
+    pa_wifiNl80211_GetSurvey(ifNamePtr, SurveyBusyHandler, &selection);
+
+    for (i = 0; i < selection.bssCount; i++)
+    {
+        AddBssOverlap(&selection, &selection.bss[i]);
+    }
+
+    for (i = 0; i < selection.count; i++)
+    {
+        pa_wifiAcs_ChannelScore_t *scorePtr = &scoresPtr[i];
+
+        scorePtr->score = (BSS_COUNT_WEIGHT * scorePtr->bssCount) + scorePtr->overlap;
+        if (PA_WIFIACS_BUSY_UNKNOWN != scorePtr->busyPercent)
+        {
+            scorePtr->score += BUSY_PERCENT_WEIGHT * scorePtr->busyPercent;
+        }
+        LE_DEBUG("Channel %u: %u BSS, overlap %u, busy %u%%, score %u", scorePtr->channel,
+                 scorePtr->bssCount, scorePtr->overlap, scorePtr->busyPercent, scorePtr->score);
+
+        if ((NULL == bestPtr) || (scorePtr->score < bestPtr->score) ||
+            ((scorePtr->score == bestPtr->score) &&
+             IsPreferredChannel(scorePtr->channel, is5GHz) &&
+             !IsPreferredChannel(bestPtr->channel, is5GHz)))
+        {
+            bestPtr = scorePtr;
+        }
+    }
+
+    if (NULL == bestPtr)
+    {
+        LE_ERROR("No channel to select");
+        return LE_FAULT;
+    }
+
+    *scoreCountPtr = selection.count;
+    *channelPtr = bestPtr->channel;
+    LE_INFO("Channel %u selected, score %u", bestPtr->channel, bestPtr->score);
+    return LE_OK;
+}
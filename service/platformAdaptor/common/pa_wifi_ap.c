@@ -6,48 +6,82 @@
  *
  */
 // -------------------------------------------------------------------------------------------------
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <ctype.h>
 #include <arpa/inet.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_wifi_ap.h"
+#include "pa_wifi_cmd.h"
+#include "pa_wifi_hostapd.h"
+#include "pa_wifi_nl80211.h"
+#include "pa_wifi_ring.h"
+#include "pa_wifi_stats.h"
+#include "pa_wifi_dhcp.h"
+#include "pa_wifi_acs.h"
+#include "pa_wifi_conf.h"
+#include "pa_wifi_radio.h"
+#include "pa_wifi_acl.h"
+#include "pa_wifi_proc.h"
+#include "pa_wifi_simu.h"
 
 // Set of commands to drive the WiFi features.
-#define COMMAND_WIFI_HW_START        "WIFI_START"
-#define COMMAND_WIFI_HW_STOP         "WIFI_STOP"
-#define COMMAND_WIFI_SET_EVENT       "WIFI_SET_EVENT"
-#define COMMAND_WIFI_UNSET_EVENT     "WIFI_UNSET_EVENT"
 #define COMMAND_WIFIAP_HOSTAPD_START "WIFIAP_HOSTAPD_START"
-#define COMMAND_WIFIAP_HOSTAPD_STOP  "WIFIAP_HOSTAPD_STOP"
 #define COMMAND_WIFIAP_WLAN_UP       "WIFIAP_WLAN_UP"
+#define COMMAND_WIFIAP_BSS_UP        "WIFIAP_BSS_UP"
+#define COMMAND_WIFIAP_BSS_DOWN      "WIFIAP_BSS_DOWN"
+
+// Name of the soft restart and of the automatic channel selection in the command statistics.
+#define COMMAND_WIFIAP_SOFT_RESTART  "WIFIAP_SOFT_RESTART"
+#define COMMAND_WIFIAP_ACS           "WIFIAP_ACS"
 
 // iptables rule to allow/disallow the DHCP port on WLAN interface
 #define COMMAND_IPTABLE_DHCP_INSERT  "IPTABLE_DHCP_INSERT"
 #define COMMAND_IPTABLE_DHCP_DELETE  "IPTABLE_DHCP_DELETE"
 #define COMMAND_DNSMASQ_RESTART       "DNSMASQ_RESTART"
+#define COMMAND_DNSMASQ_WLAN_START    "DNSMASQ_WLAN_START"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WiFi platform adaptor shell script
+ * Link to the dnsmasq related configuration file
+ */
+//--------------------------------------------------------------------------------------------------
+#define DNSMASQ_CFG_LINK "/etc/dnsmasq.d/dnsmasq.wlan.conf"
+//--------------------------------------------------------------------------------------------------
+/**
+ * dnsmasq related configuration file
  */
 //--------------------------------------------------------------------------------------------------
-#define WIFI_SCRIPT_PATH "/legato/systems/current/apps/wifiService/read-only/pa_wifi "
+#define DNSMASQ_CFG_FILE "/tmp/dnsmasq.wlan.conf"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Link to the dnsmasq related configuration file
+ * Lease files of the dedicated dnsmasq instance of the PA script, formatted with the interface
+ * name, and of the system dnsmasq
  */
 //--------------------------------------------------------------------------------------------------
-#define DNSMASQ_CFG_LINK "/etc/dnsmasq.d/dnsmasq.wlan.conf"
+#define DNSMASQ_LEASE_FILE_FORMAT   "/tmp/dnsmasq.%s.leases"
+#define DNSMASQ_SYSTEM_LEASE_FILE   "/var/lib/misc/dnsmasq.leases"
+
 //--------------------------------------------------------------------------------------------------
 /**
- * dnsmasq related configuration file
+ * Pid files of the dedicated dnsmasq instance and of hostapd, written by the PA script commands
+ * starting them. Both are formatted with the interface name.
  */
 //--------------------------------------------------------------------------------------------------
-#define DNSMASQ_CFG_FILE "/tmp/dnsmasq.wlan.conf"
+#define DNSMASQ_PID_FILE_FORMAT     "/var/run/dnsmasq.%s.pid"
+#define HOSTAPD_PID_FILE_FORMAT     "/var/run/hostapd.%s.pid"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease time of the DHCP ranges, in hours
+ */
+//--------------------------------------------------------------------------------------------------
+#define DNSMASQ_LEASE_HOURS 24
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -56,6 +90,15 @@
 //--------------------------------------------------------------------------------------------------
 #define WIFI_HOSTAPD_FILE "/tmp/hostapd.conf"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limits of the beacon interval, DTIM period and WMM parameters accepted by hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_BEACON_INTERVAL 15
+#define MAX_WMM_AIFS        15
+#define MAX_WMM_ECW         15
+
 // WiFi access point configuration.
 //--------------------------------------------------------------------------------------------------
 /**
@@ -65,13 +108,21 @@
 #define HOSTAPD_CONFIG_COMMON \
     "driver=nl80211\n"\
     "wmm_enabled=1\n"\
-    "beacon_int=100\n"\
-    "dtim_period=2\n"\
     "rts_threshold=2347\n"\
     "fragm_threshold=2346\n"\
     "ctrl_interface=/var/run/hostapd\n"\
     "ctrl_interface_group=0\n"
 //--------------------------------------------------------------------------------------------------
+/**
+ * Host access point configuration of an additional BSS, which does not inherit the settings of
+ * the main one.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_CONFIG_BSS \
+    "wmm_enabled=1\n"\
+    "ctrl_interface=/var/run/hostapd\n"\
+    "ctrl_interface_group=0\n"
+//--------------------------------------------------------------------------------------------------
 /**
  * Host access point configuration with security disabled.
  */
@@ -79,8 +130,7 @@
 #define HOSTAPD_CONFIG_SECURITY_NONE \
     "auth_algs=1\n"\
     "eap_server=0\n"\
-    "eapol_key_index_workaround=0\n"\
-    "macaddr_acl=0\n"
+    "eapol_key_index_workaround=0\n"
 //--------------------------------------------------------------------------------------------------
 /**
  * Host access point configuration with security enabled.
@@ -99,6 +149,31 @@
 //--------------------------------------------------------------------------------------------------
 #define WIFI_MAX_USERS 10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station events printed by iw event: "<interface> (phy #<n>): new station <MAC address>"
+ */
+//--------------------------------------------------------------------------------------------------
+#define IW_EVENT_NEW_STATION "new station "
+#define IW_EVENT_DEL_STATION "del station "
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disconnection reason code, when the event line has one: "... reason: <code>"
+ */
+//--------------------------------------------------------------------------------------------------
+#define IW_EVENT_REASON      "reason: "
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum time to wait for hostapd to terminate on a stop or a soft restart, and for the dedicated
+ * dnsmasq instance to terminate on a stop, in ms. They are killed after it. The wait blocks the
+ * main thread, on the pidfd of the process, so it is kept short.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_TERMINATE_TIMEOUT_MS 500
+#define DNSMASQ_TERMINATE_TIMEOUT_MS 500
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hardware mode mask
@@ -108,10 +183,18 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum numbers of bytes in temporary string written to hostapd.conf
+ * Bits of the HT and VHT capabilities info reported by the driver.
  */
 //--------------------------------------------------------------------------------------------------
-#define TEMP_STRING_MAX_BYTES 1024
+#define HT_CAPA_LDPC                0x0001
+#define HT_CAPA_40MHZ               0x0002
+#define HT_CAPA_SHORT_GI_20         0x0020
+#define HT_CAPA_SHORT_GI_40         0x0040
+#define VHT_CAPA_RX_LDPC            0x00000010
+#define VHT_CAPA_SHORT_GI_80        0x00000020
+#define VHT_CAPA_AMPDU_EXP_SHIFT    23
+#define VHT_CAPA_AMPDU_EXP_MASK     0x7
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The current security protocol
@@ -161,12 +244,70 @@ static bool                         SavedDiscoverable                     = true
  */
 //--------------------------------------------------------------------------------------------------
 static uint16_t                     SavedChannelNumber                    = 6;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automatic channel selection: enabled, channel selected at the last start (0 if none) and scores
+ * of the channels.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool                      IsAutoChannel = false;
+static uint16_t                  SelectedChannel = 0;
+static pa_wifiAcs_ChannelScore_t ChannelScores[PA_WIFIACS_MAX_CHANNELS];
+static size_t                    ChannelScoreCount = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Channel of the client at the last start in concurrent mode, 0 if it was not connected. The radio
+ * operates on one channel, which the access point must share.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t                  ClientChannel = 0;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Channel width and HT/VHT options (PA_WIFIAP_HT_* bits), and capabilities of the band of the
+ * radio, read when the access point starts.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiAp_ChannelWidth_t  SavedChannelWidth = PA_WIFIAP_CHANNEL_WIDTH_20;
+static uint32_t                  SavedHtOptions = 0;
+static bool                      IsBandCapaKnown = false;
+static pa_wifiNl80211_BandCapa_t BandCapa;
 //--------------------------------------------------------------------------------------------------
 /**
  * The maximum numbers of clients the AP is able to manage
  */
 //--------------------------------------------------------------------------------------------------
 static uint32_t                     SavedMaxNumClients                    = WIFI_MAX_USERS;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Beacon interval (TU), DTIM period (beacons) and maximum inactivity of a station (s).
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t                     SavedBeaconInterval                   = 100;
+static uint8_t                      SavedDtimPeriod                       = 2;
+static uint32_t                     SavedMaxInactivity                    = 300;
+//--------------------------------------------------------------------------------------------------
+/**
+ * EDCA parameters of the WMM access categories, written to hostapd.conf once set.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                  isSet;        ///< The parameters were set, hostapd defaults otherwise.
+    pa_wifiAp_WmmParams_t params;       ///< EDCA parameters.
+}
+WmmAcConfig_t;
+
+static WmmAcConfig_t SavedWmmAcConfig[PA_WIFIAP_WMM_AC_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of each access category in the wmm_ac_* parameters of hostapd, and index of its transmit
+ * queue in the tx_queue_data* parameters.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char   *WmmAcNames[PA_WIFIAP_WMM_AC_COUNT]      = { "be", "bk", "vi", "vo" };
+static const uint8_t WmmAcTxQueues[PA_WIFIAP_WMM_AC_COUNT]   = { 2, 3, 1, 0 };
 
 // WPA-Personal
 //--------------------------------------------------------------------------------------------------
@@ -184,1032 +325,2851 @@ static char SavedPreSharedKey[LE_WIFIDEFS_MAX_PSK_BYTES]      = "";
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The main thread running the WiFi service
+ * DHCP server of the WLAN.
  */
 //--------------------------------------------------------------------------------------------------
-static void            *WifiApPaThreadMain(void *contextPtr);
+typedef enum
+{
+    DHCP_SERVER_NONE,       ///< Not started.
+    DHCP_SERVER_DEDICATED,  ///< Dedicated dnsmasq instance, restarted alone.
+    DHCP_SERVER_SYSTEM      ///< System dnsmasq, through DNSMASQ_CFG_LINK.
+}
+DhcpServer_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
- * The handle of the WiFi service thread
+ * DHCP server currently serving the WLAN.
  */
 //--------------------------------------------------------------------------------------------------
-static le_thread_Ref_t  WifiApPaThread  = NULL;
+static DhcpServer_t DhcpServer = DHCP_SERVER_NONE;
+
 //--------------------------------------------------------------------------------------------------
 /**
- * The handle of the input pipe used to be notified of the WiFi related events.
+ * Pid file of the dedicated dnsmasq instance, kept from its start so that it is stopped even if
+ * the interface of the access point changed since.
  */
 //--------------------------------------------------------------------------------------------------
-static FILE            *IwThreadPipePtr = NULL;
+static char DnsmasqPidFile[PATH_MAX] = "";
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WifiAp state event ID used to report WifiAp state events to the registered event handlers.
+ * IP address of the access point and client IP addresses range, set by pa_wifiAp_SetIpRange().
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t    WifiApPaEvent;
+static char SavedIpAp[INET_ADDRSTRLEN] = "";
+static char SavedIpStart[INET_ADDRSTRLEN] = "";
+static char SavedIpStop[INET_ADDRSTRLEN] = "";
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Thread destructor
+ * Additional BSS of the access point. The main BSS, index 0, uses the settings above and its
+ * entry is not used.
  */
 //--------------------------------------------------------------------------------------------------
-static void ThreadDestructor
-(
-    void *contextPtr
-)
+typedef struct
 {
-    int status;
+    bool                  isEnabled;                            ///< The BSS is configured.
+    bool                  isUp;                                 ///< Its address is set.
+    char                  ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES]; ///< Interface created by hostapd.
+    pa_wifiAp_BssConfig_t config;                               ///< Settings.
+    char                  ipAp[INET_ADDRSTRLEN];                ///< Address, empty if none.
+    char                  ipStart[INET_ADDRSTRLEN];             ///< First client address.
+    char                  ipStop[INET_ADDRSTRLEN];              ///< Last client address.
+}
+Bss_t;
 
-    // Kill the script launched by popen() in PA thread
-    status = system(WIFI_SCRIPT_PATH COMMAND_WIFI_UNSET_EVENT);
+static Bss_t BssTable[PA_WIFIAP_MAX_BSS];
 
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
-    {
-        LE_ERROR("Unable to kill the WIFI events script");
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last write of the dnsmasq related configuration file.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiConf_File_t DnsmasqConfFile = PA_WIFICONF_FILE_INIT;
 
-    if (IwThreadPipePtr)
-    {
-        // And close the communication pipe used in created thread.
-        pclose(IwThreadPipePtr);
-        IwThreadPipePtr = NULL;
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last write of hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiConf_File_t HostapdConfFile = PA_WIFICONF_FILE_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the addresses of the additional BSS and serve their DHCP ranges, once hostapd created their
+ * interfaces.
+ */
+//--------------------------------------------------------------------------------------------------
+static void             ApplyBssIpRanges(void);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the DHCP server of the WLAN.
+ */
+//--------------------------------------------------------------------------------------------------
+static void             StopDhcpServer(void);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of handlers of each PA event.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_HANDLER_MAX_COUNT     4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the access point events.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiAp_NewEventHandlerFunc_t handlerFuncPtr;    ///< Handler function.
+    void                           *contextPtr;        ///< Handler context.
+}
+EventHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the station events.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiAp_StationEventHandlerFunc_t handlerFuncPtr;    ///< Handler function.
+    void                               *contextPtr;        ///< Handler context.
+}
+StationEventHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registered event handlers. The events are dispatched to them straight from the event ring, on
+ * the main thread, so that no event is allocated or queued again.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventHandler_t        EventHandlers[EVENT_HANDLER_MAX_COUNT];
+static uint32_t              EventHandlerCount = 0;
+static StationEventHandler_t StationEventHandlers[EVENT_HANDLER_MAX_COUNT];
+static uint32_t              StationEventHandlerCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interface of the access point, given by the radio module. Main thread only.
+ */
+//--------------------------------------------------------------------------------------------------
+static char             ApIfName[LE_WIFIDEFS_MAX_IFNAME_BYTES] = "";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the access point is started, so that the parameter changes must be applied to the
+ * running hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool             IsApStarted = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How a parameter change is applied to the running hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    APPLY_SET,          ///< Used as is by hostapd, ex: on the next association.
+    APPLY_BEACON,       ///< Beacon update, the stations stay connected.
+    APPLY_RELOAD        ///< Configuration reload, the stations are disconnected.
+}
+ApplyMode_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameter of the running hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char *namePtr;    ///< hostapd.conf name.
+    const char *valuePtr;   ///< Value.
 }
+Parameter_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A parameter which hostapd only reads at startup changed since the access point was started:
+ * the next pa_wifiAp_Restart() must restart hostapd, even if hostapd.conf was already written by
+ * a parameter applied to the running hostapd.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRestartPending = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capacity of the ring carrying the events from the event thread to the main thread. The
+ * simulated stations may all leave at once at stop, while the main thread waits for the generator.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifdef SIMU
+#define EVENT_QUEUE_MAX_COUNT   (2 * PA_WIFISIMU_MAX_STATIONS)
+#else
+#define EVENT_QUEUE_MAX_COUNT   32
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring carrying the events from the event thread to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_wifiRing_Ref_t EventRing;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The first-layer WiFi Client Event Handler.
+ * Main thread side of the event ring: report an event to the registered handlers.
  *
+ * The handlers get the event in the ring slot, which is only valid during the call.
  */
 //--------------------------------------------------------------------------------------------------
-static void FirstLayerWifiApEventHandler
+static void EventRingHandler
 (
-    void *reportPtr,
-    void *secondLayerHandlerFunc
+    void *elemPtr,
+    void *contextPtr
 )
 {
-    pa_wifiAp_NewEventHandlerFunc_t  ApHandlerFunc = secondLayerHandlerFunc;
-    le_wifiAp_Event_t               *wifiEventPtr  = (le_wifiAp_Event_t *)reportPtr;
+    pa_wifiAp_StationEvent_t *stationEventPtr = elemPtr;
+    uint32_t                  i;
+
+    stationEventPtr->bssIndex = pa_wifiAp_GetBssIndex(stationEventPtr->ifName);
 
-    if (NULL != wifiEventPtr)
+    LE_INFO("Event: %d", stationEventPtr->event);
+    for (i = 0; i < EventHandlerCount; i++)
     {
-        LE_INFO("Event: %d", *wifiEventPtr);
-        ApHandlerFunc(*wifiEventPtr, le_event_GetContextPtr());
+        EventHandlers[i].handlerFuncPtr(stationEventPtr->event, EventHandlers[i].contextPtr);
     }
-    else
+    for (i = 0; i < StationEventHandlerCount; i++)
     {
-        LE_ERROR("Event is NULL");
+        StationEventHandlers[i].handlerFuncPtr(stationEventPtr,
+                                               StationEventHandlers[i].contextPtr);
     }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WiFi access point platform adaptor thread
+ * Report a station event from the event thread, unless the event ring is full.
  *
+ * The interface is the first word of the iw event line, the station MAC address follows the
+ * event keyword and the reason code, if any, follows IW_EVENT_REASON.
  */
 //--------------------------------------------------------------------------------------------------
-static void *WifiApPaThreadMain
+static void ReportEvent
 (
-    void *contextPtr
+    le_wifiAp_Event_t event,
+    const char *linePtr,
+    const char *keywordPtr,
+    le_clk_Time_t captureTime
 )
 {
-    char path[1024];
+    pa_wifiAp_StationEvent_t stationEvent;
+    const char              *macPtr = strstr(linePtr, keywordPtr) + strlen(keywordPtr);
+    const char              *reasonPtr = strstr(macPtr, IW_EVENT_REASON);
+    size_t                   length;
 
-    LE_INFO("Wifi event report thread started!");
+    memset(&stationEvent, 0, sizeof(stationEvent));
+    stationEvent.event = event;
+    stationEvent.captureTime = captureTime;
 
-    // Open the command "iw events" for reading.
-    IwThreadPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFI_SET_EVENT, "r");
-
-    if (NULL == IwThreadPipePtr)
+    length = strcspn(linePtr, " :");
+    if (length < sizeof(stationEvent.ifName))
     {
-        LE_ERROR("Failed to run command:\"%s\" errno:%d %s",
-                 COMMAND_WIFI_SET_EVENT,
-                 errno,
-                 LE_ERRNO_TXT(errno));
-        return NULL;
+        memcpy(stationEvent.ifName, linePtr, length);
     }
 
-    // Read the output a line at a time - output it.
-    while (NULL != fgets(path, sizeof(path)-1, IwThreadPipePtr))
+    for (length = 0; length < (sizeof(stationEvent.macAddress) - 1); length++)
     {
-        LE_INFO("PARSING:%s: len:%d", path, (int) strnlen(path, sizeof(path)-1));
-        if (NULL != strstr(path, "new station"))
-        {
-            LE_INFO("FOUND new station");
-            // Report event: LE_WIFIAP_EVENT_CONNECTED
-            le_wifiAp_Event_t event = LE_WIFIAP_EVENT_CLIENT_CONNECTED;
-            LE_INFO( "InternalWifiApStateEvent event: %d ", event);
-            le_event_Report(WifiApPaEvent , (void *)&event, sizeof(le_wifiAp_Event_t));
-        }
-        else if (NULL != strstr(path, "del station"))
+        if (!isxdigit((unsigned char)macPtr[length]) && (':' != macPtr[length]))
         {
-            LE_INFO("FOUND del station");
-            // Report event: LE_WIFIAP_EVENT_DISCONNECTED
-            le_wifiAp_Event_t event = LE_WIFIAP_EVENT_CLIENT_DISCONNECTED;
-            LE_INFO("InternalWifiApStateEvent event: %d ", event);
-            le_event_Report(WifiApPaEvent , (void *)&event, sizeof(le_wifiAp_Event_t));
+            break;
         }
+        stationEvent.macAddress[length] = tolower((unsigned char)macPtr[length]);
+    }
+
+    if (NULL != reasonPtr)
+    {
+        stationEvent.reason = (uint16_t)strtoul(reasonPtr + strlen(IW_EVENT_REASON), NULL, 10);
+    }
+
+    LE_INFO("InternalWifiApStateEvent event: %d, interface: %s, station: %s, reason: %u",
+            event, stationEvent.ifName, stationEvent.macAddress, stationEvent.reason);
+    if (LE_OK != pa_wifiRing_Push(EventRing, &stationEvent))
+    {
+        LE_WARN("Event queue full, event %d dropped", event);
     }
-    // Run the event loop
-    le_event_RunLoop();
-    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function handles AP configuration file related operations.
+ * Handler of the iw event lines of the access point interfaces, called by the event thread.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WriteApCfgFile
+static void ApEventHandler
 (
-    const char *dataPtr,
-    FILE *filePtr
+    const char *linePtr,
+    le_clk_Time_t captureTime
 )
 {
-    size_t length;
-
-    if ((NULL == filePtr) || (NULL == dataPtr))
+    LE_INFO("PARSING:%s: len:%d", linePtr, (int) strlen(linePtr));
+    if (NULL != strstr(linePtr, IW_EVENT_NEW_STATION))
     {
-        LE_ERROR("Invalid parameter(s)");
-        return LE_FAULT;
+        LE_INFO("FOUND new station");
+        // Report event: LE_WIFIAP_EVENT_CONNECTED
+        ReportEvent(LE_WIFIAP_EVENT_CLIENT_CONNECTED, linePtr, IW_EVENT_NEW_STATION, captureTime);
     }
-
-    length = strlen(dataPtr);
-    if (length > 0)
+    else if (NULL != strstr(linePtr, IW_EVENT_DEL_STATION))
     {
-        if (fwrite(dataPtr, 1, length, filePtr) != length)
-        {
-            LE_ERROR("Unable to generate the hostapd file.");
-            return LE_FAULT;
-        }
+        LE_INFO("FOUND del station");
+        // Report event: LE_WIFIAP_EVENT_DISCONNECTED
+        ReportEvent(LE_WIFIAP_EVENT_CLIENT_DISCONNECTED, linePtr, IW_EVENT_DEL_STATION,
+                    captureTime);
     }
-
-    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function writes configuration to hostapd.conf.
+ * Append the security parameters of a BSS to hostapd.conf.
  *
- * @return LE_FAULT  The function failed.
+ * @return LE_FAULT  The security parameters are missing or invalid.
  * @return LE_OK     The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GenerateHostapdConf
+static le_result_t AppendSecurity
 (
-    void
+    pa_wifiConf_Buffer_t *configPtr,
+    le_wifiAp_SecurityProtocol_t securityProtocol,
+    const char *passphrasePtr,
+    const char *preSharedKeyPtr
 )
 {
-    char        tmpConfig[TEMP_STRING_MAX_BYTES];
-    le_result_t result = LE_FAULT;
-    FILE        *configFilePtr  = NULL;
-
-    configFilePtr = fopen(WIFI_HOSTAPD_FILE, "w");
-    if (NULL ==  configFilePtr)
-    {
-        LE_ERROR("Unable to create hostapd.conf file.");
-        return LE_FAULT;
-    }
-
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
-    // prepare SSID, channel, country code etc in hostapd.conf
-    snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_COMMON
-            "ssid=%s\nchannel=%d\nmax_num_sta=%d\ncountry_code=%s\nignore_broadcast_ssid=%d\n"),
-            (char *)SavedSsid,
-            SavedChannelNumber,
-            SavedMaxNumClients,
-            (char *)SavedCountryCode,
-            !SavedDiscoverable);
-    // Write common config such as SSID, channel, country code, etc in hostapd.conf
-    tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
-    if (LE_OK != WriteApCfgFile(tmpConfig, configFilePtr))
-    {
-        LE_ERROR("Unable to set SSID, channel, etc in hostapd.conf");
-        goto error;
-    }
-
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
-    // Write security parameters in hostapd.conf
-    switch (SavedSecurityProtocol)
+    switch (securityProtocol)
     {
         case LE_WIFIAP_SECURITY_NONE:
             LE_DEBUG("LE_WIFIAP_SECURITY_NONE");
-            result = WriteApCfgFile(HOSTAPD_CONFIG_SECURITY_NONE, configFilePtr);
-            break;
+            pa_wifiConf_Append(configPtr, "%s", HOSTAPD_CONFIG_SECURITY_NONE);
+            return LE_OK;
 
         case LE_WIFIAP_SECURITY_WPA2:
             LE_DEBUG("LE_WIFIAP_SECURITY_WPA2");
-            if ('\0' != SavedPassphrase[0])
-            {
-                snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_SECURITY_WPA2
-                        "wpa_passphrase=%s\n"), SavedPassphrase);
-                tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
-                result = WriteApCfgFile(tmpConfig, configFilePtr);
-            }
-            else if ('\0' != SavedPreSharedKey[0])
+            if ('\0' != passphrasePtr[0])
             {
-                snprintf(tmpConfig, sizeof(tmpConfig), (HOSTAPD_CONFIG_SECURITY_WPA2
-                        "wpa_psk=%s\n"), SavedPreSharedKey);
-                tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
-                result = WriteApCfgFile(tmpConfig, configFilePtr);
+                pa_wifiConf_Append(configPtr, (HOSTAPD_CONFIG_SECURITY_WPA2
+                        "wpa_passphrase=%s\n"), passphrasePtr);
+                return LE_OK;
             }
-            else
+            else if ('\0' != preSharedKeyPtr[0])
             {
-                LE_ERROR("Security protocol is missing!");
-                result = LE_FAULT;
+                pa_wifiConf_Append(configPtr, (HOSTAPD_CONFIG_SECURITY_WPA2
+                        "wpa_psk=%s\n"), preSharedKeyPtr);
+                return LE_OK;
             }
-            break;
+            LE_ERROR("Security protocol is missing!");
+            return LE_FAULT;
 
         default:
             LE_ERROR("Unsupported security protocol!");
-            result = LE_FAULT;
-            break;
+            return LE_FAULT;
     }
+}
 
-    // Write security parameters in hostapd.conf
-    if (LE_OK != result)
-    {
-        LE_ERROR("Unable to set security parameters in hostapd.conf");
-        goto error;
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the interface name of an additional BSS, derived from the main interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetBssIfName
+(
+    uint8_t bssIndex
+)
+{
+    snprintf(BssTable[bssIndex].ifName, sizeof(BssTable[bssIndex].ifName), "%s_%u",
+             ApIfName, bssIndex);
+}
 
-    // prepare IEEE std including hardware mode into hostapd.conf
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
-    switch( SavedIeeeStdMask & HARDWARE_MODE_MASK )
-    {
-        case LE_WIFIAP_BITMASK_IEEE_STD_A:
-            le_utf8_Copy(tmpConfig, "hw_mode=a\n", sizeof(tmpConfig), NULL);
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_B:
-            le_utf8_Copy(tmpConfig, "hw_mode=b\n", sizeof(tmpConfig), NULL);
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_G:
-            le_utf8_Copy(tmpConfig, "hw_mode=g\n", sizeof(tmpConfig), NULL);
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
-            le_utf8_Copy(tmpConfig, "hw_mode=ad\n", sizeof(tmpConfig), NULL);
-            break;
-        default:
-            le_utf8_Copy(tmpConfig, "hw_mode=g\n", sizeof(tmpConfig), NULL);
-            break;
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the address of the interface of an additional BSS, and allow the DHCP ports on it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetBssAddress
+(
+    Bss_t *bssPtr
+)
+{
+    char cmd[128];
+    int  status;
 
-    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_D )
+    snprintf(cmd, sizeof(cmd), "%s %s %s", COMMAND_WIFIAP_BSS_UP, bssPtr->ifName, bssPtr->ipAp);
+    status = pa_wifiCmd_Run(cmd, NULL, 0);
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
     {
-        le_utf8_Append(tmpConfig, "ieee80211d=1\n", sizeof(tmpConfig), NULL);
+        LE_WARN("Unable to set the address of %s", bssPtr->ifName);
+        return;
     }
-    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_H )
+    bssPtr->isUp = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the DHCP port rules of the interfaces of the additional BSS.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearBssAddresses
+(
+    void
+)
+{
+    char    cmd[128];
+    uint8_t bssIndex;
+
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
     {
-        le_utf8_Append(tmpConfig, "ieee80211h=1\n", sizeof(tmpConfig), NULL);
+        Bss_t *bssPtr = &BssTable[bssIndex];
+
+        if (bssPtr->isUp)
+        {
+            snprintf(cmd, sizeof(cmd), "%s %s", COMMAND_WIFIAP_BSS_DOWN, bssPtr->ifName);
+            pa_wifiCmd_Run(cmd, NULL, 0);
+            bssPtr->isUp = false;
+        }
     }
-    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_N )
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the EDCA parameters of the access categories set to hostapd.conf: advertised to the
+ * stations (wmm_ac_*) and used by the access point for its transmit queues (tx_queue_data*). They
+ * are shared by all the BSS.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendWmmParams
+(
+    pa_wifiConf_Buffer_t *configPtr
+)
+{
+    int ac;
+
+    for (ac = 0; ac < PA_WIFIAP_WMM_AC_COUNT; ac++)
     {
-        // hw_mode=b does not support ieee80211n, but driver can handle it
-        le_utf8_Append(tmpConfig, "ieee80211n=1\n", sizeof(tmpConfig), NULL);
+        const pa_wifiAp_WmmParams_t *paramsPtr = &SavedWmmAcConfig[ac].params;
+        const char                  *namePtr = WmmAcNames[ac];
+        unsigned int                 queue = WmmAcTxQueues[ac];
+        // The burst of a transmit queue is the TXOP limit in ms, with one decimal.
+        unsigned int                 burst = ((unsigned int)paramsPtr->txopLimit * 32 + 50) / 100;
+        // A transmit queue takes no empty contention window: an exponent of 0 gives CW 1.
+        unsigned int                 cwMin = (paramsPtr->ecwMin > 0) ?
+                                             (1u << paramsPtr->ecwMin) - 1 : 1;
+        unsigned int                 cwMax = (paramsPtr->ecwMax > 0) ?
+                                             (1u << paramsPtr->ecwMax) - 1 : 1;
+
+        if (!SavedWmmAcConfig[ac].isSet)
+        {
+            continue;
+        }
+
+        pa_wifiConf_Append(configPtr,
+                "wmm_ac_%s_aifs=%u\nwmm_ac_%s_cwmin=%u\nwmm_ac_%s_cwmax=%u\n"
+                "wmm_ac_%s_txop_limit=%u\n",
+                namePtr, paramsPtr->aifs, namePtr, paramsPtr->ecwMin,
+                namePtr, paramsPtr->ecwMax, namePtr, paramsPtr->txopLimit);
+        pa_wifiConf_Append(configPtr,
+                "tx_queue_data%u_aifs=%u\ntx_queue_data%u_cwmin=%u\n"
+                "tx_queue_data%u_cwmax=%u\ntx_queue_data%u_burst=%u.%u\n",
+                queue, paramsPtr->aifs, queue, cwMin,
+                queue, cwMax, queue, burst / 10, burst % 10);
     }
-    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the channel width and the HT/VHT options against the capabilities of a band.
+ *
+ * @return LE_UNSUPPORTED   The band does not support them.
+ * @return LE_OK            They are supported.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckHtConfig
+(
+    pa_wifiAp_ChannelWidth_t width,
+    uint32_t options,
+    const pa_wifiNl80211_BandCapa_t *capaPtr
+)
+{
+    uint16_t shortGiCapa = (PA_WIFIAP_CHANNEL_WIDTH_20 == width) ? HT_CAPA_SHORT_GI_20 :
+                                                                   HT_CAPA_SHORT_GI_40;
+
+    if (!capaPtr->isHt)
     {
-        le_utf8_Append(tmpConfig, "ieee80211ac=1\n", sizeof(tmpConfig), NULL);
+        LE_WARN("HT not supported by the radio");
+        return LE_UNSUPPORTED;
     }
-    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AX )
+    if ((width >= PA_WIFIAP_CHANNEL_WIDTH_40) && !(capaPtr->htCapa & HT_CAPA_40MHZ))
     {
-        le_utf8_Append(tmpConfig, "ieee80211ax=1\n", sizeof(tmpConfig), NULL);
+        LE_WARN("40 MHz not supported by the radio");
+        return LE_UNSUPPORTED;
     }
-    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_W )
+    if (((PA_WIFIAP_CHANNEL_WIDTH_80 == width) || (options & PA_WIFIAP_HT_MAX_AMPDU)) &&
+        !capaPtr->isVht)
     {
-        le_utf8_Append(tmpConfig, "ieee80211w=1\n", sizeof(tmpConfig), NULL);
+        LE_WARN("VHT not supported by the radio");
+        return LE_UNSUPPORTED;
     }
-    // Write IEEE std in hostapd.conf
-    tmpConfig[TEMP_STRING_MAX_BYTES - 1] = '\0';
-    if (LE_OK != WriteApCfgFile(tmpConfig, configFilePtr))
+    if ((options & PA_WIFIAP_HT_SHORT_GI) &&
+        (((PA_WIFIAP_CHANNEL_WIDTH_80 == width) && !(capaPtr->vhtCapa & VHT_CAPA_SHORT_GI_80)) ||
+         ((PA_WIFIAP_CHANNEL_WIDTH_80 != width) && !(capaPtr->htCapa & shortGiCapa))))
     {
-        LE_ERROR("Unable to set IEEE std in hostapd.conf");
-        goto error;
+        LE_WARN("Short guard interval not supported by the radio");
+        return LE_UNSUPPORTED;
+    }
+    if ((options & PA_WIFIAP_HT_LDPC) && !(capaPtr->htCapa & HT_CAPA_LDPC))
+    {
+        LE_WARN("LDPC not supported by the radio");
+        return LE_UNSUPPORTED;
     }
-    fclose(configFilePtr);
     return LE_OK;
-
-error:
-    fclose(configFilePtr);
-    // Remove generated hostapd.conf file
-    remove(WIFI_HOSTAPD_FILE);
-    return LE_FAULT;
 }
 
-#ifdef SIMU
-// SIMU variable for timers
-static le_timer_Ref_t SimuClientConnectTimer = NULL;
-
 //--------------------------------------------------------------------------------------------------
 /**
- * This function generates a WiFi Access Point Event if callback event handler is set.
+ * Get the center channel of the 80 MHz channel of a 5 GHz channel.
+ *
+ * @return The center channel, or 0 if the channel is not part of an 80 MHz channel.
  */
 //--------------------------------------------------------------------------------------------------
-static void GenerateApEvent
+static uint16_t GetVht80CenterChannel
 (
-    le_wifiAp_Event_t wifiApEvent
+    uint16_t channel
 )
 {
-    if (NULL != CallBackHandlerFuncPtr)
+    // 80 MHz channels: 36-48, 52-64, 100-112, 116-128, 132-144 and 149-161.
+    if (((channel >= 36) && (channel <= 64)) || ((channel >= 100) && (channel <= 144)))
+    {
+        return 36 + 16 * ((channel - 36) / 16) + 6;
+    }
+    if ((channel >= 149) && (channel <= 161))
     {
-        CallBackHandlerFuncPtr(wifiApEvent);
+        return 155;
     }
+    return 0;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * SIMULATION! Simulates a LE_WIFIAP_EVENT_CLIENT_CONNECTED event
+ * Append the channel width and the HT/VHT options to hostapd.conf, for the IEEE standards set.
+ * Nothing is appended, and the access point runs at 20 MHz, if the capabilities of the radio are
+ * unknown or do not support them.
  */
 //--------------------------------------------------------------------------------------------------
-static void SimuClientConnectTimeCallBack
+static void AppendHtConfig
 (
-    le_timer_Ref_t timerRef
+    pa_wifiConf_Buffer_t *configPtr,
+    uint16_t channel
 )
 {
-    GenerateApEvent(LE_WIFIAP_EVENT_CLIENT_CONNECTED);
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * This function activates some timers to simulate client connect/disconnect events.
- */
-//--------------------------------------------------------------------------------------------------
+    pa_wifiAp_ChannelWidth_t width = SavedChannelWidth;
+    uint32_t                 options = SavedHtOptions;
+    bool                     is5GHz = (LE_WIFIAP_BITMASK_IEEE_STD_A ==
+                                       (SavedIeeeStdMask & HARDWARE_MODE_MASK));
+    bool                     isVht = (0 != (SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC));
+    bool                     isHt40Plus;
+
+    if ((!(SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_N)) ||
+        ((PA_WIFIAP_CHANNEL_WIDTH_20 == width) && (0 == options)))
+    {
+        return;
+    }
+    if (!IsBandCapaKnown)
+    {
+        LE_WARN("Capabilities of the radio unknown, HT settings not used");
+        return;
+    }
 
-static void StartApSimulation(void)
-{
-    // once every 10 seconds...
-    le_clk_Time_t interval = { 10, 0 };
-    SimuClientConnectTimer = le_timer_Create("WiFi Simu AP Connect Timer");
+    // VHT settings need the IEEE 802.11ac standard, and an 80 MHz channel.
+    if ((PA_WIFIAP_CHANNEL_WIDTH_80 == width) &&
+        ((!isVht) || (0 == GetVht80CenterChannel(channel))))
+    {
+        LE_WARN("No 80 MHz channel for channel %u, using 40 MHz", channel);
+        width = PA_WIFIAP_CHANNEL_WIDTH_40;
+    }
+    if (!isVht)
+    {
+        options &= ~PA_WIFIAP_HT_MAX_AMPDU;
+    }
 
-    LE_INFO("Timer: %p", SimuClientConnectTimer);
+    // The secondary channel is above the primary one if they form an allowed 40 MHz channel.
+    isHt40Plus = is5GHz ? (1 == (channel / 4) % 2) : (channel <= 7);
+    if ((PA_WIFIAP_CHANNEL_WIDTH_40 == width) &&
+        ((14 == channel) || (165 == channel)))
+    {
+        LE_WARN("No 40 MHz channel for channel %u, using 20 MHz", channel);
+        width = PA_WIFIAP_CHANNEL_WIDTH_20;
+    }
 
-    if (LE_OK != le_timer_SetHandler(SimuClientConnectTimer, SimuClientConnectTimeCallBack))
+    if (LE_OK != CheckHtConfig(width, options, &BandCapa))
     {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetHandler failed.");
+        LE_WARN("HT settings not supported by the radio, not used");
+        return;
     }
-    if (LE_OK != le_timer_SetInterval(SimuClientConnectTimer, interval))
+
+    pa_wifiConf_Append(configPtr, "ht_capab=%s%s%s%s\n",
+            (PA_WIFIAP_CHANNEL_WIDTH_20 == width) ? "" : (isHt40Plus ? "[HT40+]" : "[HT40-]"),
+            ((options & PA_WIFIAP_HT_SHORT_GI) && (BandCapa.htCapa & HT_CAPA_SHORT_GI_20)) ?
+            "[SHORT-GI-20]" : "",
+            ((options & PA_WIFIAP_HT_SHORT_GI) && (BandCapa.htCapa & HT_CAPA_SHORT_GI_40) &&
+             (PA_WIFIAP_CHANNEL_WIDTH_20 != width)) ? "[SHORT-GI-40]" : "",
+            (options & PA_WIFIAP_HT_LDPC) ? "[LDPC]" : "");
+
+    if ((!isVht) || (!BandCapa.isVht))
     {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+        return;
     }
 
-    //repeat 5 times
-    if (LE_OK != le_timer_SetRepeat(SimuClientConnectTimer, 5))
+    if (PA_WIFIAP_CHANNEL_WIDTH_80 == width)
     {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+        pa_wifiConf_Append(configPtr, "vht_oper_chwidth=1\nvht_oper_centr_freq_seg0_idx=%u\n",
+                           GetVht80CenterChannel(channel));
     }
-    if (LE_OK != le_timer_Start(SimuClientConnectTimer))
+    else
+    {
+        pa_wifiConf_Append(configPtr, "vht_oper_chwidth=0\n");
+    }
+    pa_wifiConf_Append(configPtr, "vht_capab=%s%s",
+            ((options & PA_WIFIAP_HT_SHORT_GI) && (BandCapa.vhtCapa & VHT_CAPA_SHORT_GI_80) &&
+             (PA_WIFIAP_CHANNEL_WIDTH_80 == width)) ? "[SHORT-GI-80]" : "",
+            ((options & PA_WIFIAP_HT_LDPC) && (BandCapa.vhtCapa & VHT_CAPA_RX_LDPC)) ?
+            "[RXLDPC]" : "");
+    if (options & PA_WIFIAP_HT_MAX_AMPDU)
     {
-        LE_ERROR("ERROR: StartApSimulation le_timer_SetInterval failed.");
+        pa_wifiConf_Append(configPtr, "[MAX-A-MPDU-LEN-EXP%u]",
+                           (BandCapa.vhtCapa >> VHT_CAPA_AMPDU_EXP_SHIFT) &
+                           VHT_CAPA_AMPDU_EXP_MASK);
     }
+    pa_wifiConf_Append(configPtr, "\n");
 }
-#endif
 
 //--------------------------------------------------------------------------------------------------
-// Public declarations
+/**
+ * Check whether the channel width or the HT/VHT options differ from the defaults.
+ */
 //--------------------------------------------------------------------------------------------------
+static bool IsHtConfigured
+(
+    void
+)
+{
+    return ((PA_WIFIAP_CHANNEL_WIDTH_20 != SavedChannelWidth) || (0 != SavedHtOptions));
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to initialize the WiFi module platform adapter (PA).
- *
- * @return LE_FAULT  The function failed.
- * @return LE_OK     The function succeeded.
+ * Read the capabilities of the band of the access point from the driver. They are unknown if the
+ * driver is not loaded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Init
+static le_result_t UpdateBandCapa
 (
     void
 )
 {
-    le_result_t result = LE_OK;
-
-    LE_INFO("pa_wifiAp_Init() called");
-    // Create the event for signaling user handlers.
-    WifiApPaEvent = le_event_CreateId("WifiApPaEvent", sizeof(le_wifiAp_Event_t));
+    bool        is5GHz = (LE_WIFIAP_BITMASK_IEEE_STD_A == (SavedIeeeStdMask & HARDWARE_MODE_MASK));
+    le_result_t result;
 
+    // The station interface always exists on the radio, unlike the virtual one of the access point.
+    result = pa_wifiNl80211_GetBandCapa(pa_wifiRadio_GetInterface(PA_WIFIRADIO_ROLE_CLIENT),
+                                        is5GHz, &BandCapa);
+    IsBandCapaKnown = (LE_OK == result);
+    if (IsBandCapaKnown)
+    {
+        LE_DEBUG("%s GHz band: HT %d (0x%04x), VHT %d (0x%08x)", is5GHz ? "5" : "2.4",
+                 BandCapa.isHt, BandCapa.htCapa, BandCapa.isVht, BandCapa.vhtCapa);
+    }
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to release the WiFi module platform adapter (PA).
- *
- * @return LE_OK     The function succeeded.
+ * Append the MAC address access control of a BSS to hostapd.conf, when it is used.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Release
+static void AppendAcl
 (
-    void
+    pa_wifiConf_Buffer_t *configPtr
 )
 {
-    LE_INFO("AP release called");
-    return LE_OK;
+    if (pa_wifiAcl_IsUsed())
+    {
+        pa_wifiConf_Append(configPtr, "macaddr_acl=%d\naccept_mac_file=%s\ndeny_mac_file=%s\n",
+                           (int)pa_wifiAcl_GetPolicy(),
+                           pa_wifiAcl_GetFile(PA_WIFIACL_LIST_ACCEPT),
+                           pa_wifiAcl_GetFile(PA_WIFIACL_LIST_DENY));
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function starts the WiFi access point.
- * Note that all settings, if to be used, such as security, username, password must set prior to
- * starting the access point.
+ * This function writes configuration to hostapd.conf.
  *
- * @return LE_FAULT         The function failed.
- * @return LE_OK            The function succeeded.
- * @return LE_NOT_FOUND     The WiFi card is absent.
- * @return LE_UNAVAILABLE   The WiFi card may not work.
+ * The whole file is generated, then only written if it changed since the last write.
  *
+ * @return LE_FAULT      The function failed.
+ * @return LE_DUPLICATE  hostapd.conf is unchanged.
+ * @return LE_OK         The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Start
+static le_result_t GenerateHostapdConf
 (
     void
 )
 {
-    int     systemResult;
-
-    // Check that an SSID is provided before starting
-    if ('\0' == SavedSsid[0])
+    pa_wifiConf_Buffer_t config = PA_WIFICONF_BUFFER_INIT;
+    le_result_t          result = LE_FAULT;
+    uint8_t              bssIndex;
+    uint16_t             channel = (0 != ClientChannel) ? ClientChannel :
+                                   ((0 != SelectedChannel) ? SelectedChannel : SavedChannelNumber);
+
+    // The MAC address lists are read by hostapd at start and reload, like hostapd.conf.
+    if (LE_FAULT == pa_wifiAcl_WriteFiles())
     {
-        LE_ERROR("Unable to start AP because no valid SSID provided");
-        return LE_FAULT;
+        LE_ERROR("Unable to generate the MAC address list files.");
+        goto error;
     }
 
-    // Check channel number is properly set before starting
-    if ((SavedChannelNumber < MIN_CHANNEL_VALUE) ||
-            (SavedChannelNumber > MAX_CHANNEL_VALUE))
+    // prepare SSID, channel, country code etc in hostapd.conf
+    pa_wifiConf_Append(&config, (HOSTAPD_CONFIG_COMMON
+            "ssid=%s\nchannel=%d\nmax_num_sta=%d\ncountry_code=%s\nignore_broadcast_ssid=%d\n"
+            "beacon_int=%u\ndtim_period=%u\nap_max_inactivity=%u\n"),
+            (char *)SavedSsid,
+            channel,
+            SavedMaxNumClients,
+            (char *)SavedCountryCode,
+            !SavedDiscoverable,
+            SavedBeaconInterval,
+            SavedDtimPeriod,
+            SavedMaxInactivity);
+    AppendWmmParams(&config);
+    AppendAcl(&config);
+
+    // prepare security parameters in hostapd.conf
+    result = AppendSecurity(&config, SavedSecurityProtocol, SavedPassphrase, SavedPreSharedKey);
+    if (LE_OK != result)
     {
-        LE_ERROR("Unable to start AP because no valid channel number provided");
-        return LE_FAULT;
+        LE_ERROR("Unable to set security parameters in hostapd.conf");
+        goto error;
     }
 
-    LE_DEBUG("Starting AP, SSID: %s", SavedSsid);
-
-    // Create hostapd.conf file in /tmp
-    if ( LE_OK != GenerateHostapdConf())
+    // prepare IEEE std including hardware mode into hostapd.conf
+    switch( SavedIeeeStdMask & HARDWARE_MODE_MASK )
     {
-        LE_ERROR("Failed to generate hostapd.conf");
-        return LE_FAULT;
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            pa_wifiConf_Append(&config, "hw_mode=a\n");
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_B:
+            pa_wifiConf_Append(&config, "hw_mode=b\n");
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_G:
+            pa_wifiConf_Append(&config, "hw_mode=g\n");
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            pa_wifiConf_Append(&config, "hw_mode=ad\n");
+            break;
+        default:
+            pa_wifiConf_Append(&config, "hw_mode=g\n");
+            break;
     }
 
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_START);
-    /**
-     * Returned values:
-     *   0: if the interface is correctly moutned
-     *  50: if WiFi card is not inserted
-     * 100: if WiFi card may not work
-     * 127: if driver can not be installed
-     *  -1: if the fork() has failed (see man system)
-     */
-
-    if (0 == WEXITSTATUS(systemResult))
+    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_D )
     {
-        LE_DEBUG("WiFi hardware started correctly");
-        // Create WiFi AP PA Thread
-        WifiApPaThread = le_thread_Create("WifiApPaThread", WifiApPaThreadMain, NULL);
-        le_thread_SetJoinable(WifiApPaThread);
-        le_thread_AddChildDestructor(WifiApPaThread, ThreadDestructor, NULL);
-        le_thread_Start(WifiApPaThread);
+        pa_wifiConf_Append(&config, "ieee80211d=1\n");
     }
-    // Return value of 50 means WiFi card is not inserted.
-    else if ( PA_NOT_FOUND == WEXITSTATUS(systemResult))
+    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_H )
     {
-        LE_ERROR("WiFi card is not inserted");
-        return LE_NOT_FOUND;
+        pa_wifiConf_Append(&config, "ieee80211h=1\n");
     }
-    // Return value of 100 means WiFi card may not work.
-    else if ( PA_NOT_POSSIBLE == WEXITSTATUS(systemResult))
+    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_N )
     {
-        LE_ERROR("Unable to reset WiFi card");
-        return LE_UNAVAILABLE;
+        // hw_mode=b does not support ieee80211n, but driver can handle it
+        pa_wifiConf_Append(&config, "ieee80211n=1\n");
     }
-    // WiFi card failed to start.
-    else
+    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
     {
-        LE_WARN("Failed to start WiFi AP command \"%s\" systemResult (%d)",
-                COMMAND_WIFI_HW_START, systemResult);
-        return LE_FAULT;
+        pa_wifiConf_Append(&config, "ieee80211ac=1\n");
+    }
+    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_AX )
+    {
+        pa_wifiConf_Append(&config, "ieee80211ax=1\n");
+    }
+    if ( SavedIeeeStdMask & LE_WIFIAP_BITMASK_IEEE_STD_W )
+    {
+        pa_wifiConf_Append(&config, "ieee80211w=1\n");
     }
+    AppendHtConfig(&config, channel);
 
-    // Start Access Point cmd: /bin/hostapd /etc/hostapd.conf
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFIAP_HOSTAPD_START);
-    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    // Additional BSS, after the radio settings which they share
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
     {
-        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)",
-                COMMAND_WIFIAP_HOSTAPD_START,
-                systemResult);
-        // Remove generated hostapd.conf file
-        remove(WIFI_HOSTAPD_FILE);
-        goto error;
+        Bss_t *bssPtr = &BssTable[bssIndex];
+
+        if (!bssPtr->isEnabled)
+        {
+            continue;
+        }
+
+        SetBssIfName(bssIndex);
+        pa_wifiConf_Append(&config, ("bss=%s\n" HOSTAPD_CONFIG_BSS
+                "ssid=%.*s\nmax_num_sta=%u\nignore_broadcast_ssid=%d\n"
+                "dtim_period=%u\nap_max_inactivity=%u\n"),
+                bssPtr->ifName,
+                (int)bssPtr->config.ssidLength,
+                (char *)bssPtr->config.ssid,
+                bssPtr->config.maxNumClients,
+                !bssPtr->config.isDiscoverable,
+                SavedDtimPeriod,
+                SavedMaxInactivity);
+        AppendAcl(&config);
+        if (LE_OK != AppendSecurity(&config, bssPtr->config.securityProtocol,
+                                    bssPtr->config.passphrase, ""))
+        {
+            LE_ERROR("Unable to set security parameters of %s in hostapd.conf", bssPtr->ifName);
+            goto error;
+        }
     }
 
-    LE_INFO("WiFi AP started correclty");
-    return LE_OK;
+    // Write hostapd.conf, unless unchanged
+    result = pa_wifiConf_Write(&HostapdConfFile, WIFI_HOSTAPD_FILE, &config);
+    if (LE_FAULT == result)
+    {
+        LE_ERROR("Unable to generate the hostapd file.");
+        goto error;
+    }
+    pa_wifiConf_Release(&config);
+    return result;
 
 error:
-    le_thread_Cancel(WifiApPaThread);
-    le_thread_Join(WifiApPaThread, NULL);
+    pa_wifiConf_Release(&config);
+    // Remove generated hostapd.conf file
+    remove(WIFI_HOSTAPD_FILE);
     return LE_FAULT;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function stops the WiFi access point.
- *
- * @return LE_FAULT         The function failed.
- * @return LE_OK            The function succeeded.
+ * Set parameters of the hostapd of an interface through its control interface, then apply them.
  *
+ * @return LE_OK            The parameters are applied.
+ * @return others           The parameters could not be set or applied.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_Stop
+static le_result_t SetParameters
 (
-    void
+    const char *ifNamePtr,
+    const Parameter_t *paramsPtr,
+    size_t count,
+    ApplyMode_t mode
 )
 {
-    int status;
+    le_result_t result = LE_OK;
+    size_t      i;
 
-    // Try to delete the rule allowing the DHCP ports on WLAN. Ignore if it fails
-    status = system(WIFI_SCRIPT_PATH COMMAND_IPTABLE_DHCP_DELETE);
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    for (i = 0; (i < count) && (LE_OK == result); i++)
     {
-        LE_WARN("Deleting rule for DHCP port fails");
+        result = pa_wifiHostapd_Set(ifNamePtr, paramsPtr[i].namePtr, paramsPtr[i].valuePtr);
     }
 
-    status = system(WIFI_SCRIPT_PATH COMMAND_WIFIAP_HOSTAPD_STOP);
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    if (LE_OK == result)
     {
-        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)",
-                COMMAND_WIFIAP_HOSTAPD_STOP,
-                status);
-        return LE_FAULT;
+        switch (mode)
+        {
+            case APPLY_BEACON:
+                result = pa_wifiHostapd_UpdateBeacon(ifNamePtr);
+                break;
+            case APPLY_RELOAD:
+                result = pa_wifiHostapd_Reload(ifNamePtr);
+                break;
+            default:
+                break;
+        }
     }
+    return result;
+}
 
-    status = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_STOP);
-    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply parameter changes to the running hostapd through its control interface, instead of
+ * waiting for the next start. The parameters are saved for the next start in any case.
+ *
+ * hostapd.conf is kept in line with the running hostapd, and the parameters are not applied when
+ * hostapd.conf is unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyParameters
+(
+    const char *labelPtr,           ///< Name of the change in the logs.
+    const Parameter_t *paramsPtr,
+    size_t count,
+    ApplyMode_t mode,
+    bool isAllBss                   ///< Apply to the additional BSS too.
+)
+{
+    le_result_t result;
+    uint8_t     bssIndex;
+
+    if (!IsApStarted)
     {
-        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFI_HW_STOP, status);
-        return LE_FAULT;
+        return;
     }
 
-    // Cancel the previously created thread
-    le_thread_Cancel(WifiApPaThread);
-    if (LE_OK != le_thread_Join(WifiApPaThread, NULL))
+    if (LE_DUPLICATE == GenerateHostapdConf())
     {
-        return LE_FAULT;
+        LE_DEBUG("%s unchanged", labelPtr);
+        return;
     }
 
-    // Remove the previously created hostapd.conf file in /tmp
-    remove(WIFI_HOSTAPD_FILE);
+    result = SetParameters(ApIfName, paramsPtr, count, mode);
+    for (bssIndex = 1; isAllBss && (LE_OK == result) && (bssIndex < PA_WIFIAP_MAX_BSS); bssIndex++)
+    {
+        if (BssTable[bssIndex].isEnabled)
+        {
+            result = SetParameters(BssTable[bssIndex].ifName, paramsPtr, count, mode);
+        }
+    }
 
-    LE_INFO("WiFi AP stopped correclty");
-    return LE_OK;
+    if (LE_OK == result)
+    {
+        LE_INFO("%s applied to the running access point", labelPtr);
+    }
+    else
+    {
+        LE_WARN("Unable to apply %s to the running access point, it will be used on next start",
+                labelPtr);
+        // Apply it again if it is set again.
+        pa_wifiConf_Invalidate(&HostapdConfFile);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add handler function for WiFi related events.
- *
- * These events provide information on WiFi access point status.
- *
- * @return LE_BAD_PARAMETER Some parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * Apply a parameter change of the main BSS to the running hostapd.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t  pa_wifiAp_AddEventHandler
+static void ApplyParameter
 (
-    pa_wifiAp_NewEventHandlerFunc_t handlerPtr,
-        ///< [IN]
-        ///< Event handler function pointer
-
-    void *contextPtr
-        ///< [IN]
-        ///< Associated event context
+    const char *namePtr,
+    const char *valuePtr,
+    ApplyMode_t mode
 )
 {
-    le_event_HandlerRef_t handlerRef;
-
-    handlerRef = le_event_AddLayeredHandler("WifiApPaHandler",
-                                            WifiApPaEvent,
-                                            FirstLayerWifiApEventHandler,
-                                            (le_event_HandlerFunc_t)handlerPtr);
-    if (NULL == handlerRef)
-    {
-        LE_ERROR("ERROR: le_event_AddLayeredHandler returned NULL");
-        return LE_BAD_PARAMETER;
-    }
+    Parameter_t param = { namePtr, valuePtr };
 
-    le_event_SetContextPtr(handlerRef, contextPtr);
-    return LE_OK;
+    ApplyParameters(namePtr, &param, 1, mode, false);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the Service Set IDentification (SSID) of the access point
- *
- * @note The SSID does not have to be human readable ASCII values, but often is.
- *
- * @return LE_BAD_PARAMETER Some parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * Record the change of a parameter which hostapd only reads at startup, to be applied by the next
+ * pa_wifiAp_Restart().
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetRestartPending
+(
+    void
+)
+{
+    if (IsApStarted)
+    {
+        IsRestartPending = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to initialize the WiFi module platform adapter (PA).
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Init
+(
+    void
+)
+{
+    le_result_t result = LE_OK;
+
+    LE_INFO("pa_wifiAp_Init() called");
+    pa_wifiCmd_Init();
+    pa_wifiRadio_Init();
+    le_utf8_Copy(ApIfName, pa_wifiRadio_GetInterface(PA_WIFIRADIO_ROLE_AP), sizeof(ApIfName),
+                 NULL);
+    // The event thread hands its events over to this thread through the ring.
+    EventRing = pa_wifiRing_Create("WifiApPaEvents",
+                                   sizeof(pa_wifiAp_StationEvent_t),
+                                   EVENT_QUEUE_MAX_COUNT,
+                                   EventRingHandler,
+                                   NULL);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to release the WiFi module platform adapter (PA).
+ *
+ * @return LE_OK     The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Release
+(
+    void
+)
+{
+    LE_INFO("AP release called");
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select the least congested channel, once the WiFi hardware is started. If the selection fails,
+ * the channel set by pa_wifiAp_SetChannel() is used.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SelectChannel
+(
+    void
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    int           hwMode = SavedIeeeStdMask & HARDWARE_MODE_MASK;
+    uint16_t      channel;
+    le_result_t   result;
+
+    SelectedChannel = 0;
+    if (LE_WIFIAP_BITMASK_IEEE_STD_AD == hwMode)
+    {
+        LE_WARN("No automatic channel selection for IEEE 802.11ad");
+        return;
+    }
+
+    // Scan on the WLAN interface: a virtual access point interface is not up yet.
+    result = pa_wifiAcs_SelectChannel(pa_wifiRadio_GetInterface(PA_WIFIRADIO_ROLE_CLIENT),
+                                      (LE_WIFIAP_BITMASK_IEEE_STD_A == hwMode),
+                                      SavedCountryCode, ChannelScores, &ChannelScoreCount,
+                                      &channel);
+    pa_wifiStats_RecordResult(COMMAND_WIFIAP_ACS, startTime, result);
+    if (LE_OK == result)
+    {
+        SelectedChannel = channel;
+    }
+    else
+    {
+        LE_WARN("Automatic channel selection failed, using channel %d", SavedChannelNumber);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * In concurrent mode, use the channel of the client if it is connected: the radio operates on one
+ * channel.
+ *
+ * @return true if the channel of the client is used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FollowClientChannel
+(
+    void
+)
+{
+    int      hwMode = SavedIeeeStdMask & HARDWARE_MODE_MASK;
+    uint16_t channel;
+    bool     is5GHz;
+
+    ClientChannel = 0;
+    if (!pa_wifiRadio_IsConcurrent() ||
+        (LE_OK != pa_wifiRadio_GetChannel(PA_WIFIRADIO_ROLE_CLIENT, &channel, &is5GHz)))
+    {
+        return false;
+    }
+
+    if (is5GHz != (LE_WIFIAP_BITMASK_IEEE_STD_A == hwMode))
+    {
+        LE_WARN("Client connected on channel %u, not in the band of the access point", channel);
+        return false;
+    }
+
+    LE_INFO("Client connected, using its channel %u", channel);
+    ClientChannel = channel;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function starts the WiFi access point.
+ * Note that all settings, if to be used, such as security, username, password must set prior to
+ * starting the access point.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ * @return LE_NOT_FOUND     The WiFi card is absent.
+ * @return LE_UNAVAILABLE   The WiFi card may not work.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Start
+(
+    void
+)
+{
+    char        cmd[64];
+    int         systemResult;
+    le_result_t result;
+    bool        isConfOutdated;
+
+    // Check that an SSID is provided before starting
+    if ('\0' == SavedSsid[0])
+    {
+        LE_ERROR("Unable to start AP because no valid SSID provided");
+        return LE_FAULT;
+    }
+
+    // Check channel number is properly set before starting
+    if ((SavedChannelNumber < MIN_CHANNEL_VALUE) ||
+            (SavedChannelNumber > MAX_CHANNEL_VALUE))
+    {
+        LE_ERROR("Unable to start AP because no valid channel number provided");
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Starting AP, SSID: %s", SavedSsid);
+
+    // The interfaces of the additional BSS are named after the one of the access point.
+    le_utf8_Copy(ApIfName, pa_wifiRadio_GetInterface(PA_WIFIRADIO_ROLE_AP), sizeof(ApIfName),
+                 NULL);
+    ClientChannel = 0;
+
+#ifdef SIMU
+    // Simulated stations take the place of the radio and of hostapd.
+    if (LE_OK != pa_wifiSimu_Start(ApIfName, ApEventHandler, EventRing))
+    {
+        return LE_FAULT;
+    }
+    IsApStarted = true;
+    return LE_OK;
+#endif
+
+    // Create hostapd.conf file in /tmp
+    if (LE_FAULT == GenerateHostapdConf())
+    {
+        LE_ERROR("Failed to generate hostapd.conf");
+        return LE_FAULT;
+    }
+
+    result = pa_wifiRadio_Start(PA_WIFIRADIO_ROLE_AP, ApEventHandler);
+    if (LE_OK != result)
+    {
+        LE_WARN("Failed to start the WiFi hardware: %s", LE_RESULT_TXT(result));
+        return result;
+    }
+    LE_DEBUG("WiFi hardware started correctly");
+
+    // hostapd.conf was generated before the capabilities of the radio and the channel were known.
+    isConfOutdated = IsHtConfigured() && (LE_OK == UpdateBandCapa());
+    if (FollowClientChannel() || IsAutoChannel)
+    {
+        if (0 == ClientChannel)
+        {
+            SelectChannel();
+        }
+        isConfOutdated = true;
+    }
+    if (isConfOutdated)
+    {
+        if (LE_FAULT == GenerateHostapdConf())
+        {
+            LE_ERROR("Failed to generate hostapd.conf");
+            goto error;
+        }
+    }
+
+    // Start Access Point cmd: /bin/hostapd /etc/hostapd.conf
+    snprintf(cmd, sizeof(cmd), "%s %s", COMMAND_WIFIAP_HOSTAPD_START, ApIfName);
+    systemResult = pa_wifiCmd_Run(cmd, NULL, 0);
+    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)",
+                COMMAND_WIFIAP_HOSTAPD_START,
+                systemResult);
+        // Remove generated hostapd.conf file
+        remove(WIFI_HOSTAPD_FILE);
+        goto error;
+    }
+
+    LE_INFO("WiFi AP started correclty on %s", ApIfName);
+    IsApStarted = true;
+    IsRestartPending = false;
+    ApplyBssIpRanges();
+    return LE_OK;
+
+error:
+    pa_wifiRadio_Stop(PA_WIFIRADIO_ROLE_AP);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Terminate hostapd through its control interface, which deauthenticates the stations, and wait
+ * for it to exit. It is signaled if it does not answer or exit in time.
+ *
+ * @return LE_OK            hostapd is not running.
+ * @return LE_FAULT         hostapd could not be terminated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StopHostapd
+(
+    void
+)
+{
+    char        pidPath[PATH_MAX];
+    pid_t       pid;
+    bool        hasPid;
+    le_result_t result;
+
+    snprintf(pidPath, sizeof(pidPath), HOSTAPD_PID_FILE_FORMAT, ApIfName);
+    hasPid = (LE_OK == pa_wifiProc_ReadPidFile(pidPath, "hostapd", &pid));
+
+    result = pa_wifiHostapd_Terminate(ApIfName);
+    if (hasPid)
+    {
+        if ((LE_OK != result) || (LE_OK != pa_wifiProc_Wait(pid, HOSTAPD_TERMINATE_TIMEOUT_MS)))
+        {
+            LE_WARN("hostapd %d did not terminate, signaling it", (int)pid);
+            result = pa_wifiProc_Stop(pid, HOSTAPD_TERMINATE_TIMEOUT_MS);
+        }
+        remove(pidPath);
+    }
+    else if (LE_UNAVAILABLE == result)
+    {
+        LE_DEBUG("hostapd not running on %s", ApIfName);
+        result = LE_OK;
+    }
+    // Without a pid file, the exit of hostapd cannot be waited for: the request is enough.
+
+    return (LE_OK == result) ? LE_OK : LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function stops the WiFi access point.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Stop
+(
+    void
+)
+{
+    char cmd[64];
+    int  status;
+
+#ifdef SIMU
+    pa_wifiSimu_Stop();
+    IsApStarted = false;
+    return LE_OK;
+#endif
+
+    // Try to delete the rule allowing the DHCP ports on WLAN. Ignore if it fails
+    snprintf(cmd, sizeof(cmd), "%s %s", COMMAND_IPTABLE_DHCP_DELETE, ApIfName);
+    status = pa_wifiCmd_Run(cmd, NULL, 0);
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_WARN("Deleting rule for DHCP port fails");
+    }
+    ClearBssAddresses();
+
+    StopDhcpServer();
+    if (LE_OK != StopHostapd())
+    {
+        LE_ERROR("Unable to stop hostapd");
+        return LE_FAULT;
+    }
+
+    // The hardware is only stopped if the client does not use it.
+    if (LE_OK != pa_wifiRadio_Stop(PA_WIFIRADIO_ROLE_AP))
+    {
+        return LE_FAULT;
+    }
+
+    // Remove the previously created hostapd.conf file in /tmp
+    remove(WIFI_HOSTAPD_FILE);
+    IsApStarted = false;
+
+    LE_INFO("WiFi AP stopped correclty");
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that hostapd answers on its control interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHostapdAlive
+(
+    void
+)
+{
+    char reply[8];
+
+    return ((LE_OK == pa_wifiHostapd_Request(ApIfName, "PING", reply, sizeof(reply))) &&
+            (0 == strncmp(reply, "PONG", 4)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function restarts hostapd only, with the current settings. The driver stays loaded, and
+ * the interface address, the DHCP port rule and dnsmasq are kept, so that the access point is
+ * back in the time hostapd needs to start. The stations are disconnected.
+ *
+ * hostapd is not restarted when hostapd.conf is unchanged, no parameter which hostapd only reads
+ * at startup changed, and hostapd is running.
+ *
+ * The duration of the restart is recorded in the command statistics as WIFIAP_SOFT_RESTART.
+ *
+ * @return LE_OK            hostapd is restarted.
+ * @return LE_DUPLICATE     No restart needed: hostapd is running, the stations stay associated.
+ * @return LE_TERMINATED    hostapd was stopped but could not be started again: the access point is
+ *                          stopped.
+ * @return LE_FAULT         The access point is not started, or hostapd could not be stopped: the
+ *                          access point is unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Restart
+(
+    void
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    le_result_t   result;
+    char          cmd[64];
+    int           status;
+    uint8_t       bssIndex;
+
+    if (!IsApStarted)
+    {
+        LE_ERROR("Access point not started");
+        return LE_FAULT;
+    }
+
+    // The new settings are read by the new hostapd. The band may have changed.
+    if (IsHtConfigured())
+    {
+        UpdateBandCapa();
+    }
+    result = GenerateHostapdConf();
+    if (LE_FAULT == result)
+    {
+        LE_ERROR("Failed to generate hostapd.conf");
+        return LE_FAULT;
+    }
+
+    // Nothing to apply: keep the stations associated.
+    if ((LE_DUPLICATE == result) && (!IsRestartPending) && IsHostapdAlive())
+    {
+        LE_INFO("hostapd.conf unchanged, WiFi AP not restarted");
+        return LE_DUPLICATE;
+    }
+
+    if (LE_OK != StopHostapd())
+    {
+        LE_ERROR("Unable to terminate hostapd, the access point is unchanged");
+        return LE_FAULT;
+    }
+
+    // hostapd removed the interfaces of the additional BSS.
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
+    {
+        BssTable[bssIndex].isUp = false;
+    }
+
+    snprintf(cmd, sizeof(cmd), "%s %s", COMMAND_WIFIAP_HOSTAPD_START, ApIfName);
+    status = pa_wifiCmd_Run(cmd, NULL, 0);
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_ERROR("WiFi AP Command \"%s\" Failed: (%d)", COMMAND_WIFIAP_HOSTAPD_START, status);
+        pa_wifiStats_Record(COMMAND_WIFIAP_SOFT_RESTART, startTime, status);
+        // Release the hardware and the DHCP server, as a stop would.
+        pa_wifiAp_Stop();
+        return LE_TERMINATED;
+    }
+    IsRestartPending = false;
+
+    // hostapd may have brought the interface down when terminating: restore its address.
+    if ('\0' != SavedIpAp[0])
+    {
+        snprintf(cmd, sizeof(cmd), "%s %s %s", COMMAND_WIFIAP_WLAN_UP, SavedIpAp, ApIfName);
+        status = pa_wifiCmd_Run(cmd, NULL, 0);
+        if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+        {
+            LE_WARN("Unable to restore the address of %s", ApIfName);
+        }
+    }
+    ApplyBssIpRanges();
+
+    pa_wifiStats_Record(COMMAND_WIFIAP_SOFT_RESTART, startTime, 0);
+    LE_INFO("WiFi AP restarted");
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for WiFi related events.
+ *
+ * These events provide information on WiFi access point status.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t  pa_wifiAp_AddEventHandler
+(
+    pa_wifiAp_NewEventHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Event handler function pointer
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    if ((NULL == handlerPtr) || (EventHandlerCount >= EVENT_HANDLER_MAX_COUNT))
+    {
+        LE_ERROR("Cannot add event handler %p", handlerPtr);
+        return LE_BAD_PARAMETER;
+    }
+
+    EventHandlers[EventHandlerCount].handlerFuncPtr = handlerPtr;
+    EventHandlers[EventHandlerCount].contextPtr = contextPtr;
+    EventHandlerCount++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for station connection and disconnection events.
+ *
+ * These events are reported along with the ones of pa_wifiAp_AddEventHandler(), with the MAC
+ * address of the station.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_BAD_PARAMETER The handler could not be added.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_AddStationEventHandler
+(
+    pa_wifiAp_StationEventHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Event handler function pointer
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+)
+{
+    if ((NULL == handlerPtr) || (StationEventHandlerCount >= EVENT_HANDLER_MAX_COUNT))
+    {
+        LE_ERROR("Cannot add station event handler %p", handlerPtr);
+        return LE_BAD_PARAMETER;
+    }
+
+    StationEventHandlers[StationEventHandlerCount].handlerFuncPtr = handlerPtr;
+    StationEventHandlers[StationEventHandlerCount].contextPtr = contextPtr;
+    StationEventHandlerCount++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stations associated with one interface of the access point, from the driver.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_FAULT         The station dump failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetInterfaceStations
+(
+    const char *ifNamePtr,
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+    void *contextPtr
+)
+{
+    if (LE_OK == pa_wifiNl80211_GetStations(ifNamePtr, handlerPtr, contextPtr))
+    {
+        return LE_OK;
+    }
+
+    // Drivers without nl80211 station dump: ask hostapd.
+    if (LE_OK == pa_wifiHostapd_GetStations(ifNamePtr, handlerPtr, contextPtr))
+    {
+        return LE_OK;
+    }
+
+    LE_WARN("Unable to get the stations of %s", ifNamePtr);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stations associated with the access point, from the driver.
+ *
+ * The handler is called for each station before the function returns.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_FAULT         The station dump failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetStations
+(
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each station
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context
+)
+{
+    le_result_t result = GetInterfaceStations(ApIfName, handlerPtr, contextPtr);
+    uint8_t     bssIndex;
+
+    if (!IsApStarted)
+    {
+        return result;
+    }
+
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
+    {
+        if (BssTable[bssIndex].isEnabled)
+        {
+            GetInterfaceStations(BssTable[bssIndex].ifName, handlerPtr, contextPtr);
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the Service Set IDentification (SSID) of the access point
+ *
+ * @note The SSID does not have to be human readable ASCII values, but often is.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the SSID is applied at once and the stations are
+ *       disconnected.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiAp_SetSsid
 (
-    const uint8_t *ssidPtr,
+    const uint8_t *ssidPtr,
+        ///< [IN]
+        ///< The SSID to set as an octet array.
+
+    size_t ssidNumElements
+        ///< [IN]
+        ///< The length of the SSID in bytes.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_INFO("SSID length %d | SSID: \"%.*s\"",
+            (int)ssidNumElements,
+            (int)ssidNumElements,
+            (char *)ssidPtr);
+
+    if ((0 < ssidNumElements) && (ssidNumElements <= LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        // Store SSID to be used later during startup procedure
+        memcpy(&SavedSsid[0], (const char *)&ssidPtr[0], ssidNumElements);
+        // Make sure there is a null termination
+        SavedSsid[ssidNumElements] = '\0';
+        ApplyParameter("ssid", SavedSsid, APPLY_RELOAD);
+        result = LE_OK;
+    }
+    else
+    {
+        LE_ERROR("ERROR: SSID length exceeds %d bytes\n", LE_WIFIDEFS_MAX_SSID_LENGTH);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the security protocol used to communicate.
+ *
+ * @note WEP is not supported as it is unsecure and has been deprecated in favor of WPA/WPA2.
+ * This limitation applies to access point mode only.
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetSecurityProtocol
+(
+    le_wifiAp_SecurityProtocol_t securityProtocol
+        ///< [IN]
+        ///< The security protocol used to communicate with the access point.
+)
+{
+    le_result_t result;
+
+    LE_INFO("Security protocol : %d", securityProtocol);
+    switch (securityProtocol)
+    {
+        case LE_WIFIAP_SECURITY_NONE:
+        case LE_WIFIAP_SECURITY_WPA2:
+            if (securityProtocol != SavedSecurityProtocol)
+            {
+                SetRestartPending();
+            }
+            SavedSecurityProtocol = securityProtocol;
+            result = LE_OK;
+            break;
+
+        default:
+            result = LE_BAD_PARAMETER;
+            break;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the passphrase used to generate the PSK.
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * pa_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ *
+ * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started with WPA2, the passphrase is applied at once and the
+ *       stations are disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetPassPhrase
+(
+    const char *passphrasePtr
+        ///< [IN]
+        ///< Passphrase to authenticate against the access point.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_INFO("Set passphrase");
+    if (NULL != passphrasePtr)
+    {
+        uint32_t length = strlen(passphrasePtr);
+
+        if ((length >= LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) &&
+            (length <= LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
+        {
+            // Store Passphrase to be used later during startup procedure
+            le_utf8_Copy(SavedPassphrase, passphrasePtr, sizeof(SavedPassphrase), NULL);
+            if (LE_WIFIAP_SECURITY_WPA2 == SavedSecurityProtocol)
+            {
+                ApplyParameter("wpa_passphrase", SavedPassphrase, APPLY_RELOAD);
+            }
+            result = LE_OK;
+        }
+        else
+        {
+            LE_ERROR("Invalid passphrase length (%d) [%d..%d]",
+                    length,
+                    LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH,
+                    LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH);
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the pre-shared key (PSK).
+ *
+ * @note This is one way to authenticate against the access point. The other one is provided by the
+ * pa_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
+ * with WPA-personal authentication.
+ *
+ * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started with WPA2, the PSK is applied at once and the stations
+ *       are disconnected.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetPreSharedKey
+(
+    const char *preSharedKeyPtr
+        ///< [IN]
+        ///< Pre-shared key used to authenticate against the access point.
+)
+{
+    le_result_t result = LE_BAD_PARAMETER;
+
+    LE_INFO("Set PSK");
+    if (NULL != preSharedKeyPtr)
+    {
+        uint32_t length = strlen(preSharedKeyPtr);
+
+        if (length <= LE_WIFIDEFS_MAX_PSK_LENGTH)
+        {
+            // Store PSK to be used later during startup procedure
+            le_utf8_Copy(SavedPreSharedKey, preSharedKeyPtr, sizeof(SavedPreSharedKey), NULL);
+            if (LE_WIFIAP_SECURITY_WPA2 == SavedSecurityProtocol)
+            {
+                ApplyParameter("wpa_psk", SavedPreSharedKey, APPLY_RELOAD);
+            }
+            result = LE_OK;
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set if the access point should announce its presence.
+ * Default value is TRUE.
+ * If the value is set to FALSE, the access point will be hidden.
+ *
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the beacon is updated at once, the stations stay
+ *       connected.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetDiscoverable
+(
+    bool isDiscoverable
+        ///< [IN]
+        ///< If TRUE, the access point SSID is visible by the clients otherwise it is hidden.
+)
+{
+    // Store Discoverable to be used later during startup procedure
+    LE_INFO("Set discoverability");
+    SavedDiscoverable = isDiscoverable;
+    ApplyParameter("ignore_broadcast_ssid", isDiscoverable ? "0" : "1", APPLY_BEACON);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which WiFi channel to use.
+ * Default number is 7.
+ * Some legal restrictions might apply for your region.
+ * The channel number must be between 1 and 14 for IEEE 802.11b/g.
+ * The channel number must be between 7 and 196 for IEEE 802.11a.
+ * The channel number must be between 1 and 6 for IEEE 802.11ad.
+ * @return
+ *      - LE_OUT_OF_RANGE if requested channel number is out of range.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetChannel
+(
+    uint16_t channelNumber
+        ///< [IN]
+        ///< the channel number.
+)
+{
+    le_result_t result = LE_OUT_OF_RANGE;
+    int8_t hwMode = SavedIeeeStdMask & 0x0F;
+
+    LE_INFO("Set channel");
+    switch (hwMode)
+    {
+        case LE_WIFIAP_BITMASK_IEEE_STD_A:
+            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_A;
+            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_A;
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_B:
+        case LE_WIFIAP_BITMASK_IEEE_STD_G:
+            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_VALUE;
+            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_VALUE;
+            break;
+        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
+            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_AD;
+            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_AD;
+            break;
+        default:
+            LE_WARN("Invalid hardware mode");
+    }
+
+    if ((channelNumber >= MIN_CHANNEL_VALUE) &&
+        (channelNumber <= MAX_CHANNEL_VALUE))
+    {
+       if (channelNumber != SavedChannelNumber)
+       {
+           SetRestartPending();
+       }
+       SavedChannelNumber = channelNumber;
+       result = LE_OK;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the automatic channel selection. When enabled, the least congested channel is
+ * selected at each start of the access point from a scan and from the channel survey of the
+ * driver, instead of the channel set by pa_wifiAp_SetChannel(), which is used if the selection
+ * fails.
+ *
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetAutoChannel
+(
+    bool enable
+        ///< [IN]
+        ///< true to enable the automatic channel selection.
+)
+{
+    IsAutoChannel = enable;
+    if (!enable)
+    {
+        SelectedChannel = 0;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel scores of the last automatic channel selection, and the channel selected.
+ *
+ * @return LE_NOT_FOUND     No channel was selected automatically.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetChannelScores
+(
+    pa_wifiAcs_ChannelScore_t *scoresPtr,
+        ///< [OUT]
+        ///< Channel scores.
+    size_t *scoreCountPtr,
+        ///< [INOUT]
+        ///< Size of the scores array, number of scores returned.
+    uint16_t *channelPtr
+        ///< [OUT]
+        ///< Selected channel.
+)
+{
+    if (0 == SelectedChannel)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (*scoreCountPtr > ChannelScoreCount)
+    {
+        *scoreCountPtr = ChannelScoreCount;
+    }
+    memcpy(scoresPtr, ChannelScores, *scoreCountPtr * sizeof(pa_wifiAcs_ChannelScore_t));
+    *channelPtr = SelectedChannel;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the access point on a virtual interface, next to the client on the WLAN interface, so that
+ * both can be used at the same time. Applied at the next start of the access point. While the
+ * client is connected, the access point uses its channel.
+ *
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetConcurrent
+(
+    bool enable
+        ///< [IN]
+        ///< true to run the access point on a virtual interface.
+)
+{
+    le_result_t result = pa_wifiRadio_SetConcurrent(enable);
+
+    if (LE_OK == result)
+    {
+        le_utf8_Copy(ApIfName, pa_wifiRadio_GetInterface(PA_WIFIRADIO_ROLE_AP), sizeof(ApIfName),
+                     NULL);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the channel width and the HT and VHT options of the access point, used with the IEEE
+ * 802.11n and 802.11ac standards. Default is 20 MHz without option.
+ *
+ * The settings are checked against the capabilities of the radio when the driver is loaded, and
+ * again when the access point starts: the access point falls back to 20 MHz without option if they
+ * are not supported.
+ *
+ * @return LE_BAD_PARAMETER Invalid width or option.
+ * @return LE_UNSUPPORTED   The radio does not support the settings.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the settings are used from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetHtConfig
+(
+    pa_wifiAp_ChannelWidth_t width,
+        ///< [IN]
+        ///< Channel width.
+    uint32_t options
+        ///< [IN]
+        ///< HT and VHT options, PA_WIFIAP_HT_* bits.
+)
+{
+    LE_INFO("Set HT config: width %d, options 0x%x", width, options);
+    if ((width < PA_WIFIAP_CHANNEL_WIDTH_20) || (width > PA_WIFIAP_CHANNEL_WIDTH_80) ||
+        (options & ~PA_WIFIAP_HT_ALL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // Check the settings now if the driver is loaded, otherwise when the access point starts.
+    if ((LE_OK == UpdateBandCapa()) && (LE_OK != CheckHtConfig(width, options, &BandCapa)))
+    {
+        return LE_UNSUPPORTED;
+    }
+
+    if ((width != SavedChannelWidth) || (options != SavedHtOptions))
+    {
+        SetRestartPending();
+    }
+    SavedChannelWidth = width;
+    SavedHtOptions = options;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set which IEEE standard to use.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t stdMask
+        ///< [IN]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    int8_t hwMode = stdMask & 0x0F;
+    int8_t numCheck = (hwMode & 0x1) + ((hwMode >> 1) & 0x1) +
+                       ((hwMode >> 2) & 0x1) + ((hwMode >> 3) & 0x1);
+
+    LE_INFO("Set IeeeStdBitMask : 0x%X", stdMask);
+    //Hardware mode should be set.
+    if ( 0 == numCheck )
+    {
+        LE_WARN("No hardware mode is set.");
+        return LE_BAD_PARAMETER;
+    }
+    //Hardware mode should be exclusive.
+    if ( numCheck > 1 )
+    {
+        LE_WARN("Only one hardware mode can be set.");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
+    {
+        // ieee80211ac=1 only works with hw_mode=a
+        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_A) )
+        {
+            LE_WARN("ieee80211ac=1 only works with hw_mode=a.");
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_H )
+    {
+        // ieee80211h=1 can be used only with ieee80211d=1
+        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_D) )
+        {
+            LE_WARN("ieee80211h=1 only works with ieee80211d=1.");
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    if (stdMask != SavedIeeeStdMask)
+    {
+        SetRestartPending();
+    }
+    SavedIeeeStdMask = stdMask;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get which IEEE standard was set.
+ * Default hardware mode is IEEE 802.11g.
+ *
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetIeeeStandard
+(
+    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
+        ///< [OUT]
+        ///< Bit mask for the IEEE standard.
+)
+{
+    if ( NULL == stdMaskPtr )
+    {
+        LE_WARN("stdMaskPtr == NULL");
+        return LE_FAULT;
+    }
+
+    *stdMaskPtr = SavedIeeeStdMask;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set what country code to use for regulatory domain.
+ * ISO/IEC 3166-1 Alpha-2 code is used.
+ * Default country code is US.
+ * @return
+ *      - LE_FAULT if the function failed.
+ *      - LE_OK if the function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetCountryCode
+(
+    const char *countryCodePtr
+        /// [IN]
+        ///< the country code.
+)
+{
+    le_result_t result = LE_FAULT;
+
+    LE_INFO("Set countryCode");
+    if (NULL != countryCodePtr)
+    {
+        uint32_t length = strlen(countryCodePtr);
+
+        if (length == LE_WIFIDEFS_ISO_COUNTRYCODE_LENGTH)
+        {
+            if (0 != strcmp(SavedCountryCode, countryCodePtr))
+            {
+                SetRestartPending();
+            }
+            strncpy(&SavedCountryCode[0], &countryCodePtr[0], length );
+            SavedCountryCode[length] = '\0';
+            result = LE_OK;
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the maximum number of clients allowed to be connected to WiFi access point at the same time.
+ * Default value is 10.
+ *
+ * @note This value depends on the hardware/software capabilities of the WiFi module used.
+ *
+ * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the limit applies at once to the new associations.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetMaxNumberClients
+(
+    int maxNumberClients
         ///< [IN]
-        ///< The SSID to set as an octet array.
+        ///< The maximum number of clients. This depends on the hardware/software capabilities.
+)
+{
+    // Store maxNumberClients to be used later during startup procedure
+    le_result_t result = LE_OUT_OF_RANGE;
+    LE_INFO("Set max clients");
+    if ((maxNumberClients >= 1) && (maxNumberClients <= WIFI_MAX_USERS))
+    {
+       char value[12];
+
+       SavedMaxNumClients = maxNumberClients;
+       snprintf(value, sizeof(value), "%d", maxNumberClients);
+       ApplyParameter("max_num_sta", value, APPLY_SET);
+       result = LE_OK;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the beacon interval. Default value is 100.
+ *
+ * @return LE_OUT_OF_RANGE  The interval is lower than 15.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the interval is used from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBeaconInterval
+(
+    uint16_t beaconInterval
+        ///< [IN]
+        ///< Beacon interval, in time units of 1024 us.
+)
+{
+    LE_INFO("Set beacon interval: %u", beaconInterval);
+    if (beaconInterval < MIN_BEACON_INTERVAL)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    // The driver only takes the interval when the access point starts.
+    if (beaconInterval != SavedBeaconInterval)
+    {
+        SetRestartPending();
+    }
+    SavedBeaconInterval = beaconInterval;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the DTIM period, the number of beacons between two deliveries of the frames buffered for
+ * the stations in power save. Default value is 2.
+ *
+ * @return LE_OUT_OF_RANGE  The period is 0.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the period is used from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetDtimPeriod
+(
+    uint8_t dtimPeriod
+        ///< [IN]
+        ///< DTIM period, in beacon intervals.
+)
+{
+    LE_INFO("Set DTIM period: %u", dtimPeriod);
+    if (0 == dtimPeriod)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    // The driver only takes the period when the access point starts.
+    if (dtimPeriod != SavedDtimPeriod)
+    {
+        SetRestartPending();
+    }
+    SavedDtimPeriod = dtimPeriod;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the EDCA parameters of a WMM access category, used by the access point for its own
+ * transmissions and advertised to the stations. The defaults of hostapd are used for the access
+ * categories never set.
+ *
+ * @return LE_BAD_PARAMETER Invalid access category or parameter.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the parameters are advertised to the stations at once,
+ *       and used by the access point from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetWmmParams
+(
+    pa_wifiAp_WmmAc_t ac,
+        ///< [IN]
+        ///< Access category.
+    const pa_wifiAp_WmmParams_t *paramsPtr
+        ///< [IN]
+        ///< EDCA parameters.
+)
+{
+    WmmAcConfig_t *configPtr;
+    Parameter_t    params[4];
+    char           names[4][32];
+    char           values[4][8];
+    int            i;
+
+    if ((ac < 0) || (ac >= PA_WIFIAP_WMM_AC_COUNT) || (NULL == paramsPtr) ||
+        (paramsPtr->aifs < 1) || (paramsPtr->aifs > MAX_WMM_AIFS) ||
+        (paramsPtr->ecwMax > MAX_WMM_ECW) || (paramsPtr->ecwMin > paramsPtr->ecwMax))
+    {
+        LE_WARN("Invalid WMM parameters");
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Set WMM parameters of AC_%s: AIFS %u, ECWmin %u, ECWmax %u, TXOP limit %u",
+            WmmAcNames[ac], paramsPtr->aifs, paramsPtr->ecwMin, paramsPtr->ecwMax,
+            paramsPtr->txopLimit);
+
+    configPtr = &SavedWmmAcConfig[ac];
+    // The transmit queues of the access point are only set when it starts.
+    if ((!configPtr->isSet) || (0 != memcmp(&configPtr->params, paramsPtr, sizeof(*paramsPtr))))
+    {
+        SetRestartPending();
+    }
+    configPtr->isSet = true;
+    configPtr->params = *paramsPtr;
+
+    // hostapd updates the WMM parameter element of the beacons of all the BSS.
+    snprintf(names[0], sizeof(names[0]), "wmm_ac_%s_aifs", WmmAcNames[ac]);
+    snprintf(values[0], sizeof(values[0]), "%u", paramsPtr->aifs);
+    snprintf(names[1], sizeof(names[1]), "wmm_ac_%s_cwmin", WmmAcNames[ac]);
+    snprintf(values[1], sizeof(values[1]), "%u", paramsPtr->ecwMin);
+    snprintf(names[2], sizeof(names[2]), "wmm_ac_%s_cwmax", WmmAcNames[ac]);
+    snprintf(values[2], sizeof(values[2]), "%u", paramsPtr->ecwMax);
+    snprintf(names[3], sizeof(names[3]), "wmm_ac_%s_txop_limit", WmmAcNames[ac]);
+    snprintf(values[3], sizeof(values[3]), "%u", paramsPtr->txopLimit);
+    for (i = 0; i < NUM_ARRAY_MEMBERS(params); i++)
+    {
+        params[i].namePtr = names[i];
+        params[i].valuePtr = values[i];
+    }
+    ApplyParameters("WMM parameters", params, NUM_ARRAY_MEMBERS(params), APPLY_SET, false);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time after which an inactive station is disconnected. Default value is 300 seconds.
+ *
+ * @return LE_OUT_OF_RANGE  The time is 0.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the time applies at once.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetMaxInactivity
+(
+    uint32_t maxInactivity
+        ///< [IN]
+        ///< Maximum inactivity, in seconds.
+)
+{
+    char        value[12];
+    Parameter_t param = { "ap_max_inactivity", value };
+
+    LE_INFO("Set max inactivity: %u s", maxInactivity);
+    if (0 == maxInactivity)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    SavedMaxInactivity = maxInactivity;
+    snprintf(value, sizeof(value), "%u", maxInactivity);
+    ApplyParameters(param.namePtr, &param, 1, APPLY_SET, true);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate a station from the access point.
+ *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_NOT_FOUND     The station is not associated.
+ * @return LE_FAULT         The access point is not started or the request failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Deauthenticate
+(
+    const char *macAddressPtr,
+        ///< [IN]
+        ///< Station MAC address, xx:xx:xx:xx:xx:xx.
+    uint16_t reason
+        ///< [IN]
+        ///< IEEE 802.11 reason code, 0 for the default one.
+)
+{
+    uint8_t bssIndex;
+
+    if ((NULL == macAddressPtr) || (LE_WIFIDEFS_MAX_BSSID_LENGTH != strlen(macAddressPtr)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (!IsApStarted)
+    {
+        return LE_FAULT;
+    }
+
+    // Each BSS has its own hostapd control interface: find the one of the station.
+    for (bssIndex = 0; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
+    {
+        const char *ifNamePtr = (0 == bssIndex) ? ApIfName : BssTable[bssIndex].ifName;
+
+        if ((0 != bssIndex) && (!BssTable[bssIndex].isEnabled))
+        {
+            continue;
+        }
+        if (LE_OK == pa_wifiHostapd_HasStation(ifNamePtr, macAddressPtr))
+        {
+            LE_INFO("Deauthenticate %s from %s, reason %u", macAddressPtr, ifNamePtr, reason);
+            return (LE_OK == pa_wifiHostapd_Deauthenticate(ifNamePtr, macAddressPtr, reason)) ?
+                   LE_OK : LE_FAULT;
+        }
+    }
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stations found by a station dump, to be deauthenticated once the dump is over.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t count;
+    struct
+    {
+        char macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];
+        char ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];
+    }
+    stations[PA_WIFIACL_MAX_MACS];
+}
+DeniedStations_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station dump handler recording the stations no longer allowed by the access control.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeniedStationHandler
+(
+    const pa_wifiAp_Station_t *stationPtr,
+    void *contextPtr
+)
+{
+    DeniedStations_t *deniedPtr = contextPtr;
+
+    if (pa_wifiAcl_IsAllowed(stationPtr->macAddress))
+    {
+        return;
+    }
+    if (deniedPtr->count >= NUM_ARRAY_MEMBERS(deniedPtr->stations))
+    {
+        LE_WARN("Too many denied stations, %s stays associated", stationPtr->macAddress);
+        return;
+    }
+
+    le_utf8_Copy(deniedPtr->stations[deniedPtr->count].macAddress, stationPtr->macAddress,
+                 sizeof(deniedPtr->stations[0].macAddress), NULL);
+    le_utf8_Copy(deniedPtr->stations[deniedPtr->count].ifName, stationPtr->ifName,
+                 sizeof(deniedPtr->stations[0].ifName), NULL);
+    deniedPtr->count++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate the associated stations which the access control no longer allows. hostapd only
+ * checks the access control when a station associates.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeauthenticateDenied
+(
+    void
+)
+{
+    DeniedStations_t denied = { 0 };
+    size_t           i;
+
+    pa_wifiAp_GetStations(DeniedStationHandler, &denied);
+    for (i = 0; i < denied.count; i++)
+    {
+        LE_INFO("Deauthenticate denied station %s", denied.stations[i].macAddress);
+        pa_wifiHostapd_Deauthenticate(denied.stations[i].ifName, denied.stations[i].macAddress, 0);
+    }
+}
 
-    size_t ssidNumElements
-        ///< [IN]
-        ///< The length of the SSID in bytes.
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a MAC address list change to the running hostapd of each BSS, without disconnecting the
+ * allowed stations. The list files are updated for the next start in any case.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyAcl
+(
+    pa_wifiAcl_List_t list,
+    pa_wifiHostapd_AclAction_t action,
+    const char *macAddressPtr
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
+    le_result_t result = LE_OK;
+    uint8_t     bssIndex;
 
-    LE_INFO("SSID length %d | SSID: \"%.*s\"",
-            (int)ssidNumElements,
-            (int)ssidNumElements,
-            (char *)ssidPtr);
+    if (!IsApStarted)
+    {
+        return;
+    }
 
-    if ((0 < ssidNumElements) && (ssidNumElements <= LE_WIFIDEFS_MAX_SSID_LENGTH))
+    if (LE_FAULT == GenerateHostapdConf())
     {
-        // Store SSID to be used later during startup procedure
-        memcpy(&SavedSsid[0], (const char *)&ssidPtr[0], ssidNumElements);
-        // Make sure there is a null termination
-        SavedSsid[ssidNumElements] = '\0';
-        result = LE_OK;
+        LE_WARN("Unable to apply the MAC address list to the running access point");
+        return;
     }
-    else
+
+    for (bssIndex = 0; (LE_OK == result) && (bssIndex < PA_WIFIAP_MAX_BSS); bssIndex++)
     {
-        LE_ERROR("ERROR: SSID length exceeds %d bytes\n", LE_WIFIDEFS_MAX_SSID_LENGTH);
+        const char *ifNamePtr = (0 == bssIndex) ? ApIfName : BssTable[bssIndex].ifName;
+
+        if ((0 != bssIndex) && (!BssTable[bssIndex].isEnabled))
+        {
+            continue;
+        }
+
+        result = pa_wifiHostapd_UpdateAcl(ifNamePtr, list, action, macAddressPtr);
+        if (LE_UNSUPPORTED == result)
+        {
+            // Old hostapd: read the list files again, at the cost of the associations.
+            LE_INFO("hostapd does not support ACL updates, reloading %s", ifNamePtr);
+            result = pa_wifiHostapd_Reload(ifNamePtr);
+        }
     }
-    return result;
+
+    if (LE_OK != result)
+    {
+        LE_WARN("Unable to apply the MAC address list to the running access point, it will be "
+                "used on next start");
+        pa_wifiConf_Invalidate(&HostapdConfFile);
+        return;
+    }
+    DeauthenticateDenied();
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the security protocol used to communicate.
+ * Set the MAC address access control policy. Default is PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED.
  *
- * @note WEP is not supported as it is unsecure and has been deprecated in favor of WPA/WPA2.
- * This limitation applies to access point mode only.
- *
- * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_BAD_PARAMETER The policy is invalid.
  * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the policy applies at once, and the stations it no longer
+ *       allows are deauthenticated.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetSecurityProtocol
+le_result_t pa_wifiAp_SetMacAclPolicy
 (
-    le_wifiAp_SecurityProtocol_t securityProtocol
+    pa_wifiAcl_Policy_t policy
         ///< [IN]
-        ///< The security protocol used to communicate with the access point.
+        ///< Access control policy.
 )
 {
-    le_result_t result;
+    char        value[4];
+    Parameter_t param = { "macaddr_acl", value };
 
-    LE_INFO("Security protocol : %d", securityProtocol);
-    switch (securityProtocol)
+    LE_INFO("Set MAC address access control policy: %d", policy);
+    if ((PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED != policy) &&
+        (PA_WIFIACL_POLICY_DENY_UNLESS_ACCEPTED != policy))
     {
-        case LE_WIFIAP_SECURITY_NONE:
-        case LE_WIFIAP_SECURITY_WPA2:
-            SavedSecurityProtocol = securityProtocol;
-            result = LE_OK;
-            break;
+        return LE_BAD_PARAMETER;
+    }
 
-        default:
-            result = LE_BAD_PARAMETER;
-            break;
+    pa_wifiAcl_SetPolicy(policy);
+    snprintf(value, sizeof(value), "%d", (int)policy);
+    ApplyParameters(param.namePtr, &param, 1, APPLY_SET, true);
+    if (IsApStarted)
+    {
+        DeauthenticateDenied();
     }
-    return result;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the passphrase used to generate the PSK.
+ * Add a MAC address to an access control list.
  *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * pa_wifiAp_SetPreSharedKey() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
+ * @return LE_BAD_PARAMETER The list or the MAC address is invalid.
+ * @return LE_NO_MEMORY     The list is full.
+ * @return LE_OK            Function succeeded, or the address was already in the list.
  *
- * @return LE_BAD_PARAMETER Parameter is invalid.
- * @return LE_OK            Function succeeded.
+ * @note If the access point is started, the list applies at once, and the stations it no longer
+ *       allows are deauthenticated.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetPassPhrase
+le_result_t pa_wifiAp_AddMacAcl
 (
-    const char *passphrasePtr
+    pa_wifiAcl_List_t list,
         ///< [IN]
-        ///< Passphrase to authenticate against the access point.
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
+    le_result_t result = pa_wifiAcl_Add(list, macAddressPtr);
 
-    LE_INFO("Set passphrase");
-    if (NULL != passphrasePtr)
+    if (LE_DUPLICATE == result)
     {
-        uint32_t length = strlen(passphrasePtr);
-
-        if ((length >= LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) &&
-            (length <= LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
-        {
-            // Store Passphrase to be used later during startup procedure
-            le_utf8_Copy(SavedPassphrase, passphrasePtr, sizeof(SavedPassphrase), NULL);
-            result = LE_OK;
-        }
-        else
-        {
-            LE_ERROR("Invalid passphrase length (%d) [%d..%d]",
-                    length,
-                    LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH,
-                    LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH);
-        }
+        return LE_OK;
+    }
+    if (LE_OK == result)
+    {
+        ApplyAcl(list, PA_WIFIHOSTAPD_ACL_ADD, macAddressPtr);
     }
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the pre-shared key (PSK).
+ * Remove a MAC address from an access control list.
  *
- * @note This is one way to authenticate against the access point. The other one is provided by the
- * pa_wifiAp_SetPassPhrase() function. Both ways are exclusive and are effective only when used
- * with WPA-personal authentication.
- *
- * @return LE_BAD_PARAMETER Parameter is invalid.
+ * @return LE_BAD_PARAMETER The list or the MAC address is invalid.
+ * @return LE_NOT_FOUND     The MAC address is not in the list.
  * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the list applies at once, and the stations it no longer
+ *       allows are deauthenticated.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetPreSharedKey
+le_result_t pa_wifiAp_RemoveMacAcl
 (
-    const char *preSharedKeyPtr
+    pa_wifiAcl_List_t list,
         ///< [IN]
-        ///< Pre-shared key used to authenticate against the access point.
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
 )
 {
-    le_result_t result = LE_BAD_PARAMETER;
+    le_result_t result = pa_wifiAcl_Remove(list, macAddressPtr);
 
-    LE_INFO("Set PSK");
-    if (NULL != preSharedKeyPtr)
+    if (LE_OK == result)
     {
-        uint32_t length = strlen(preSharedKeyPtr);
-
-        if (length <= LE_WIFIDEFS_MAX_PSK_LENGTH)
-        {
-            // Store PSK to be used later during startup procedure
-            le_utf8_Copy(SavedPreSharedKey, preSharedKeyPtr, sizeof(SavedPreSharedKey), NULL);
-            result = LE_OK;
-        }
+        ApplyAcl(list, PA_WIFIHOSTAPD_ACL_DEL, macAddressPtr);
     }
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set if the access point should announce its presence.
- * Default value is TRUE.
- * If the value is set to FALSE, the access point will be hidden.
+ * Remove all the MAC addresses of an access control list.
  *
+ * @return LE_BAD_PARAMETER The list is invalid.
  * @return LE_OK            Function succeeded.
  *
+ * @note If the access point is started, the list applies at once, and the stations it no longer
+ *       allows are deauthenticated.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetDiscoverable
+le_result_t pa_wifiAp_ClearMacAcl
 (
-    bool isDiscoverable
+    pa_wifiAcl_List_t list
         ///< [IN]
-        ///< If TRUE, the access point SSID is visible by the clients otherwise it is hidden.
+        ///< MAC address list.
 )
 {
-    // Store Discoverable to be used later during startup procedure
-    LE_INFO("Set discoverability");
-    SavedDiscoverable = isDiscoverable;
-    return LE_OK;
+    le_result_t result = pa_wifiAcl_Clear(list);
+
+    if (LE_OK == result)
+    {
+        ApplyAcl(list, PA_WIFIHOSTAPD_ACL_CLEAR, NULL);
+    }
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which WiFi channel to use.
- * Default number is 7.
- * Some legal restrictions might apply for your region.
- * The channel number must be between 1 and 14 for IEEE 802.11b/g.
- * The channel number must be between 7 and 196 for IEEE 802.11a.
- * The channel number must be between 1 and 6 for IEEE 802.11ad.
- * @return
- *      - LE_OUT_OF_RANGE if requested channel number is out of range.
- *      - LE_OK if the function succeeded.
+ * Append the DHCP range of an interface to the dnsmasq related configuration. The range is tagged
+ * with the interface name, so that each interface gets its own router and DNS server options.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendDhcpRange
+(
+    pa_wifiConf_Buffer_t *confPtr,
+    const char *ifNamePtr,
+    const char *ipApPtr,
+    const char *ipStartPtr,
+    const char *ipStopPtr
+)
+{
+    pa_wifiConf_Append(confPtr,
+                       "interface=%s\n"
+                       "dhcp-range=set:%s,%s,%s,%dh\n"
+                       "dhcp-option=tag:%s,%d,%s\n"
+                       "dhcp-option=tag:%s,%d,%s\n",
+                       ifNamePtr,
+                       ifNamePtr, ipStartPtr, ipStopPtr, DNSMASQ_LEASE_HOURS,
+                       ifNamePtr, 3, ipApPtr,
+                       ifNamePtr, 6, ipApPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the dnsmasq related configuration file with the DHCP ranges of all the BSS.
  *
+ * @return LE_NOT_FOUND     No DHCP range is defined.
+ * @return LE_FAULT         The file can not be written.
+ * @return LE_DUPLICATE     The file is unchanged.
+ * @return LE_OK            The file is written.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetChannel
+static le_result_t WriteDnsmasqConf
 (
-    uint16_t channelNumber
-        ///< [IN]
-        ///< the channel number.
+    void
 )
 {
-    le_result_t result = LE_OUT_OF_RANGE;
-    int8_t hwMode = SavedIeeeStdMask & 0x0F;
+    pa_wifiConf_Buffer_t conf = PA_WIFICONF_BUFFER_INIT;
+    le_result_t          result = LE_NOT_FOUND;
+    uint8_t              bssIndex;
 
-    LE_INFO("Set channel");
-    switch (hwMode)
+    if ('\0' != SavedIpAp[0])
     {
-        case LE_WIFIAP_BITMASK_IEEE_STD_A:
-            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_A;
-            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_A;
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_B:
-        case LE_WIFIAP_BITMASK_IEEE_STD_G:
-            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_VALUE;
-            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_VALUE;
-            break;
-        case LE_WIFIAP_BITMASK_IEEE_STD_AD:
-            MIN_CHANNEL_VALUE = LE_WIFIDEFS_MIN_CHANNEL_STD_AD;
-            MAX_CHANNEL_VALUE = LE_WIFIDEFS_MAX_CHANNEL_STD_AD;
-            break;
-        default:
-            LE_WARN("Invalid hardware mode");
+        AppendDhcpRange(&conf, ApIfName, SavedIpAp, SavedIpStart, SavedIpStop);
     }
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
+    {
+        const Bss_t *bssPtr = &BssTable[bssIndex];
 
-    if ((channelNumber >= MIN_CHANNEL_VALUE) &&
-        (channelNumber <= MAX_CHANNEL_VALUE))
+        if (bssPtr->isEnabled && ('\0' != bssPtr->ipAp[0]))
+        {
+            AppendDhcpRange(&conf, bssPtr->ifName, bssPtr->ipAp, bssPtr->ipStart, bssPtr->ipStop);
+        }
+    }
+
+    if (conf.length > 0)
     {
-       SavedChannelNumber = channelNumber;
-       result = LE_OK;
+        LE_INFO("Creation of dnsmasq configuration file (%s)", DNSMASQ_CFG_FILE);
+        result = pa_wifiConf_Write(&DnsmasqConfFile, DNSMASQ_CFG_FILE, &conf);
     }
+    pa_wifiConf_Release(&conf);
     return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set which IEEE standard to use.
- * Default hardware mode is IEEE 802.11g.
+ * Start or restart the DHCP server of the WLAN with the dnsmasq related configuration file.
  *
- * @return
- *      - LE_BAD_PARAMETER if invalid IEEE standard is set.
- *      - LE_OK if the function succeeded.
+ * A dedicated dnsmasq instance, with its own pid and lease files named after the interface, is
+ * used so that the other dnsmasq users of the system are not affected and the leases survive its
+ * restart. It also answers the DNS requests on the interfaces of the WLAN, the address of the
+ * access point being advertised as DNS server. If it can not be started (ex: the system dnsmasq
+ * already owns the DHCP port), the configuration file is linked in the configuration directory of
+ * the system dnsmasq, which is restarted.
  *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetIeeeStandard
+static le_result_t StartDhcpServer
 (
-    le_wifiAp_IeeeStdBitMask_t stdMask
-        ///< [IN]
-        ///< Bit mask for the IEEE standard.
+    void
 )
 {
-    int8_t hwMode = stdMask & 0x0F;
-    int8_t numCheck = (hwMode & 0x1) + ((hwMode >> 1) & 0x1) +
-                       ((hwMode >> 2) & 0x1) + ((hwMode >> 3) & 0x1);
-
-    LE_INFO("Set IeeeStdBitMask : 0x%X", stdMask);
-    //Hardware mode should be set.
-    if ( 0 == numCheck )
-    {
-        LE_WARN("No hardware mode is set.");
-        return LE_BAD_PARAMETER;
-    }
-    //Hardware mode should be exclusive.
-    if ( numCheck > 1 )
-    {
-        LE_WARN("Only one hardware mode can be set.");
-        return LE_BAD_PARAMETER;
-    }
+    int systemResult;
 
-    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_AC )
+    if (DHCP_SERVER_SYSTEM != DhcpServer)
     {
-        // ieee80211ac=1 only works with hw_mode=a
-        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_A) )
+        char leaseFile[PATH_MAX];
+        char cmd[2 * PATH_MAX];
+
+        snprintf(DnsmasqPidFile, sizeof(DnsmasqPidFile), DNSMASQ_PID_FILE_FORMAT, ApIfName);
+        snprintf(leaseFile, sizeof(leaseFile), DNSMASQ_LEASE_FILE_FORMAT, ApIfName);
+        snprintf(cmd, sizeof(cmd), "%s %s %s",
+                 COMMAND_DNSMASQ_WLAN_START, DnsmasqPidFile, leaseFile);
+        systemResult = pa_wifiCmd_Run(cmd, NULL, 0);
+        if ((WIFEXITED(systemResult)) && (0 == WEXITSTATUS(systemResult)))
         {
-            LE_WARN("ieee80211ac=1 only works with hw_mode=a.");
-            return LE_BAD_PARAMETER;
+            DhcpServer = DHCP_SERVER_DEDICATED;
+            pa_wifiDhcp_SetLeaseFile(leaseFile);
+            return LE_OK;
         }
+        LE_WARN("Unable to start a dedicated DHCP server, using the system one.");
     }
 
-    if ( stdMask & LE_WIFIAP_BITMASK_IEEE_STD_H )
+    if (symlink(DNSMASQ_CFG_FILE, DNSMASQ_CFG_LINK) && (EEXIST != errno))
     {
-        // ieee80211h=1 can be used only with ieee80211d=1
-        if ( 0 == (stdMask & LE_WIFIAP_BITMASK_IEEE_STD_D) )
-        {
-            LE_WARN("ieee80211h=1 only works with ieee80211d=1.");
-            return LE_BAD_PARAMETER;
-        }
+        LE_ERROR("Unable to create link to dnsmasq configuration file: %m.");
+        return LE_FAULT;
     }
 
-    SavedIeeeStdMask = stdMask;
+    systemResult = pa_wifiCmd_Run(COMMAND_DNSMASQ_RESTART, NULL, 0);
+    if (0 != WEXITSTATUS (systemResult))
+    {
+        return LE_FAULT;
+    }
+    DhcpServer = DHCP_SERVER_SYSTEM;
+    pa_wifiDhcp_SetLeaseFile(DNSMASQ_SYSTEM_LEASE_FILE);
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get which IEEE standard was set.
- * Default hardware mode is IEEE 802.11g.
- *
- * @return
- *      - LE_FAULT if the function failed.
- *      - LE_OK if the function succeeded.
+ * Stop the DHCP server of the WLAN.
  *
+ * The dedicated dnsmasq instance is terminated through its pid file, so that it is stopped even if
+ * it was started before a restart of the WiFi service. The system dnsmasq is only restarted when it
+ * was serving the WLAN, to drop the WLAN configuration.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_GetIeeeStandard
+static void StopDhcpServer
 (
-    le_wifiAp_IeeeStdBitMask_t *stdMaskPtr
-        ///< [OUT]
-        ///< Bit mask for the IEEE standard.
+    void
 )
 {
-    if ( NULL == stdMaskPtr )
+    struct stat st;
+    pid_t       pid;
+
+    remove(DNSMASQ_CFG_FILE);
+
+    if ('\0' == DnsmasqPidFile[0])
     {
-        LE_WARN("stdMaskPtr == NULL");
-        return LE_FAULT;
+        snprintf(DnsmasqPidFile, sizeof(DnsmasqPidFile), DNSMASQ_PID_FILE_FORMAT, ApIfName);
+    }
+    if (LE_OK == pa_wifiProc_ReadPidFile(DnsmasqPidFile, "dnsmasq", &pid))
+    {
+        if (LE_OK != pa_wifiProc_Stop(pid, DNSMASQ_TERMINATE_TIMEOUT_MS))
+        {
+            LE_WARN("Unable to stop the DHCP server %d", (int)pid);
+        }
+    }
+    remove(DnsmasqPidFile);
+    DnsmasqPidFile[0] = '\0';
+
+    if ((0 == lstat(DNSMASQ_CFG_LINK, &st)) && S_ISLNK(st.st_mode))
+    {
+        int systemResult;
+
+        unlink(DNSMASQ_CFG_LINK);
+        systemResult = pa_wifiCmd_Run(COMMAND_DNSMASQ_RESTART, NULL, 0);
+        if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+        {
+            LE_WARN("Unable to restart the system DHCP server");
+        }
     }
 
-    *stdMaskPtr = SavedIeeeStdMask;
-    return LE_OK;
+    DhcpServer = DHCP_SERVER_NONE;
+    pa_wifiDhcp_SetLeaseFile(NULL);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set what country code to use for regulatory domain.
- * ISO/IEC 3166-1 Alpha-2 code is used.
- * Default country code is US.
- * @return
- *      - LE_FAULT if the function failed.
- *      - LE_OK if the function succeeded.
+ * Write the dnsmasq related configuration file and start or restart the DHCP server of the WLAN,
+ * unless the configuration is unchanged and the DHCP server is running. The DHCP server is stopped
+ * once no DHCP range is left.
  *
+ * @return LE_FAULT         The function failed.
+ * @return LE_OK            The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetCountryCode
+static le_result_t UpdateDhcpServer
 (
-    const char *countryCodePtr
-        /// [IN]
-        ///< the country code.
+    void
 )
 {
-    le_result_t result = LE_FAULT;
+    le_result_t result = WriteDnsmasqConf();
 
-    LE_INFO("Set countryCode");
-    if (NULL != countryCodePtr)
+    switch (result)
     {
-        uint32_t length = strlen(countryCodePtr);
+        case LE_NOT_FOUND:
+            if (DHCP_SERVER_NONE != DhcpServer)
+            {
+                LE_INFO("No DHCP range left, stopping the DHCP server.");
+                StopDhcpServer();
+            }
+            return LE_OK;
 
-        if (length == LE_WIFIDEFS_ISO_COUNTRYCODE_LENGTH)
-        {
-            strncpy(&SavedCountryCode[0], &countryCodePtr[0], length );
-            SavedCountryCode[length] = '\0';
-            result = LE_OK;
-        }
+        case LE_DUPLICATE:
+            if (DHCP_SERVER_NONE != DhcpServer)
+            {
+                // The running DHCP server already has this configuration.
+                LE_INFO("DHCP server configuration unchanged.");
+                return LE_OK;
+            }
+            break;
+
+        case LE_OK:
+            break;
+
+        default:
+            LE_ERROR("Unable to write the dnsmasq configuration file.");
+            return LE_FAULT;
     }
-    return result;
+
+    if (LE_OK != StartDhcpServer())
+    {
+        LE_ERROR("Unable to restart the DHCP server.");
+        return LE_FAULT;
+    }
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the maximum number of clients allowed to be connected to WiFi access point at the same time.
- * Default value is 10.
- *
- * @note This value depends on the hardware/software capabilities of the WiFi module used.
- *
- * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
- * @return LE_OK            Function succeeded.
+ * Set the addresses of the additional BSS and serve their DHCP ranges, once hostapd created their
+ * interfaces.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetMaxNumberClients
+static void ApplyBssIpRanges
 (
-    int maxNumberClients
-        ///< [IN]
-        ///< The maximum number of clients. This depends on the hardware/software capabilities.
+    void
 )
 {
-    // Store maxNumberClients to be used later during startup procedure
-    le_result_t result = LE_OUT_OF_RANGE;
-    LE_INFO("Set max clients");
-    if ((maxNumberClients >= 1) && (maxNumberClients <= WIFI_MAX_USERS))
+    bool    hasRange = false;
+    uint8_t bssIndex;
+
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
     {
-       SavedMaxNumClients = maxNumberClients;
-       result = LE_OK;
+        Bss_t *bssPtr = &BssTable[bssIndex];
+
+        if (bssPtr->isEnabled && ('\0' != bssPtr->ipAp[0]))
+        {
+            hasRange = true;
+            if (!bssPtr->isUp)
+            {
+                SetBssAddress(bssPtr);
+            }
+        }
+    }
+
+    if (hasRange)
+    {
+        UpdateDhcpServer();
     }
-    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Define the access point IP address and the client IP addresses range.
- *
- * @note The access point IP address must be defined outside the client IP addresses range.
+ * Check the access point IP address and the client IP addresses range.
  *
  * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
- * @return LE_FAULT         A system call has failed.
  * @return LE_OK            Function succeeded.
- *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_wifiAp_SetIpRange
+static le_result_t CheckIpRange
 (
     const char *ipApPtr,
-        ///< [IN]
-        ///< the IP address of the Access Point.
     const char *ipStartPtr,
-        ///< [IN]
-        ///< the start IP address of the Access Point.
     const char *ipStopPtr
-        ///< [IN]
-        ///< the stop IP address of the Access Point.
 )
 {
     struct sockaddr_in  saApPtr;
@@ -1270,6 +3230,43 @@ le_result_t pa_wifiAp_SetIpRange
         }
     }
 
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the access point IP address and the client IP addresses range.
+ *
+ * @note The access point IP address must be defined outside the client IP addresses range.
+ *
+ * @note The DHCP server of the WLAN is only restarted if the range changes, and keeps its leases.
+ *
+ * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetIpRange
+(
+    const char *ipApPtr,
+        ///< [IN]
+        ///< the IP address of the Access Point.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< the start IP address of the Access Point.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< the stop IP address of the Access Point.
+)
+{
+    le_result_t result = CheckIpRange(ipApPtr, ipStartPtr, ipStopPtr);
+
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
     putenv("PATH=/legato/systems/current/bin:/usr/local/bin:"
         "/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin");
 
@@ -1278,11 +3275,11 @@ le_result_t pa_wifiAp_SetIpRange
         int  systemResult;
 
         snprintf((char *)&cmd, sizeof(cmd), "%s %s %s",
-                WIFI_SCRIPT_PATH,
                 COMMAND_WIFIAP_WLAN_UP,
-                ipApPtr);
+                ipApPtr,
+                ApIfName);
 
-        systemResult = system(cmd);
+        systemResult = pa_wifiCmd_Run(cmd, NULL, 0);
         if (0 != WEXITSTATUS (systemResult))
         {
             LE_ERROR("Unable to mount the network interface.");
@@ -1290,44 +3287,22 @@ le_result_t pa_wifiAp_SetIpRange
         }
         else
         {
-            FILE *filePtr;
-
-            LE_INFO("Creation of dnsmasq configuration file (%s)", DNSMASQ_CFG_FILE);
-
-            if (symlink(DNSMASQ_CFG_FILE, DNSMASQ_CFG_LINK) && (EEXIST != errno))
-            {
-                LE_ERROR("Unable to create link to dnsmasq configuration file: %m.");
-                return LE_FAULT;
-            }
-            filePtr = fopen (DNSMASQ_CFG_FILE, "w");
-            if (filePtr != NULL)
-            {
-                //Interface is generated when COMMAND_DNSMASQ_RESTART called
-                fprintf(filePtr, "dhcp-range=%s,%s,%dh\n", ipStartPtr, ipStopPtr, 24);
-                fprintf(filePtr, "dhcp-option=%d,%s\n", 3, ipApPtr);
-                fprintf(filePtr, "dhcp-option=%d,%s\n", 6, ipApPtr);
-                fclose(filePtr);
-            }
-            else
-            {
-                LE_ERROR("Unable to open the dnsmasq configuration file: %m.");
-                return LE_FAULT;
-            }
-
             LE_INFO("@AP=%s, @APstart=%s, @APstop=%s", ipApPtr, ipStartPtr, ipStopPtr);
+            le_utf8_Copy(SavedIpAp, ipApPtr, sizeof(SavedIpAp), NULL);
+            le_utf8_Copy(SavedIpStart, ipStartPtr, sizeof(SavedIpStart), NULL);
+            le_utf8_Copy(SavedIpStop, ipStopPtr, sizeof(SavedIpStop), NULL);
 
             // Insert the rule allowing the DHCP ports on WLAN
-            systemResult = system(WIFI_SCRIPT_PATH COMMAND_IPTABLE_DHCP_INSERT);
+            snprintf((char *)&cmd, sizeof(cmd), "%s %s", COMMAND_IPTABLE_DHCP_INSERT, ApIfName);
+            systemResult = pa_wifiCmd_Run(cmd, NULL, 0);
             if (0 != WEXITSTATUS (systemResult))
             {
                 LE_ERROR("Unable to allow DHCP ports.");
                 return LE_FAULT;
             }
 
-            systemResult = system(WIFI_SCRIPT_PATH COMMAND_DNSMASQ_RESTART);
-            if (0 != WEXITSTATUS (systemResult))
+            if (LE_OK != UpdateDhcpServer())
             {
-                LE_ERROR("Unable to restart the DHCP server.");
                 return LE_FAULT;
             }
         }
@@ -1335,3 +3310,222 @@ le_result_t pa_wifiAp_SetIpRange
 
     return LE_OK;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add, change or remove an additional BSS of the access point. hostapd creates its interface,
+ * named after the main one (ex: wlan0_1).
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note The BSS are applied at the next start or restart of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBss
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS index, from 1 to PA_WIFIAP_MAX_BSS - 1.
+    const pa_wifiAp_BssConfig_t *configPtr
+        ///< [IN]
+        ///< Settings of the BSS, or NULL to remove it.
+)
+{
+    Bss_t *bssPtr;
+
+    if ((0 == bssIndex) || (bssIndex >= PA_WIFIAP_MAX_BSS))
+    {
+        LE_ERROR("Invalid BSS index %u", bssIndex);
+        return LE_BAD_PARAMETER;
+    }
+    bssPtr = &BssTable[bssIndex];
+
+    if (NULL == configPtr)
+    {
+        bool hadRange = bssPtr->isEnabled && ('\0' != bssPtr->ipAp[0]);
+
+        LE_INFO("Remove BSS %u", bssIndex);
+        if (bssPtr->isUp)
+        {
+            char cmd[128];
+
+            snprintf(cmd, sizeof(cmd), "%s %s", COMMAND_WIFIAP_BSS_DOWN, bssPtr->ifName);
+            pa_wifiCmd_Run(cmd, NULL, 0);
+        }
+        memset(bssPtr, 0, sizeof(Bss_t));
+        // Stop serving its DHCP range.
+        if (hadRange && (DHCP_SERVER_NONE != DhcpServer))
+        {
+            UpdateDhcpServer();
+        }
+        return LE_OK;
+    }
+
+    if ((0 == configPtr->ssidLength) || (configPtr->ssidLength > LE_WIFIDEFS_MAX_SSID_LENGTH))
+    {
+        LE_ERROR("Invalid SSID length %zu", configPtr->ssidLength);
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((configPtr->maxNumClients < 1) || (configPtr->maxNumClients > WIFI_MAX_USERS))
+    {
+        LE_ERROR("Invalid maximum number of clients %u", configPtr->maxNumClients);
+        return LE_BAD_PARAMETER;
+    }
+
+    switch (configPtr->securityProtocol)
+    {
+        case LE_WIFIAP_SECURITY_NONE:
+            break;
+
+        case LE_WIFIAP_SECURITY_WPA2:
+        {
+            size_t length = strnlen(configPtr->passphrase, sizeof(configPtr->passphrase));
+
+            if ((length < LE_WIFIDEFS_MIN_PASSPHRASE_LENGTH) ||
+                (length > LE_WIFIDEFS_MAX_PASSPHRASE_LENGTH))
+            {
+                LE_ERROR("Invalid passphrase length %zu", length);
+                return LE_BAD_PARAMETER;
+            }
+            break;
+        }
+
+        default:
+            LE_ERROR("Unsupported security protocol %d", configPtr->securityProtocol);
+            return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Set BSS %u, SSID: \"%.*s\"", bssIndex, (int)configPtr->ssidLength,
+            (const char *)configPtr->ssid);
+    bssPtr->config = *configPtr;
+    bssPtr->config.ssid[bssPtr->config.ssidLength] = '\0';
+    bssPtr->isEnabled = true;
+    SetBssIfName(bssIndex);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the IP address of an additional BSS and the client IP addresses range served on it.
+ *
+ * @return LE_BAD_PARAMETER The BSS does not exist, or one of the IP addresses is invalid.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is not started, the range is applied when it starts.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBssIpRange
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS index, from 1 to PA_WIFIAP_MAX_BSS - 1.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< IP address of the BSS interface.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< First client IP address.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< Last client IP address.
+)
+{
+    Bss_t      *bssPtr;
+    le_result_t result;
+
+    if ((0 == bssIndex) || (bssIndex >= PA_WIFIAP_MAX_BSS) || (!BssTable[bssIndex].isEnabled))
+    {
+        LE_ERROR("Invalid BSS index %u", bssIndex);
+        return LE_BAD_PARAMETER;
+    }
+    bssPtr = &BssTable[bssIndex];
+
+    result = CheckIpRange(ipApPtr, ipStartPtr, ipStopPtr);
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    le_utf8_Copy(bssPtr->ipStart, ipStartPtr, sizeof(bssPtr->ipStart), NULL);
+    le_utf8_Copy(bssPtr->ipStop, ipStopPtr, sizeof(bssPtr->ipStop), NULL);
+    if (0 != strcmp(bssPtr->ipAp, ipApPtr))
+    {
+        le_utf8_Copy(bssPtr->ipAp, ipApPtr, sizeof(bssPtr->ipAp), NULL);
+        bssPtr->isUp = false;
+    }
+
+    if (!IsApStarted)
+    {
+        return LE_OK;
+    }
+
+    // The interface only exists if hostapd was started with the BSS.
+    if (!bssPtr->isUp)
+    {
+        SetBssAddress(bssPtr);
+    }
+    return UpdateDhcpServer();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the interface name of a BSS.
+ *
+ * @return LE_NOT_FOUND     The BSS does not exist.
+ * @return LE_OVERFLOW      The interface name buffer is too small.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetBssInterface
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS index, 0 for the main BSS.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< Interface name.
+    size_t ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer.
+)
+{
+    if (0 == bssIndex)
+    {
+        return le_utf8_Copy(ifNamePtr, ApIfName, ifNameSize, NULL);
+    }
+
+    if ((bssIndex >= PA_WIFIAP_MAX_BSS) || (!BssTable[bssIndex].isEnabled))
+    {
+        return LE_NOT_FOUND;
+    }
+    return le_utf8_Copy(ifNamePtr, BssTable[bssIndex].ifName, ifNameSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the BSS of an interface.
+ *
+ * @return The BSS index, 0 for the main BSS or an unknown interface.
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t pa_wifiAp_GetBssIndex
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Interface name.
+)
+{
+    uint8_t bssIndex;
+
+    for (bssIndex = 1; bssIndex < PA_WIFIAP_MAX_BSS; bssIndex++)
+    {
+        if (BssTable[bssIndex].isEnabled && (0 == strcmp(BssTable[bssIndex].ifName, ifNamePtr)))
+        {
+            return bssIndex;
+        }
+    }
+    return 0;
+}
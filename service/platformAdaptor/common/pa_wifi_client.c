@@ -14,26 +14,25 @@
 #include "interfaces.h"
 
 #include "pa_wifi.h"
+#include "pa_wifi_cmd.h"
+#include "pa_wifi_ring.h"
+#include "pa_wifi_stats.h"
+#include "pa_wifi_conf.h"
+#include "pa_wifi_radio.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * WiFi platform adaptor shell script
  */
 //--------------------------------------------------------------------------------------------------
-//Trailing space is needed to pass argument
-#define WIFI_SCRIPT_PATH "/legato/systems/current/apps/wifiService/read-only/pa_wifi "
 #define WPA_SUPPLICANT_FILE "/tmp/wpa_supplicant.conf"
 
 // Set of commands to drive the WiFi features.
-#define COMMAND_WIFI_HW_START           "WIFI_START"
-#define COMMAND_WIFI_HW_STOP            "WIFI_STOP"
 #define COMMAND_WIFI_CHECK_HWSTATUS     "WIFI_CHECK_HWSTATUS"
-#define COMMAND_WIFI_SET_EVENT          "WIFI_SET_EVENT"
-#define COMMAND_WIFI_UNSET_EVENT        "WIFI_UNSET_EVENT"
 #define COMMAND_WIFICLIENT_START_SCAN   "WIFICLIENT_START_SCAN"
 #define COMMAND_WIFICLIENT_DISCONNECT   "WIFICLIENT_DISCONNECT"
 #define COMMAND_WIFICLIENT_GET_DATA     "WIFI_GET_DATA"   // using iw (interface) link command
-//Trailing space is needed to pass another argument by WIFI_SCRIPT_PATH
+//Trailing space is needed to pass another argument
 #define COMMAND_WIFICLIENT_CONNECT      "WIFICLIENT_CONNECT "
 
 //--------------------------------------------------------------------------------------------------
@@ -108,12 +107,13 @@ static bool HiddenAccessPoint = false;
  */
 //--------------------------------------------------------------------------------------------------
 static FILE *IwScanPipePtr    = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
- * The handle of the input pipe used to be notified of the WiFi events.
+ * Time the scan command was started, for the command statistics.
  */
 //--------------------------------------------------------------------------------------------------
-static FILE *IwThreadPipePtr  = NULL;
+static le_clk_Time_t ScanStartTime;
 //--------------------------------------------------------------------------------------------------
 /**
  * Flag set when a WiFi scan is in progress.
@@ -123,38 +123,107 @@ static bool  IsScanRunning    = false;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The main thread running the WiFi platform adaptor.
+ * Disconnection cause and BSSID of the access point, gathered from the event lines preceding the
+ * disconnection. Only used by the event thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_wifiClient_DisconnectionCause_t DisconnectCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+static char DisconnectApBssid[LE_WIFIDEFS_MAX_BSSID_BYTES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of handlers of each PA event.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_HANDLER_MAX_COUNT     4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the WiFi client events.
+ * @deprecated pa_wifiClient_AddEventHandler() should not be used anymore.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiClient_NewEventHandlerFunc_t handlerFuncPtr;    ///< Handler function.
+    void                               *contextPtr;        ///< Handler context.
+}
+EventHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the WiFi client event indications.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiClient_EventIndHandlerFunc_t handlerFuncPtr;    ///< Handler function.
+    void                               *contextPtr;        ///< Handler context.
+}
+EventIndHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registered event handlers. The events are dispatched to them straight from the event ring, on
+ * the main thread, so that no event is allocated or queued again.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventHandler_t    EventHandlers[EVENT_HANDLER_MAX_COUNT];
+static uint32_t          EventHandlerCount = 0;
+static EventIndHandler_t EventIndHandlers[EVENT_HANDLER_MAX_COUNT];
+static uint32_t          EventIndHandlerCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capacity of the ring carrying the event indications from the PA thread to the main thread.
+ * Further events are dropped until the main thread catches up.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_QUEUE_MAX_COUNT   32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring carrying the event indications from the PA thread to the main thread.
  */
 //--------------------------------------------------------------------------------------------------
-static void *WifiClientPaThreadMain(void *contextPtr);
+static pa_wifiRing_Ref_t EventRing;
+
 //--------------------------------------------------------------------------------------------------
 /**
- * The handle of the WiFi platform adaptor thread.
+ * Element of the event ring.
  */
 //--------------------------------------------------------------------------------------------------
-static le_thread_Ref_t WifiClientPaThread = NULL;
+typedef struct
+{
+    pa_wifiClient_TimedEventInd_t timedEvent;       ///< Event indication.
+    bool                          isHwCheckNeeded;  ///< The disconnection cause depends on the
+                                                    ///< hardware status, checked by the main
+                                                    ///< thread.
+}
+RingEvent_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WifiClient state event ID.
- * Used to report WifiClient state events to the registered event handlers.
+ * Number of event indications dropped since the last reported one. Only used by the event thread.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t WifiClientPaEvent;
+static uint32_t DroppedEventCount = 0;
+
 //--------------------------------------------------------------------------------------------------
 /**
- * WifiClient state event ID.
- * Used to report WifiClient state events to the registered event handlers.
+ * Running connection and disconnection commands, NULL if none. Only used by the main thread.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t WifiClientPaEventId;
+static pa_wifiCmd_JobRef_t ConnectJobRef = NULL;
+static pa_wifiCmd_JobRef_t DisconnectJobRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pool for WifiClient state events reporting.
+ * Set when a connection is requested while the disconnection command is running. The connection
+ * command is started when it completes, otherwise it would find wpa_supplicant still running.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t WifiPaEventPool;
+static bool IsConnectPending = false;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -165,272 +234,270 @@ static le_mem_PoolRef_t WifiPaEventPool;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum numbers of bytes in temparatory config string written to wpa_supplicant.conf
+ * Last write of wpa_supplicant.conf.
  */
 //--------------------------------------------------------------------------------------------------
-#define TEMP_CONFIG_MAX_BYTES 512
+static pa_wifiConf_File_t WpaSupplicantConfFile = PA_WIFICONF_FILE_INIT;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Thread destructor
+ * Report an event indication to the registered handlers, on the main thread.
+ *
+ * The handlers get the event of the caller, which is only valid during the call.
  */
 //--------------------------------------------------------------------------------------------------
-static void ThreadDestructor
+static void DispatchEventInd
 (
-    void *contextPtr
+    pa_wifiClient_TimedEventInd_t *timedEventPtr
+        ///< [IN]
+        ///< Event to report.
 )
 {
-    int systemResult;
+    le_wifiClient_Event_t event = timedEventPtr->indication.event;
+    uint32_t              i;
 
-    // Kill the script launched by popen() in Client thread
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_UNSET_EVENT);
+    LE_DEBUG("WiFi event: %d, interface: %s, bssid: %s",
+             event, timedEventPtr->indication.ifName, timedEventPtr->indication.apBssid);
 
-    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    for (i = 0; i < EventIndHandlerCount; i++)
     {
-        LE_WARN("Unable to kill the WIFI events script");
+        EventIndHandlers[i].handlerFuncPtr(&timedEventPtr->indication,
+                                           EventIndHandlers[i].contextPtr);
     }
 
-    if (IwThreadPipePtr)
+    // Report event (will be deprecated)
+    for (i = 0; i < EventHandlerCount; i++)
     {
-        // And close FP used in created thread
-        pclose(IwThreadPipePtr);
-        IwThreadPipePtr = NULL;
+        EventHandlers[i].handlerFuncPtr(event, EventHandlers[i].contextPtr);
     }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The first-layer WiFi Client Event Handler.
- * @deprecated pa_wifiClient_AddEventHandler() should not be used anymore.
- * It has been replaced by pa_wifiClient_AddEventIndHandler().
- *
+ * Get the cause of a disconnection by local request from the hardware status: the WLAN interface
+ * or the driver may be gone.
  */
 //--------------------------------------------------------------------------------------------------
-static void FirstLayerWifiClientEventHandler
+static le_wifiClient_DisconnectionCause_t GetLocalDisconnectCause
 (
-    void *reportPtr,
-    void *secondLayerHandlerFuncPtr
+    void
 )
 {
-    pa_wifiClient_NewEventHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFuncPtr;
-    le_wifiClient_Event_t    *wifiEventPtr = (le_wifiClient_Event_t *)reportPtr;
+    // Check WLAN interface, not available means hardware removed
+    int systemResult = pa_wifiCmd_Run(COMMAND_WIFI_CHECK_HWSTATUS, NULL, 0);
 
-    if (NULL != wifiEventPtr)
-    {
-        LE_DEBUG("Event: %d", *wifiEventPtr);
-        clientHandlerFunc(*wifiEventPtr, le_event_GetContextPtr());
-    }
-    else
+    switch (WEXITSTATUS(systemResult))
     {
-        LE_ERROR("Event is NULL");
+        case 0:
+            // WLAN interface is up, local request
+            return LE_WIFICLIENT_CLIENT_REQUEST;
+        case PA_NOT_POSSIBLE:
+            // Driver removed, WiFi stop called
+            return LE_WIFICLIENT_HARDWARE_STOP;
+        case PA_NOT_FOUND:
+            // WLAN interface is gone, WiFi hardware is removed
+            return LE_WIFICLIENT_HARDWARE_DETACHED;
+        default:
+            LE_WARN("WiFi Client Command \"%s\" Failed: (%d)",
+                    COMMAND_WIFI_CHECK_HWSTATUS, systemResult);
+            return LE_WIFICLIENT_CLIENT_REQUEST;
     }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The first-layer WiFi Client Event Indication Handler.
+ * Main thread side of the event ring: report an event indication to the registered handlers.
  *
+ * The handlers get the event in the ring slot. The hardware status is checked here rather than by
+ * the event thread, which must neither wait for the commands of the main thread nor be cancelled
+ * while it runs one.
  */
 //--------------------------------------------------------------------------------------------------
-static void FirstLayerWifiClientEventIndHandler
+static void EventRingHandler
 (
-    void *reportPtr,
-    void *secondLayerHandlerFuncPtr
+    void *elemPtr,
+    void *contextPtr
 )
 {
-    pa_wifiClient_EventIndHandlerFunc_t  clientHandlerFunc = secondLayerHandlerFuncPtr;
-    le_wifiClient_EventInd_t*  wifiEventIndPtr = reportPtr;
+    RingEvent_t *ringEventPtr = elemPtr;
 
-    if (NULL != wifiEventIndPtr)
+    if (ringEventPtr->isHwCheckNeeded)
     {
-        LE_DEBUG("WiFi event: %d, interface: %s, bssid: %s",
-                wifiEventIndPtr->event,
-                wifiEventIndPtr->ifName,
-                wifiEventIndPtr->apBssid);
+        ringEventPtr->timedEvent.indication.disconnectionCause = GetLocalDisconnectCause();
+    }
+    DispatchEventInd(&ringEventPtr->timedEvent);
+}
 
-        if (LE_WIFICLIENT_EVENT_DISCONNECTED == wifiEventIndPtr->event)
-        {
-            LE_DEBUG("disconnectCause: %d", wifiEventIndPtr->disconnectionCause);
-        }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize an event indication.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitEventInd
+(
+    pa_wifiClient_TimedEventInd_t *timedEventPtr,
+        ///< [OUT]
+        ///< Event to initialize.
+    le_clk_Time_t captureTime
+        ///< [IN]
+        ///< Time the event source was read.
+)
+{
+    memset(timedEventPtr, 0, sizeof(pa_wifiClient_TimedEventInd_t));
+    timedEventPtr->captureTime = captureTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report an event indication from the event thread, unless the event ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportEventInd
+(
+    const pa_wifiClient_TimedEventInd_t *timedEventPtr,
+        ///< [IN]
+        ///< Event to report, copied into the event ring.
+    bool isHwCheckNeeded
+        ///< [IN]
+        ///< The disconnection cause must be set from the hardware status.
+)
+{
+    RingEvent_t ringEvent;
+
+    ringEvent.timedEvent = *timedEventPtr;
+    ringEvent.timedEvent.droppedCount = DroppedEventCount;
+    ringEvent.timedEvent.reportTime = le_clk_GetRelativeTime();
+    ringEvent.isHwCheckNeeded = isHwCheckNeeded;
 
-        clientHandlerFunc(wifiEventIndPtr, le_event_GetContextPtr());
+    if (LE_OK == pa_wifiRing_Push(EventRing, &ringEvent))
+    {
+        DroppedEventCount = 0;
     }
     else
     {
-        LE_ERROR("wifiEventIndPtr is NULL");
+        DroppedEventCount++;
+        LE_WARN("Event queue full, %u event(s) dropped", DroppedEventCount);
     }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * WiFi Client PA Thread
- *
+ * Handler of the iw event lines of the client interface, called by the event thread.
  */
 //--------------------------------------------------------------------------------------------------
-static void *WifiClientPaThreadMain
+static void ClientEventHandler
 (
-    void *contextPtr
+    const char *linePtr,
+    le_clk_Time_t captureTime
 )
 {
-    le_wifiClient_DisconnectionCause_t cause;
-    le_wifiClient_Event_t              event;
+    pa_wifiClient_TimedEventInd_t      timedEvent;
+    le_wifiClient_EventInd_t          *WifiClientPaEventPtr = &timedEvent.indication;
     char path[PATH_MAX_BYTES];
-    char apBssid[LE_WIFIDEFS_MAX_BSSID_BYTES];
     char *ret;
     char *pathReentrant;
-    int  systemResult;
-
-    LE_INFO("Wifi event report thread started!");
+    bool isHwCheckNeeded = false;
 
-    IwThreadPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFI_SET_EVENT, "r");
+    le_utf8_Copy(path, linePtr, sizeof(path), NULL);
+    LE_DEBUG("PARSING:%s: len:%d", path, (int) strnlen(path, sizeof(path) - 1));
 
-    if (NULL == IwThreadPipePtr)
+    if (NULL != strstr(path, "Beacon loss"))
     {
-        LE_ERROR("Failed to run command:\"%s\" errno:%d %s",
-                COMMAND_WIFI_SET_EVENT,
-                errno,
-                LE_ERRNO_TXT(errno));
-        return NULL;
+        DisconnectCause = LE_WIFICLIENT_BEACON_LOSS;
     }
-
-    memset(apBssid, 0, LE_WIFIDEFS_MAX_BSSID_BYTES);
-    cause = LE_WIFICLIENT_UNKNOWN_CAUSE;
-    // Read the output one line at a time - output it.
-    while (NULL != fgets(path, sizeof(path) - 1, IwThreadPipePtr))
+    if (NULL != (ret = strstr(path, "del station")))
     {
-        LE_DEBUG("PARSING:%s: len:%d", path, (int) strnlen(path, sizeof(path) - 1));
-
-        if (NULL != strstr(path, "Beacon loss"))
+        memset(DisconnectApBssid, 0, LE_WIFIDEFS_MAX_BSSID_BYTES);
+        memcpy(DisconnectApBssid, &ret[sizeof("del station")],
+               LE_WIFIDEFS_MAX_BSSID_LENGTH);
+        DisconnectApBssid[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
+    }
+    if (NULL != (ret = strstr(path, "connected to")))
+    {
+        LE_INFO("FOUND connected");
+
+        DisconnectCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+        InitEventInd(&timedEvent, captureTime);
+        WifiClientPaEventPtr->event = LE_WIFICLIENT_EVENT_CONNECTED;
+        WifiClientPaEventPtr->disconnectionCause = DisconnectCause;
+        // Retrieve AP BSSID
+        memcpy(WifiClientPaEventPtr->apBssid, &ret[sizeof("connected to")],
+                LE_WIFIDEFS_MAX_BSSID_LENGTH);
+        WifiClientPaEventPtr->apBssid[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
+        // Retrieve WLAN interface name
+        pathReentrant = path;
+        ret = strtok_r(pathReentrant, " ", &pathReentrant);
+        if (NULL == ret)
         {
-            cause = LE_WIFICLIENT_BEACON_LOSS;
+            LE_WARN("Failed to retrieve WLAN interface");
+            WifiClientPaEventPtr->ifName[0] = '\0';
         }
-        if (NULL != (ret = strstr(path, "del station")))
+        else
         {
-            memset(apBssid, 0, LE_WIFIDEFS_MAX_BSSID_BYTES);
-            memcpy(apBssid, &ret[sizeof("del station")],
-                   LE_WIFIDEFS_MAX_BSSID_LENGTH);
-            apBssid[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
+            memcpy(WifiClientPaEventPtr->ifName, ret, strlen(ret));
+            WifiClientPaEventPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
         }
-        if (NULL != (ret = strstr(path, "connected to")))
-        {
-            LE_INFO("FOUND connected");
-
-            cause = LE_WIFICLIENT_UNKNOWN_CAUSE;
-            le_wifiClient_EventInd_t* WifiClientPaEventPtr = le_mem_ForceAlloc(WifiPaEventPool);
-            memset(WifiClientPaEventPtr, 0, sizeof(le_wifiClient_EventInd_t));
-            WifiClientPaEventPtr->event = LE_WIFICLIENT_EVENT_CONNECTED;
-            WifiClientPaEventPtr->disconnectionCause = cause;
-            // Retrieve AP BSSID
-            memcpy(WifiClientPaEventPtr->apBssid, &ret[sizeof("connected to")],
-                    LE_WIFIDEFS_MAX_BSSID_LENGTH);
-            WifiClientPaEventPtr->apBssid[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
-            // Retrieve WLAN interface name
-            pathReentrant = path;
-            ret = strtok_r(pathReentrant, " ", &pathReentrant);
-            if (NULL == ret)
-            {
-                LE_WARN("Failed to retrieve WLAN interface");
-                WifiClientPaEventPtr->ifName[0] = '\0';
-            }
-            else
-            {
-                memcpy(WifiClientPaEventPtr->ifName, ret, strlen(ret));
-                WifiClientPaEventPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
-            }
-            // Report event: LE_WIFICLIENT_EVENT_CONNECTED
-            LE_DEBUG("WiFi event: %d, interface: %s, bssid: %s",
-                     WifiClientPaEventPtr->event,
-                     WifiClientPaEventPtr->ifName,
-                     WifiClientPaEventPtr->apBssid);
+        // Report event: LE_WIFICLIENT_EVENT_CONNECTED
+        LE_DEBUG("WiFi event: %d, interface: %s, bssid: %s",
+                 WifiClientPaEventPtr->event,
+                 WifiClientPaEventPtr->ifName,
+                 WifiClientPaEventPtr->apBssid);
 
-            le_event_ReportWithRefCounting(WifiClientPaEventId, WifiClientPaEventPtr);
+        ReportEventInd(&timedEvent, false);
 
-            // Report event: LE_WIFICLIENT_EVENT_CONNECTED (will be deprecated)
-            event = LE_WIFICLIENT_EVENT_CONNECTED;
-            le_event_Report(WifiClientPaEvent, (void *)&event, sizeof(le_wifiClient_Event_t));
+    }
+    else if (NULL != strstr(path, "disconnected"))
+    {
+        LE_INFO("FOUND disconnected");
 
-        }
-        else if (NULL != strstr(path, "disconnected"))
+        if (LE_WIFICLIENT_BEACON_LOSS != DisconnectCause)
         {
-            LE_INFO("FOUND disconnected");
-
-            if (LE_WIFICLIENT_BEACON_LOSS != cause)
-            {
-                if (NULL != strstr(path, "local request"))
-                {
-                    // Check WLAN interface, not available means hardware removed
-                    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_CHECK_HWSTATUS);
-
-                    switch (WEXITSTATUS(systemResult))
-                    {
-                        case 0:
-                            // WLAN interface is up, local request
-                            cause = LE_WIFICLIENT_CLIENT_REQUEST;
-                            break;
-                        case PA_NOT_POSSIBLE:
-                            // Driver removed, WiFi stop called
-                            cause = LE_WIFICLIENT_HARDWARE_STOP;
-                            break;
-                        case PA_NOT_FOUND:
-                            // WLAN interface is gone, WiFi hardware is removed
-                            cause = LE_WIFICLIENT_HARDWARE_DETACHED;
-                            break;
-                        default:
-                            LE_WARN("WiFi Client Command \"%s\" Failed: (%d)",
-                                COMMAND_WIFI_CHECK_HWSTATUS, systemResult);
-                            cause = LE_WIFICLIENT_CLIENT_REQUEST;
-
-                    }
-                }
-                // AP terminated connection
-                else if (NULL != strstr(path, "by AP"))
-                {
-                    cause = LE_WIFICLIENT_BY_AP;
-                }
-            }
-
-            le_wifiClient_EventInd_t* WifiClientPaEventPtr = le_mem_ForceAlloc(WifiPaEventPool);
-            memset(WifiClientPaEventPtr, 0, sizeof(le_wifiClient_EventInd_t));
-            WifiClientPaEventPtr->event = LE_WIFICLIENT_EVENT_DISCONNECTED;
-            //Disconnection cause
-            WifiClientPaEventPtr->disconnectionCause = cause;
-            // Retrieve WLAN interface name
-            pathReentrant = path;
-            ret = strtok_r(pathReentrant, " ", &pathReentrant);
-            if (NULL == ret)
+            if (NULL != strstr(path, "local request"))
             {
-                LE_WARN("Failed to retrieve WLAN interface");
-                WifiClientPaEventPtr->ifName[0] = '\0';
+                // The hardware may be gone: the main thread checks it, see EventRingHandler().
+                DisconnectCause = LE_WIFICLIENT_CLIENT_REQUEST;
+                isHwCheckNeeded = true;
             }
-            else
+            // AP terminated connection
+            else if (NULL != strstr(path, "by AP"))
             {
-                memcpy(WifiClientPaEventPtr->ifName, ret, strlen(ret));
-                WifiClientPaEventPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
+                DisconnectCause = LE_WIFICLIENT_BY_AP;
             }
-            // Retrieve AP BSSID
-            memcpy(WifiClientPaEventPtr->apBssid, apBssid, LE_WIFIDEFS_MAX_BSSID_LENGTH);
-            WifiClientPaEventPtr->apBssid[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
-
-            // Report event: LE_WIFICLIENT_EVENT_DISCONNECTED
-            LE_DEBUG("WiFi event: %d, disconnectCause: %d, interface: %s, bssid: %s",
-                     WifiClientPaEventPtr->event,
-                     WifiClientPaEventPtr->disconnectionCause,
-                     WifiClientPaEventPtr->ifName,
-                     WifiClientPaEventPtr->apBssid);
-
-            // Report event: LE_WIFICLIENT_EVENT_DISCONNECTED (will be deprecated)
-            event = LE_WIFICLIENT_EVENT_DISCONNECTED;
-            le_event_Report(WifiClientPaEvent, (void *)&event, sizeof(le_wifiClient_Event_t));
-
-            // Restore to default value
-            cause = LE_WIFICLIENT_UNKNOWN_CAUSE;
-            memset(apBssid, 0, LE_WIFIDEFS_MAX_BSSID_BYTES);
-            le_event_ReportWithRefCounting(WifiClientPaEventId, WifiClientPaEventPtr);
         }
+
+        InitEventInd(&timedEvent, captureTime);
+        WifiClientPaEventPtr->event = LE_WIFICLIENT_EVENT_DISCONNECTED;
+        //Disconnection cause
+        WifiClientPaEventPtr->disconnectionCause = DisconnectCause;
+        // Retrieve WLAN interface name
+        pathReentrant = path;
+        ret = strtok_r(pathReentrant, " ", &pathReentrant);
+        if (NULL == ret)
+        {
+            LE_WARN("Failed to retrieve WLAN interface");
+            WifiClientPaEventPtr->ifName[0] = '\0';
+        }
+        else
+        {
+            memcpy(WifiClientPaEventPtr->ifName, ret, strlen(ret));
+            WifiClientPaEventPtr->ifName[LE_WIFIDEFS_MAX_IFNAME_LENGTH] = '\0';
+        }
+        // Retrieve AP BSSID
+        memcpy(WifiClientPaEventPtr->apBssid, DisconnectApBssid, LE_WIFIDEFS_MAX_BSSID_LENGTH);
+        WifiClientPaEventPtr->apBssid[LE_WIFIDEFS_MAX_BSSID_LENGTH] = '\0';
+
+        // Report event: LE_WIFICLIENT_EVENT_DISCONNECTED
+        LE_DEBUG("WiFi event: %d, disconnectCause: %d, interface: %s, bssid: %s",
+                 WifiClientPaEventPtr->event,
+                 WifiClientPaEventPtr->disconnectionCause,
+                 WifiClientPaEventPtr->ifName,
+                 WifiClientPaEventPtr->apBssid);
+        ReportEventInd(&timedEvent, isHwCheckNeeded);
+
+        // Restore to default value
+        DisconnectCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+        memset(DisconnectApBssid, 0, LE_WIFIDEFS_MAX_BSSID_BYTES);
     }
-    // Run the event loop
-    le_event_RunLoop();
-    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -450,11 +517,14 @@ le_result_t pa_wifiClient_Init
 )
 {
     LE_INFO("Init called");
-    // pa_wifiClient_AddEventHandler() will be deprecated
-    WifiClientPaEvent = le_event_CreateId("WifiClientPaEvent", sizeof(le_wifiClient_Event_t));
-    // Create the event for signaling user handlers.
-    WifiClientPaEventId = le_event_CreateIdWithRefCounting("WifiConnectEvent");
-    WifiPaEventPool = le_mem_CreatePool("WifiPaEventPool", sizeof(le_wifiClient_EventInd_t));
+    pa_wifiCmd_Init();
+    pa_wifiRadio_Init();
+    // The PA thread hands its events over to this thread through the ring.
+    EventRing = pa_wifiRing_Create("WifiClientPaEvents",
+                                   sizeof(RingEvent_t),
+                                   EVENT_QUEUE_MAX_COUNT,
+                                   EventRingHandler,
+                                   NULL);
 
     return LE_OK;
 }
@@ -490,51 +560,32 @@ le_result_t pa_wifiClient_Start
     void
 )
 {
-    int systemResult;
-    le_result_t result = LE_OK;
+    le_result_t result = pa_wifiRadio_Start(PA_WIFIRADIO_ROLE_CLIENT, ClientEventHandler);
 
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_START);
-    /**
-     * Returned values:
-     *   0: if the interface is correctly moutned
-     *  50: if WiFi card is not inserted
-     * 100: if WiFi card may not work
-     * 127: if driver can not be installed
-     *  -1: if the fork() has failed (see man system)
-     */
-    // Return value of 0 means WLAN interface is up.
-    if (0 == WEXITSTATUS(systemResult))
+    if (LE_OK == result)
     {
         LE_DEBUG("WiFi client started correctly");
-
-        /* Create WiFi Client PA Thread */
-        WifiClientPaThread = le_thread_Create("WifiClientPaThread", WifiClientPaThreadMain, NULL);
-        le_thread_SetJoinable(WifiClientPaThread);
-        le_thread_AddChildDestructor(WifiClientPaThread, ThreadDestructor, NULL);
-        le_thread_Start(WifiClientPaThread);
-        return LE_OK;
-    }
-    // Return value of 50 means WiFi card is not inserted.
-    else if ( PA_NOT_FOUND == WEXITSTATUS(systemResult))
-    {
-        LE_WARN("WiFi card is not inserted");
-        result = LE_NOT_FOUND;
     }
-    // Return value of 100 means WiFi card may not work.
-    else if ( PA_NOT_POSSIBLE == WEXITSTATUS(systemResult))
-    {
-        LE_WARN("Unable to reset WiFi card");
-        result = LE_UNAVAILABLE;
-    }
-    // WiFi card failed to start.
-    else
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel the running connection request, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CancelConnect
+(
+    void
+)
+{
+    IsConnectPending = false;
+
+    if (NULL != ConnectJobRef)
     {
-        LE_WARN("Failed to start WiFi client command \"%s\" systemResult (%d)",
-                COMMAND_WIFI_HW_START, systemResult);
-        result = LE_FAULT;
+        pa_wifiCmd_Cancel(ConnectJobRef);
+        ConnectJobRef = NULL;
     }
-
-    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -550,23 +601,20 @@ le_result_t pa_wifiClient_Stop
     void
 )
 {
-    int systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFI_HW_STOP);
-    /**
-     * Returned values:
-     *  0: if the interface is correctly unmounted
-     * -1: if the fork() has failed (see man system)
-     * 92: if unable to stop the interface
-     */
-    if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+    CancelConnect();
+
+    // The access point keeps the hardware started: only terminate wpa_supplicant, if running.
+    if (pa_wifiRadio_IsShared(PA_WIFIRADIO_ROLE_CLIENT))
     {
-        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)",
-                COMMAND_WIFI_HW_STOP, systemResult);
-        return LE_FAULT;
+        int systemResult = pa_wifiCmd_Run(COMMAND_WIFICLIENT_DISCONNECT, NULL, 0);
+
+        if ((!WIFEXITED(systemResult)) || (0 != WEXITSTATUS(systemResult)))
+        {
+            LE_DEBUG("wpa_supplicant not running");
+        }
     }
 
-    /* Terminate the created thread */
-    le_thread_Cancel(WifiClientPaThread);
-    if (LE_OK != le_thread_Join(WifiClientPaThread, NULL))
+    if (LE_OK != pa_wifiRadio_Stop(PA_WIFIRADIO_ROLE_CLIENT))
     {
         return LE_FAULT;
     }
@@ -607,8 +655,9 @@ le_result_t pa_wifiClient_Scan
     }
 
     IsScanRunning = true;
+    ScanStartTime = le_clk_GetRelativeTime();
     /* Open the command for reading. */
-    IwScanPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFICLIENT_START_SCAN, "r");
+    IwScanPipePtr = pa_wifiCmd_Open(COMMAND_WIFICLIENT_START_SCAN);
 
     if (NULL == IwScanPipePtr)
     {
@@ -675,7 +724,7 @@ le_result_t pa_wifiClient_GetLinkResult
     LE_INFO("Link results");
 
     /* Open the command for reading. */
-    iwLinkPipePtr = popen(WIFI_SCRIPT_PATH COMMAND_WIFICLIENT_GET_DATA, "r");
+    iwLinkPipePtr = pa_wifiCmd_Open(COMMAND_WIFICLIENT_GET_DATA);
 
     if (NULL == iwLinkPipePtr)
     {
@@ -981,6 +1030,8 @@ le_result_t pa_wifiClient_ScanDone
     if (NULL != IwScanPipePtr)
     {
         int st = pclose(IwScanPipePtr);
+
+        pa_wifiStats_Record(COMMAND_WIFICLIENT_START_SCAN, ScanStartTime, st);
         if (WIFEXITED(st))
         {
             LE_DEBUG("Scan exit status(%d)", WEXITSTATUS(st));
@@ -1036,41 +1087,11 @@ le_result_t pa_wifiClient_SetSecurityProtocol
     return result;
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * This function writes configurations to wpa_supplicant file.
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t WriteClientCfgFile
-(
-    const char *dataPtr,
-    FILE *filePtr
-)
-{
-    size_t length;
-
-    if ((NULL == filePtr) || (NULL == dataPtr))
-    {
-        LE_ERROR("Invalid parameter(s)");
-        return LE_FAULT;
-    }
-
-    length = strlen(dataPtr);
-    if (length > 0)
-    {
-        if (fwrite(dataPtr, 1, length, filePtr) != length)
-        {
-            LE_ERROR("Unable to write the wpa_supplicant file.");
-            return LE_FAULT;
-        }
-    }
-
-    return LE_OK;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * This function generates the WPA supplicant configuration file.
+ *
+ * The whole file is generated, then only written if it changed since the last write.
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t GenerateWpaSupplicant
@@ -1079,9 +1100,7 @@ static le_result_t GenerateWpaSupplicant
     const uint32_t ssidLength
 )
 {
-    FILE    *filePtr;
-    char     tmpConfig[TEMP_CONFIG_MAX_BYTES];
-    char     tmpString[TEMP_STRING_MAX_BYTES];
+    pa_wifiConf_Buffer_t config = PA_WIFICONF_BUFFER_INIT;
 
     LE_DEBUG("Generate Wpa Supplicant");
 
@@ -1092,36 +1111,14 @@ static le_result_t GenerateWpaSupplicant
         return LE_FAULT;
     }
 
-    // Create the WPA supplicant file
-    filePtr = fopen(WPA_SUPPLICANT_FILE, "w");
-    if (filePtr == NULL)
-    {
-        LE_ERROR("Unable to create \"%s\" file.", WPA_SUPPLICANT_FILE);
-        return LE_FAULT;
-    }
-
-    //used to store configuration to be written into wpa_supplicant.conf
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
-    //used to store optional elements to be appended
-    memset(tmpString, '\0', sizeof(tmpString));
     //common contents of wpa_supplicant.conf
-    snprintf(tmpConfig, sizeof(tmpConfig), WPA_SUPPLICANT_CONFIG_COMMON,
-             ssidLength, (char *)ssidPtr, HiddenAccessPoint);
+    pa_wifiConf_Append(&config, WPA_SUPPLICANT_CONFIG_COMMON,
+                       ssidLength, (char *)ssidPtr, HiddenAccessPoint);
 
-    //The common part and the security protocol part are written to wpa_supplicant.conf
-    //separately for easier debug.
-    tmpConfig[TEMP_CONFIG_MAX_BYTES - 1] = '\0';
-    if (LE_OK != WriteClientCfgFile(tmpConfig, filePtr))
-    {
-        LE_ERROR("Unable to write wpa_supplicant common part");
-        goto WRONG_CONFIG;
-    }
-
-    memset(tmpConfig, '\0', sizeof(tmpConfig));
     switch (SavedSecurityProtocol)
     {
         case LE_WIFICLIENT_SECURITY_NONE:
-            le_utf8_Copy(tmpConfig, "key_mgmt=NONE\n", sizeof(tmpConfig), NULL);
+            pa_wifiConf_Append(&config, "key_mgmt=NONE\n");
             break;
 
         case LE_WIFICLIENT_SECURITY_WEP:
@@ -1131,9 +1128,7 @@ static le_result_t GenerateWpaSupplicant
                 LE_ERROR("No valid WEP key");
                 goto WRONG_CONFIG;
             }
-            le_utf8_Copy(tmpConfig, "key_mgmt=NONE\n", sizeof(tmpConfig), NULL);
-            snprintf(tmpString, sizeof(tmpString), "wep_key0=\"%s\"\n", SavedWepKey);
-            le_utf8_Append(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
+            pa_wifiConf_Append(&config, "key_mgmt=NONE\nwep_key0=\"%s\"\n", SavedWepKey);
             break;
 
         case LE_WIFICLIENT_SECURITY_WPA_PSK_PERSONAL:
@@ -1147,13 +1142,12 @@ static le_result_t GenerateWpaSupplicant
             // Passphrase is set, generate psk here
             if (0 != SavedPassphrase[0])
             {
-                snprintf(tmpString, sizeof(tmpString), "psk=\"%s\"\n", SavedPassphrase);
+                pa_wifiConf_Append(&config, "psk=\"%s\"\n", SavedPassphrase);
             }
             else
             {
-                snprintf(tmpString, sizeof(tmpString), "psk=%s\n", SavedPreSharedKey);
+                pa_wifiConf_Append(&config, "psk=%s\n", SavedPreSharedKey);
             }
-            le_utf8_Copy(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
             break;
 
         case LE_WIFICLIENT_SECURITY_WPA_EAP_PEAP0_ENTERPRISE:
@@ -1164,15 +1158,11 @@ static le_result_t GenerateWpaSupplicant
                 LE_ERROR("No valid Username or Password");
                 goto WRONG_CONFIG;
             }
-            le_utf8_Copy(tmpConfig, "key_mgmt=WPA-EAP\n", sizeof(tmpConfig), NULL);
-            le_utf8_Append(tmpConfig, "eap=PEAP\n", sizeof(tmpConfig), NULL);
-            snprintf(tmpString, sizeof(tmpString), "identity=\"%s\"\n", SavedUsername);
-            le_utf8_Append(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
-            memset(tmpString, '\0', sizeof(tmpString));
-            snprintf(tmpString, sizeof(tmpString), "password=\"%s\"\n", SavedPassword);
-            le_utf8_Append(tmpConfig, tmpString, sizeof(tmpConfig), NULL);
-            le_utf8_Append(tmpConfig, "phase1=\"peapver=0\"\n", sizeof(tmpConfig), NULL);
-            le_utf8_Append(tmpConfig, "phase2=\"auth=MSCHAPV2\"\n", sizeof(tmpConfig), NULL);
+            pa_wifiConf_Append(&config, "key_mgmt=WPA-EAP\neap=PEAP\n");
+            pa_wifiConf_Append(&config, "identity=\"%s\"\n", SavedUsername);
+            pa_wifiConf_Append(&config, "password=\"%s\"\n", SavedPassword);
+            pa_wifiConf_Append(&config, "phase1=\"peapver=0\"\n");
+            pa_wifiConf_Append(&config, "phase2=\"auth=MSCHAPV2\"\n");
             break;
 
         default:
@@ -1181,34 +1171,143 @@ static le_result_t GenerateWpaSupplicant
     }
 
     // Append "}" to complete the network block
-    le_utf8_Append(tmpConfig, "}\n", sizeof(tmpConfig), NULL);
-    tmpConfig[TEMP_CONFIG_MAX_BYTES - 1] = '\0';
+    pa_wifiConf_Append(&config, "}\n");
 
-    if (LE_OK != WriteClientCfgFile(tmpConfig, filePtr))
+    // Write wpa_supplicant.conf, unless unchanged
+    if (LE_FAULT == pa_wifiConf_Write(&WpaSupplicantConfFile, WPA_SUPPLICANT_FILE, &config))
     {
-        LE_ERROR("Unable to write wpa_supplicant security protocol part");
         goto WRONG_CONFIG;
     }
 
-    fclose(filePtr);
+    pa_wifiConf_Release(&config);
     return LE_OK;
 
 WRONG_CONFIG:
 
     LE_ERROR("Unable to generate the WPA supplicant file \"%s\".", WPA_SUPPLICANT_FILE);
-    fclose(filePtr);
+    pa_wifiConf_Release(&config);
     return LE_FAULT;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion of the connection command. The connection itself is reported by the PA thread, a
+ * failure is reported here as a disconnection so that the clients are not left waiting.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConnectCompletionHandler
+(
+    int status,
+    const char *outputPtr,
+    void *contextPtr
+)
+{
+    pa_wifiClient_TimedEventInd_t timedEvent;
+
+    ConnectJobRef = NULL;
+
+    // Return value of 0 means WiFi client connected.
+    if (WIFEXITED(status) && (0 == WEXITSTATUS(status)))
+    {
+        LE_DEBUG("WiFi Client connected");
+        return;
+    }
+    // Return value of 14 means wpa_supplicant is running.
+    else if (WIFEXITED(status) && (PA_DUPLICATE == WEXITSTATUS(status)))
+    {
+        LE_WARN("WPA_SUPPLICANT is running already");
+        return;
+    }
+    // Return value of 8 means connection time out.
+    else if (WIFEXITED(status) && (PA_TIMEOUT == WEXITSTATUS(status)))
+    {
+        LE_WARN("Connection time out");
+    }
+    else
+    {
+        LE_ERROR("WiFi Client Command %s Failed: (%d) %s",
+                 COMMAND_WIFICLIENT_CONNECT, status, outputPtr);
+    }
+
+    InitEventInd(&timedEvent, le_clk_GetRelativeTime());
+    timedEvent.indication.event = LE_WIFICLIENT_EVENT_DISCONNECTED;
+    timedEvent.indication.disconnectionCause = LE_WIFICLIENT_UNKNOWN_CAUSE;
+    timedEvent.reportTime = timedEvent.captureTime;
+    timedEvent.isLocal = true;
+    DispatchEventInd(&timedEvent);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the connection command.
+ *
+ * @return LE_FAULT             The command could not be started.
+ * @return LE_OK                The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartConnect
+(
+    void
+)
+{
+    char tmpString[TEMP_STRING_MAX_BYTES];
+
+    le_utf8_Copy(tmpString, COMMAND_WIFICLIENT_CONNECT, sizeof(tmpString), NULL);
+    le_utf8_Append(tmpString, WPA_SUPPLICANT_FILE, sizeof(tmpString), NULL);
+
+    ConnectJobRef = pa_wifiCmd_RunAsync(tmpString, ConnectCompletionHandler, NULL);
+    if (NULL == ConnectJobRef)
+    {
+        LE_ERROR("WiFi Client Command %s Failed", tmpString);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion of the disconnection command.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DisconnectCompletionHandler
+(
+    int status,
+    const char *outputPtr,
+    void *contextPtr
+)
+{
+    DisconnectJobRef = NULL;
+
+    if (WIFEXITED(status) && (0 == WEXITSTATUS(status)))
+    {
+        LE_INFO("WiFi Client Command \"%s\" OK:", COMMAND_WIFICLIENT_DISCONNECT);
+    }
+    else
+    {
+        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d) %s",
+                COMMAND_WIFICLIENT_DISCONNECT, status, outputPtr);
+    }
+
+    if (IsConnectPending)
+    {
+        IsConnectPending = false;
+        StartConnect();
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function connects a wifiClient.
  *
+ * The connection command runs in the background: the function returns once it is started. The
+ * connection is reported by a LE_WIFICLIENT_EVENT_CONNECTED event, a failure or a time out by a
+ * LE_WIFICLIENT_EVENT_DISCONNECTED event. Must be called from the main thread.
+ *
  * @return LE_FAULT             The function failed.
  * @return LE_BAD_PARAMETER     Invalid parameter.
- * @return LE_DUPLICATE         Duplicated request.
- * @return LE_TIMEOUT           Connection request time out.
+ * @return LE_DUPLICATE         A connection request is in progress.
  * @return LE_OK                The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -1222,10 +1321,6 @@ le_result_t pa_wifiClient_Connect
         ///< The number of Bytes in the ssidBytes
 )
 {
-    int         systemResult;
-    char        tmpString[TEMP_STRING_MAX_BYTES];
-    le_result_t result  = LE_OK;
-
     // Check SSID
     if (( 0 == ssidLength) || (ssidLength > LE_WIFIDEFS_MAX_SSID_LENGTH))
     {
@@ -1233,6 +1328,12 @@ le_result_t pa_wifiClient_Connect
         return LE_BAD_PARAMETER;
     }
 
+    if ((NULL != ConnectJobRef) || IsConnectPending)
+    {
+        LE_WARN("Connection request in progress");
+        return LE_DUPLICATE;
+    }
+
     LE_INFO("Connecting over SSID length %d SSID: \"%.*s\"", ssidLength, ssidLength,
             (char *)ssidBytes);
 
@@ -1240,43 +1341,24 @@ le_result_t pa_wifiClient_Connect
     {
         return LE_BAD_PARAMETER;
     }
-    le_utf8_Copy(tmpString, WIFI_SCRIPT_PATH, sizeof(tmpString), NULL);
-    le_utf8_Append(tmpString, COMMAND_WIFICLIENT_CONNECT, sizeof(tmpString), NULL);
-    le_utf8_Append(tmpString, WPA_SUPPLICANT_FILE, sizeof(tmpString), NULL);
 
-    systemResult = system(tmpString);
-    // Return value of 0 means WiFi client connected.
-    if (0 == WEXITSTATUS(systemResult))
-    {
-        LE_DEBUG("WiFi Client connected");
-        result = LE_OK;
-    }
-    // Return value of 8 means connection time out.
-    else if ( PA_TIMEOUT == WEXITSTATUS(systemResult))
+    if (NULL != DisconnectJobRef)
     {
-        LE_DEBUG("Connection time out");
-        result = LE_TIMEOUT;
-    }
-    // Return value of 14 means wpa_supplicant is running.
-    else if ( PA_DUPLICATE == WEXITSTATUS(systemResult))
-    {
-        LE_WARN("WPA_SUPPLICANT is running already");
-        result = LE_DUPLICATE;
-    }
-    // Return value of -1 means that the fork() has failed (see man system).
-    else
-    {
-        LE_ERROR("WiFi Client Command %s Failed: (%d)", tmpString, systemResult);
-        result = LE_FAULT;
+        LE_DEBUG("Connection started after the disconnection");
+        IsConnectPending = true;
+        return LE_OK;
     }
 
-    return result;
+    return StartConnect();
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * This function disconnects a wifiClient.
  *
+ * A running connection request is cancelled and the disconnection command runs in the background.
+ * Must be called from the main thread.
+ *
  * @return LE_FAULT  The function failed.
  * @return LE_OK     The function succeeded.
  */
@@ -1286,23 +1368,25 @@ le_result_t pa_wifiClient_Disconnect
     void
 )
 {
-    int         systemResult;
-    le_result_t result       = LE_OK;
+    CancelConnect();
 
-    // Terminate connection
-    systemResult = system(WIFI_SCRIPT_PATH COMMAND_WIFICLIENT_DISCONNECT);
-    if (0 == WEXITSTATUS(systemResult))
+    if (NULL != DisconnectJobRef)
     {
-        LE_INFO("WiFi Client Command \"%s\" OK:", COMMAND_WIFICLIENT_DISCONNECT);
-        result = LE_OK;
+        LE_DEBUG("Disconnection in progress");
+        return LE_OK;
     }
-    else
+
+    // Terminate connection
+    DisconnectJobRef = pa_wifiCmd_RunAsync(COMMAND_WIFICLIENT_DISCONNECT,
+                                           DisconnectCompletionHandler,
+                                           NULL);
+    if (NULL == DisconnectJobRef)
     {
-        LE_ERROR("WiFi Client Command \"%s\" Failed: (%d)",
-                COMMAND_WIFICLIENT_DISCONNECT, systemResult);
-        result = LE_FAULT;
+        LE_ERROR("WiFi Client Command \"%s\" Failed", COMMAND_WIFICLIENT_DISCONNECT);
+        return LE_FAULT;
     }
-    return result;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1528,18 +1612,14 @@ le_result_t pa_wifiClient_AddEventHandler
         ///< Associated event context.
 )
 {
-    le_event_HandlerRef_t handlerRef;
-
-    handlerRef = le_event_AddLayeredHandler("WifiClientPaHandler",
-                                    WifiClientPaEvent,
-                                    FirstLayerWifiClientEventHandler,
-                                    (le_event_HandlerFunc_t)handlerPtr);
-    if (NULL == handlerRef)
+    if ((NULL == handlerPtr) || (EventHandlerCount >= EVENT_HANDLER_MAX_COUNT))
     {
-        LE_ERROR("le_event_AddLayeredHandler returned NULL");
+        LE_ERROR("Cannot add event handler %p", handlerPtr);
         return LE_BAD_PARAMETER;
     }
-    le_event_SetContextPtr(handlerRef, contextPtr);
+    EventHandlers[EventHandlerCount].handlerFuncPtr = handlerPtr;
+    EventHandlers[EventHandlerCount].contextPtr = contextPtr;
+    EventHandlerCount++;
     return LE_OK;
 }
 
@@ -1547,7 +1627,8 @@ le_result_t pa_wifiClient_AddEventHandler
 /**
  * Add handler function for PA EVENT 'le_wifiClient_EventInd_t'
  *
- * This event provide information on PA WiFi Client event changes.
+ * This event provide information on PA WiFi Client event changes. The handler is called on the main
+ * thread with the indication in the event ring, which is only valid during the call.
  *
  * @return LE_BAD_PARAMETER  The function failed due to an invalid parameter.
  * @return LE_OK             The function succeeded.
@@ -1564,17 +1645,40 @@ le_result_t pa_wifiClient_AddEventIndHandler
         ///< Associated event context.
 )
 {
-    le_event_HandlerRef_t handlerRef;
-
-    handlerRef = le_event_AddLayeredHandler("WifiClientPaHandler",
-                                    WifiClientPaEventId,
-                                    FirstLayerWifiClientEventIndHandler,
-                                   (le_event_HandlerFunc_t)handlerPtr);
-    if (NULL == handlerRef)
+    if ((NULL == handlerPtr) || (EventIndHandlerCount >= EVENT_HANDLER_MAX_COUNT))
     {
-        LE_ERROR("le_event_AddLayeredHandler returned NULL");
+        LE_ERROR("Cannot add event indication handler %p", handlerPtr);
         return LE_BAD_PARAMETER;
     }
-    le_event_SetContextPtr(handlerRef, contextPtr);
+    EventIndHandlers[EventIndHandlerCount].handlerFuncPtr = handlerPtr;
+    EventIndHandlers[EventIndHandlerCount].contextPtr = contextPtr;
+    EventIndHandlerCount++;
     return LE_OK;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the occupancy of the queue carrying the event indications from the PA thread to the main
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiClient_GetEventQueueStats
+(
+    uint32_t *depthPtr,
+        ///< [OUT]
+        ///< Number of events currently queued.
+    uint32_t *maxDepthPtr,
+        ///< [OUT]
+        ///< Highest number of events queued since startup.
+    uint32_t *capacityPtr
+        ///< [OUT]
+        ///< Queue capacity.
+)
+{
+    pa_wifiRing_Stats_t stats;
+
+    pa_wifiRing_GetStats(EventRing, &stats);
+    *depthPtr = stats.depth;
+    *maxDepthPtr = stats.maxDepth;
+    *capacityPtr = stats.capacity;
+}
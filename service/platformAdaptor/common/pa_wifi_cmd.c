@@ -0,0 +1,750 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter script commands
+ *
+ *  The PA script is started once in command server mode. It reads one command per line on its
+ *  standard input and answers on its standard output with a frame made of:
+ *   - the command output lines, each one prefixed by FRAME_OUTPUT,
+ *   - a line made of FRAME_STATUS followed by the command exit status.
+ *
+ *  Asynchronous commands are spawned in their own script instance. Their output is read from a
+ *  pipe monitored on the event loop and their exit is detected through SIGCHLD, handled by the
+ *  Legato signal events so only the children spawned here are reaped.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_cmd.h"
+#include "pa_wifi_native.h"
+#include "pa_wifi_stats.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor shell script
+ */
+//--------------------------------------------------------------------------------------------------
+#define WIFI_SCRIPT_FILE    "/legato/systems/current/apps/wifiService/read-only/pa_wifi"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment variable replacing the PA script (ex: replay/pa_wifi.sh off-target).
+ */
+//--------------------------------------------------------------------------------------------------
+#define WIFI_SCRIPT_ENV     "WIFI_PA_SCRIPT"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Argument starting the script in command server mode.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMAND_SERVE       "SERVE"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command server frames.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FRAME_READY         "=READY\n"  ///< First line sent by the server.
+#define FRAME_OUTPUT        '.'         ///< Prefix of a command output line.
+#define FRAME_STATUS        '='         ///< Prefix of the command exit status, ends the frame.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum numbers of bytes in a command line and in an output line.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMAND_MAX_BYTES   512
+#define LINE_MAX_BYTES      512
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of arguments of an asynchronous command, and of bytes of its output.
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOB_MAX_ARGS        8
+#define JOB_OUTPUT_MAX_BYTES 1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous command.
+ */
+//--------------------------------------------------------------------------------------------------
+struct pa_wifiCmd_Job
+{
+    le_dls_Link_t                      link;                          ///< Link in JobList.
+    pid_t                              pid;                           ///< Script process ID.
+    int                                outputFd;                      ///< Output pipe, or -1.
+    le_fdMonitor_Ref_t                 fdMonitorRef;                  ///< Output pipe monitor.
+    pa_wifiCmd_CompletionHandlerFunc_t handlerFunc;                   ///< NULL once cancelled.
+    void                              *contextPtr;                    ///< Handler context.
+    le_clk_Time_t                      startTime;                     ///< Spawn time.
+    size_t                             outputLength;                  ///< Bytes in output.
+    char                               output[JOB_OUTPUT_MAX_BYTES];  ///< Command output.
+    char                               command[COMMAND_MAX_BYTES];    ///< Command, for traces.
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Environment of the spawned scripts.
+ */
+//--------------------------------------------------------------------------------------------------
+extern char **environ;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool and list of the running asynchronous commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t JobPool = NULL;
+static le_dls_List_t    JobList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex serializing the commands sent to the command server.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t CmdMutex = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process ID of the command server, -1 if it is not running.
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t ServerPid = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream on the command server socket, NULL if it is not running.
+ */
+//--------------------------------------------------------------------------------------------------
+static FILE *ServerPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cleared when the PA script does not support the command server mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsServerSupported = true;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a command output line to the output buffer and to the traces.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddOutput
+(
+    const char *textPtr,
+    char *outputPtr,
+    size_t outputSize
+)
+{
+    LE_DEBUG("%s", textPtr);
+
+    if ((NULL != outputPtr) && (outputSize > 0))
+    {
+        le_utf8_Append(outputPtr, textPtr, outputSize, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the command server. Closing its socket ends its command loop.
+ *
+ * @note Must be called with CmdMutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopServer
+(
+    void
+)
+{
+    if (NULL != ServerPtr)
+    {
+        fclose(ServerPtr);
+        ServerPtr = NULL;
+    }
+
+    if (ServerPid > 0)
+    {
+        waitpid(ServerPid, NULL, 0);
+        ServerPid = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the command server.
+ *
+ * @note Must be called with CmdMutex locked.
+ *
+ * @return true if the server is ready.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StartServer
+(
+    void
+)
+{
+    const char *scriptPtr = pa_wifiCmd_GetScript();
+    char        line[LINE_MAX_BYTES];
+    int         fds[2];
+    pid_t       pid;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0)
+    {
+        LE_ERROR("socketpair failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        return false;
+    }
+
+    pid = fork();
+    if (pid < 0)
+    {
+        LE_ERROR("fork failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (0 == pid)
+    {
+        // Child: the server reads the commands on stdin and answers on stdout. SIGCHLD is
+        // blocked in this process, see pa_wifiCmd_Init().
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, NULL);
+        dup2(fds[1], STDIN_FILENO);
+        dup2(fds[1], STDOUT_FILENO);
+        execl(scriptPtr, scriptPtr, COMMAND_SERVE, (char *)NULL);
+        _exit(127);
+    }
+
+    close(fds[1]);
+    ServerPid = pid;
+    ServerPtr = fdopen(fds[0], "r");
+    if (NULL == ServerPtr)
+    {
+        LE_ERROR("fdopen failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        close(fds[0]);
+        StopServer();
+        return false;
+    }
+
+    if ((NULL == fgets(line, sizeof(line), ServerPtr)) || (0 != strcmp(line, FRAME_READY)))
+    {
+        LE_WARN("PA script has no command server mode, one script instance per command");
+        IsServerSupported = false;
+        StopServer();
+        return false;
+    }
+
+    LE_INFO("PA command server started, pid %d", (int)pid);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command through the command server.
+ *
+ * @note Must be called with CmdMutex locked.
+ *
+ * @return The command status in the format of system().
+ */
+//--------------------------------------------------------------------------------------------------
+static int RunOnServer
+(
+    const char *commandPtr,
+    char *outputPtr,
+    size_t outputSize
+)
+{
+    char request[COMMAND_MAX_BYTES];
+    char line[LINE_MAX_BYTES];
+    bool isLineStart = true;
+    int  length = snprintf(request, sizeof(request), "%s\n", commandPtr);
+
+    if ((length < 0) || (length >= (int)sizeof(request)))
+    {
+        LE_ERROR("Command too long: %s", commandPtr);
+        return -1;
+    }
+
+    if (send(fileno(ServerPtr), request, length, MSG_NOSIGNAL) != length)
+    {
+        LE_ERROR("Failed to send command errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        StopServer();
+        return -1;
+    }
+
+    while (NULL != fgets(line, sizeof(line), ServerPtr))
+    {
+        size_t lineLength = strlen(line);
+
+        if (isLineStart && (FRAME_STATUS == line[0]))
+        {
+            // Same encoding as a normal exit in a wait status.
+            return (atoi(&line[1]) & 0xff) << 8;
+        }
+
+        // Long lines are read in several parts, only the first one has the prefix.
+        AddOutput((isLineStart && (FRAME_OUTPUT == line[0])) ? &line[1] : line,
+                  outputPtr,
+                  outputSize);
+        isLineStart = (lineLength > 0) && ('\n' == line[lineLength - 1]);
+    }
+
+    LE_ERROR("PA command server exited during command \"%s\"", commandPtr);
+    StopServer();
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a command in a new instance of the PA script.
+ *
+ * @return The command status in the format of system().
+ */
+//--------------------------------------------------------------------------------------------------
+static int RunWithShell
+(
+    const char *commandPtr,
+    char *outputPtr,
+    size_t outputSize
+)
+{
+    char  cmd[COMMAND_MAX_BYTES];
+    char  line[LINE_MAX_BYTES];
+    FILE *pipePtr;
+    int   length = snprintf(cmd, sizeof(cmd), "%s %s", pa_wifiCmd_GetScript(), commandPtr);
+
+    if ((length < 0) || (length >= (int)sizeof(cmd)))
+    {
+        LE_ERROR("Command too long: %s", commandPtr);
+        return -1;
+    }
+
+    pipePtr = popen(cmd, "r");
+    if (NULL == pipePtr)
+    {
+        LE_ERROR("Failed to run command:\"%s\" errno:%d %s",
+                 commandPtr,
+                 errno,
+                 LE_ERRNO_TXT(errno));
+        return -1;
+    }
+
+    while (NULL != fgets(line, sizeof(line), pipePtr))
+    {
+        AddOutput(line, outputPtr, outputSize);
+    }
+
+    return pclose(pipePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop monitoring the output pipe of an asynchronous command and close it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseJobOutput
+(
+    struct pa_wifiCmd_Job *jobPtr
+)
+{
+    if (NULL != jobPtr->fdMonitorRef)
+    {
+        le_fdMonitor_Delete(jobPtr->fdMonitorRef);
+        jobPtr->fdMonitorRef = NULL;
+    }
+
+    if (jobPtr->outputFd >= 0)
+    {
+        close(jobPtr->outputFd);
+        jobPtr->outputFd = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the available output of an asynchronous command. The output beyond the buffer size is
+ * dropped, but still read so that the script never blocks on a full pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadJobOutput
+(
+    struct pa_wifiCmd_Job *jobPtr
+)
+{
+    char    buffer[LINE_MAX_BYTES];
+    ssize_t length;
+
+    while ((length = read(jobPtr->outputFd, buffer, sizeof(buffer))) > 0)
+    {
+        size_t room = sizeof(jobPtr->output) - 1 - jobPtr->outputLength;
+
+        if ((size_t)length > room)
+        {
+            length = room;
+        }
+        memcpy(&jobPtr->output[jobPtr->outputLength], buffer, length);
+        jobPtr->outputLength += length;
+        jobPtr->output[jobPtr->outputLength] = '\0';
+    }
+
+    if ((0 == length) || ((EAGAIN != errno) && (EINTR != errno)))
+    {
+        // End of file: the script and its children closed the pipe.
+        CloseJobOutput(jobPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output pipe handler of an asynchronous command.
+ */
+//--------------------------------------------------------------------------------------------------
+static void JobOutputHandler
+(
+    int fd,
+    short events
+)
+{
+    ReadJobOutput(le_fdMonitor_GetContextPtr());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Complete an asynchronous command whose script has exited.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteJob
+(
+    struct pa_wifiCmd_Job *jobPtr,
+    int status
+)
+{
+    // Whatever the script wrote is in the pipe by now. Do not wait for the end of file: daemons
+    // started by the script may keep the pipe open.
+    if (jobPtr->outputFd >= 0)
+    {
+        ReadJobOutput(jobPtr);
+        CloseJobOutput(jobPtr);
+    }
+
+    le_dls_Remove(&JobList, &jobPtr->link);
+
+    pa_wifiStats_Record(jobPtr->command, jobPtr->startTime, status);
+    if (NULL != jobPtr->handlerFunc)
+    {
+        jobPtr->handlerFunc(status, jobPtr->output, jobPtr->contextPtr);
+    }
+
+    le_mem_Release(jobPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SIGCHLD handler: reap the asynchronous commands which have exited. The other children
+ * (command server, popen()) are left to their owner.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChildSignalHandler
+(
+    int sigNum
+)
+{
+    le_dls_Link_t *linkPtr = le_dls_Peek(&JobList);
+
+    while (NULL != linkPtr)
+    {
+        struct pa_wifiCmd_Job *jobPtr = CONTAINER_OF(linkPtr, struct pa_wifiCmd_Job, link);
+        int                    status;
+
+        // The handler may start or cancel commands, but cancelled ones stay in the list until
+        // they are reaped.
+        linkPtr = le_dls_PeekNext(&JobList, linkPtr);
+
+        if (waitpid(jobPtr->pid, &status, WNOHANG) == jobPtr->pid)
+        {
+            CompleteJob(jobPtr, status);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the command module. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiCmd_Init
+(
+    void
+)
+{
+    if (NULL == CmdMutex)
+    {
+        CmdMutex = le_mutex_CreateNonRecursive("WifiPaCmd");
+        JobPool  = le_mem_CreatePool("WifiPaCmdJob", sizeof(struct pa_wifiCmd_Job));
+
+        // SIGCHLD is received as an event; it must be blocked before the PA threads are created.
+        le_sig_Block(SIGCHLD);
+        le_sig_SetEventHandler(SIGCHLD, ChildSignalHandler);
+
+        pa_wifiNative_Init();
+        pa_wifiStats_Init();
+
+        if (0 != strcmp(pa_wifiCmd_GetScript(), WIFI_SCRIPT_FILE))
+        {
+            LE_INFO("PA script: %s", pa_wifiCmd_GetScript());
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of the PA script: the one of the wifiService app, unless replaced by the
+ * WIFI_PA_SCRIPT environment variable.
+ *
+ * @return The path of the PA script.
+ */
+//--------------------------------------------------------------------------------------------------
+const char *pa_wifiCmd_GetScript
+(
+    void
+)
+{
+    const char *pathPtr = getenv(WIFI_SCRIPT_ENV);
+
+    return ((NULL != pathPtr) && ('\0' != pathPtr[0])) ? pathPtr : WIFI_SCRIPT_FILE;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command whose output is read as a stream (scan results, events), in a new
+ * instance of the script. The stream is closed with pclose().
+ *
+ * @return The stream of the command output, NULL with errno set if the command could not be run.
+ */
+//--------------------------------------------------------------------------------------------------
+FILE *pa_wifiCmd_Open
+(
+    const char *commandPtr
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces.
+)
+{
+    char cmd[COMMAND_MAX_BYTES];
+    int  length = snprintf(cmd, sizeof(cmd), "%s %s", pa_wifiCmd_GetScript(), commandPtr);
+
+    if ((length < 0) || (length >= (int)sizeof(cmd)))
+    {
+        LE_ERROR("Command too long: %s", commandPtr);
+        errno = E2BIG;
+        return NULL;
+    }
+
+    return popen(cmd, "r");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command and wait for its completion. Can be called from any thread, commands
+ * are run one at a time. The commands which do not need the shell are run natively, see
+ * pa_wifi_native.h.
+ *
+ * @return The command status in the format of system(): -1 if the command could not be run,
+ *         otherwise a wait status to decode with WIFEXITED() and WEXITSTATUS().
+ */
+//--------------------------------------------------------------------------------------------------
+int pa_wifiCmd_Run
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces (ex: "WIFIAP_WLAN_UP 192.168.0.1").
+    char *outputPtr,
+        ///< [OUT]
+        ///< Buffer receiving the command output, truncated if needed. Can be NULL.
+    size_t outputSize
+        ///< [IN]
+        ///< Size of the output buffer.
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    int           status = -1;
+    bool          isServed = false;
+
+    if ((NULL != outputPtr) && (outputSize > 0))
+    {
+        outputPtr[0] = '\0';
+    }
+
+    if (NULL != strchr(commandPtr, '\n'))
+    {
+        LE_ERROR("Invalid command: %s", commandPtr);
+        return -1;
+    }
+
+    // Not under CmdMutex: native commands run PA script hooks.
+    if (pa_wifiNative_Run(commandPtr, &status))
+    {
+        pa_wifiStats_Record(commandPtr, startTime, status);
+        return status;
+    }
+
+    le_mutex_Lock(CmdMutex);
+    if ((NULL == ServerPtr) && IsServerSupported)
+    {
+        StartServer();
+    }
+    if (NULL != ServerPtr)
+    {
+        status = RunOnServer(commandPtr, outputPtr, outputSize);
+        isServed = true;
+    }
+    le_mutex_Unlock(CmdMutex);
+
+    if (!isServed)
+    {
+        status = RunWithShell(commandPtr, outputPtr, outputSize);
+    }
+
+    pa_wifiStats_Record(commandPtr, startTime, status);
+    return status;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command in a new instance of the script without waiting for its completion.
+ *
+ * The command output is collected and its exit is detected on the event loop of the calling
+ * thread, which then calls the completion handler. Must be called from the thread which called
+ * pa_wifiCmd_Init(), usually the main thread.
+ *
+ * @return Command reference, or NULL if the command could not be started.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_wifiCmd_JobRef_t pa_wifiCmd_RunAsync
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces (ex: "WIFIAP_WLAN_UP 192.168.0.1").
+    pa_wifiCmd_CompletionHandlerFunc_t handlerFunc,
+        ///< [IN]
+        ///< Completion handler. Can be NULL.
+    void *contextPtr
+        ///< [IN]
+        ///< Completion handler context.
+)
+{
+    struct pa_wifiCmd_Job     *jobPtr;
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t          attr;
+    sigset_t                   mask;
+    char                       args[COMMAND_MAX_BYTES];
+    char                      *argv[JOB_MAX_ARGS + 2];
+    char                      *savePtr = NULL;
+    int                        argc = 0;
+    int                        fds[2];
+    int                        rc;
+
+    if (LE_OK != le_utf8_Copy(args, commandPtr, sizeof(args), NULL))
+    {
+        LE_ERROR("Command too long: %s", commandPtr);
+        return NULL;
+    }
+
+    argv[argc++] = (char *)pa_wifiCmd_GetScript();
+    for (char *argPtr = strtok_r(args, " ", &savePtr);
+         NULL != argPtr;
+         argPtr = strtok_r(NULL, " ", &savePtr))
+    {
+        if (argc > JOB_MAX_ARGS)
+        {
+            LE_ERROR("Too many arguments: %s", commandPtr);
+            return NULL;
+        }
+        argv[argc++] = argPtr;
+    }
+    argv[argc] = NULL;
+
+    if (pipe2(fds, O_CLOEXEC) < 0)
+    {
+        LE_ERROR("pipe failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        return NULL;
+    }
+
+    // The script gets no input, writes to the pipe, runs in its own process group so that it can
+    // be terminated with its children, and does not inherit the blocked SIGCHLD.
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+    posix_spawnattr_init(&attr);
+    sigemptyset(&mask);
+    posix_spawnattr_setsigmask(&attr, &mask);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP);
+
+    jobPtr = le_mem_ForceAlloc(JobPool);
+    memset(jobPtr, 0, sizeof(*jobPtr));
+    jobPtr->link        = LE_DLS_LINK_INIT;
+    jobPtr->handlerFunc = handlerFunc;
+    jobPtr->contextPtr  = contextPtr;
+    le_utf8_Copy(jobPtr->command, commandPtr, sizeof(jobPtr->command), NULL);
+
+    jobPtr->startTime = le_clk_GetRelativeTime();
+    rc = posix_spawn(&jobPtr->pid, argv[0], &actions, &attr, argv, environ);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (0 != rc)
+    {
+        LE_ERROR("Failed to run command:\"%s\" errno:%d %s", commandPtr, rc, LE_ERRNO_TXT(rc));
+        close(fds[0]);
+        le_mem_Release(jobPtr);
+        return NULL;
+    }
+
+    // The exit is reported by SIGCHLD on the event loop, so it cannot be missed even if the
+    // script is already done.
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    jobPtr->outputFd     = fds[0];
+    jobPtr->fdMonitorRef = le_fdMonitor_Create("WifiPaCmd", fds[0], JobOutputHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(jobPtr->fdMonitorRef, jobPtr);
+    le_dls_Queue(&JobList, &jobPtr->link);
+
+    LE_DEBUG("Command \"%s\" started, pid %d", commandPtr, (int)jobPtr->pid);
+    return jobPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel an asynchronous command: the script and its children are terminated and the completion
+ * handler is not called. Must be called from the thread which started the command.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiCmd_Cancel
+(
+    pa_wifiCmd_JobRef_t jobRef
+        ///< [IN]
+        ///< Command reference.
+)
+{
+    // The command is released when its script is reaped.
+    LE_INFO("Cancelling command \"%s\"", jobRef->command);
+    jobRef->handlerFunc = NULL;
+    kill(-jobRef->pid, SIGTERM);
+}
@@ -0,0 +1,280 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter configuration files
+ *
+ *  The content is hashed with 64-bit FNV-1a. A file is considered unchanged when the hash of the
+ *  new content is the hash of the last content written, and the file on disk is still the one
+ *  written (same inode, size and modification time): a file removed or edited by someone else is
+ *  always written again.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_conf.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initial size of a buffer, enough for most configuration files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INIT_BUFFER_BYTES       1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Suffix of the temporary file renamed over the configuration file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEMP_FILE_SUFFIX        ".tmp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * 64-bit FNV-1a parameters.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FNV_OFFSET_BASIS        0xcbf29ce484222325ULL
+#define FNV_PRIME               0x100000001b3ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash a content.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t Hash
+(
+    const char *dataPtr,
+    size_t length
+)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    size_t   i;
+
+    for (i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)dataPtr[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a file is still the one of the last write.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsFileUnchanged
+(
+    const pa_wifiConf_File_t *filePtr,
+    const char *pathPtr
+)
+{
+    struct stat st;
+
+    if (-1 == stat(pathPtr, &st))
+    {
+        return false;
+    }
+
+    return ((st.st_dev == filePtr->device) &&
+            (st.st_ino == filePtr->inode) &&
+            (st.st_size == filePtr->size) &&
+            (st.st_mtim.tv_sec == filePtr->mtime.tv_sec) &&
+            (st.st_mtim.tv_nsec == filePtr->mtime.tv_nsec));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a content to a file, retrying on partial writes.
+ *
+ * @return
+ *      - LE_OK             The content is written.
+ *      - LE_FAULT          The write failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int fd,
+    const char *dataPtr,
+    size_t length
+)
+{
+    while (length > 0)
+    {
+        ssize_t count = write(fd, dataPtr, length);
+
+        if (-1 == count)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            return LE_FAULT;
+        }
+        dataPtr += count;
+        length -= (size_t)count;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append formatted text to a buffer, growing it as needed.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiConf_Append
+(
+    pa_wifiConf_Buffer_t *bufferPtr,
+        ///< [INOUT]
+        ///< Buffer.
+    const char *formatPtr,
+        ///< [IN]
+        ///< printf() format.
+    ...
+)
+{
+    va_list args;
+    int     length;
+    size_t  needed;
+
+    va_start(args, formatPtr);
+    length = vsnprintf(NULL, 0, formatPtr, args);
+    va_end(args);
+    LE_ASSERT(length >= 0);
+
+    needed = bufferPtr->length + (size_t)length + 1;
+    if (needed > bufferPtr->size)
+    {
+        size_t size = (0 == bufferPtr->size) ? INIT_BUFFER_BYTES : bufferPtr->size;
+
+        while (size < needed)
+        {
+            size *= 2;
+        }
+        bufferPtr->dataPtr = realloc(bufferPtr->dataPtr, size);
+        LE_ASSERT(NULL != bufferPtr->dataPtr);
+        bufferPtr->size = size;
+    }
+
+    va_start(args, formatPtr);
+    vsnprintf(bufferPtr->dataPtr + bufferPtr->length, bufferPtr->size - bufferPtr->length,
+              formatPtr, args);
+    va_end(args);
+    bufferPtr->length += (size_t)length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the memory of a buffer, which is then empty.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiConf_Release
+(
+    pa_wifiConf_Buffer_t *bufferPtr
+        ///< [INOUT]
+        ///< Buffer.
+)
+{
+    free(bufferPtr->dataPtr);
+    bufferPtr->dataPtr = NULL;
+    bufferPtr->length = 0;
+    bufferPtr->size = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the content of a buffer to a configuration file, unless the content and the file are
+ * unchanged since the last write.
+ *
+ * @return
+ *      - LE_OK             The file is written.
+ *      - LE_DUPLICATE      The file is unchanged, it is not written.
+ *      - LE_FAULT          The file can not be written. The previous file is left in place.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiConf_Write
+(
+    pa_wifiConf_File_t *filePtr,
+        ///< [INOUT]
+        ///< Last write of the file.
+    const char *pathPtr,
+        ///< [IN]
+        ///< Path of the file.
+    const pa_wifiConf_Buffer_t *bufferPtr
+        ///< [IN]
+        ///< Content of the file.
+)
+{
+    char        tempPath[PATH_MAX];
+    uint64_t    hash = Hash(bufferPtr->dataPtr, bufferPtr->length);
+    struct stat st;
+    int         fd;
+
+    if (filePtr->isWritten && (hash == filePtr->hash) && IsFileUnchanged(filePtr, pathPtr))
+    {
+        LE_DEBUG("%s unchanged", pathPtr);
+        return LE_DUPLICATE;
+    }
+
+    if (LE_OK != le_utf8_Copy(tempPath, pathPtr, sizeof(tempPath), NULL) ||
+        LE_OK != le_utf8_Append(tempPath, TEMP_FILE_SUFFIX, sizeof(tempPath), NULL))
+    {
+        LE_ERROR("Path too long: %s", pathPtr);
+        return LE_FAULT;
+    }
+
+    // The file may hold a passphrase: only readable by the owner.
+    fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to create %s, errno %d (%s)", tempPath, errno, LE_ERRNO_TXT(errno));
+        return LE_FAULT;
+    }
+
+    if ((LE_OK != WriteAll(fd, bufferPtr->dataPtr, bufferPtr->length)) ||
+        (-1 == fstat(fd, &st)))
+    {
+        LE_ERROR("Unable to write %s, errno %d (%s)", tempPath, errno, LE_ERRNO_TXT(errno));
+        close(fd);
+        unlink(tempPath);
+        return LE_FAULT;
+    }
+    close(fd);
+
+    if (-1 == rename(tempPath, pathPtr))
+    {
+        LE_ERROR("Unable to rename %s, errno %d (%s)", tempPath, errno, LE_ERRNO_TXT(errno));
+        unlink(tempPath);
+        return LE_FAULT;
+    }
+
+    filePtr->isWritten = true;
+    filePtr->hash = hash;
+    filePtr->device = st.st_dev;
+    filePtr->inode = st.st_ino;
+    filePtr->size = st.st_size;
+    filePtr->mtime = st.st_mtim;
+    LE_DEBUG("%s written (%zu bytes)", pathPtr, bufferPtr->length);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forget the last write of a configuration file, so that it is written again by the next
+ * pa_wifiConf_Write().
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiConf_Invalidate
+(
+    pa_wifiConf_File_t *filePtr
+        ///< [INOUT]
+        ///< Last write of the file.
+)
+{
+    filePtr->isWritten = false;
+}
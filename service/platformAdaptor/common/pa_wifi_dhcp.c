@@ -0,0 +1,459 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter DHCP leases
+ *
+ *  The lease file of dnsmasq has one line per lease:
+ *  <expiry> <MAC address> <IP address> <host name or *> <client id or *>
+ *
+ *  dnsmasq rewrites it in place after each change, so the directory of the file is watched and
+ *  the table is marked out of date on any change of the file. It is only parsed again, and merged
+ *  into the table, when the leases are next read.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <ctype.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_dhcp.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of lease entries allocated at startup.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INIT_LEASE_COUNT    10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Changes of the lease file watched in its directory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LEASE_FILE_EVENTS   (IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | \
+                             IN_MOVED_FROM | IN_MOVED_TO)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease entry of the table.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiDhcp_Lease_t lease;          ///< Lease, lease.macAddress is the key of the table.
+    uint32_t            parseCount;     ///< Last parse of the lease file reporting it.
+    le_dls_Link_t       link;           ///< Link in LeaseList.
+}
+LeaseEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease table: entries allocated from the pool, indexed by MAC address in the map and listed in
+ * the order they were first seen.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LeasePool = NULL;
+static le_hashmap_Ref_t LeaseMap;
+static le_dls_List_t    LeaseList = LE_DLS_LIST_INIT;
+static uint32_t         ParseCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lease file, and its name in its directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static char        LeaseFile[PATH_MAX] = "";
+static const char *LeaseFileNamePtr = LeaseFile;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * inotify descriptor watching the directory of the lease file, and its monitor.
+ */
+//--------------------------------------------------------------------------------------------------
+static int                InotifyFd = -1;
+static le_fdMonitor_Ref_t InotifyMonitorRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * True if the lease file may have changed since it was last parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsDirty = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the lease table on first use.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitLeaseTable
+(
+    void
+)
+{
+    if (NULL != LeasePool)
+    {
+        return;
+    }
+    LeasePool = le_mem_CreatePool("WifiDhcpLeasePool", sizeof(LeaseEntry_t));
+    le_mem_ExpandPool(LeasePool, INIT_LEASE_COUNT);
+    LeaseMap = le_hashmap_Create("WifiDhcpLeaseMap", INIT_LEASE_COUNT,
+                                 le_hashmap_HashString, le_hashmap_EqualsString);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a lease from the table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveLease
+(
+    LeaseEntry_t *entryPtr
+)
+{
+    le_hashmap_Remove(LeaseMap, entryPtr->lease.macAddress);
+    le_dls_Remove(&LeaseList, &entryPtr->link);
+    le_mem_Release(entryPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the leases which were not in the last parse of the lease file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveOldLeases
+(
+    void
+)
+{
+    le_dls_Link_t *linkPtr = le_dls_Peek(&LeaseList);
+
+    while (NULL != linkPtr)
+    {
+        LeaseEntry_t *entryPtr = CONTAINER_OF(linkPtr, LeaseEntry_t, link);
+
+        linkPtr = le_dls_PeekNext(&LeaseList, linkPtr);
+        if (entryPtr->parseCount != ParseCount)
+        {
+            RemoveLease(entryPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a MAC address in lower case.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyMacAddress
+(
+    char       *destPtr,
+    const char *srcPtr
+)
+{
+    size_t i;
+
+    for (i = 0; (i < (LE_WIFIDEFS_MAX_BSSID_BYTES - 1)) && ('\0' != srcPtr[i]); i++)
+    {
+        destPtr[i] = (char)tolower((unsigned char)srcPtr[i]);
+    }
+    destPtr[i] = '\0';
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the lease file and merge it into the table. The leases which are not in the file any more
+ * are removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseLeaseFile
+(
+    void
+)
+{
+    FILE *filePtr;
+    char  line[256];
+
+    // A change during the parse is reported afterwards and makes the table out of date again.
+    IsDirty = (InotifyFd < 0);
+    ParseCount++;
+
+    filePtr = fopen(LeaseFile, "r");
+    if (NULL != filePtr)
+    {
+        while (NULL != fgets(line, sizeof(line), filePtr))
+        {
+            unsigned long long expiry;
+            char               macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];
+            char               ipAddress[INET_ADDRSTRLEN];
+            char               hostname[PA_WIFIDHCP_MAX_HOSTNAME_BYTES];
+            LeaseEntry_t      *entryPtr;
+
+            // The field widths are the buffer sizes minus 1. Other lines (ex: duid) are ignored.
+            if (4 != sscanf(line, "%llu %17s %15s %63s", &expiry, macAddress, ipAddress, hostname))
+            {
+                continue;
+            }
+            CopyMacAddress(macAddress, macAddress);
+
+            entryPtr = le_hashmap_Get(LeaseMap, macAddress);
+            if (NULL == entryPtr)
+            {
+                entryPtr = le_mem_ForceAlloc(LeasePool);
+                memset(entryPtr, 0, sizeof(LeaseEntry_t));
+                le_utf8_Copy(entryPtr->lease.macAddress, macAddress,
+                             sizeof(entryPtr->lease.macAddress), NULL);
+                entryPtr->link = LE_DLS_LINK_INIT;
+                le_hashmap_Put(LeaseMap, entryPtr->lease.macAddress, entryPtr);
+                le_dls_Queue(&LeaseList, &entryPtr->link);
+                LE_DEBUG("Lease %s: %s", macAddress, ipAddress);
+            }
+            le_utf8_Copy(entryPtr->lease.ipAddress, ipAddress, sizeof(entryPtr->lease.ipAddress),
+                         NULL);
+            le_utf8_Copy(entryPtr->lease.hostname, (0 == strcmp(hostname, "*")) ? "" : hostname,
+                         sizeof(entryPtr->lease.hostname), NULL);
+            entryPtr->lease.expiry = expiry;
+            entryPtr->parseCount = ParseCount;
+        }
+        fclose(filePtr);
+    }
+    RemoveOldLeases();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a lease has expired.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsExpired
+(
+    const pa_wifiDhcp_Lease_t *leasePtr,
+    time_t                     now
+)
+{
+    return ((0 != leasePtr->expiry) && (leasePtr->expiry <= (uint64_t)now));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the inotify events: mark the table out of date if the lease file changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InotifyHandler
+(
+    int    fd,
+    short  events
+)
+{
+    char    buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+
+    while (0 < (length = read(fd, buffer, sizeof(buffer))))
+    {
+        const char *ptr;
+
+        for (ptr = buffer; ptr < (buffer + length);
+             ptr += sizeof(struct inotify_event) + ((const struct inotify_event *)ptr)->len)
+        {
+            const struct inotify_event *eventPtr = (const struct inotify_event *)ptr;
+
+            if ((eventPtr->mask & IN_Q_OVERFLOW) ||
+                ((0 != eventPtr->len) && (0 == strcmp(eventPtr->name, LeaseFileNamePtr))))
+            {
+                IsDirty = true;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop watching the lease file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopWatching
+(
+    void
+)
+{
+    if (NULL != InotifyMonitorRef)
+    {
+        le_fdMonitor_Delete(InotifyMonitorRef);
+        InotifyMonitorRef = NULL;
+    }
+    if (0 <= InotifyFd)
+    {
+        close(InotifyFd);
+        InotifyFd = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start watching the directory of the lease file.
+ *
+ * @return
+ *      - LE_OK             The lease file is watched.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartWatching
+(
+    void
+)
+{
+    char  directory[PATH_MAX];
+    char *slashPtr;
+
+    le_utf8_Copy(directory, LeaseFile, sizeof(directory), NULL);
+    slashPtr = strrchr(directory, '/');
+    if ((NULL == slashPtr) || (directory == slashPtr))
+    {
+        LE_ERROR("Invalid lease file %s", LeaseFile);
+        return LE_FAULT;
+    }
+    *slashPtr = '\0';
+    LeaseFileNamePtr = LeaseFile + (slashPtr - directory) + 1;
+
+    InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (0 > InotifyFd)
+    {
+        LE_ERROR("inotify_init1 failed: %m");
+        return LE_FAULT;
+    }
+    if (0 > inotify_add_watch(InotifyFd, directory, LEASE_FILE_EVENTS))
+    {
+        LE_ERROR("Unable to watch %s: %m", directory);
+        StopWatching();
+        return LE_FAULT;
+    }
+    InotifyMonitorRef = le_fdMonitor_Create("WifiDhcpLeases", InotifyFd, InotifyHandler, POLLIN);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the lease file of the DHCP server of the WLAN, and start watching it.
+ *
+ * @return
+ *      - LE_OK             The lease file is watched.
+ *      - LE_FAULT          The lease file can not be watched. The leases are then read again
+ *                          each time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiDhcp_SetLeaseFile
+(
+    const char *pathPtr
+        ///< [IN]
+        ///< Lease file path, or NULL when the DHCP server is stopped.
+)
+{
+    InitLeaseTable();
+
+    if ((NULL != pathPtr) && (0 == strcmp(pathPtr, LeaseFile)))
+    {
+        return (0 <= InotifyFd) ? LE_OK : LE_FAULT;
+    }
+
+    StopWatching();
+    LeaseFile[0] = '\0';
+    LeaseFileNamePtr = LeaseFile;
+    IsDirty = false;
+    ParseCount++;
+    RemoveOldLeases();
+
+    if (NULL == pathPtr)
+    {
+        return LE_OK;
+    }
+
+    if (LE_OK != le_utf8_Copy(LeaseFile, pathPtr, sizeof(LeaseFile), NULL))
+    {
+        LE_ERROR("Lease file path too long");
+        LeaseFile[0] = '\0';
+        return LE_FAULT;
+    }
+    IsDirty = true;
+    LE_INFO("DHCP lease file %s", LeaseFile);
+    return StartWatching();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current leases, in the order they were first seen.
+ *
+ * The handler is called for each lease which has not expired, before the function returns.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiDhcp_GetLeases
+(
+    pa_wifiDhcp_LeaseHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each lease.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+)
+{
+    time_t         now = time(NULL);
+    le_dls_Link_t *linkPtr;
+
+    if ((NULL == LeasePool) || ('\0' == LeaseFile[0]))
+    {
+        return;
+    }
+    if (IsDirty)
+    {
+        ParseLeaseFile();
+    }
+
+    for (linkPtr = le_dls_Peek(&LeaseList); NULL != linkPtr;
+         linkPtr = le_dls_PeekNext(&LeaseList, linkPtr))
+    {
+        const LeaseEntry_t *entryPtr = CONTAINER_OF(linkPtr, LeaseEntry_t, link);
+
+        if (!IsExpired(&entryPtr->lease, now))
+        {
+            handlerPtr(&entryPtr->lease, contextPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current lease of a MAC address.
+ *
+ * @return The lease, valid until the next call of a pa_wifiDhcp function, or NULL if none.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_wifiDhcp_Lease_t *pa_wifiDhcp_GetLease
+(
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address.
+)
+{
+    char                macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];
+    const LeaseEntry_t *entryPtr;
+
+    if ((NULL == LeasePool) || ('\0' == LeaseFile[0]))
+    {
+        return NULL;
+    }
+    if (IsDirty)
+    {
+        ParseLeaseFile();
+    }
+
+    CopyMacAddress(macAddress, macAddressPtr);
+    entryPtr = le_hashmap_Get(LeaseMap, macAddress);
+    if ((NULL == entryPtr) || IsExpired(&entryPtr->lease, time(NULL)))
+    {
+        return NULL;
+    }
+    return &entryPtr->lease;
+}
@@ -0,0 +1,710 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter radio
+ *
+ *  The roles are only started and stopped from the main thread. The event thread reads the role
+ *  handlers and interfaces under a mutex, and calls the handlers without holding it.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_cmd.h"
+#include "pa_wifi_native.h"
+#include "pa_wifi_nl80211.h"
+#include "pa_wifi_radio.h"
+
+// Set of commands to drive the WiFi hardware.
+#define COMMAND_WIFI_HW_START       "WIFI_START"
+#define COMMAND_WIFI_HW_STOP        "WIFI_STOP"
+#define COMMAND_WIFI_SET_EVENT      "WIFI_SET_EVENT"
+#define COMMAND_WIFI_UNSET_EVENT    "WIFI_UNSET_EVENT"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exit codes of WIFI_START, same as the PA script ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EXIT_NOT_FOUND          50      ///< WiFi card is not inserted.
+#define EXIT_NOT_POSSIBLE       100     ///< WiFi card may not work.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WLAN interface, created by the driver, and virtual interface of the access point in concurrent
+ * mode, used when the HW_INFO hook of the PA script does not give them.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WLAN_INTERFACE_DEFAULT          "wlan0"
+#define AP_VIRTUAL_INTERFACE_DEFAULT    "ap0"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Locally administered bit of the first byte of a MAC address.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAC_LOCAL_BIT           0x02
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a role.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                            isStarted;              ///< Role started.
+    bool                            isVirtual;              ///< Interface created for the role.
+    char                            ifName[IF_NAMESIZE];    ///< Interface, set when started.
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc;            ///< Event line handler.
+}
+Role_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Roles, indexed by pa_wifiRadio_Role_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static Role_t Roles[PA_WIFIRADIO_ROLE_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of roles started. The hardware is started when it is not 0.
+ */
+//--------------------------------------------------------------------------------------------------
+static int StartedCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the access point runs on a virtual interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsConcurrent = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the roles read by the event thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t RoleMutex = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event thread, and the input pipe of the iw events it reads.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t EventThread = NULL;
+static FILE           *IwThreadPipePtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WLAN interface, created by the driver.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char *GetWlanInterface
+(
+    void
+)
+{
+    const char *ifNamePtr = pa_wifiNative_GetInterface();
+
+    return (NULL != ifNamePtr) ? ifNamePtr : WLAN_INTERFACE_DEFAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the virtual interface of the access point in concurrent mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char *GetApVirtualInterface
+(
+    void
+)
+{
+    const char *ifNamePtr = pa_wifiNative_GetApInterface();
+
+    return (NULL != ifNamePtr) ? ifNamePtr : AP_VIRTUAL_INTERFACE_DEFAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event thread destructor
+ */
+//--------------------------------------------------------------------------------------------------
+static void ThreadDestructor
+(
+    void *contextPtr
+)
+{
+    int status;
+
+    // Kill the script launched by popen() in the event thread
+    status = pa_wifiCmd_Run(COMMAND_WIFI_UNSET_EVENT, NULL, 0);
+
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_WARN("Unable to kill the WIFI events script");
+    }
+
+    if (IwThreadPipePtr)
+    {
+        // And close the communication pipe used in the event thread.
+        pclose(IwThreadPipePtr);
+        IwThreadPipePtr = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the interface of an event line is the one of a role. The access point also gets
+ * the lines of its additional BSS, named after its interface (ex: "wlan0_1").
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRoleLine
+(
+    pa_wifiRadio_Role_t role,
+    const char *ifNamePtr,
+    size_t ifNameLength
+)
+{
+    const Role_t *rolePtr = &Roles[role];
+    size_t        length = strlen(rolePtr->ifName);
+
+    if (!rolePtr->isStarted || (NULL == rolePtr->handlerFunc) ||
+        (ifNameLength < length) || (0 != strncmp(ifNamePtr, rolePtr->ifName, length)))
+    {
+        return false;
+    }
+
+    return (ifNameLength == length) ||
+           ((PA_WIFIRADIO_ROLE_AP == role) && ('_' == ifNamePtr[length]));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event thread: read the iw events and pass each line to the roles it concerns.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *EventThreadMain
+(
+    void *contextPtr
+)
+{
+    char line[1024];
+
+    LE_INFO("Wifi event report thread started!");
+
+    IwThreadPipePtr = pa_wifiCmd_Open(COMMAND_WIFI_SET_EVENT);
+
+    if (NULL == IwThreadPipePtr)
+    {
+        LE_ERROR("Failed to run command:\"%s\" errno:%d %s",
+                 COMMAND_WIFI_SET_EVENT,
+                 errno,
+                 LE_ERRNO_TXT(errno));
+        return NULL;
+    }
+
+    // Read the output one line at a time.
+    while (NULL != fgets(line, sizeof(line), IwThreadPipePtr))
+    {
+        // Timestamp the line as soon as it is read, before any parsing or blocking call.
+        le_clk_Time_t                   captureTime = le_clk_GetRelativeTime();
+        pa_wifiRadio_EventHandlerFunc_t handlers[PA_WIFIRADIO_ROLE_COUNT];
+        size_t                          ifNameLength = strcspn(line, " :");
+        int                             role;
+
+        // Lines not naming an interface (ex: "phy #0: regulatory domain change") are ignored.
+        le_mutex_Lock(RoleMutex);
+        for (role = 0; role < PA_WIFIRADIO_ROLE_COUNT; role++)
+        {
+            handlers[role] = IsRoleLine(role, line, ifNameLength) ? Roles[role].handlerFunc : NULL;
+        }
+        le_mutex_Unlock(RoleMutex);
+
+        for (role = 0; role < PA_WIFIRADIO_ROLE_COUNT; role++)
+        {
+            if (NULL != handlers[role])
+            {
+                handlers[role](line, captureTime);
+            }
+        }
+    }
+    // Run the event loop
+    le_event_RunLoop();
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give a virtual interface a locally administered MAC address derived from the one of the WLAN
+ * interface: most drivers refuse two interfaces with the same address on a radio.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetVirtualAddress
+(
+    const char *ifNamePtr
+)
+{
+    struct ifreq ifr;
+    uint8_t     *macPtr = (uint8_t *)ifr.ifr_hwaddr.sa_data;
+    const char  *wlanIfNamePtr = GetWlanInterface();
+    int          sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (sock < 0)
+    {
+        LE_ERROR("socket failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        return;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    le_utf8_Copy(ifr.ifr_name, wlanIfNamePtr, sizeof(ifr.ifr_name), NULL);
+    if (ioctl(sock, SIOCGIFHWADDR, &ifr) < 0)
+    {
+        LE_WARN("%s: SIOCGIFHWADDR failed errno:%d %s", wlanIfNamePtr, errno, LE_ERRNO_TXT(errno));
+        close(sock);
+        return;
+    }
+
+    if (macPtr[0] & MAC_LOCAL_BIT)
+    {
+        macPtr[5] ^= 0x01;
+    }
+    else
+    {
+        macPtr[0] |= MAC_LOCAL_BIT;
+    }
+
+    le_utf8_Copy(ifr.ifr_name, ifNamePtr, sizeof(ifr.ifr_name), NULL);
+    ifr.ifr_hwaddr.sa_family = ARPHRD_ETHER;
+    if (ioctl(sock, SIOCSIFHWADDR, &ifr) < 0)
+    {
+        LE_WARN("%s: SIOCSIFHWADDR failed errno:%d %s", ifNamePtr, errno, LE_ERRNO_TXT(errno));
+    }
+    close(sock);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the virtual interface of the access point. An interface left by a previous run is
+ * reused.
+ *
+ * @return
+ *      - LE_OK             The interface exists.
+ *      - LE_FAULT          The interface could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddVirtualInterface
+(
+    Role_t *rolePtr,
+    const char *ifNamePtr
+)
+{
+    const char *wlanIfNamePtr = GetWlanInterface();
+    le_result_t result = pa_wifiNl80211_AddApInterface(wlanIfNamePtr, ifNamePtr);
+
+    if (LE_DUPLICATE == result)
+    {
+        LE_INFO("Reusing interface %s", ifNamePtr);
+    }
+    else if (LE_OK != result)
+    {
+        LE_ERROR("Unable to create interface %s on %s, the driver may not support it",
+                 ifNamePtr, wlanIfNamePtr);
+        return LE_FAULT;
+    }
+    else
+    {
+        SetVirtualAddress(ifNamePtr);
+    }
+
+    rolePtr->isVirtual = true;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the hardware and the event thread.
+ *
+ * @return
+ *      - LE_OK             The hardware is started.
+ *      - LE_NOT_FOUND      The WiFi card is absent.
+ *      - LE_UNAVAILABLE    The WiFi card may not work.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartHardware
+(
+    void
+)
+{
+    int status = pa_wifiCmd_Run(COMMAND_WIFI_HW_START, NULL, 0);
+
+    /**
+     * Returned values:
+     *   0: if the interface is correctly mounted
+     *  50: if WiFi card is not inserted
+     * 100: if WiFi card may not work
+     * 127: if driver can not be installed
+     *  -1: if the fork() has failed (see man system)
+     */
+    if ((-1 == status) || !WIFEXITED(status))
+    {
+        LE_WARN("Failed to start WiFi command \"%s\" status (%d)", COMMAND_WIFI_HW_START, status);
+        return LE_FAULT;
+    }
+
+    switch (WEXITSTATUS(status))
+    {
+        case 0:
+            break;
+        case EXIT_NOT_FOUND:
+            LE_WARN("WiFi card is not inserted");
+            return LE_NOT_FOUND;
+        case EXIT_NOT_POSSIBLE:
+            LE_WARN("Unable to reset WiFi card");
+            return LE_UNAVAILABLE;
+        default:
+            LE_WARN("Failed to start WiFi command \"%s\" status (%d)",
+                    COMMAND_WIFI_HW_START, status);
+            return LE_FAULT;
+    }
+
+    LE_DEBUG("WiFi hardware started correctly");
+    EventThread = le_thread_Create("WifiEventThread", EventThreadMain, NULL);
+    le_thread_SetJoinable(EventThread);
+    le_thread_AddChildDestructor(EventThread, ThreadDestructor, NULL);
+    le_thread_Start(EventThread);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the hardware, then the event thread, which may still read the events of the stop.
+ *
+ * @return
+ *      - LE_OK             The hardware is stopped.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StopHardware
+(
+    void
+)
+{
+    int status = pa_wifiCmd_Run(COMMAND_WIFI_HW_STOP, NULL, 0);
+
+    if ((!WIFEXITED(status)) || (0 != WEXITSTATUS(status)))
+    {
+        LE_ERROR("WiFi Command \"%s\" Failed: (%d)", COMMAND_WIFI_HW_STOP, status);
+        return LE_FAULT;
+    }
+
+    le_thread_Cancel(EventThread);
+    if (LE_OK != le_thread_Join(EventThread, NULL))
+    {
+        return LE_FAULT;
+    }
+    EventThread = NULL;
+
+    LE_DEBUG("WiFi hardware stopped correctly");
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the radio module. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiRadio_Init
+(
+    void
+)
+{
+    if (NULL == RoleMutex)
+    {
+        RoleMutex = le_mutex_CreateNonRecursive("WifiPaRadio");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the access point on a virtual interface, so that the client can be used at the same time.
+ * Applied at the next start of the access point.
+ *
+ * @return
+ *      - LE_OK             The mode is set.
+ *      - LE_BUSY           The access point is started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_SetConcurrent
+(
+    bool isConcurrent
+        ///< [IN]
+        ///< true to run the access point on a virtual interface.
+)
+{
+    if (Roles[PA_WIFIRADIO_ROLE_AP].isStarted)
+    {
+        LE_ERROR("Access point started");
+        return LE_BUSY;
+    }
+
+    IsConcurrent = isConcurrent;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the access point runs on a virtual interface.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_wifiRadio_IsConcurrent
+(
+    void
+)
+{
+    return IsConcurrent;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the interface of a role.
+ *
+ * @return The interface name.
+ */
+//--------------------------------------------------------------------------------------------------
+const char *pa_wifiRadio_GetInterface
+(
+    pa_wifiRadio_Role_t role
+        ///< [IN]
+        ///< Role.
+)
+{
+    LE_ASSERT(role < PA_WIFIRADIO_ROLE_COUNT);
+
+    if (Roles[role].isStarted)
+    {
+        return Roles[role].ifName;
+    }
+    return ((PA_WIFIRADIO_ROLE_AP == role) && IsConcurrent) ? GetApVirtualInterface() :
+                                                              GetWlanInterface();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether another role is started, so that the hardware stays started when the role stops.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_wifiRadio_IsShared
+(
+    pa_wifiRadio_Role_t role
+        ///< [IN]
+        ///< Role.
+)
+{
+    LE_ASSERT(role < PA_WIFIRADIO_ROLE_COUNT);
+
+    return (StartedCount - (Roles[role].isStarted ? 1 : 0)) > 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a role. The hardware and the event thread are started if no other role is started. For
+ * the access point in concurrent mode, its virtual interface is created.
+ *
+ * @return
+ *      - LE_OK             The role is started.
+ *      - LE_NOT_FOUND      The WiFi card is absent.
+ *      - LE_UNAVAILABLE    The WiFi card may not work.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_Start
+(
+    pa_wifiRadio_Role_t role,
+        ///< [IN]
+        ///< Role.
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc
+        ///< [IN]
+        ///< Handler of the event lines of the role.
+)
+{
+    Role_t     *rolePtr;
+    const char *ifNamePtr;
+    le_result_t result;
+
+    LE_ASSERT(role < PA_WIFIRADIO_ROLE_COUNT);
+    rolePtr = &Roles[role];
+
+    if (rolePtr->isStarted)
+    {
+        LE_DEBUG("Role %d already started", role);
+        return LE_OK;
+    }
+
+    ifNamePtr = pa_wifiRadio_GetInterface(role);
+
+    if (0 == StartedCount)
+    {
+        result = StartHardware();
+        if (LE_OK != result)
+        {
+            return result;
+        }
+    }
+    else
+    {
+        LE_INFO("WiFi hardware already started, shared by %d role(s)", StartedCount);
+    }
+
+    if (0 != strcmp(ifNamePtr, GetWlanInterface()))
+    {
+        if (LE_OK != AddVirtualInterface(rolePtr, ifNamePtr))
+        {
+            if (0 == StartedCount)
+            {
+                StopHardware();
+            }
+            return LE_FAULT;
+        }
+    }
+
+    le_mutex_Lock(RoleMutex);
+    le_utf8_Copy(rolePtr->ifName, ifNamePtr, sizeof(rolePtr->ifName), NULL);
+    rolePtr->handlerFunc = handlerFunc;
+    rolePtr->isStarted = true;
+    le_mutex_Unlock(RoleMutex);
+    StartedCount++;
+
+    LE_INFO("Role %d started on %s", role, rolePtr->ifName);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop a role. Its virtual interface, if any, is deleted. The hardware and the event thread are
+ * stopped if no other role is started.
+ *
+ * @return
+ *      - LE_OK             The role is stopped.
+ *      - LE_FAULT          The hardware could not be stopped, the role stays started with its
+ *                          interface.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_Stop
+(
+    pa_wifiRadio_Role_t role
+        ///< [IN]
+        ///< Role.
+)
+{
+    Role_t *rolePtr;
+    bool    wasVirtual;
+
+    LE_ASSERT(role < PA_WIFIRADIO_ROLE_COUNT);
+    rolePtr = &Roles[role];
+
+    if (!rolePtr->isStarted)
+    {
+        LE_DEBUG("Role %d not started", role);
+        return LE_OK;
+    }
+
+    // The virtual interface is deleted before the driver is unloaded.
+    wasVirtual = rolePtr->isVirtual;
+    if (wasVirtual)
+    {
+        if (LE_FAULT == pa_wifiNl80211_DelInterface(rolePtr->ifName))
+        {
+            LE_WARN("Unable to delete interface %s", rolePtr->ifName);
+        }
+        rolePtr->isVirtual = false;
+    }
+
+    if ((1 == StartedCount) && (LE_OK != StopHardware()))
+    {
+        // The role stays started: it gets its interface back.
+        if (wasVirtual && (LE_OK != AddVirtualInterface(rolePtr, rolePtr->ifName)))
+        {
+            LE_ERROR("Unable to restore interface %s", rolePtr->ifName);
+        }
+        return LE_FAULT;
+    }
+
+    le_mutex_Lock(RoleMutex);
+    rolePtr->handlerFunc = NULL;
+    rolePtr->isStarted = false;
+    le_mutex_Unlock(RoleMutex);
+    StartedCount--;
+
+    LE_INFO("Role %d stopped, %d role(s) left", role, StartedCount);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel the interface of a role operates on, ex: the channel of the access point the
+ * client is associated with.
+ *
+ * @return
+ *      - LE_OK             The channel is returned.
+ *      - LE_UNAVAILABLE    The interface does not operate on any channel.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRadio_GetChannel
+(
+    pa_wifiRadio_Role_t role,
+        ///< [IN]
+        ///< Role.
+    uint16_t *channelPtr,
+        ///< [OUT]
+        ///< Channel number.
+    bool *is5GHzPtr
+        ///< [OUT]
+        ///< true if the channel is a 5 GHz one.
+)
+{
+    uint32_t    frequency;
+    le_result_t result = pa_wifiNl80211_GetFrequency(pa_wifiRadio_GetInterface(role), &frequency);
+
+    if (LE_NOT_FOUND == result)
+    {
+        return LE_UNAVAILABLE;
+    }
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    // IEEE 802.11 channel numbering: 2.4 GHz from 2407 MHz, channel 14 apart, 5 GHz from 5000 MHz.
+    if (2484 == frequency)
+    {
+        *channelPtr = 14;
+        *is5GHzPtr = false;
+    }
+    else if ((frequency >= 2412) && (frequency <= 2472))
+    {
+        *channelPtr = (uint16_t)((frequency - 2407) / 5);
+        *is5GHzPtr = false;
+    }
+    else if ((frequency >= 5000) && (frequency <= 5900))
+    {
+        *channelPtr = (uint16_t)((frequency - 5000) / 5);
+        *is5GHzPtr = true;
+    }
+    else
+    {
+        LE_WARN("Unsupported frequency %u MHz", frequency);
+        return LE_UNAVAILABLE;
+    }
+    return LE_OK;
+}
@@ -0,0 +1,325 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter single-producer/single-consumer ring
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_ring.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Padding used to keep the producer and consumer indexes on separate cache lines.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_LINE_BYTES    64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay between two attempts of pa_wifiRing_PushWait() when the ring is full, in ns.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_WAIT_NS        1000000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a ring name.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_NAME_BYTES     32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring.
+ *
+ * head and tail are free-running counters: the slot index is the counter masked by the capacity
+ * and head - tail is the number of queued elements.
+ */
+//--------------------------------------------------------------------------------------------------
+struct pa_wifiRing
+{
+    // Set at creation.
+    char                       name[RING_NAME_BYTES];  ///< Ring name.
+    size_t                     elemSize;               ///< Element size.
+    size_t                     slotSize;               ///< Slot size, element size aligned.
+    uint32_t                   capacity;               ///< Number of slots, power of 2.
+    int                        eventFd;                ///< Consumer wake-up.
+    le_fdMonitor_Ref_t         fdMonitorRef;           ///< Monitor of eventFd.
+    pa_wifiRing_ConsumerFunc_t consumerFunc;           ///< Element handler.
+    void                      *contextPtr;             ///< Element handler context.
+    uint8_t                    padding1[CACHE_LINE_BYTES];
+
+    // Written by the producer.
+    uint32_t                   head;                   ///< Count of pushed elements.
+    uint32_t                   maxDepth;               ///< Highest depth.
+    uint32_t                   dropCount;              ///< Count of dropped elements.
+    uint8_t                    padding2[CACHE_LINE_BYTES];
+
+    // Written by the consumer.
+    uint32_t                   tail;                   ///< Count of popped elements.
+    bool                       isWaiting;              ///< Consumer drained the ring, cleared by
+                                                       ///< the producer when it wakes it up.
+    uint8_t                    padding3[CACHE_LINE_BYTES];
+
+    uint8_t                    slots[];                ///< capacity * slotSize bytes.
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wake the consumer up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WakeConsumer
+(
+    pa_wifiRing_Ref_t ringRef
+)
+{
+    uint64_t value = 1;
+
+    if (write(ringRef->eventFd, &value, sizeof(value)) < 0)
+    {
+        LE_ERROR("Ring %s: wake-up failed (%m)", ringRef->name);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an element into the ring if a slot is free.
+ *
+ * @return true if the element is queued.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool TryPush
+(
+    pa_wifiRing_Ref_t ringRef,
+    const void *elemPtr
+)
+{
+    uint32_t head  = __atomic_load_n(&ringRef->head, __ATOMIC_RELAXED);
+    uint32_t tail  = __atomic_load_n(&ringRef->tail, __ATOMIC_ACQUIRE);
+    uint32_t depth = head - tail;
+
+    if (depth >= ringRef->capacity)
+    {
+        return false;
+    }
+
+    memcpy(&ringRef->slots[(head & (ringRef->capacity - 1)) * ringRef->slotSize],
+           elemPtr,
+           ringRef->elemSize);
+
+    // Sequentially consistent with the isWaiting accesses: either the consumer sees the new head
+    // when it checks the ring before sleeping, or this thread sees isWaiting set and wakes it up.
+    __atomic_store_n(&ringRef->head, head + 1, __ATOMIC_SEQ_CST);
+
+    if ((depth + 1) > ringRef->maxDepth)
+    {
+        __atomic_store_n(&ringRef->maxDepth, depth + 1, __ATOMIC_RELAXED);
+    }
+
+    if (__atomic_exchange_n(&ringRef->isWaiting, false, __ATOMIC_SEQ_CST))
+    {
+        WakeConsumer(ringRef);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Consumer side: pop the queued elements when the eventfd is signaled.
+ *
+ * At most one ring worth of elements is handled per call, so that a busy producer does not starve
+ * the other event sources of the consumer thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingFdHandler
+(
+    int fd,
+    short events
+)
+{
+    pa_wifiRing_Ref_t ringRef = le_fdMonitor_GetContextPtr();
+    uint32_t          tail    = ringRef->tail;
+    uint32_t          count   = 0;
+    uint64_t          value;
+
+    if ((read(fd, &value, sizeof(value)) < 0) && (EAGAIN != errno))
+    {
+        LE_ERROR("Ring %s: read failed (%m)", ringRef->name);
+    }
+
+    for (;;)
+    {
+        uint32_t head = __atomic_load_n(&ringRef->head, __ATOMIC_ACQUIRE);
+
+        while (tail != head)
+        {
+            if (count++ >= ringRef->capacity)
+            {
+                // Yield to the event loop and come back later.
+                WakeConsumer(ringRef);
+                return;
+            }
+
+            ringRef->consumerFunc(&ringRef->slots[(tail & (ringRef->capacity - 1)) *
+                                                  ringRef->slotSize],
+                                  ringRef->contextPtr);
+            tail++;
+            __atomic_store_n(&ringRef->tail, tail, __ATOMIC_RELEASE);
+        }
+
+        // Ring drained: ask the producer for a wake-up, then check nothing was pushed meanwhile.
+        __atomic_store_n(&ringRef->isWaiting, true, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ringRef->head, __ATOMIC_SEQ_CST) == tail)
+        {
+            return;
+        }
+        __atomic_store_n(&ringRef->isWaiting, false, __ATOMIC_SEQ_CST);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a ring. Must be called by the consumer thread, which must run an event loop.
+ *
+ * @return Ring reference. Failures are fatal.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_wifiRing_Ref_t pa_wifiRing_Create
+(
+    const char *namePtr,
+        ///< [IN]
+        ///< Ring name, for traces.
+    size_t elemSize,
+        ///< [IN]
+        ///< Size of an element in bytes.
+    uint32_t capacity,
+        ///< [IN]
+        ///< Number of slots, rounded up to a power of 2.
+    pa_wifiRing_ConsumerFunc_t consumerFunc,
+        ///< [IN]
+        ///< Handler called for each element.
+    void *contextPtr
+        ///< [IN]
+        ///< Handler context.
+)
+{
+    pa_wifiRing_Ref_t ringRef;
+    size_t            slotSize  = (elemSize + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    uint32_t          slotCount = 1;
+
+    LE_ASSERT((NULL != consumerFunc) && (elemSize > 0) && (capacity > 0));
+
+    while (slotCount < capacity)
+    {
+        slotCount <<= 1;
+    }
+
+    ringRef = calloc(1, sizeof(struct pa_wifiRing) + (slotCount * slotSize));
+    LE_ASSERT(NULL != ringRef);
+
+    le_utf8_Copy(ringRef->name, namePtr, sizeof(ringRef->name), NULL);
+    ringRef->elemSize     = elemSize;
+    ringRef->slotSize     = slotSize;
+    ringRef->capacity     = slotCount;
+    ringRef->consumerFunc = consumerFunc;
+    ringRef->contextPtr   = contextPtr;
+    // The consumer starts idle.
+    ringRef->isWaiting    = true;
+
+    ringRef->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    LE_FATAL_IF(ringRef->eventFd < 0, "Ring %s: eventfd failed (%m)", ringRef->name);
+
+    ringRef->fdMonitorRef = le_fdMonitor_Create(ringRef->name, ringRef->eventFd, RingFdHandler,
+                                                POLLIN);
+    le_fdMonitor_SetContextPtr(ringRef->fdMonitorRef, ringRef);
+
+    LE_DEBUG("Ring %s: %u slots of %zu bytes", ringRef->name, slotCount, slotSize);
+
+    return ringRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an element into the ring. Must only be called by the producer thread.
+ *
+ * @return
+ *      - LE_OK             The element is queued.
+ *      - LE_OVERFLOW       The ring is full, the element is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiRing_Push
+(
+    pa_wifiRing_Ref_t ringRef,
+        ///< [IN]
+        ///< Ring reference.
+    const void *elemPtr
+        ///< [IN]
+        ///< Element to copy.
+)
+{
+    if (!TryPush(ringRef, elemPtr))
+    {
+        __atomic_add_fetch(&ringRef->dropCount, 1, __ATOMIC_RELAXED);
+        return LE_OVERFLOW;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an element into the ring, waiting for a free slot if the ring is full. Must only be called
+ * by the producer thread, for elements which must not be lost.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiRing_PushWait
+(
+    pa_wifiRing_Ref_t ringRef,
+        ///< [IN]
+        ///< Ring reference.
+    const void *elemPtr
+        ///< [IN]
+        ///< Element to copy.
+)
+{
+    struct timespec delay = { 0, PUSH_WAIT_NS };
+
+    while (!TryPush(ringRef, elemPtr))
+    {
+        nanosleep(&delay, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the ring statistics. Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiRing_GetStats
+(
+    pa_wifiRing_Ref_t ringRef,
+        ///< [IN]
+        ///< Ring reference.
+    pa_wifiRing_Stats_t *statsPtr
+        ///< [OUT]
+        ///< Ring statistics.
+)
+{
+    uint32_t tail = __atomic_load_n(&ringRef->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&ringRef->head, __ATOMIC_ACQUIRE);
+
+    statsPtr->capacity  = ringRef->capacity;
+    statsPtr->depth     = head - tail;
+    statsPtr->maxDepth  = __atomic_load_n(&ringRef->maxDepth, __ATOMIC_RELAXED);
+    statsPtr->dropCount = __atomic_load_n(&ringRef->dropCount, __ATOMIC_RELAXED);
+}
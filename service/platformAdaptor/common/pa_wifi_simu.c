@@ -0,0 +1,617 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter station churn generator
+ *
+ *  The generator thread draws the time of the next event from the total rate of the associations
+ *  and of the departures, then whether it is an association or a departure, in proportion of their
+ *  rates. The bursts are scheduled apart: the exponential distribution has no memory, so the next
+ *  event is drawn again after a burst.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <time.h>
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include "pa_wifi_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Longest sleep of the generator thread, so that it sees a stop request in time, in us.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STOP_POLL_US            100000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay between two checks of the room in the event ring, in us.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_POLL_US            1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Natural logarithm of 2, for NaturalLog().
+ */
+//--------------------------------------------------------------------------------------------------
+#define LN2                     0.69314718055994530942
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Burst mode.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    BURST_NONE,     ///< No burst.
+    BURST_JOIN,     ///< Bursts of associations.
+    BURST_LEAVE,    ///< Bursts of departures.
+    BURST_MIXED     ///< Bursts of associations and of departures in turn.
+}
+BurstMode_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulated station.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];   ///< Random MAC address.
+    bool isAssociated;                              ///< Station associated.
+}
+Station_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generator state, only used by the generator thread once started.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                            ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];   ///< AP interface.
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc;        ///< Event line handler.
+    pa_wifiRing_Ref_t               ringRef;            ///< Ring of the handler.
+    uint32_t                        stationCount;       ///< Number of stations of the pool.
+    uint32_t                        associatedCount;    ///< Number of associated stations.
+    double                          arrivalRate;        ///< Associations per us.
+    double                          departureRate;      ///< Departures per us and station.
+    BurstMode_t                     burstMode;          ///< Burst mode.
+    uint32_t                        burstSize;          ///< Stations of a burst.
+    uint64_t                        burstIntervalUs;    ///< Time between two bursts.
+    unsigned int                    seed;               ///< Random generator state.
+    uint64_t                        eventCount;         ///< Events generated.
+    Station_t                       stations[PA_WIFISIMU_MAX_STATIONS];
+}
+Simu_t;
+
+static Simu_t Simu;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generator thread, and the stop request it polls.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t SimuThread = NULL;
+static bool            IsStopRequested = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time in us.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeUs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000000) + (uint64_t)now.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Natural logarithm of a number in ]0, 1], without depending on the math library.
+ *
+ * The number is scaled into [0.5, 1] by powers of 2, then ln(x) = 2 atanh((x - 1) / (x + 1)),
+ * whose series converges in a few terms there.
+ */
+//--------------------------------------------------------------------------------------------------
+static double NaturalLog
+(
+    double x
+)
+{
+    double z;
+    double z2;
+    double term;
+    double sum = 0;
+    int    exponent = 0;
+    int    n;
+
+    while (x < 0.5)
+    {
+        x *= 2;
+        exponent--;
+    }
+
+    z = (x - 1) / (x + 1);
+    z2 = z * z;
+    term = z;
+    for (n = 1; n < 32; n += 2)
+    {
+        sum += term / n;
+        term *= z2;
+    }
+    return (2 * sum) + (exponent * LN2);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Draw a uniform random number in ]0, 1].
+ */
+//--------------------------------------------------------------------------------------------------
+static double Uniform
+(
+    void
+)
+{
+    return ((double)rand_r(&Simu.seed) + 1.0) / ((double)RAND_MAX + 1.0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Draw a random locally administered unicast MAC address.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RandomMacAddress
+(
+    char *macAddressPtr
+)
+{
+    uint8_t mac[6];
+    size_t  i;
+
+    for (i = 0; i < sizeof(mac); i++)
+    {
+        mac[i] = (uint8_t)(rand_r(&Simu.seed) >> 7);
+    }
+    mac[0] = (mac[0] & 0xFC) | 0x02;
+
+    snprintf(macAddressPtr, LE_WIFIDEFS_MAX_BSSID_BYTES, "%02x:%02x:%02x:%02x:%02x:%02x",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Associate or disassociate a station, and pass the iw event line to the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetAssociated
+(
+    Station_t *stationPtr,
+    bool isAssociated
+)
+{
+    char line[128];
+
+    stationPtr->isAssociated = isAssociated;
+    if (isAssociated)
+    {
+        Simu.associatedCount++;
+    }
+    else
+    {
+        Simu.associatedCount--;
+    }
+    Simu.eventCount++;
+
+    // Same format as iw event.
+    snprintf(line, sizeof(line), "%s: %s station %s\n", Simu.ifName,
+             isAssociated ? "new" : "del", stationPtr->macAddress);
+    Simu.handlerFunc(line, le_clk_GetRelativeTime());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pick a random station of the pool, associated or not. There must be one.
+ */
+//--------------------------------------------------------------------------------------------------
+static Station_t *PickStation
+(
+    bool isAssociated
+)
+{
+    uint32_t count = isAssociated ? Simu.associatedCount :
+                                    (Simu.stationCount - Simu.associatedCount);
+    uint32_t rank = (uint32_t)rand_r(&Simu.seed) % count;
+    uint32_t i;
+
+    for (i = 0; i < Simu.stationCount; i++)
+    {
+        if ((Simu.stations[i].isAssociated == isAssociated) && (0 == rank--))
+        {
+            return &Simu.stations[i];
+        }
+    }
+
+    LE_FATAL("No %s station", isAssociated ? "associated" : "free");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sleep until a time, unless a stop is requested.
+ *
+ * @return false if a stop is requested.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SleepUntil
+(
+    uint64_t timeUs
+)
+{
+    for (;;)
+    {
+        uint64_t nowUs = GetTimeUs();
+        uint64_t waitUs;
+
+        if (__atomic_load_n(&IsStopRequested, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+        if (nowUs >= timeUs)
+        {
+            return true;
+        }
+
+        waitUs = timeUs - nowUs;
+        if (waitUs > STOP_POLL_US)
+        {
+            waitUs = STOP_POLL_US;
+        }
+        usleep((useconds_t)waitUs);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait until the event ring has room for one more event, and still for the departures of all the
+ * stations: at stop, they are queued while the main thread waits for the generator thread, so
+ * the ring is not drained. A burst larger than the ring is thus paced by the main thread.
+ *
+ * @return false if a stop is requested.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WaitRingRoom
+(
+    void
+)
+{
+    pa_wifiRing_Stats_t stats;
+
+    for (;;)
+    {
+        if (__atomic_load_n(&IsStopRequested, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+
+        pa_wifiRing_GetStats(Simu.ringRef, &stats);
+        if ((stats.depth + Simu.stationCount) < stats.capacity)
+        {
+            return true;
+        }
+        usleep(RING_POLL_US);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Associate or disassociate up to a burst of stations at once.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunBurst
+(
+    bool isJoin
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < Simu.burstSize; i++)
+    {
+        if (isJoin ? (Simu.associatedCount == Simu.stationCount) : (0 == Simu.associatedCount))
+        {
+            break;
+        }
+        if (!WaitRingRoom())
+        {
+            break;
+        }
+        SetAssociated(PickStation(!isJoin), isJoin);
+    }
+    LE_DEBUG("Burst: %u stations %s", i, isJoin ? "joined" : "left");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generator thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *SimuThreadMain
+(
+    void *contextPtr
+)
+{
+    uint64_t nextBurstUs = GetTimeUs() + Simu.burstIntervalUs;
+    bool     isJoinBurst = (BURST_LEAVE != Simu.burstMode);
+    bool     isArrival;
+    uint32_t i;
+
+    for (;;)
+    {
+        double   arrivalRate = (Simu.associatedCount < Simu.stationCount) ? Simu.arrivalRate : 0;
+        double   totalRate = arrivalRate + (Simu.associatedCount * Simu.departureRate);
+        uint64_t eventUs = UINT64_MAX;
+
+        if (totalRate > 0)
+        {
+            eventUs = GetTimeUs() + (uint64_t)(-NaturalLog(Uniform()) / totalRate);
+        }
+
+        if ((BURST_NONE != Simu.burstMode) && (nextBurstUs <= eventUs))
+        {
+            if (!SleepUntil(nextBurstUs))
+            {
+                break;
+            }
+            RunBurst(isJoinBurst);
+            if (BURST_MIXED == Simu.burstMode)
+            {
+                isJoinBurst = !isJoinBurst;
+            }
+            nextBurstUs += Simu.burstIntervalUs;
+            continue;
+        }
+
+        if (!SleepUntil(eventUs))
+        {
+            break;
+        }
+        if (!WaitRingRoom())
+        {
+            break;
+        }
+        isArrival = ((Uniform() * totalRate) <= arrivalRate);
+        SetAssociated(PickStation(!isArrival), isArrival);
+    }
+
+    // hostapd disconnects the stations when it terminates.
+    for (i = 0; i < Simu.stationCount; i++)
+    {
+        if (Simu.stations[i].isAssociated)
+        {
+            SetAssociated(&Simu.stations[i], false);
+        }
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an unsigned integer environment variable.
+ *
+ * @return LE_BAD_PARAMETER if the variable is set but invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetEnvUint
+(
+    const char *namePtr,
+    uint32_t minValue,
+    uint32_t maxValue,
+    uint32_t *valuePtr
+)
+{
+    const char   *strPtr = getenv(namePtr);
+    char         *endPtr;
+    unsigned long value;
+
+    if (NULL == strPtr)
+    {
+        return LE_OK;
+    }
+
+    errno = 0;
+    value = strtoul(strPtr, &endPtr, 10);
+    if ((0 != errno) || ('\0' == *strPtr) || ('\0' != *endPtr) ||
+        (value < minValue) || (value > maxValue))
+    {
+        LE_ERROR("Invalid %s: %s, expected %u to %u", namePtr, strPtr, minValue, maxValue);
+        return LE_BAD_PARAMETER;
+    }
+    *valuePtr = (uint32_t)value;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a rate per minute environment variable, and convert it to a rate per us.
+ *
+ * @return LE_BAD_PARAMETER if the variable is set but invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetEnvRate
+(
+    const char *namePtr,
+    double *ratePtr
+)
+{
+    const char *strPtr = getenv(namePtr);
+    char       *endPtr;
+    double      perMinute;
+
+    if (NULL == strPtr)
+    {
+        return LE_OK;
+    }
+
+    errno = 0;
+    perMinute = strtod(strPtr, &endPtr);
+    if ((0 != errno) || ('\0' == *strPtr) || ('\0' != *endPtr) || !(perMinute >= 0))
+    {
+        LE_ERROR("Invalid %s: %s, expected a rate per minute", namePtr, strPtr);
+        return LE_BAD_PARAMETER;
+    }
+    *ratePtr = perMinute / 60e6;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the configuration of the generator from the environment.
+ *
+ * @return LE_BAD_PARAMETER if a variable is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadConfig
+(
+    void
+)
+{
+    static const char *burstNames[] = { "none", "join", "leave", "mixed" };
+    const char        *burstPtr = getenv("WIFI_SIMU_BURST");
+    uint32_t           burstIntervalSec = 60;
+    uint32_t           seed = (uint32_t)GetTimeUs();
+
+    Simu.stationCount = 5;
+    Simu.arrivalRate = 6 / 60e6;
+    Simu.departureRate = 1 / 60e6;
+    Simu.burstMode = BURST_NONE;
+    Simu.burstSize = 10;
+
+    if ((LE_OK != GetEnvUint("WIFI_SIMU_STATIONS", 1, PA_WIFISIMU_MAX_STATIONS,
+                             &Simu.stationCount)) ||
+        (LE_OK != GetEnvRate("WIFI_SIMU_ARRIVAL_RATE", &Simu.arrivalRate)) ||
+        (LE_OK != GetEnvRate("WIFI_SIMU_DEPARTURE_RATE", &Simu.departureRate)) ||
+        (LE_OK != GetEnvUint("WIFI_SIMU_BURST_SIZE", 1, PA_WIFISIMU_MAX_STATIONS,
+                             &Simu.burstSize)) ||
+        (LE_OK != GetEnvUint("WIFI_SIMU_BURST_INTERVAL", 1, 86400, &burstIntervalSec)) ||
+        (LE_OK != GetEnvUint("WIFI_SIMU_SEED", 0, UINT32_MAX, &seed)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (NULL != burstPtr)
+    {
+        size_t i;
+
+        for (i = 0; i < NUM_ARRAY_MEMBERS(burstNames); i++)
+        {
+            if (0 == strcmp(burstPtr, burstNames[i]))
+            {
+                break;
+            }
+        }
+        if (NUM_ARRAY_MEMBERS(burstNames) == i)
+        {
+            LE_ERROR("Invalid WIFI_SIMU_BURST: %s, expected none, join, leave or mixed", burstPtr);
+            return LE_BAD_PARAMETER;
+        }
+        Simu.burstMode = (BurstMode_t)i;
+    }
+
+    Simu.burstIntervalUs = (uint64_t)burstIntervalSec * 1000000;
+    Simu.seed = seed;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the generator. The stations associate with the given interface.
+ *
+ * @return
+ *      - LE_OK             The generator is started.
+ *      - LE_BUSY           The generator is already started.
+ *      - LE_BAD_PARAMETER  Invalid environment variable.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiSimu_Start
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc,
+        ///< [IN]
+        ///< Handler of the event lines, called by the generator thread.
+    pa_wifiRing_Ref_t ringRef
+        ///< [IN]
+        ///< Ring the handler queues the events into.
+)
+{
+    pa_wifiRing_Stats_t stats;
+    uint32_t            i;
+
+    if (NULL != SimuThread)
+    {
+        return LE_BUSY;
+    }
+
+    memset(&Simu, 0, sizeof(Simu));
+    if (LE_OK != ReadConfig())
+    {
+        return LE_BAD_PARAMETER;
+    }
+    pa_wifiRing_GetStats(ringRef, &stats);
+    if (stats.capacity <= Simu.stationCount)
+    {
+        LE_ERROR("Event ring of %u events too small for %u stations",
+                 stats.capacity, Simu.stationCount);
+        return LE_BAD_PARAMETER;
+    }
+    le_utf8_Copy(Simu.ifName, ifNamePtr, sizeof(Simu.ifName), NULL);
+    Simu.handlerFunc = handlerFunc;
+    Simu.ringRef = ringRef;
+    for (i = 0; i < Simu.stationCount; i++)
+    {
+        RandomMacAddress(Simu.stations[i].macAddress);
+    }
+
+    LE_INFO("Simulation: %u stations, %.1f associations/min, %.2f departures/min/station, "
+            "burst %d of %u every %llu s",
+            Simu.stationCount, Simu.arrivalRate * 60e6, Simu.departureRate * 60e6,
+            Simu.burstMode, Simu.burstSize, (unsigned long long)(Simu.burstIntervalUs / 1000000));
+
+    __atomic_store_n(&IsStopRequested, false, __ATOMIC_RELEASE);
+    SimuThread = le_thread_Create("WifiSimuThread", SimuThreadMain, NULL);
+    le_thread_SetJoinable(SimuThread);
+    le_thread_Start(SimuThread);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the generator. The associated stations leave first, as when hostapd terminates.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiSimu_Stop
+(
+    void
+)
+{
+    if (NULL == SimuThread)
+    {
+        return;
+    }
+
+    __atomic_store_n(&IsStopRequested, true, __ATOMIC_RELEASE);
+    if (LE_OK != le_thread_Join(SimuThread, NULL))
+    {
+        LE_ERROR("Unable to join the simulation thread");
+    }
+    SimuThread = NULL;
+    LE_INFO("Simulation stopped after %llu events", (unsigned long long)Simu.eventCount);
+}
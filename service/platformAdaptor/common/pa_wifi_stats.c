@@ -0,0 +1,367 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter command statistics
+ *
+ *  Histogram buckets: durations below 8 us have one bucket each. Above, each power of two
+ *  [2^n, 2^(n+1)) is split into 8 equal buckets, so a bucket is at most 12.5% wide relative to
+ *  its lower bound. 240 buckets cover durations up to 2^32 us (71 minutes).
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <sys/wait.h>
+
+#include "legato.h"
+
+#include "pa_wifi_stats.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Histogram geometry.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SUB_BUCKET_BITS     3
+#define SUB_BUCKET_COUNT    (1 << SUB_BUCKET_BITS)
+#define BUCKET_COUNT        (SUB_BUCKET_COUNT + ((32 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of distinct commands.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMAND_MAX_COUNT   32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Recorded data of one command.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     name[PA_WIFISTATS_NAME_MAX_BYTES];                 ///< Command name.
+    uint32_t count;                                             ///< Number of runs.
+    uint64_t maxUs;                                             ///< Maximum duration (us).
+    uint32_t buckets[BUCKET_COUNT];                             ///< Duration histogram.
+    uint32_t exitCodeCount;                                     ///< Number of distinct statuses.
+    int32_t  exitCodes[PA_WIFISTATS_EXIT_CODE_MAX_COUNT];       ///< Exit statuses.
+    uint32_t exitCounts[PA_WIFISTATS_EXIT_CODE_MAX_COUNT];      ///< Runs per exit status.
+}
+CommandStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the statistics, recorded by the main thread and the PA threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t StatsMutex = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the commands, in the order of their first run.
+ */
+//--------------------------------------------------------------------------------------------------
+static CommandStats_t CommandStats[COMMAND_MAX_COUNT];
+static uint32_t       CommandCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the histogram bucket of a duration.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetBucket
+(
+    uint64_t valueUs
+)
+{
+    uint32_t msb;
+
+    if (valueUs < SUB_BUCKET_COUNT)
+    {
+        return (uint32_t)valueUs;
+    }
+    if (valueUs > UINT32_MAX)
+    {
+        return BUCKET_COUNT - 1;
+    }
+
+    msb = 31 - __builtin_clz((uint32_t)valueUs);
+    return SUB_BUCKET_COUNT + ((msb - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT) +
+           (((uint32_t)valueUs >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the highest duration of a histogram bucket.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetBucketMax
+(
+    uint32_t bucket
+)
+{
+    uint32_t shift;
+    uint64_t lowest;
+
+    if (bucket < SUB_BUCKET_COUNT)
+    {
+        return bucket;
+    }
+
+    shift  = (bucket - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+    lowest = (uint64_t)(SUB_BUCKET_COUNT + ((bucket - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT))
+             << shift;
+    return lowest + (1ULL << shift) - 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a percentile of a command duration, at the resolution of the histogram.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetPercentile
+(
+    const CommandStats_t *statsPtr,
+    uint32_t percent
+)
+{
+    uint64_t target = (((uint64_t)statsPtr->count * percent) + 99) / 100;
+    uint64_t total = 0;
+
+    if (0 == target)
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        total += statsPtr->buckets[i];
+        if (total >= target)
+        {
+            uint64_t valueUs = GetBucketMax(i);
+
+            return (valueUs < statsPtr->maxUs) ? valueUs : statsPtr->maxUs;
+        }
+    }
+    return statsPtr->maxUs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the exit status recorded for a command status in the format of system().
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t GetExitCode
+(
+    int status
+)
+{
+    if (-1 == status)
+    {
+        return PA_WIFISTATS_EXIT_NOT_RUN;
+    }
+    if (WIFSIGNALED(status))
+    {
+        return PA_WIFISTATS_EXIT_SIGNALED + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the command statistics. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiStats_Init
+(
+    void
+)
+{
+    if (NULL == StatsMutex)
+    {
+        StatsMutex = le_mutex_CreateNonRecursive("WifiPaStats");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a run with its exit status.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordExitCode
+(
+    const char *commandPtr,
+    le_clk_Time_t startTime,
+    int32_t exitCode
+)
+{
+    le_clk_Time_t   duration = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    uint64_t        durationUs = ((uint64_t)duration.sec * 1000000) + duration.usec;
+    size_t          nameLength = strcspn(commandPtr, " ");
+    CommandStats_t *statsPtr = NULL;
+    uint32_t        i;
+
+    if (nameLength >= PA_WIFISTATS_NAME_MAX_BYTES)
+    {
+        nameLength = PA_WIFISTATS_NAME_MAX_BYTES - 1;
+    }
+
+    le_mutex_Lock(StatsMutex);
+
+    for (i = 0; i < CommandCount; i++)
+    {
+        if ((0 == strncmp(CommandStats[i].name, commandPtr, nameLength)) &&
+            ('\0' == CommandStats[i].name[nameLength]))
+        {
+            statsPtr = &CommandStats[i];
+            break;
+        }
+    }
+
+    if ((NULL == statsPtr) && (CommandCount < COMMAND_MAX_COUNT))
+    {
+        statsPtr = &CommandStats[CommandCount++];
+        memset(statsPtr, 0, sizeof(CommandStats_t));
+        memcpy(statsPtr->name, commandPtr, nameLength);
+    }
+
+    if (NULL != statsPtr)
+    {
+        statsPtr->count++;
+        statsPtr->buckets[GetBucket(durationUs)]++;
+        if (durationUs > statsPtr->maxUs)
+        {
+            statsPtr->maxUs = durationUs;
+        }
+
+        for (i = 0; i < statsPtr->exitCodeCount; i++)
+        {
+            if (statsPtr->exitCodes[i] == exitCode)
+            {
+                break;
+            }
+        }
+        if (i == statsPtr->exitCodeCount)
+        {
+            if (i < PA_WIFISTATS_EXIT_CODE_MAX_COUNT)
+            {
+                statsPtr->exitCodes[statsPtr->exitCodeCount++] = exitCode;
+            }
+            else
+            {
+                // The last entry gathers the statuses which do not fit.
+                i = PA_WIFISTATS_EXIT_CODE_MAX_COUNT - 1;
+                statsPtr->exitCodes[i] = PA_WIFISTATS_EXIT_OTHER;
+            }
+        }
+        statsPtr->exitCounts[i]++;
+    }
+
+    le_mutex_Unlock(StatsMutex);
+
+    LE_DEBUG("Command \"%s\" took %" PRIu64 " us, exit code %d", commandPtr, durationUs,
+             (int)exitCode);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a command run. Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiStats_Record
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command, only its first word is used as name.
+    le_clk_Time_t startTime,
+        ///< [IN]
+        ///< Time the command was started (le_clk_GetRelativeTime()).
+    int status
+        ///< [IN]
+        ///< Command status in the format of system().
+)
+{
+    RecordExitCode(commandPtr, startTime, GetExitCode(status));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the run of an operation done in the PA, instead of a command. A successful operation is
+ * recorded with the exit status 0, a failed one with PA_WIFISTATS_EXIT_FAILED. Can be called from
+ * any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiStats_RecordResult
+(
+    const char *namePtr,
+        ///< [IN]
+        ///< Operation name, only its first word is used.
+    le_clk_Time_t startTime,
+        ///< [IN]
+        ///< Time the operation was started (le_clk_GetRelativeTime()).
+    le_result_t result
+        ///< [IN]
+        ///< Operation result.
+)
+{
+    RecordExitCode(namePtr, startTime, (LE_OK == result) ? 0 : PA_WIFISTATS_EXIT_FAILED);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a command. Can be called from any thread.
+ *
+ * @return
+ *      - LE_OK             The statistics are returned.
+ *      - LE_NOT_FOUND      No command at this index.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiStats_Get
+(
+    uint32_t index,
+        ///< [IN]
+        ///< Command index, from 0, in the order of the first run.
+    pa_wifiStats_Command_t *statsPtr
+        ///< [OUT]
+        ///< Command statistics.
+)
+{
+    const CommandStats_t *commandPtr;
+
+    le_mutex_Lock(StatsMutex);
+
+    if (index >= CommandCount)
+    {
+        le_mutex_Unlock(StatsMutex);
+        return LE_NOT_FOUND;
+    }
+
+    commandPtr = &CommandStats[index];
+    memcpy(statsPtr->name, commandPtr->name, sizeof(statsPtr->name));
+    statsPtr->count         = commandPtr->count;
+    statsPtr->p50Us         = GetPercentile(commandPtr, 50);
+    statsPtr->p90Us         = GetPercentile(commandPtr, 90);
+    statsPtr->p99Us         = GetPercentile(commandPtr, 99);
+    statsPtr->maxUs         = commandPtr->maxUs;
+    statsPtr->exitCodeCount = commandPtr->exitCodeCount;
+    memcpy(statsPtr->exitCodes, commandPtr->exitCodes, sizeof(statsPtr->exitCodes));
+    memcpy(statsPtr->exitCounts, commandPtr->exitCounts, sizeof(statsPtr->exitCounts));
+
+    le_mutex_Unlock(StatsMutex);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the statistics of all commands. Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiStats_Reset
+(
+    void
+)
+{
+    le_mutex_Lock(StatsMutex);
+    CommandCount = 0;
+    le_mutex_Unlock(StatsMutex);
+}
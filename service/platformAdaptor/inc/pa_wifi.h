@@ -41,6 +41,31 @@ typedef struct
     uint64_t tx;                                    ///< Tx of access point (bytes).
 } pa_wifiClient_AccessPoint_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timed event indication structure.
+ *
+ * Every le_wifiClient_EventInd_t reported through pa_wifiClient_AddEventIndHandler() is the first
+ * member of this envelope, so the pointer given to the handler can be cast back to
+ * pa_wifiClient_TimedEventInd_t to retrieve the timing information. The envelope is not allocated:
+ * the handler must copy what it keeps after the call.
+ *
+ * All times are monotonic (le_clk_GetRelativeTime()).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_wifiClient_EventInd_t indication;     ///< Public event indication. Must be first.
+    le_clk_Time_t            captureTime;    ///< Time the event source (line, message) was read.
+    le_clk_Time_t            reportTime;     ///< Time the PA reported the event.
+    le_clk_Time_t            dispatchTime;   ///< Time the service queued the event to the clients.
+    uint32_t                 seqNum;         ///< Per-interface sequence number, set by the service.
+    uint32_t                 droppedCount;   ///< Events dropped by the PA before this one.
+    uint32_t                 coalescedCount; ///< Events merged into this one, set by the service.
+    bool                     isLocal;        ///< Generated on the main thread, without the PA parse
+                                             ///< and queue hops.
+} pa_wifiClient_TimedEventInd_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event handler for PA WiFi access point changes.
@@ -102,7 +127,8 @@ typedef void (*pa_wifiClient_EventIndHandlerFunc_t)
 /**
  * Add handler function for PA EVENT 'le_wifiClient_EventInd_t'
  *
- * This event provides information on PA WiFi Client event changes.
+ * This event provides information on PA WiFi Client event changes. The handler is called on the
+ * main thread, the indication is only valid during the call.
  */
 //--------------------------------------------------------------------------------------------------
 LE_SHARED le_result_t pa_wifiClient_AddEventIndHandler
@@ -115,6 +141,25 @@ LE_SHARED le_result_t pa_wifiClient_AddEventIndHandler
         ///< Associated event context.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the occupancy of the queue carrying the event indications from the PA thread to the main
+ * thread.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiClient_GetEventQueueStats
+(
+    uint32_t *depthPtr,
+        ///< [OUT]
+        ///< Number of events currently queued.
+    uint32_t *maxDepthPtr,
+        ///< [OUT]
+        ///< Highest number of events queued since startup.
+    uint32_t *capacityPtr
+        ///< [OUT]
+        ///< Queue capacity.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the PA WiFi Module.
@@ -231,10 +276,13 @@ LE_SHARED le_result_t pa_wifiClient_GetLinkResult
 /**
  * This function connects a wifiClient.
  *
+ * The connection command runs in the background: the function returns once it is started. The
+ * connection is reported by a LE_WIFICLIENT_EVENT_CONNECTED event, a failure or a time out by a
+ * LE_WIFICLIENT_EVENT_DISCONNECTED event. Must be called from the main thread.
+ *
  * @return LE_FAULT             The function failed.
  * @return LE_BAD_PARAMETER     Invalid parameter.
- * @return LE_DUPLICATE         Duplicated request.
- * @return LE_TIMEOUT           Connection request time out.
+ * @return LE_DUPLICATE         A connection request is in progress.
  * @return LE_OK                The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
@@ -252,6 +300,9 @@ LE_SHARED le_result_t pa_wifiClient_Connect
 /**
  * This function disconnects a wifiClient.
  *
+ * A running connection request is cancelled and the disconnection command runs in the background.
+ * Must be called from the main thread.
+ *
  * @return LE_FAULT  The function failed.
  * @return LE_OK     The function succeeded.
  */
@@ -378,6 +429,10 @@ LE_SHARED le_result_t pa_wifiClient_ClearAllCredentials
 /**
  * Start WiFi Client PA
  *
+ * @note The hardware start runs synchronously: the caller is blocked while the driver loads and
+ * its interface appears, up to a few seconds. Its result is the reply of le_wifiClient_Start()
+ * and no event reports it, so it is not run with pa_wifiCmd_RunAsync().
+ *
  * @return LE_FAULT         The function failed.
  * @return LE_OK            The function succeeded.
  * @return LE_NOT_FOUND     The WiFi card is absent.
@@ -393,6 +448,9 @@ LE_SHARED le_result_t pa_wifiClient_Start
 /**
  * Stop WiFi Client PA
  *
+ * @note A running connection request is cancelled. wpa_supplicant is terminated and the hardware
+ * stopped synchronously, as their result is the reply of le_wifiClient_Stop().
+ *
  * @return LE_FAULT  The function failed.
  * @return LE_OK     The function succeeded.
  */
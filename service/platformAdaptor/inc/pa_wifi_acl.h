@@ -0,0 +1,184 @@
+#ifndef PA_WIFI_ACL_H
+#define PA_WIFI_ACL_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor MAC address access control.
+ *
+ * The access point keeps an accept list and a deny list of station MAC addresses, and a policy
+ * telling which one hostapd uses (macaddr_acl). The lists are written to the files given to
+ * hostapd by accept_mac_file and deny_mac_file, read when hostapd starts or reloads.
+ *
+ * All the functions must be called from the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+#include "interfaces.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of MAC addresses of a list.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIACL_MAX_MACS     64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * MAC address list.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFIACL_LIST_ACCEPT,     ///< Stations accepted, with PA_WIFIACL_POLICY_DENY_UNLESS_ACCEPTED.
+    PA_WIFIACL_LIST_DENY,       ///< Stations denied, with PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED.
+    PA_WIFIACL_LIST_COUNT
+}
+pa_wifiAcl_List_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Access control policy, the value of macaddr_acl in hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED = 0,     ///< Accept the stations not in the deny list.
+    PA_WIFIACL_POLICY_DENY_UNLESS_ACCEPTED = 1      ///< Deny the stations not in the accept list.
+}
+pa_wifiAcl_Policy_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the access control policy. Default is PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiAcl_SetPolicy
+(
+    pa_wifiAcl_Policy_t policy
+        ///< [IN]
+        ///< Access control policy.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the access control policy.
+ *
+ * @return The access control policy.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED pa_wifiAcl_Policy_t pa_wifiAcl_GetPolicy
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a MAC address to a list.
+ *
+ * @return
+ *      - LE_OK             The address is added.
+ *      - LE_DUPLICATE      The address is already in the list.
+ *      - LE_BAD_PARAMETER  Invalid list or MAC address.
+ *      - LE_NO_MEMORY      The list is full.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAcl_Add
+(
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a MAC address from a list.
+ *
+ * @return
+ *      - LE_OK             The address is removed.
+ *      - LE_NOT_FOUND      The address is not in the list.
+ *      - LE_BAD_PARAMETER  Invalid list or MAC address.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAcl_Remove
+(
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the MAC addresses of a list.
+ *
+ * @return
+ *      - LE_OK             The list is empty.
+ *      - LE_BAD_PARAMETER  Invalid list.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAcl_Clear
+(
+    pa_wifiAcl_List_t list
+        ///< [IN]
+        ///< MAC address list.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a station is allowed by the policy and the lists.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool pa_wifiAcl_IsAllowed
+(
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the access control is used: a list is not empty or the policy is not the default
+ * one.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool pa_wifiAcl_IsUsed
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of the file of a list, for hostapd.conf.
+ *
+ * @return The path.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED const char *pa_wifiAcl_GetFile
+(
+    pa_wifiAcl_List_t list
+        ///< [IN]
+        ///< MAC address list.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the files of the lists, unless unchanged.
+ *
+ * @return
+ *      - LE_OK             The files are up to date.
+ *      - LE_FAULT          A file can not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAcl_WriteFiles
+(
+    void
+);
+
+#endif // PA_WIFI_ACL_H
@@ -0,0 +1,89 @@
+#ifndef PA_WIFI_ACS_H
+#define PA_WIFI_ACS_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor automatic channel selection.
+ *
+ * Before the access point is started, the channels allowed for the band are scored from a scan
+ * and from the channel survey of the driver, and the least congested one is selected.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of scored channels.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIACS_MAX_CHANNELS     16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum duration of the scan of a channel selection, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIACS_SCAN_TIMEOUT_MS  10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Busy time of a channel which the driver does not give.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIACS_BUSY_UNKNOWN     0xFF
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Score of a channel. The lower the score, the less congested the channel:
+ *
+ *  score = 10 * bssCount + overlap + 4 * busyPercent
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t channel;       ///< Channel number.
+    uint16_t bssCount;      ///< Number of BSS on the channel.
+    uint32_t overlap;       ///< Signal-weighted overlap of the BSS on this and nearby channels.
+    uint8_t  busyPercent;   ///< Busy time (%), or PA_WIFIACS_BUSY_UNKNOWN.
+    uint32_t score;         ///< Channel score.
+}
+pa_wifiAcs_ChannelScore_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan, score the allowed channels and select the least congested one.
+ *
+ * @note The scan is synchronous: the caller, and its event loop, is blocked until the scan ends,
+ * at most PA_WIFIACS_SCAN_TIMEOUT_MS.
+ *
+ * @return
+ *      - LE_OK             A channel is selected.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The scan failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAcs_SelectChannel
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    bool is5GHz,
+        ///< [IN]
+        ///< Select a 5 GHz channel, else a 2.4 GHz one.
+    const char *countryCodePtr,
+        ///< [IN]
+        ///< ISO country code.
+    pa_wifiAcs_ChannelScore_t *scoresPtr,
+        ///< [OUT]
+        ///< Channel scores, PA_WIFIACS_MAX_CHANNELS entries.
+    size_t *scoreCountPtr,
+        ///< [OUT]
+        ///< Number of scored channels.
+    uint16_t *channelPtr
+        ///< [OUT]
+        ///< Selected channel.
+);
+
+#endif // PA_WIFI_ACS_H
@@ -10,6 +10,8 @@
 // -------------------------------------------------------------------------------------------------
 #include "legato.h"
 #include "interfaces.h"
+#include "pa_wifi_acs.h"
+#include "pa_wifi_acl.h"
 //--------------------------------------------------------------------------------------------------
 /**
  * Return value from WiFi platform adapter scripts code.
@@ -19,6 +21,82 @@
 //--------------------------------------------------------------------------------------------------
 #define PA_NOT_FOUND        50
 #define PA_NOT_POSSIBLE     100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of BSS of the access point, including the main BSS (index 0).
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIAP_MAX_BSS   4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings of an additional BSS.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t                      ssid[LE_WIFIDEFS_MAX_SSID_BYTES];      ///< SSID.
+    size_t                       ssidLength;                            ///< SSID length.
+    le_wifiAp_SecurityProtocol_t securityProtocol;                      ///< Security protocol.
+    char                         passphrase[LE_WIFIDEFS_MAX_PASSPHRASE_BYTES];
+                                                                        ///< WPA2 passphrase.
+    uint32_t                     maxNumClients;                         ///< Maximum clients.
+    bool                         isDiscoverable;                        ///< SSID broadcast.
+}
+pa_wifiAp_BssConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WMM access categories.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFIAP_WMM_AC_BE,        ///< Best effort.
+    PA_WIFIAP_WMM_AC_BK,        ///< Background.
+    PA_WIFIAP_WMM_AC_VI,        ///< Video.
+    PA_WIFIAP_WMM_AC_VO,        ///< Voice.
+    PA_WIFIAP_WMM_AC_COUNT
+}
+pa_wifiAp_WmmAc_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * EDCA parameters of a WMM access category.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t  aifs;          ///< Arbitration inter-frame space number, 1 to 15.
+    uint8_t  ecwMin;        ///< Minimum contention window exponent, 0 to 15: CWmin = 2^ecwMin - 1.
+    uint8_t  ecwMax;        ///< Maximum contention window exponent, ecwMin to 15.
+    uint16_t txopLimit;     ///< Transmit opportunity limit, in units of 32 us, 0 for one frame.
+}
+pa_wifiAp_WmmParams_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Channel width of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFIAP_CHANNEL_WIDTH_20,     ///< 20 MHz.
+    PA_WIFIAP_CHANNEL_WIDTH_40,     ///< 40 MHz, HT.
+    PA_WIFIAP_CHANNEL_WIDTH_80      ///< 80 MHz, VHT, 5 GHz band only.
+}
+pa_wifiAp_ChannelWidth_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * HT and VHT options of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIAP_HT_SHORT_GI   0x1     ///< Short guard interval, for the channel width.
+#define PA_WIFIAP_HT_LDPC       0x2     ///< LDPC coding.
+#define PA_WIFIAP_HT_MAX_AMPDU  0x4     ///< Largest VHT A-MPDU length supported by the driver.
+#define PA_WIFIAP_HT_ALL        0x7
 //--------------------------------------------------------------------------------------------------
 /**
  * Event handler for PA WiFi access point changes.
@@ -36,6 +114,69 @@ typedef void (*pa_wifiAp_NewEventHandlerFunc_t)
         ///< Associated WiFi event context
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station event, with the station MAC address.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_wifiAp_Event_t event;                                    ///< WiFi access point event.
+    char              ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];     ///< WLAN interface name.
+    uint8_t           bssIndex;                                 ///< BSS, 0 for the main one.
+    char              macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];  ///< Station MAC address.
+    uint16_t          reason;                                   ///< Disconnection reason, or 0.
+    le_clk_Time_t     captureTime;                              ///< Time the event was read.
+}
+pa_wifiAp_StationEvent_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for PA WiFi access point station events.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiAp_StationEventHandlerFunc_t)
+(
+    const pa_wifiAp_StationEvent_t *stationEventPtr,
+        ///< [IN]
+        ///< Station event to process
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Station information returned by the driver.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];   ///< Station MAC address.
+    char     ifName[LE_WIFIDEFS_MAX_IFNAME_BYTES];      ///< WLAN interface name.
+    uint32_t connectedSec;                              ///< Time since association (s).
+    uint32_t inactiveMs;                                ///< Time since last activity (ms).
+    int8_t   signal;                                    ///< Signal strength (dBm), 0 if unknown.
+    uint64_t rxBytes;                                   ///< Bytes received from the station.
+    uint64_t txBytes;                                   ///< Bytes sent to the station.
+}
+pa_wifiAp_Station_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called for each station of a station dump.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiAp_StationHandlerFunc_t)
+(
+    const pa_wifiAp_Station_t *stationPtr,
+        ///< [IN]
+        ///< Station information
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add handler function for WiFi related events.
@@ -56,6 +197,50 @@ LE_SHARED le_result_t pa_wifiAp_AddEventHandler
         ///< Associated event context
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for station connection and disconnection events.
+ *
+ * These events are reported along with the ones of pa_wifiAp_AddEventHandler(), with the MAC
+ * address of the station. The handler is called on the main thread, the event is only valid during
+ * the call.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_BAD_PARAMETER The handler could not be added.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_AddStationEventHandler
+(
+    pa_wifiAp_StationEventHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Event handler function pointer
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated event context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stations associated with the access point, from the driver.
+ *
+ * The handler is called for each station before the function returns.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_FAULT         The station dump failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_GetStations
+(
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each station
+
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the PA WiFi Access Point.
@@ -86,6 +271,10 @@ LE_SHARED le_result_t pa_wifiAp_Release
  * Note that all settings, if to be used, such as security, username, password must set prior to
  * starting the access point.
  *
+ * @note The hardware start, hostapd start and WLAN setup run synchronously: the caller is blocked
+ * up to a few seconds. Its result is the reply of le_wifiAp_Start() and no event reports it, so
+ * the commands are not run with pa_wifiCmd_RunAsync().
+ *
  * @return LE_FAULT         The function failed.
  * @return LE_OK            The function succeeded.
  * @return LE_NOT_FOUND     The WiFi card is absent.
@@ -102,6 +291,9 @@ le_result_t pa_wifiAp_Start
 /**
  * This function stops the WiFi access point.
  *
+ * @note hostapd is terminated through its control interface and the hardware stopped
+ * synchronously, as their result is the reply of le_wifiAp_Stop().
+ *
  * @return LE_FAULT         The function failed.
  * @return LE_OK            The function succeeded.
  *
@@ -112,6 +304,30 @@ le_result_t pa_wifiAp_Stop
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function restarts hostapd only, with the current settings. The driver stays loaded, and
+ * the interface address, the DHCP port rule and dnsmasq are kept, so that the access point is
+ * back in the time hostapd needs to start. The stations are disconnected.
+ *
+ * hostapd is not restarted when hostapd.conf is unchanged, no parameter which hostapd only reads
+ * at startup changed, and hostapd is running.
+ *
+ * The duration of the restart is recorded in the command statistics as WIFIAP_SOFT_RESTART.
+ *
+ * @return LE_OK            hostapd is restarted.
+ * @return LE_DUPLICATE     No restart needed: hostapd is running, the stations stay associated.
+ * @return LE_TERMINATED    hostapd was stopped but could not be started again: the access point is
+ *                          stopped.
+ * @return LE_FAULT         The access point is not started, or hostapd could not be stopped: the
+ *                          access point is unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Restart
+(
+    void
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the security protocol to use.
@@ -138,6 +354,9 @@ le_result_t pa_wifiAp_SetSecurityProtocol
  *
  * @return LE_BAD_PARAMETER Some parameter is invalid.
  * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the SSID is applied at once and the stations are
+ *       disconnected.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiAp_SetSsid
@@ -161,6 +380,9 @@ le_result_t pa_wifiAp_SetSsid
  *
  * @return LE_BAD_PARAMETER Parameter is invalid.
  * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started with WPA2, the passphrase is applied at once and the
+ *       stations are disconnected.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiAp_SetPassPhrase
@@ -180,6 +402,9 @@ le_result_t pa_wifiAp_SetPassPhrase
  *
  * @return LE_BAD_PARAMETER Parameter is invalid.
  * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started with WPA2, the PSK is applied at once and the stations
+ *       are disconnected.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiAp_SetPreSharedKey
@@ -197,6 +422,8 @@ le_result_t pa_wifiAp_SetPreSharedKey
  *
  * @return LE_OK            Function succeeded.
  *
+ * @note If the access point is started, the beacon is updated at once, the stations stay
+ *       connected.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiAp_SetDiscoverable
@@ -206,6 +433,49 @@ le_result_t pa_wifiAp_SetDiscoverable
         ///< If TRUE, the access point SSID is visible by the clients otherwise it is hidden.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the access point on a virtual interface, next to the client on the WLAN interface, so that
+ * both can be used at the same time. Applied at the next start of the access point. While the
+ * client is connected, the access point uses its channel.
+ *
+ * @return LE_BUSY          The access point is started.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetConcurrent
+(
+    bool enable
+        ///< [IN]
+        ///< true to run the access point on a virtual interface.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the channel width and the HT and VHT options of the access point, used with the IEEE
+ * 802.11n and 802.11ac standards. Default is 20 MHz without option.
+ *
+ * The settings are checked against the capabilities of the radio when the driver is loaded, and
+ * again when the access point starts: the access point falls back to 20 MHz without option if they
+ * are not supported.
+ *
+ * @return LE_BAD_PARAMETER Invalid width or option.
+ * @return LE_UNSUPPORTED   The radio does not support the settings.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the settings are used from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetHtConfig
+(
+    pa_wifiAp_ChannelWidth_t width,
+        ///< [IN]
+        ///< Channel width.
+    uint32_t options
+        ///< [IN]
+        ///< HT and VHT options, PA_WIFIAP_HT_* bits.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set which IEEE standard to use.
@@ -281,6 +551,130 @@ le_result_t pa_wifiAp_SetChannel
         ///< the channel number.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable the automatic channel selection. When enabled, the least congested channel is
+ * selected at each start of the access point from a scan and from the channel survey of the
+ * driver, instead of the channel set by pa_wifiAp_SetChannel(), which is used if the selection
+ * fails.
+ *
+ * @note The scan blocks pa_wifiAp_Start() up to PA_WIFIACS_SCAN_TIMEOUT_MS (10 s).
+ *
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetAutoChannel
+(
+    bool enable
+        ///< [IN]
+        ///< true to enable the automatic channel selection.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel scores of the last automatic channel selection, and the channel selected.
+ *
+ * @return LE_NOT_FOUND     No channel was selected automatically.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_GetChannelScores
+(
+    pa_wifiAcs_ChannelScore_t *scoresPtr,
+        ///< [OUT]
+        ///< Channel scores.
+    size_t *scoreCountPtr,
+        ///< [INOUT]
+        ///< Size of the scores array, number of scores returned.
+    uint16_t *channelPtr
+        ///< [OUT]
+        ///< Selected channel.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add, change or remove an additional BSS of the access point. hostapd creates its interface,
+ * named after the main one (ex: wlan0_1).
+ *
+ * @return LE_BAD_PARAMETER Some parameter is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note The BSS are applied at the next start or restart of the access point.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_SetBss
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS index, from 1 to PA_WIFIAP_MAX_BSS - 1.
+    const pa_wifiAp_BssConfig_t *configPtr
+        ///< [IN]
+        ///< Settings of the BSS, or NULL to remove it.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define the IP address of an additional BSS and the client IP addresses range served on it.
+ *
+ * @return LE_BAD_PARAMETER The BSS does not exist, or one of the IP addresses is invalid.
+ * @return LE_FAULT         A system call has failed.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is not started, the range is applied when it starts.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_SetBssIpRange
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS index, from 1 to PA_WIFIAP_MAX_BSS - 1.
+    const char *ipApPtr,
+        ///< [IN]
+        ///< IP address of the BSS interface.
+    const char *ipStartPtr,
+        ///< [IN]
+        ///< First client IP address.
+    const char *ipStopPtr
+        ///< [IN]
+        ///< Last client IP address.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the interface name of a BSS.
+ *
+ * @return LE_NOT_FOUND     The BSS does not exist.
+ * @return LE_OVERFLOW      The interface name buffer is too small.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiAp_GetBssInterface
+(
+    uint8_t bssIndex,
+        ///< [IN]
+        ///< BSS index, 0 for the main BSS.
+    char *ifNamePtr,
+        ///< [OUT]
+        ///< Interface name.
+    size_t ifNameSize
+        ///< [IN]
+        ///< Size of the interface name buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the BSS of an interface.
+ *
+ * @return The BSS index, 0 for the main BSS or an unknown interface.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED uint8_t pa_wifiAp_GetBssIndex
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Interface name.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the maximum number of clients connected to WiFi access point at the same time.
@@ -291,6 +685,7 @@ le_result_t pa_wifiAp_SetChannel
  * @return LE_OUT_OF_RANGE  Requested number of users exceeds the capabilities of the Access Point.
  * @return LE_OK            Function succeeded.
  *
+ * @note If the access point is started, the limit applies at once to the new associations.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_wifiAp_SetMaxNumberClients
@@ -300,12 +695,192 @@ le_result_t pa_wifiAp_SetMaxNumberClients
         ///< the maximum number of clients regarding the WiFi driver and hardware capabilities.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the beacon interval. Default value is 100.
+ *
+ * @return LE_OUT_OF_RANGE  The interval is lower than 15.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the interval is used from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetBeaconInterval
+(
+    uint16_t beaconInterval
+        ///< [IN]
+        ///< Beacon interval, in time units of 1024 us.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the DTIM period, the number of beacons between two deliveries of the frames buffered for
+ * the stations in power save. Default value is 2.
+ *
+ * @return LE_OUT_OF_RANGE  The period is 0.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the period is used from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetDtimPeriod
+(
+    uint8_t dtimPeriod
+        ///< [IN]
+        ///< DTIM period, in beacon intervals.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the EDCA parameters of a WMM access category, used by the access point for its own
+ * transmissions and advertised to the stations. The defaults of hostapd are used for the access
+ * categories never set.
+ *
+ * @return LE_BAD_PARAMETER Invalid access category or parameter.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the parameters are advertised to the stations at once,
+ *       and used by the access point from the next start or restart.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetWmmParams
+(
+    pa_wifiAp_WmmAc_t ac,
+        ///< [IN]
+        ///< Access category.
+    const pa_wifiAp_WmmParams_t *paramsPtr
+        ///< [IN]
+        ///< EDCA parameters.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time after which an inactive station is disconnected. Default value is 300 seconds.
+ *
+ * @return LE_OUT_OF_RANGE  The time is 0.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the time applies at once.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetMaxInactivity
+(
+    uint32_t maxInactivity
+        ///< [IN]
+        ///< Maximum inactivity, in seconds.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate a station from the access point.
+ *
+ * @return LE_BAD_PARAMETER The MAC address is invalid.
+ * @return LE_NOT_FOUND     The station is not associated.
+ * @return LE_FAULT         The access point is not started or the request failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_Deauthenticate
+(
+    const char *macAddressPtr,
+        ///< [IN]
+        ///< Station MAC address, xx:xx:xx:xx:xx:xx.
+    uint16_t reason
+        ///< [IN]
+        ///< IEEE 802.11 reason code, 0 for the default one.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the MAC address access control policy. Default is PA_WIFIACL_POLICY_ACCEPT_UNLESS_DENIED.
+ *
+ * @return LE_BAD_PARAMETER The policy is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the policy applies at once, and the stations it no longer
+ *       allows are deauthenticated.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_SetMacAclPolicy
+(
+    pa_wifiAcl_Policy_t policy
+        ///< [IN]
+        ///< Access control policy.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a MAC address to an access control list.
+ *
+ * @return LE_BAD_PARAMETER The list or the MAC address is invalid.
+ * @return LE_NO_MEMORY     The list is full.
+ * @return LE_OK            Function succeeded, or the address was already in the list.
+ *
+ * @note If the access point is started, the list applies at once, and the stations it no longer
+ *       allows are deauthenticated.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_AddMacAcl
+(
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a MAC address from an access control list.
+ *
+ * @return LE_BAD_PARAMETER The list or the MAC address is invalid.
+ * @return LE_NOT_FOUND     The MAC address is not in the list.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the list applies at once, and the stations it no longer
+ *       allows are deauthenticated.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_RemoveMacAcl
+(
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address, xx:xx:xx:xx:xx:xx.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the MAC addresses of an access control list.
+ *
+ * @return LE_BAD_PARAMETER The list is invalid.
+ * @return LE_OK            Function succeeded.
+ *
+ * @note If the access point is started, the list applies at once, and the stations it no longer
+ *       allows are deauthenticated.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiAp_ClearMacAcl
+(
+    pa_wifiAcl_List_t list
+        ///< [IN]
+        ///< MAC address list.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Define the access point IP address and the client IP addresses range.
  *
  * @note The access point IP address must be defined outside the client IP addresses range.
  *
+ * @note The DHCP server of the WLAN is only restarted if the range changes, and keeps its leases.
+ *
+ * @note The WLAN and DHCP server commands run synchronously, as the result is the reply of
+ * le_wifiAp_SetIpRange(). Unlike the start, they do not wait on the hardware.
+ *
  * @return LE_BAD_PARAMETER At least, one of the given IP addresses is invalid.
  * @return LE_FAULT         A system call has failed.
  * @return LE_OK            Function succeeded.
@@ -0,0 +1,147 @@
+#ifndef PA_WIFI_CMD_H
+#define PA_WIFI_CMD_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor script commands.
+ *
+ * The commands are sent to a long-lived instance of the PA script started in command server mode
+ * (pa_wifi SERVE), so that the shell is not started and the script not parsed for each command.
+ * If the script does not support the command server mode, each command runs in a new instance
+ * of the script, as system() does.
+ *
+ * Commands which take long (connection, hardware start) can be run asynchronously instead: the
+ * script is spawned and its completion is reported on the event loop, so the caller is not blocked.
+ *
+ * The WIFI_PA_SCRIPT environment variable of the service replaces the PA script, for instance by
+ * the replay script (replay/pa_wifi.sh) to run the service without WiFi hardware.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the command module. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiCmd_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of the PA script: the one of the wifiService app, unless replaced by the
+ * WIFI_PA_SCRIPT environment variable.
+ *
+ * @return The path of the PA script.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED const char *pa_wifiCmd_GetScript
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command whose output is read as a stream (scan results, events), in a new
+ * instance of the script. The stream is closed with pclose().
+ *
+ * @return The stream of the command output, NULL with errno set if the command could not be run.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED FILE *pa_wifiCmd_Open
+(
+    const char *commandPtr
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command and wait for its completion. Can be called from any thread, commands
+ * are run one at a time. The commands which do not need the shell are run natively, see
+ * pa_wifi_native.h.
+ *
+ * @return The command status in the format of system(): -1 if the command could not be run,
+ *         otherwise a wait status to decode with WIFEXITED() and WEXITSTATUS().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED int pa_wifiCmd_Run
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces (ex: "WIFIAP_WLAN_UP 192.168.0.1").
+    char *outputPtr,
+        ///< [OUT]
+        ///< Buffer receiving the command output, truncated if needed. Can be NULL.
+    size_t outputSize
+        ///< [IN]
+        ///< Size of the output buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to an asynchronous command.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_wifiCmd_Job *pa_wifiCmd_JobRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called when an asynchronous command has completed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiCmd_CompletionHandlerFunc_t)
+(
+    int status,
+        ///< [IN]
+        ///< Command wait status, to decode with WIFEXITED() and WEXITSTATUS().
+    const char *outputPtr,
+        ///< [IN]
+        ///< Command output (stdout and stderr), truncated if needed. Only valid during the call.
+    void *contextPtr
+        ///< [IN]
+        ///< Context given to pa_wifiCmd_RunAsync().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command in a new instance of the script without waiting for its completion.
+ *
+ * The command output is collected and its exit is detected on the event loop of the calling
+ * thread, which then calls the completion handler. Must be called from the thread which called
+ * pa_wifiCmd_Init(), usually the main thread.
+ *
+ * @return Command reference, or NULL if the command could not be started.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED pa_wifiCmd_JobRef_t pa_wifiCmd_RunAsync
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces (ex: "WIFIAP_WLAN_UP 192.168.0.1").
+    pa_wifiCmd_CompletionHandlerFunc_t handlerFunc,
+        ///< [IN]
+        ///< Completion handler. Can be NULL.
+    void *contextPtr
+        ///< [IN]
+        ///< Completion handler context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel an asynchronous command: the script and its children are terminated and the completion
+ * handler is not called. Must be called from the thread which started the command.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiCmd_Cancel
+(
+    pa_wifiCmd_JobRef_t jobRef
+        ///< [IN]
+        ///< Command reference.
+);
+
+#endif // PA_WIFI_CMD_H
@@ -0,0 +1,131 @@
+#ifndef PA_WIFI_CONF_H
+#define PA_WIFI_CONF_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor configuration files.
+ *
+ * A configuration file (hostapd.conf, wpa_supplicant.conf) is built in a growable buffer, then
+ * written to a temporary file renamed over the file, so that a daemon never reads a partial file.
+ * The file is not written again when its content and the file are unchanged since the last
+ * write, which lets the caller skip the reload of the daemon.
+ *
+ * All the functions must be called from the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <sys/stat.h>
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Growable buffer holding the content of a configuration file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char   *dataPtr;        ///< Content, null-terminated, or NULL if empty.
+    size_t  length;         ///< Length of the content.
+    size_t  size;           ///< Allocated size.
+}
+pa_wifiConf_Buffer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializer of an empty buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFICONF_BUFFER_INIT     { NULL, 0, 0 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last write of a configuration file: hash of the content and identity of the file written.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool            isWritten;  ///< The file was written.
+    uint64_t        hash;       ///< Hash of the content written.
+    dev_t           device;     ///< Device of the file written.
+    ino_t           inode;      ///< Inode of the file written.
+    off_t           size;       ///< Size of the file written.
+    struct timespec mtime;      ///< Modification time of the file written.
+}
+pa_wifiConf_File_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializer of a file never written.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFICONF_FILE_INIT       { false, 0, 0, 0, 0, { 0, 0 } }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append formatted text to a buffer, growing it as needed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiConf_Append
+(
+    pa_wifiConf_Buffer_t *bufferPtr,
+        ///< [INOUT]
+        ///< Buffer.
+    const char *formatPtr,
+        ///< [IN]
+        ///< printf() format.
+    ...
+)
+__attribute__((format(printf, 2, 3)));
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the memory of a buffer, which is then empty.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiConf_Release
+(
+    pa_wifiConf_Buffer_t *bufferPtr
+        ///< [INOUT]
+        ///< Buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the content of a buffer to a configuration file, unless the content and the file are
+ * unchanged since the last write.
+ *
+ * @return
+ *      - LE_OK             The file is written.
+ *      - LE_DUPLICATE      The file is unchanged, it is not written.
+ *      - LE_FAULT          The file can not be written. The previous file is left in place.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiConf_Write
+(
+    pa_wifiConf_File_t *filePtr,
+        ///< [INOUT]
+        ///< Last write of the file.
+    const char *pathPtr,
+        ///< [IN]
+        ///< Path of the file.
+    const pa_wifiConf_Buffer_t *bufferPtr
+        ///< [IN]
+        ///< Content of the file.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forget the last write of a configuration file, so that it is written again by the next
+ * pa_wifiConf_Write().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiConf_Invalidate
+(
+    pa_wifiConf_File_t *filePtr
+        ///< [INOUT]
+        ///< Last write of the file.
+);
+
+#endif // PA_WIFI_CONF_H
@@ -0,0 +1,105 @@
+#ifndef PA_WIFI_DHCP_H
+#define PA_WIFI_DHCP_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor DHCP leases.
+ *
+ * The leases given by the DHCP server of the WLAN are kept in memory. The lease file of the
+ * server is watched with inotify and only parsed again after it changed, when the leases are read.
+ *
+ * All the functions must be called from the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <netinet/in.h>
+
+#include "legato.h"
+#include "interfaces.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a lease host name.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIDHCP_MAX_HOSTNAME_BYTES  64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DHCP lease.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     macAddress[LE_WIFIDEFS_MAX_BSSID_BYTES];   ///< MAC address, lower case.
+    char     ipAddress[INET_ADDRSTRLEN];                ///< IPv4 address.
+    char     hostname[PA_WIFIDHCP_MAX_HOSTNAME_BYTES];  ///< Host name, empty if unknown.
+    uint64_t expiry;                                    ///< Expiry (seconds since the Epoch), or 0.
+}
+pa_wifiDhcp_Lease_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called for each lease.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiDhcp_LeaseHandlerFunc_t)
+(
+    const pa_wifiDhcp_Lease_t *leasePtr,
+        ///< [IN]
+        ///< Lease.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the lease file of the DHCP server of the WLAN, and start watching it.
+ *
+ * @return
+ *      - LE_OK             The lease file is watched.
+ *      - LE_FAULT          The lease file can not be watched. The leases are then read again
+ *                          each time.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiDhcp_SetLeaseFile
+(
+    const char *pathPtr
+        ///< [IN]
+        ///< Lease file path, or NULL when the DHCP server is stopped.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current leases, in the order of the lease file.
+ *
+ * The handler is called for each lease which has not expired, before the function returns.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiDhcp_GetLeases
+(
+    pa_wifiDhcp_LeaseHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each lease.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current lease of a MAC address.
+ *
+ * @return The lease, valid until the next call of a pa_wifiDhcp function, or NULL if none.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED const pa_wifiDhcp_Lease_t *pa_wifiDhcp_GetLease
+(
+    const char *macAddressPtr
+        ///< [IN]
+        ///< MAC address.
+);
+
+#endif // PA_WIFI_DHCP_H
@@ -0,0 +1,240 @@
+#ifndef PA_WIFI_HOSTAPD_H
+#define PA_WIFI_HOSTAPD_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor hostapd control interface client.
+ *
+ * Requests sent to a running hostapd through its control socket (ctrl_interface of hostapd.conf),
+ * to change the access point configuration without restarting hostapd nor reloading the driver.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+#include "pa_wifi_ap.h"
+#include "pa_wifi_acl.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a hostapd reply.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFIHOSTAPD_REPLY_MAX_BYTES  4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update of a MAC address list.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFIHOSTAPD_ACL_ADD,         ///< Add a MAC address.
+    PA_WIFIHOSTAPD_ACL_DEL,         ///< Remove a MAC address.
+    PA_WIFIHOSTAPD_ACL_CLEAR        ///< Remove all the MAC addresses.
+}
+pa_wifiHostapd_AclAction_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request to hostapd and get its reply.
+ *
+ * @return
+ *      - LE_OK             The reply is returned.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_TIMEOUT        hostapd did not reply.
+ *      - LE_FAULT          The request could not be sent.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_Request
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *requestPtr,
+        ///< [IN]
+        ///< Request (ex: "STA-FIRST").
+    char *replyPtr,
+        ///< [OUT]
+        ///< Reply, null-terminated.
+    size_t replySize
+        ///< [IN]
+        ///< Size of the reply buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a configuration parameter of the running hostapd (SET). Most parameters only take effect
+ * after pa_wifiHostapd_Reload().
+ *
+ * @return
+ *      - LE_OK             The parameter is set.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          hostapd rejected the parameter or did not reply.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_Set
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *namePtr,
+        ///< [IN]
+        ///< Parameter name, as in hostapd.conf.
+    const char *valuePtr
+        ///< [IN]
+        ///< Parameter value.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the configuration changes to the beacon only (UPDATE_BEACON), without disconnecting the
+ * stations. Falls back to pa_wifiHostapd_Reload() if hostapd does not support it.
+ *
+ * @return
+ *      - LE_OK             The beacon is updated.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The update failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_UpdateBeacon
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the configuration changes (RELOAD). The associated stations are disconnected.
+ *
+ * @return
+ *      - LE_OK             The configuration is applied.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The reload failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_Reload
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stations known by hostapd (STA-FIRST, STA-NEXT).
+ *
+ * The handler is called for each station before the function returns.
+ *
+ * @return
+ *      - LE_OK             The stations are returned.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          A request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_GetStations
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each station.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a station is known by hostapd on an interface (STA).
+ *
+ * @return
+ *      - LE_OK             The station is known.
+ *      - LE_NOT_FOUND      The station is not known.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_HasStation
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< Station MAC address.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate a station (DEAUTHENTICATE).
+ *
+ * @return
+ *      - LE_OK             The station is deauthenticated.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_Deauthenticate
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *macAddressPtr,
+        ///< [IN]
+        ///< Station MAC address.
+    uint16_t reason
+        ///< [IN]
+        ///< IEEE 802.11 reason code, 0 for hostapd's default.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a MAC address list of a running hostapd (ACCEPT_ACL, DENY_ACL), without disconnecting the
+ * stations. The file of the list must be updated as well, for the next reload.
+ *
+ * @return
+ *      - LE_OK             The list is updated.
+ *      - LE_UNSUPPORTED    hostapd does not support the request, a reload is needed.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_UpdateAcl
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    pa_wifiHostapd_AclAction_t action,
+        ///< [IN]
+        ///< Update of the list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< Station MAC address, ignored by PA_WIFIHOSTAPD_ACL_CLEAR.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Request hostapd to terminate (TERMINATE). The stations are deauthenticated, the driver and the
+ * interface are left as they are. The function does not wait for hostapd to exit: the caller
+ * waits on its process.
+ *
+ * @return
+ *      - LE_OK             hostapd is terminating.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiHostapd_Terminate
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+);
+
+#endif // PA_WIFI_HOSTAPD_H
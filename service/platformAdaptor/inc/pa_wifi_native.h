@@ -0,0 +1,75 @@
+#ifndef PA_WIFI_NATIVE_H
+#define PA_WIFI_NATIVE_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor native commands.
+ *
+ * The PA script commands which only check or configure the network interface and the driver
+ * module (hardware start and stop, hardware status, interface address) are run natively with
+ * ioctl() and sysfs instead of ifconfig, lsmod, pgrep... The PA script is only used for the
+ * board specific hooks: board settings and driver loading/unloading (HW_MODULE_LOAD,
+ * HW_MODULE_UNLOAD) and the hardware parameters (HW_INFO). If the script does not provide these
+ * hooks, all the commands run in the script.
+ *
+ * The interfaces given by HW_INFO (IFACE, and AP_IFACE for the access point in concurrent mode)
+ * are also used by the other PA modules.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the native commands. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiNative_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WLAN interface given by the HW_INFO hook. Can be called from any thread.
+ *
+ * @return The interface name, or NULL if the PA script does not give it.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED const char *pa_wifiNative_GetInterface
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the virtual interface of the access point given by the HW_INFO hook. Can be called from any
+ * thread.
+ *
+ * @return The interface name, or NULL if the PA script does not give it.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED const char *pa_wifiNative_GetApInterface
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command natively, if possible. Can be called from any thread.
+ *
+ * @return true if the command was run natively, false if it must be run by the PA script.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool pa_wifiNative_Run
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces (ex: "WIFIAP_WLAN_UP 192.168.0.1").
+    int *statusPtr
+        ///< [OUT]
+        ///< Command status in the format of system(), set if the command was run natively.
+);
+
+#endif // PA_WIFI_NATIVE_H
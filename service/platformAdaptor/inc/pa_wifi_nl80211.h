@@ -0,0 +1,321 @@
+#ifndef PA_WIFI_NL80211_H
+#define PA_WIFI_NL80211_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor nl80211 requests.
+ *
+ * Requests sent directly to the driver through a generic netlink socket, for the information
+ * which the PA script can only get by parsing the output of iw, and for the virtual interfaces.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+#include "pa_wifi_ap.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength of a BSS which the driver does not give.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFINL80211_SIGNAL_UNKNOWN   INT32_MIN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * BSS found by a scan.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t frequency;     ///< Frequency (MHz).
+    int32_t  signalMbm;     ///< Signal strength (1/100 dBm), or PA_WIFINL80211_SIGNAL_UNKNOWN.
+}
+pa_wifiNl80211_Bss_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called for each BSS.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiNl80211_BssHandlerFunc_t)
+(
+    const pa_wifiNl80211_Bss_t *bssPtr,
+        ///< [IN]
+        ///< BSS.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Survey of a channel. The times are counted by the driver since it started, 0 if it does not
+ * give them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t frequency;     ///< Frequency (MHz).
+    bool     inUse;         ///< Channel currently used by the interface.
+    int8_t   noise;         ///< Noise level (dBm), 0 if unknown.
+    uint64_t activeMs;      ///< Time the radio was on the channel (ms).
+    uint64_t busyMs;        ///< Time the channel was sensed busy (ms).
+}
+pa_wifiNl80211_Survey_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called for each surveyed channel.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiNl80211_SurveyHandlerFunc_t)
+(
+    const pa_wifiNl80211_Survey_t *surveyPtr,
+        ///< [IN]
+        ///< Channel survey.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * HT and VHT capabilities of a band of the radio, as defined by IEEE 802.11 for the HT and VHT
+ * capabilities elements.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isHt;          ///< HT (802.11n) is supported.
+    uint16_t htCapa;        ///< HT capabilities info.
+    bool     isVht;         ///< VHT (802.11ac) is supported.
+    uint32_t vhtCapa;       ///< VHT capabilities info.
+}
+pa_wifiNl80211_BandCapa_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frequency of a band of the radio, with the restrictions of the regulatory domain.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t frequency;     ///< Frequency (MHz).
+    bool     isDisabled;    ///< Not allowed.
+    bool     isNoIr;        ///< No initiated radiation: no beaconing.
+    bool     isRadar;       ///< Radar detection (DFS) required.
+}
+pa_wifiNl80211_Frequency_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called for each frequency of a band.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiNl80211_FrequencyHandlerFunc_t)
+(
+    const pa_wifiNl80211_Frequency_t *frequencyPtr,
+        ///< [IN]
+        ///< Frequency.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the stations associated with an interface (NL80211_CMD_GET_STATION).
+ *
+ * The handler is called for each station before the function returns.
+ *
+ * @return
+ *      - LE_OK             The dump succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_GetStations
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each station.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan on an interface (NL80211_CMD_TRIGGER_SCAN) and dump the BSS found
+ * (NL80211_CMD_GET_SCAN). If the scan can not be run, the results of the previous scan are
+ * dumped.
+ *
+ * The handler is called for each BSS before the function returns.
+ *
+ * @return
+ *      - LE_OK             The dump succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_Scan
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    uint32_t timeoutMs,
+        ///< [IN]
+        ///< Maximum duration of the scan, in ms.
+    pa_wifiNl80211_BssHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each BSS.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the channel survey of an interface (NL80211_CMD_GET_SURVEY).
+ *
+ * The handler is called for each channel before the function returns.
+ *
+ * @return
+ *      - LE_OK             The dump succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_GetSurvey
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiNl80211_SurveyHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each channel.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an access point interface on the radio of another interface (NL80211_CMD_NEW_INTERFACE).
+ * The new interface is down.
+ *
+ * @return
+ *      - LE_OK             The interface is created.
+ *      - LE_NOT_FOUND      The parent interface does not exist.
+ *      - LE_DUPLICATE      The interface already exists.
+ *      - LE_FAULT          The request failed, ex: the driver does not support the interface type.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_AddApInterface
+(
+    const char *parentIfNamePtr,
+        ///< [IN]
+        ///< WLAN interface of the radio.
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Name of the new interface.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an interface (NL80211_CMD_DEL_INTERFACE).
+ *
+ * @return
+ *      - LE_OK             The interface is deleted.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_DelInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frequency an interface operates on (NL80211_CMD_GET_INTERFACE), ex: the frequency of
+ * the access point a station interface is associated with.
+ *
+ * @return
+ *      - LE_OK             The frequency is returned.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The interface does not operate on any frequency.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_GetFrequency
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    uint32_t *frequencyPtr
+        ///< [OUT]
+        ///< Frequency (MHz).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the HT and VHT capabilities of a band of the radio of an interface (NL80211_CMD_GET_WIPHY).
+ *
+ * @return
+ *      - LE_OK             The capabilities are returned.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The radio does not support the band.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_GetBandCapa
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    bool is5GHz,
+        ///< [IN]
+        ///< true for the 5 GHz band, false for the 2.4 GHz one.
+    pa_wifiNl80211_BandCapa_t *capaPtr
+        ///< [OUT]
+        ///< Capabilities of the band.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frequencies of a band of the radio of an interface and their regulatory restrictions
+ * (NL80211_CMD_GET_WIPHY).
+ *
+ * The handler is called for each frequency before the function returns.
+ *
+ * @return
+ *      - LE_OK             The frequencies are reported.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The radio does not support the band.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiNl80211_GetFrequencies
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    bool is5GHz,
+        ///< [IN]
+        ///< true for the 5 GHz band, false for the 2.4 GHz one.
+    pa_wifiNl80211_FrequencyHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each frequency.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+);
+
+#endif // PA_WIFI_NL80211_H
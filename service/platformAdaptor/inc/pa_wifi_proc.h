@@ -0,0 +1,79 @@
+#ifndef PA_WIFI_PROC_H
+#define PA_WIFI_PROC_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor daemon processes.
+ *
+ * The daemons started by the PA script (hostapd, dnsmasq) detach from it: they are found through
+ * the pid files they write, and stopped with a deadline instead of killall and fixed delays. Only
+ * the process named in the pid file is signaled, and only if it still runs the expected program.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the pid file of a daemon and check that the process runs the expected program.
+ *
+ * @return
+ *      - LE_OK             The process is running.
+ *      - LE_NOT_FOUND      No pid file, or the process is no longer running the program.
+ *      - LE_FAULT          The pid file is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiProc_ReadPidFile
+(
+    const char *pathPtr,
+        ///< [IN]
+        ///< Path of the pid file.
+    const char *namePtr,
+        ///< [IN]
+        ///< Program name (ex: "hostapd").
+    pid_t *pidPtr
+        ///< [OUT]
+        ///< Process identifier.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a process to exit.
+ *
+ * @return
+ *      - LE_OK             The process exited.
+ *      - LE_TIMEOUT        The process is still running.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiProc_Wait
+(
+    pid_t pid,
+        ///< [IN]
+        ///< Process identifier.
+    uint32_t timeoutMs
+        ///< [IN]
+        ///< Maximum time to wait, in ms.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Terminate a process with SIGTERM and wait for it to exit. It is killed with SIGKILL if it does
+ * not exit in time.
+ *
+ * @return
+ *      - LE_OK             The process exited.
+ *      - LE_TIMEOUT        The process is still running after SIGKILL.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiProc_Stop
+(
+    pid_t pid,
+        ///< [IN]
+        ///< Process identifier.
+    uint32_t timeoutMs
+        ///< [IN]
+        ///< Maximum time to wait after SIGTERM, in ms.
+);
+
+#endif // PA_WIFI_PROC_H
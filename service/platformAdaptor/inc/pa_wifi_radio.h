@@ -0,0 +1,179 @@
+#ifndef PA_WIFI_RADIO_H
+#define PA_WIFI_RADIO_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor radio.
+ *
+ * The WiFi client and the access point share the radio. The hardware is started (WIFI_START) by
+ * the first role started and stopped (WIFI_STOP) by the last one stopped. The iw events are read
+ * by a single thread, which runs while the hardware is started, and each event line is passed to
+ * the roles whose interface it names.
+ *
+ * The client runs on the WLAN interface. By default the access point runs on the same interface,
+ * so only one of them can work at a time. In concurrent mode the access point runs on a virtual
+ * interface created on the same radio, and the client stays connected while it runs.
+ *
+ * All the functions must be called from the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Roles sharing the radio.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_WIFIRADIO_ROLE_CLIENT,   ///< WiFi client.
+    PA_WIFIRADIO_ROLE_AP,       ///< Access point.
+    PA_WIFIRADIO_ROLE_COUNT
+}
+pa_wifiRadio_Role_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called by the event thread for each iw event line naming the interface of a role, or,
+ * for the access point, one of its additional BSS (ex: "wlan0_1").
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiRadio_EventHandlerFunc_t)
+(
+    const char *linePtr,
+        ///< [IN]
+        ///< Event line, as printed by iw event.
+    le_clk_Time_t captureTime
+        ///< [IN]
+        ///< Time the line was read.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the radio module. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiRadio_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the access point on a virtual interface, so that the client can be used at the same time.
+ * Applied at the next start of the access point.
+ *
+ * @return
+ *      - LE_OK             The mode is set.
+ *      - LE_BUSY           The access point is started.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiRadio_SetConcurrent
+(
+    bool isConcurrent
+        ///< [IN]
+        ///< true to run the access point on a virtual interface.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the access point runs on a virtual interface.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool pa_wifiRadio_IsConcurrent
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the interface of a role.
+ *
+ * @return The interface name.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED const char *pa_wifiRadio_GetInterface
+(
+    pa_wifiRadio_Role_t role
+        ///< [IN]
+        ///< Role.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether another role is started, so that the hardware stays started when the role stops.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool pa_wifiRadio_IsShared
+(
+    pa_wifiRadio_Role_t role
+        ///< [IN]
+        ///< Role.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a role. The hardware and the event thread are started if no other role is started. For
+ * the access point in concurrent mode, its virtual interface is created.
+ *
+ * @return
+ *      - LE_OK             The role is started.
+ *      - LE_NOT_FOUND      The WiFi card is absent.
+ *      - LE_UNAVAILABLE    The WiFi card may not work.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiRadio_Start
+(
+    pa_wifiRadio_Role_t role,
+        ///< [IN]
+        ///< Role.
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc
+        ///< [IN]
+        ///< Handler of the event lines of the role.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop a role. Its virtual interface, if any, is deleted. The hardware and the event thread are
+ * stopped if no other role is started.
+ *
+ * @return
+ *      - LE_OK             The role is stopped.
+ *      - LE_FAULT          The hardware could not be stopped, the role stays started.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiRadio_Stop
+(
+    pa_wifiRadio_Role_t role
+        ///< [IN]
+        ///< Role.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the channel the interface of a role operates on, ex: the channel of the access point the
+ * client is associated with.
+ *
+ * @return
+ *      - LE_OK             The channel is returned.
+ *      - LE_UNAVAILABLE    The interface does not operate on any channel.
+ *      - LE_FAULT          The function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiRadio_GetChannel
+(
+    pa_wifiRadio_Role_t role,
+        ///< [IN]
+        ///< Role.
+    uint16_t *channelPtr,
+        ///< [OUT]
+        ///< Channel number.
+    bool *is5GHzPtr
+        ///< [OUT]
+        ///< true if the channel is a 5 GHz one.
+);
+
+#endif // PA_WIFI_RADIO_H
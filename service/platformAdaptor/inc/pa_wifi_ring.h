@@ -0,0 +1,129 @@
+#ifndef PA_WIFI_RING_H
+#define PA_WIFI_RING_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * Single-producer/single-consumer ring used to hand events from a worker thread (PA event thread,
+ * scan thread) over to the thread which created the ring, usually the main thread.
+ *
+ * Elements are copied into fixed-size slots, so pushing never allocates. The producer wakes the
+ * consumer through an eventfd monitored on the consumer event loop, only when the consumer has
+ * drained the ring and is about to sleep.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_wifiRing *pa_wifiRing_Ref_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called by the consumer thread for each element popped from the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_wifiRing_ConsumerFunc_t)
+(
+    void *elemPtr,
+        ///< [IN]
+        ///< Element, only valid during the call.
+    void *contextPtr
+        ///< [IN]
+        ///< Context given to pa_wifiRing_Create().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t capacity;  ///< Number of slots.
+    uint32_t depth;     ///< Number of elements currently queued.
+    uint32_t maxDepth;  ///< Highest number of elements queued since creation.
+    uint32_t dropCount; ///< Number of elements rejected because the ring was full.
+} pa_wifiRing_Stats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a ring. Must be called by the consumer thread, which must run an event loop.
+ *
+ * @return Ring reference. Failures are fatal.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED pa_wifiRing_Ref_t pa_wifiRing_Create
+(
+    const char *namePtr,
+        ///< [IN]
+        ///< Ring name, for traces.
+    size_t elemSize,
+        ///< [IN]
+        ///< Size of an element in bytes.
+    uint32_t capacity,
+        ///< [IN]
+        ///< Number of slots, rounded up to a power of 2.
+    pa_wifiRing_ConsumerFunc_t consumerFunc,
+        ///< [IN]
+        ///< Handler called for each element.
+    void *contextPtr
+        ///< [IN]
+        ///< Handler context.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an element into the ring. Must only be called by the producer thread.
+ *
+ * @return
+ *      - LE_OK             The element is queued.
+ *      - LE_OVERFLOW       The ring is full, the element is dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiRing_Push
+(
+    pa_wifiRing_Ref_t ringRef,
+        ///< [IN]
+        ///< Ring reference.
+    const void *elemPtr
+        ///< [IN]
+        ///< Element to copy.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an element into the ring, waiting for a free slot if the ring is full. Must only be called
+ * by the producer thread, for elements which must not be lost.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiRing_PushWait
+(
+    pa_wifiRing_Ref_t ringRef,
+        ///< [IN]
+        ///< Ring reference.
+    const void *elemPtr
+        ///< [IN]
+        ///< Element to copy.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the ring statistics. Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiRing_GetStats
+(
+    pa_wifiRing_Ref_t ringRef,
+        ///< [IN]
+        ///< Ring reference.
+    pa_wifiRing_Stats_t *statsPtr
+        ///< [OUT]
+        ///< Ring statistics.
+);
+
+#endif // PA_WIFI_RING_H
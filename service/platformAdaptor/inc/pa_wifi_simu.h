@@ -0,0 +1,77 @@
+#ifndef PA_WIFI_SIMU_H
+#define PA_WIFI_SIMU_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor station churn generator, for the simulation mode (SIMU) of the access
+ * point.
+ *
+ * A generator thread takes the place of the iw event thread: it writes the same "new station" and
+ * "del station" event lines, and passes them to the event line handler of the access point, so
+ * that the events follow the real path to the le_wifiAp subscribers.
+ *
+ * A pool of simulated stations with random locally administered MAC addresses associates and
+ * leaves the access point:
+ *  - the associations are a Poisson process, while a station of the pool is not associated,
+ *  - each associated station leaves after an exponentially distributed time,
+ *  - optionally, bursts of stations associate or leave at once, at a fixed interval.
+ *
+ * The generator is configured by environment variables, read when it starts:
+ *  - WIFI_SIMU_STATIONS:           number of stations of the pool (default 5).
+ *  - WIFI_SIMU_ARRIVAL_RATE:       associations per minute (default 6).
+ *  - WIFI_SIMU_DEPARTURE_RATE:     departures per minute of each associated station (default 1).
+ *  - WIFI_SIMU_BURST:              none (default), join, leave or mixed (join and leave in turn).
+ *  - WIFI_SIMU_BURST_SIZE:         number of stations of a burst (default 10).
+ *  - WIFI_SIMU_BURST_INTERVAL:     time between two bursts, in seconds (default 60).
+ *  - WIFI_SIMU_SEED:               seed of the random generator (default: time based).
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+#include "pa_wifi_radio.h"
+#include "pa_wifi_ring.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of simulated stations.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFISIMU_MAX_STATIONS    1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the generator. The stations associate with the given interface.
+ *
+ * @return
+ *      - LE_OK             The generator is started.
+ *      - LE_BUSY           The generator is already started.
+ *      - LE_BAD_PARAMETER  Invalid environment variable, or event ring too small.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiSimu_Start
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiRadio_EventHandlerFunc_t handlerFunc,
+        ///< [IN]
+        ///< Handler of the event lines, called by the generator thread.
+    pa_wifiRing_Ref_t ringRef
+        ///< [IN]
+        ///< Ring the handler queues the events into. Its capacity must exceed the number of
+        ///< stations: the generator waits for room in it, and keeps room for the departures of
+        ///< all the stations at stop.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the generator. The associated stations leave first, as when hostapd terminates.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiSimu_Stop
+(
+    void
+);
+
+#endif // PA_WIFI_SIMU_H
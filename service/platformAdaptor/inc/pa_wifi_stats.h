@@ -0,0 +1,129 @@
+#ifndef PA_WIFI_STATS_H
+#define PA_WIFI_STATS_H
+// -------------------------------------------------------------------------------------------------
+/**
+ * WiFi platform adaptor command statistics.
+ *
+ * The duration of every PA command is recorded in a per-command log-linear histogram (8 buckets
+ * per power of two, so percentiles are within 12.5%), with a breakdown of the exit statuses.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a command name, and number of distinct exit statuses per command.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFISTATS_NAME_MAX_BYTES         32
+#define PA_WIFISTATS_EXIT_CODE_MAX_COUNT    8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exit status values which are not exit codes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_WIFISTATS_EXIT_NOT_RUN           (-1)    ///< The command could not be run.
+#define PA_WIFISTATS_EXIT_OTHER             (-2)    ///< Any status once the table is full.
+#define PA_WIFISTATS_EXIT_FAILED            (-3)    ///< An operation run in the PA failed.
+#define PA_WIFISTATS_EXIT_SIGNALED          256     ///< Added to the number of a killing signal.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of one command.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char     name[PA_WIFISTATS_NAME_MAX_BYTES];                 ///< Command name.
+    uint32_t count;                                             ///< Number of runs.
+    uint64_t p50Us;                                             ///< Median duration (us).
+    uint64_t p90Us;                                             ///< 90th percentile (us).
+    uint64_t p99Us;                                             ///< 99th percentile (us).
+    uint64_t maxUs;                                             ///< Maximum duration (us).
+    uint32_t exitCodeCount;                                     ///< Number of distinct statuses.
+    int32_t  exitCodes[PA_WIFISTATS_EXIT_CODE_MAX_COUNT];       ///< Exit statuses.
+    uint32_t exitCounts[PA_WIFISTATS_EXIT_CODE_MAX_COUNT];      ///< Runs per exit status.
+} pa_wifiStats_Command_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the command statistics. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiStats_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a command run. Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiStats_Record
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command, only its first word is used as name.
+    le_clk_Time_t startTime,
+        ///< [IN]
+        ///< Time the command was started (le_clk_GetRelativeTime()).
+    int status
+        ///< [IN]
+        ///< Command status in the format of system().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the run of an operation done in the PA, instead of a command. A successful operation is
+ * recorded with the exit status 0, a failed one with PA_WIFISTATS_EXIT_FAILED. Can be called from
+ * any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiStats_RecordResult
+(
+    const char *namePtr,
+        ///< [IN]
+        ///< Operation name, only its first word is used.
+    le_clk_Time_t startTime,
+        ///< [IN]
+        ///< Time the operation was started (le_clk_GetRelativeTime()).
+    le_result_t result
+        ///< [IN]
+        ///< Operation result.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a command. Can be called from any thread.
+ *
+ * @return
+ *      - LE_OK             The statistics are returned.
+ *      - LE_NOT_FOUND      No command at this index.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pa_wifiStats_Get
+(
+    uint32_t index,
+        ///< [IN]
+        ///< Command index, from 0, in the order of the first run.
+    pa_wifiStats_Command_t *statsPtr
+        ///< [OUT]
+        ///< Command statistics.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the statistics of all commands. Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pa_wifiStats_Reset
+(
+    void
+);
+
+#endif // PA_WIFI_STATS_H
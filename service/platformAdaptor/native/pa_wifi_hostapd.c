@@ -0,0 +1,581 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter hostapd control interface client
+ *
+ *  Each request binds its own datagram socket in /tmp, sends the request to the hostapd control
+ *  socket of the interface and waits for the reply. The unsolicited messages of hostapd ("<n>..."
+ *  prefix) are only sent to attached clients and are skipped anyway.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_hostapd.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * hostapd control socket directory, ctrl_interface of hostapd.conf.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOSTAPD_CTRL_DIR            "/var/run/hostapd"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local socket path format: process id and request number.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOCAL_SOCKET_PATH_FORMAT    "/tmp/wifi_hostapd_%d_%u"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum time to wait for a reply, in ms. hostapd answers from its event loop without blocking,
+ * and the requests are sent from the main thread of the service, so a late reply is a failure.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REPLY_TIMEOUT_MS            500
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a request.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REQUEST_MAX_BYTES           512
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of requests sent, used to make the local socket paths unique.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RequestCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request expecting "OK".
+ *
+ * @return
+ *      - LE_OK             hostapd replied "OK".
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          hostapd replied something else or did not reply.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RequestOk
+(
+    const char *ifNamePtr,
+    const char *requestPtr
+)
+{
+    char        reply[PA_WIFIHOSTAPD_REPLY_MAX_BYTES];
+    le_result_t result = pa_wifiHostapd_Request(ifNamePtr, requestPtr, reply, sizeof(reply));
+
+    if (LE_UNAVAILABLE == result)
+    {
+        return LE_UNAVAILABLE;
+    }
+    if ((LE_OK != result) || (0 != strncmp(reply, "OK", 2)))
+    {
+        LE_ERROR("hostapd request \"%.*s\" failed: %s",
+                 (int)strcspn(requestPtr, " "), requestPtr,
+                 (LE_OK == result) ? reply : LE_RESULT_TXT(result));
+        return LE_FAULT;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the reply of STA-FIRST or STA-NEXT: the station MAC address followed by
+ * "name=value" lines.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseStation
+(
+    char *replyPtr,
+    const char *ifNamePtr,
+    pa_wifiAp_Station_t *stationPtr
+)
+{
+    char *savePtr = NULL;
+    char *linePtr = strtok_r(replyPtr, "\n", &savePtr);
+
+    memset(stationPtr, 0, sizeof(pa_wifiAp_Station_t));
+    le_utf8_Copy(stationPtr->macAddress, linePtr, sizeof(stationPtr->macAddress), NULL);
+    le_utf8_Copy(stationPtr->ifName, ifNamePtr, sizeof(stationPtr->ifName), NULL);
+
+    while (NULL != (linePtr = strtok_r(NULL, "\n", &savePtr)))
+    {
+        char *valuePtr = strchr(linePtr, '=');
+
+        if (NULL == valuePtr)
+        {
+            continue;
+        }
+        *valuePtr++ = '\0';
+
+        if (0 == strcmp(linePtr, "connected_time"))
+        {
+            stationPtr->connectedSec = (uint32_t)strtoul(valuePtr, NULL, 10);
+        }
+        else if (0 == strcmp(linePtr, "inactive_msec"))
+        {
+            stationPtr->inactiveMs = (uint32_t)strtoul(valuePtr, NULL, 10);
+        }
+        else if (0 == strcmp(linePtr, "signal"))
+        {
+            stationPtr->signal = (int8_t)strtol(valuePtr, NULL, 10);
+        }
+        else if (0 == strcmp(linePtr, "rx_bytes"))
+        {
+            stationPtr->rxBytes = strtoull(valuePtr, NULL, 10);
+        }
+        else if (0 == strcmp(linePtr, "tx_bytes"))
+        {
+            stationPtr->txBytes = strtoull(valuePtr, NULL, 10);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request to hostapd and get its reply.
+ *
+ * @return
+ *      - LE_OK             The reply is returned.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_TIMEOUT        hostapd did not reply.
+ *      - LE_FAULT          The request could not be sent.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Request
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *requestPtr,
+        ///< [IN]
+        ///< Request (ex: "STA-FIRST").
+    char *replyPtr,
+        ///< [OUT]
+        ///< Reply, null-terminated.
+    size_t replySize
+        ///< [IN]
+        ///< Size of the reply buffer.
+)
+{
+    struct sockaddr_un localAddr;
+    struct sockaddr_un hostapdAddr;
+    le_result_t        result = LE_FAULT;
+    int                fd;
+
+    if ((NULL == replyPtr) || (0 == replySize))
+    {
+        return LE_FAULT;
+    }
+    replyPtr[0] = '\0';
+
+    memset(&hostapdAddr, 0, sizeof(hostapdAddr));
+    hostapdAddr.sun_family = AF_UNIX;
+    snprintf(hostapdAddr.sun_path, sizeof(hostapdAddr.sun_path), "%s/%s",
+             HOSTAPD_CTRL_DIR, ifNamePtr);
+    if (0 != access(hostapdAddr.sun_path, F_OK))
+    {
+        LE_DEBUG("No hostapd control socket %s", hostapdAddr.sun_path);
+        return LE_UNAVAILABLE;
+    }
+
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to open socket, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+        return LE_FAULT;
+    }
+
+    // hostapd replies to the address of the sender, so the socket must be bound.
+    memset(&localAddr, 0, sizeof(localAddr));
+    localAddr.sun_family = AF_UNIX;
+    snprintf(localAddr.sun_path, sizeof(localAddr.sun_path), LOCAL_SOCKET_PATH_FORMAT,
+             (int)getpid(), RequestCount++);
+    unlink(localAddr.sun_path);
+
+    if (-1 == bind(fd, (struct sockaddr *)&localAddr, sizeof(localAddr)))
+    {
+        LE_ERROR("Unable to bind %s, errno %d (%s)",
+                 localAddr.sun_path, errno, LE_ERRNO_TXT(errno));
+        close(fd);
+        return LE_FAULT;
+    }
+
+    if (-1 == connect(fd, (struct sockaddr *)&hostapdAddr, sizeof(hostapdAddr)))
+    {
+        LE_ERROR("Unable to connect to %s, errno %d (%s)",
+                 hostapdAddr.sun_path, errno, LE_ERRNO_TXT(errno));
+        result = ((ECONNREFUSED == errno) || (ENOENT == errno)) ? LE_UNAVAILABLE : LE_FAULT;
+        goto end;
+    }
+
+    if (-1 == send(fd, requestPtr, strlen(requestPtr), 0))
+    {
+        LE_ERROR("Unable to send hostapd request, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+        goto end;
+    }
+
+    for (;;)
+    {
+        struct pollfd pollFd = { fd, POLLIN, 0 };
+        ssize_t       length;
+        int           pollResult = poll(&pollFd, 1, REPLY_TIMEOUT_MS);
+
+        if ((-1 == pollResult) && (EINTR == errno))
+        {
+            continue;
+        }
+        if (pollResult <= 0)
+        {
+            LE_ERROR("No reply from hostapd to \"%.*s\"",
+                     (int)strcspn(requestPtr, " "), requestPtr);
+            result = LE_TIMEOUT;
+            break;
+        }
+
+        length = recv(fd, replyPtr, replySize - 1, 0);
+        if (-1 == length)
+        {
+            LE_ERROR("Unable to receive hostapd reply, errno %d (%s)",
+                     errno, LE_ERRNO_TXT(errno));
+            break;
+        }
+        replyPtr[length] = '\0';
+
+        // Skip the unsolicited messages.
+        if ((length > 0) && ('<' == replyPtr[0]))
+        {
+            continue;
+        }
+        result = LE_OK;
+        break;
+    }
+
+end:
+    close(fd);
+    unlink(localAddr.sun_path);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a configuration parameter of the running hostapd (SET). Most parameters only take effect
+ * after pa_wifiHostapd_Reload().
+ *
+ * @return
+ *      - LE_OK             The parameter is set.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          hostapd rejected the parameter or did not reply.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Set
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *namePtr,
+        ///< [IN]
+        ///< Parameter name, as in hostapd.conf.
+    const char *valuePtr
+        ///< [IN]
+        ///< Parameter value.
+)
+{
+    char request[REQUEST_MAX_BYTES];
+
+    if (snprintf(request, sizeof(request), "SET %s %s", namePtr, valuePtr) >=
+        (int)sizeof(request))
+    {
+        LE_ERROR("Value of %s too long", namePtr);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("hostapd SET %s", namePtr);
+    return RequestOk(ifNamePtr, request);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the configuration changes to the beacon only (UPDATE_BEACON), without disconnecting the
+ * stations. Falls back to pa_wifiHostapd_Reload() if hostapd does not support it.
+ *
+ * @return
+ *      - LE_OK             The beacon is updated.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The update failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_UpdateBeacon
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+)
+{
+    char        reply[PA_WIFIHOSTAPD_REPLY_MAX_BYTES];
+    le_result_t result = pa_wifiHostapd_Request(ifNamePtr, "UPDATE_BEACON", reply, sizeof(reply));
+
+    if (LE_OK != result)
+    {
+        return (LE_UNAVAILABLE == result) ? LE_UNAVAILABLE : LE_FAULT;
+    }
+    if (0 == strncmp(reply, "OK", 2))
+    {
+        return LE_OK;
+    }
+    if (0 == strncmp(reply, "UNKNOWN COMMAND", 15))
+    {
+        LE_INFO("hostapd does not support UPDATE_BEACON, reloading");
+        return pa_wifiHostapd_Reload(ifNamePtr);
+    }
+
+    LE_ERROR("hostapd request \"UPDATE_BEACON\" failed: %s", reply);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply the configuration changes (RELOAD). The associated stations are disconnected.
+ *
+ * @return
+ *      - LE_OK             The configuration is applied.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The reload failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Reload
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+)
+{
+    return RequestOk(ifNamePtr, "RELOAD");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stations known by hostapd (STA-FIRST, STA-NEXT).
+ *
+ * The handler is called for each station before the function returns.
+ *
+ * @return
+ *      - LE_OK             The stations are returned.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          A request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_GetStations
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each station.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+)
+{
+    char                reply[PA_WIFIHOSTAPD_REPLY_MAX_BYTES];
+    char                request[REQUEST_MAX_BYTES] = "STA-FIRST";
+    pa_wifiAp_Station_t station;
+    le_result_t         result;
+
+    for (;;)
+    {
+        result = pa_wifiHostapd_Request(ifNamePtr, request, reply, sizeof(reply));
+        if (LE_OK != result)
+        {
+            return (LE_UNAVAILABLE == result) ? LE_UNAVAILABLE : LE_FAULT;
+        }
+
+        // An empty reply or FAIL ends the list.
+        if (('\0' == reply[0]) || (0 == strncmp(reply, "FAIL", 4)))
+        {
+            return LE_OK;
+        }
+
+        ParseStation(reply, ifNamePtr, &station);
+        handlerPtr(&station, contextPtr);
+
+        snprintf(request, sizeof(request), "STA-NEXT %s", station.macAddress);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a station is known by hostapd on an interface (STA).
+ *
+ * @return
+ *      - LE_OK             The station is known.
+ *      - LE_NOT_FOUND      The station is not known.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_HasStation
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< Station MAC address.
+)
+{
+    char        reply[PA_WIFIHOSTAPD_REPLY_MAX_BYTES];
+    char        request[REQUEST_MAX_BYTES];
+    le_result_t result;
+
+    snprintf(request, sizeof(request), "STA %s", macAddressPtr);
+    result = pa_wifiHostapd_Request(ifNamePtr, request, reply, sizeof(reply));
+    if (LE_OK != result)
+    {
+        return (LE_UNAVAILABLE == result) ? LE_UNAVAILABLE : LE_FAULT;
+    }
+
+    // Same as STA-FIRST: an empty reply or FAIL for an unknown station.
+    if (('\0' == reply[0]) || (0 == strncmp(reply, "FAIL", 4)))
+    {
+        return LE_NOT_FOUND;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deauthenticate a station (DEAUTHENTICATE).
+ *
+ * @return
+ *      - LE_OK             The station is deauthenticated.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Deauthenticate
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    const char *macAddressPtr,
+        ///< [IN]
+        ///< Station MAC address.
+    uint16_t reason
+        ///< [IN]
+        ///< IEEE 802.11 reason code, 0 for hostapd's default.
+)
+{
+    char request[REQUEST_MAX_BYTES];
+
+    if (0 == reason)
+    {
+        snprintf(request, sizeof(request), "DEAUTHENTICATE %s", macAddressPtr);
+    }
+    else
+    {
+        snprintf(request, sizeof(request), "DEAUTHENTICATE %s reason=%u", macAddressPtr,
+                 (unsigned int)reason);
+    }
+    return RequestOk(ifNamePtr, request);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a MAC address list of a running hostapd (ACCEPT_ACL, DENY_ACL), without disconnecting the
+ * stations. The file of the list must be updated as well, for the next reload.
+ *
+ * @return
+ *      - LE_OK             The list is updated.
+ *      - LE_UNSUPPORTED    hostapd does not support the request, a reload is needed.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_UpdateAcl
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiAcl_List_t list,
+        ///< [IN]
+        ///< MAC address list.
+    pa_wifiHostapd_AclAction_t action,
+        ///< [IN]
+        ///< Update of the list.
+    const char *macAddressPtr
+        ///< [IN]
+        ///< Station MAC address, ignored by PA_WIFIHOSTAPD_ACL_CLEAR.
+)
+{
+    static const char *const actionNames[] =
+    {
+        [PA_WIFIHOSTAPD_ACL_ADD]   = "ADD_MAC",
+        [PA_WIFIHOSTAPD_ACL_DEL]   = "DEL_MAC",
+        [PA_WIFIHOSTAPD_ACL_CLEAR] = "CLEAR",
+    };
+    const char *listNamePtr = (PA_WIFIACL_LIST_DENY == list) ? "DENY_ACL" : "ACCEPT_ACL";
+    char        reply[PA_WIFIHOSTAPD_REPLY_MAX_BYTES];
+    char        request[REQUEST_MAX_BYTES];
+    le_result_t result;
+
+    if (PA_WIFIHOSTAPD_ACL_CLEAR == action)
+    {
+        snprintf(request, sizeof(request), "%s CLEAR", listNamePtr);
+    }
+    else
+    {
+        snprintf(request, sizeof(request), "%s %s %s", listNamePtr, actionNames[action],
+                 macAddressPtr);
+    }
+
+    result = pa_wifiHostapd_Request(ifNamePtr, request, reply, sizeof(reply));
+    if (LE_OK != result)
+    {
+        return (LE_UNAVAILABLE == result) ? LE_UNAVAILABLE : LE_FAULT;
+    }
+    if (0 == strncmp(reply, "OK", 2))
+    {
+        return LE_OK;
+    }
+    if (0 == strncmp(reply, "UNKNOWN COMMAND", 15))
+    {
+        return LE_UNSUPPORTED;
+    }
+
+    LE_ERROR("hostapd request \"%s\" failed: %s", request, reply);
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Request hostapd to terminate (TERMINATE). The stations are deauthenticated, the driver and the
+ * interface are left as they are. The function does not wait for hostapd to exit: the caller
+ * waits on its process.
+ *
+ * @return
+ *      - LE_OK             hostapd is terminating.
+ *      - LE_UNAVAILABLE    hostapd is not running on this interface.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiHostapd_Terminate
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+)
+{
+    return RequestOk(ifNamePtr, "TERMINATE");
+}
@@ -0,0 +1,868 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter native commands
+ *
+ *  Same commands and exit codes as the PA script, run with ioctl(), sysfs and procfs. The board
+ *  specific parts are delegated to the PA script hooks.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_cmd.h"
+#include "pa_wifi_native.h"
+#include "pa_wifi_proc.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PA script hooks.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HOOK_INFO               "HW_INFO"           ///< Print the hardware parameters.
+#define HOOK_MODULE_LOAD        "HW_MODULE_LOAD"    ///< Board settings and driver loading.
+#define HOOK_MODULE_UNLOAD      "HW_MODULE_UNLOAD"  ///< Driver unloading and board settings revert.
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PA script command terminating wpa_supplicant.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMAND_CLIENT_DISCONNECT "WIFICLIENT_DISCONNECT"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exit codes of the commands, same as the PA script ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EXIT_OK                 0
+#define EXIT_NOT_FOUND          50      ///< Driver loaded but no interface: hardware absent.
+#define EXIT_NOT_POSSIBLE       100     ///< Interface can not be brought up, or driver not loaded.
+#define EXIT_ERROR              127
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval between two checks of the interface existence, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define IFACE_POLL_MS           100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay given to the hardware between the driver unloading and reloading on a reset, in ms. Same
+ * as the PA script.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SETTLE_MS               1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval between two checks of the driver after an interface loss, and time left to the driver
+ * unloading before the hardware is reported removed, in ms. The WiFi stops of the service are
+ * done by then, as they run on the thread checking the hardware status.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HWSTATUS_POLL_MS        20
+#define HWSTATUS_TIMEOUT_MS     200
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a command, of a module name and of the HW_INFO output.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMAND_MAX_BYTES       512
+#define MODULE_NAME_MAX_BYTES   64
+#define INFO_MAX_BYTES          512
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pid file of the iw event process, written by the WIFI_SET_EVENT command of the PA script, and
+ * time to wait for it to terminate, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define IW_EVENT_PID_FILE           "/var/run/wifi_iw_event.pid"
+#define IW_TERMINATE_TIMEOUT_MS     500
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Availability of the native commands, known once the PA script hooks have been queried.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    NATIVE_UNKNOWN,     ///< PA script not queried yet.
+    NATIVE_ENABLED,     ///< PA script provides the hooks.
+    NATIVE_DISABLED     ///< All commands run in the PA script.
+}
+NativeState_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hardware parameters given by the HW_INFO hook.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char ifName[IF_NAMESIZE];               ///< WLAN interface.
+    char apIfName[IF_NAMESIZE];             ///< Virtual interface of the access point, optional.
+    char module[MODULE_NAME_MAX_BYTES];     ///< Driver module, as listed in /sys/module.
+    int  ifaceTimeout;                      ///< Seconds to wait for the interface after loading.
+    int  resetRetries;                      ///< Driver reloads when the interface stays down.
+}
+HwInfo_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Native command.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char *namePtr;                    ///< PA script command.
+    int (*func)(const char *argPtr);        ///< Native implementation, returns the exit code.
+}
+NativeCommand_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the hook query.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t NativeMutex = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Native commands availability.
+ */
+//--------------------------------------------------------------------------------------------------
+static NativeState_t NativeState = NATIVE_UNKNOWN;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hardware parameters, valid once NativeState is NATIVE_ENABLED.
+ */
+//--------------------------------------------------------------------------------------------------
+static HwInfo_t HwInfo;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sleep for some milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SleepMs
+(
+    int delayMs
+)
+{
+    struct timespec delay = { delayMs / 1000, (delayMs % 1000) * 1000000L };
+
+    while ((nanosleep(&delay, &delay) < 0) && (EINTR == errno))
+    {
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script hook or command.
+ *
+ * @return The exit code, EXIT_ERROR if the script did not exit normally.
+ */
+//--------------------------------------------------------------------------------------------------
+static int RunScript
+(
+    const char *commandPtr,
+    char *outputPtr,
+    size_t outputSize
+)
+{
+    int status = pa_wifiCmd_Run(commandPtr, outputPtr, outputSize);
+
+    if ((-1 == status) || !WIFEXITED(status))
+    {
+        return EXIT_ERROR;
+    }
+    return WEXITSTATUS(status);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the driver module is loaded.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsModuleLoaded
+(
+    void
+)
+{
+    char        path[PATH_MAX];
+    struct stat st;
+
+    snprintf(path, sizeof(path), "/sys/module/%s", HwInfo.module);
+    return (0 == stat(path, &st)) && S_ISDIR(st.st_mode);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the flags of a WLAN interface.
+ *
+ * @return
+ *      - LE_OK             The flags are read.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The flags could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetInterfaceFlags
+(
+    const char *ifNamePtr,
+    short *flagsPtr
+)
+{
+    struct ifreq ifr;
+    le_result_t  result = LE_OK;
+    int          sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (sock < 0)
+    {
+        LE_ERROR("socket failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        return LE_FAULT;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    le_utf8_Copy(ifr.ifr_name, ifNamePtr, sizeof(ifr.ifr_name), NULL);
+    if (ioctl(sock, SIOCGIFFLAGS, &ifr) < 0)
+    {
+        result = (ENODEV == errno) ? LE_NOT_FOUND : LE_FAULT;
+    }
+    else
+    {
+        *flagsPtr = ifr.ifr_flags;
+    }
+
+    close(sock);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bring a WLAN interface up or down, optionally setting its IPv4 address first.
+ *
+ * @return
+ *      - LE_OK             The interface is configured.
+ *      - LE_FAULT          The interface could not be configured.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetInterface
+(
+    const char *ifNamePtr,
+    bool isUp,
+    const struct in_addr *addrPtr
+)
+{
+    struct ifreq ifr;
+    le_result_t  result = LE_FAULT;
+    int          sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (sock < 0)
+    {
+        LE_ERROR("socket failed errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        return LE_FAULT;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    le_utf8_Copy(ifr.ifr_name, ifNamePtr, sizeof(ifr.ifr_name), NULL);
+
+    if (NULL != addrPtr)
+    {
+        struct sockaddr_in *sinPtr = (struct sockaddr_in *)&ifr.ifr_addr;
+
+        // As ifconfig, the netmask is set by the kernel from the address class.
+        sinPtr->sin_family = AF_INET;
+        sinPtr->sin_addr = *addrPtr;
+        if (ioctl(sock, SIOCSIFADDR, &ifr) < 0)
+        {
+            LE_ERROR("%s: SIOCSIFADDR failed errno:%d %s",
+                     ifNamePtr, errno, LE_ERRNO_TXT(errno));
+            goto out;
+        }
+    }
+
+    if (ioctl(sock, SIOCGIFFLAGS, &ifr) < 0)
+    {
+        LE_ERROR("%s: SIOCGIFFLAGS failed errno:%d %s", ifNamePtr, errno, LE_ERRNO_TXT(errno));
+        goto out;
+    }
+
+    if (isUp)
+    {
+        ifr.ifr_flags |= IFF_UP;
+    }
+    else
+    {
+        ifr.ifr_flags &= ~IFF_UP;
+    }
+
+    if (ioctl(sock, SIOCSIFFLAGS, &ifr) < 0)
+    {
+        LE_ERROR("%s: SIOCSIFFLAGS failed errno:%d %s", ifNamePtr, errno, LE_ERRNO_TXT(errno));
+        goto out;
+    }
+
+    result = LE_OK;
+
+out:
+    close(sock);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a WLAN interface is up.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInterfaceUp
+(
+    const char *ifNamePtr
+)
+{
+    short flags;
+
+    return (LE_OK == GetInterfaceFlags(ifNamePtr, &flags)) && (flags & IFF_UP);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the WLAN interface to be created by the driver.
+ *
+ * @return true if the interface exists.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WaitInterface
+(
+    void
+)
+{
+    int pollCount = (HwInfo.ifaceTimeout * 1000) / IFACE_POLL_MS;
+
+    while (0 == if_nametoindex(HwInfo.ifName))
+    {
+        if (pollCount-- <= 0)
+        {
+            return false;
+        }
+        SleepMs(IFACE_POLL_MS);
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the running processes whose program is namePtr and, if argPtr is not NULL, with an argument
+ * containing argPtr. Zombies are ignored.
+ *
+ * @return Number of processes found, only the first maxCount ones are stored.
+ */
+//--------------------------------------------------------------------------------------------------
+static int FindProcesses
+(
+    const char *namePtr,
+    const char *argPtr,
+    pid_t *pidsPtr,
+    int maxCount
+)
+{
+    DIR           *dirPtr = opendir("/proc");
+    struct dirent *entryPtr;
+    int            count = 0;
+
+    if (NULL == dirPtr)
+    {
+        LE_ERROR("Unable to open /proc errno:%d %s", errno, LE_ERRNO_TXT(errno));
+        return 0;
+    }
+
+    while (NULL != (entryPtr = readdir(dirPtr)))
+    {
+        char    path[PATH_MAX];
+        char    cmdline[COMMAND_MAX_BYTES];
+        char    state = 'Z';
+        char   *progPtr;
+        ssize_t length;
+        bool    isMatch;
+        int     fd;
+        FILE   *statPtr;
+
+        if ((entryPtr->d_name[0] < '0') || (entryPtr->d_name[0] > '9'))
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/proc/%s/stat", entryPtr->d_name);
+        statPtr = fopen(path, "re");
+        if (NULL == statPtr)
+        {
+            continue;
+        }
+        // Format: pid (comm) state ...
+        if (1 != fscanf(statPtr, "%*d (%*[^)]) %c", &state))
+        {
+            state = 'Z';
+        }
+        fclose(statPtr);
+        if ('Z' == state)
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/proc/%s/cmdline", entryPtr->d_name);
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+        length = read(fd, cmdline, sizeof(cmdline) - 1);
+        close(fd);
+        if (length <= 0)
+        {
+            continue;
+        }
+        cmdline[length] = '\0';
+
+        // The arguments are separated by null characters.
+        progPtr = strrchr(cmdline, '/');
+        progPtr = (NULL == progPtr) ? cmdline : progPtr + 1;
+        isMatch = (0 == strcmp(progPtr, namePtr));
+        if (isMatch && (NULL != argPtr))
+        {
+            char *nextPtr = cmdline + strlen(cmdline) + 1;
+
+            isMatch = false;
+            while ((nextPtr < (cmdline + length)) && !isMatch)
+            {
+                isMatch = (NULL != strstr(nextPtr, argPtr));
+                nextPtr += strlen(nextPtr) + 1;
+            }
+        }
+
+        if (isMatch)
+        {
+            if (count < maxCount)
+            {
+                pidsPtr[count] = (pid_t)atoi(entryPtr->d_name);
+            }
+            count++;
+        }
+    }
+
+    closedir(dirPtr);
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the driver, wait for the interface and bring it up.
+ *
+ * @return The exit code of WIFI_START.
+ */
+//--------------------------------------------------------------------------------------------------
+static int StartHardware
+(
+    void
+)
+{
+    if (EXIT_OK != RunScript(HOOK_MODULE_LOAD, NULL, 0))
+    {
+        LE_ERROR("Failed to load the WiFi driver");
+        return EXIT_ERROR;
+    }
+
+    if (!WaitInterface())
+    {
+        LE_ERROR("Failed to start WiFi, interface %s does not exist", HwInfo.ifName);
+        return IsModuleLoaded() ? EXIT_NOT_FOUND : EXIT_ERROR;
+    }
+
+    if (LE_OK != SetInterface(HwInfo.ifName, true, NULL))
+    {
+        LE_ERROR("Failed to start WiFi, interface %s can not be brought up", HwInfo.ifName);
+        return EXIT_NOT_POSSIBLE;
+    }
+
+    return EXIT_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WIFI_START: start the hardware, reloading the driver if the firmware failed to boot.
+ */
+//--------------------------------------------------------------------------------------------------
+static int WifiStart
+(
+    const char *argPtr
+)
+{
+    int retries = HwInfo.resetRetries;
+    int code;
+
+    while ((EXIT_NOT_POSSIBLE == (code = StartHardware())) && (retries-- > 0))
+    {
+        LE_WARN("WiFi reset");
+        RunScript(HOOK_MODULE_UNLOAD, NULL, 0);
+        SleepMs(SETTLE_MS);
+    }
+
+    if (EXIT_OK != code)
+    {
+        LE_WARN("Clean up after start failure %d", code);
+        RunScript(HOOK_MODULE_UNLOAD, NULL, 0);
+    }
+    return code;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WIFI_STOP: terminate wpa_supplicant, bring the interface down and unload the driver.
+ */
+//--------------------------------------------------------------------------------------------------
+static int WifiStop
+(
+    const char *argPtr
+)
+{
+    pid_t pid;
+    short flags;
+
+    if (FindProcesses("wpa_supplicant", HwInfo.ifName, &pid, 1) > 0)
+    {
+        RunScript(COMMAND_CLIENT_DISCONNECT, NULL, 0);
+    }
+
+    if ((LE_OK == GetInterfaceFlags(HwInfo.ifName, &flags)) && (flags & IFF_UP))
+    {
+        SetInterface(HwInfo.ifName, false, NULL);
+    }
+
+    return (EXIT_OK == RunScript(HOOK_MODULE_UNLOAD, NULL, 0)) ? EXIT_OK : EXIT_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WIFI_CHECK_HWSTATUS: tell why the interface went down.
+ *
+ * Instead of the fixed delay of the PA script, the driver is polled until it is unloaded or
+ * HWSTATUS_TIMEOUT_MS elapsed.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CheckHwStatus
+(
+    const char *argPtr
+)
+{
+    int waitedMs = 0;
+
+    // Client request disconnection if interface is up
+    while (!IsInterfaceUp(HwInfo.ifName))
+    {
+        // Driver removed: WiFi stop called.
+        if (!IsModuleLoaded())
+        {
+            return EXIT_NOT_POSSIBLE;
+        }
+        // Driver stays: hardware removed.
+        if (waitedMs >= HWSTATUS_TIMEOUT_MS)
+        {
+            return EXIT_NOT_FOUND;
+        }
+        SleepMs(HWSTATUS_POLL_MS);
+        waitedMs += HWSTATUS_POLL_MS;
+    }
+    return EXIT_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WIFI_UNSET_EVENT: terminate the iw event process started by WIFI_SET_EVENT. The other iw
+ * processes of the system are left running.
+ */
+//--------------------------------------------------------------------------------------------------
+static int UnsetEvent
+(
+    const char *argPtr
+)
+{
+    pid_t       pid;
+    le_result_t result = pa_wifiProc_ReadPidFile(IW_EVENT_PID_FILE, "iw", &pid);
+
+    if (LE_OK == result)
+    {
+        result = pa_wifiProc_Stop(pid, IW_TERMINATE_TIMEOUT_MS);
+        if (LE_OK != result)
+        {
+            LE_ERROR("iw event process %d still running", (int)pid);
+            return EXIT_ERROR;
+        }
+    }
+    else if (LE_NOT_FOUND == result)
+    {
+        LE_DEBUG("No iw event process running");
+    }
+
+    remove(IW_EVENT_PID_FILE);
+    return (LE_FAULT == result) ? EXIT_ERROR : EXIT_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * WIFIAP_WLAN_UP: set the address of the access point interface, which must be up. The interface
+ * follows the address, the WLAN interface if it is not given.
+ */
+//--------------------------------------------------------------------------------------------------
+static int WlanUp
+(
+    const char *argPtr
+)
+{
+    char           address[INET_ADDRSTRLEN];
+    const char    *ifNamePtr = HwInfo.ifName;
+    struct in_addr addr;
+    size_t         length;
+
+    if (NULL == argPtr)
+    {
+        LE_ERROR("Invalid IP address");
+        return EXIT_ERROR;
+    }
+
+    length = strcspn(argPtr, " ");
+    if ('\0' != argPtr[length])
+    {
+        ifNamePtr = argPtr + length + 1;
+    }
+
+    if (length >= sizeof(address))
+    {
+        LE_ERROR("Invalid IP address");
+        return EXIT_ERROR;
+    }
+    memcpy(address, argPtr, length);
+    address[length] = '\0';
+
+    if (1 != inet_pton(AF_INET, address, &addr))
+    {
+        LE_ERROR("Invalid IP address");
+        return EXIT_ERROR;
+    }
+
+    if (!IsInterfaceUp(ifNamePtr))
+    {
+        LE_ERROR("Interface %s is not up", ifNamePtr);
+        return EXIT_ERROR;
+    }
+
+    return (LE_OK == SetInterface(ifNamePtr, true, &addr)) ? EXIT_OK : EXIT_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Native commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static const NativeCommand_t NativeCommands[] =
+{
+    { "WIFI_START",             WifiStart },
+    { "WIFI_STOP",              WifiStop },
+    { "WIFI_CHECK_HWSTATUS",    CheckHwStatus },
+    { "WIFI_UNSET_EVENT",       UnsetEvent },
+    { "WIFIAP_WLAN_UP",         WlanUp },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Query the hardware parameters from the PA script, once.
+ *
+ * @return true if the native commands can be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsNativeEnabled
+(
+    void
+)
+{
+    char  info[INFO_MAX_BYTES];
+    char *savePtr = NULL;
+
+    le_mutex_Lock(NativeMutex);
+
+    if (NATIVE_UNKNOWN == NativeState)
+    {
+        NativeState = NATIVE_DISABLED;
+        memset(&HwInfo, 0, sizeof(HwInfo));
+
+        if (EXIT_OK == RunScript(HOOK_INFO, info, sizeof(info)))
+        {
+            for (char *linePtr = strtok_r(info, "\n", &savePtr);
+                 NULL != linePtr;
+                 linePtr = strtok_r(NULL, "\n", &savePtr))
+            {
+                char *valuePtr = strchr(linePtr, '=');
+
+                if (NULL == valuePtr)
+                {
+                    continue;
+                }
+                *valuePtr++ = '\0';
+
+                if (0 == strcmp(linePtr, "IFACE"))
+                {
+                    le_utf8_Copy(HwInfo.ifName, valuePtr, sizeof(HwInfo.ifName), NULL);
+                }
+                else if (0 == strcmp(linePtr, "AP_IFACE"))
+                {
+                    le_utf8_Copy(HwInfo.apIfName, valuePtr, sizeof(HwInfo.apIfName), NULL);
+                }
+                else if (0 == strcmp(linePtr, "MODULE"))
+                {
+                    le_utf8_Copy(HwInfo.module, valuePtr, sizeof(HwInfo.module), NULL);
+                }
+                else if (0 == strcmp(linePtr, "IFACE_TIMEOUT"))
+                {
+                    HwInfo.ifaceTimeout = atoi(valuePtr);
+                }
+                else if (0 == strcmp(linePtr, "RESET_RETRIES"))
+                {
+                    HwInfo.resetRetries = atoi(valuePtr);
+                }
+            }
+        }
+
+        if (('\0' != HwInfo.ifName[0]) && ('\0' != HwInfo.module[0]))
+        {
+            LE_INFO("Native PA commands on %s, driver %s", HwInfo.ifName, HwInfo.module);
+            NativeState = NATIVE_ENABLED;
+        }
+        else
+        {
+            LE_INFO("PA script has no hardware hooks, all commands run in the script");
+        }
+    }
+
+    le_mutex_Unlock(NativeMutex);
+
+    return (NATIVE_ENABLED == NativeState);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the native commands. Can be called several times.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_wifiNative_Init
+(
+    void
+)
+{
+    if (NULL == NativeMutex)
+    {
+        NativeMutex = le_mutex_CreateNonRecursive("WifiPaNative");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the WLAN interface given by the HW_INFO hook. Can be called from any thread.
+ *
+ * @return The interface name, or NULL if the PA script does not give it.
+ */
+//--------------------------------------------------------------------------------------------------
+const char *pa_wifiNative_GetInterface
+(
+    void
+)
+{
+    IsNativeEnabled();
+    return ('\0' != HwInfo.ifName[0]) ? HwInfo.ifName : NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the virtual interface of the access point given by the HW_INFO hook. Can be called from any
+ * thread.
+ *
+ * @return The interface name, or NULL if the PA script does not give it.
+ */
+//--------------------------------------------------------------------------------------------------
+const char *pa_wifiNative_GetApInterface
+(
+    void
+)
+{
+    IsNativeEnabled();
+    return ('\0' != HwInfo.apIfName[0]) ? HwInfo.apIfName : NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a PA script command natively, if possible. Can be called from any thread.
+ *
+ * @return true if the command was run natively, false if it must be run by the PA script.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_wifiNative_Run
+(
+    const char *commandPtr,
+        ///< [IN]
+        ///< Command and its arguments, separated by spaces (ex: "WIFIAP_WLAN_UP 192.168.0.1").
+    int *statusPtr
+        ///< [OUT]
+        ///< Command status in the format of system(), set if the command was run natively.
+)
+{
+    char  command[COMMAND_MAX_BYTES];
+    char *argPtr;
+
+    if (LE_OK != le_utf8_Copy(command, commandPtr, sizeof(command), NULL))
+    {
+        return false;
+    }
+
+    argPtr = strchr(command, ' ');
+    if (NULL != argPtr)
+    {
+        *argPtr++ = '\0';
+    }
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(NativeCommands); i++)
+    {
+        if (0 == strcmp(command, NativeCommands[i].namePtr))
+        {
+            int code;
+
+            // The hooks are not native commands, so the query does not come back here.
+            if (!IsNativeEnabled())
+            {
+                return false;
+            }
+
+            code = NativeCommands[i].func(argPtr);
+            LE_DEBUG("Native command \"%s\" exit %d", commandPtr, code);
+
+            // Same encoding as a normal exit in a wait status.
+            *statusPtr = (code & 0xff) << 8;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,1378 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter nl80211 requests
+ *
+ *  Minimal generic netlink client: the nl80211 family id and its scan multicast group are resolved
+ *  once through the generic netlink controller, then each request opens its own socket. The
+ *  functions are called from the main thread only.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <linux/nl80211.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_nl80211.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of the attributes of a request.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REQUEST_ATTRIBUTES_MAX_BYTES    64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of the receive buffer. A dump message holds at most one page of attributes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECEIVE_BUFFER_BYTES            16384
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum time to wait for a response, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECEIVE_TIMEOUT_SEC             1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generic netlink request.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    struct nlmsghdr   header;                                   ///< Netlink header.
+    struct genlmsghdr genHeader;                                ///< Generic netlink header.
+    char              attributes[REQUEST_ATTRIBUTES_MAX_BYTES]; ///< Attributes.
+}
+Request_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of a response message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*MessageHandlerFunc_t)
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context of a station dump.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char                    *ifNamePtr;   ///< Interface name.
+    pa_wifiAp_StationHandlerFunc_t handlerPtr;  ///< Handler called for each station.
+    void                          *contextPtr;  ///< Handler context.
+}
+StationDump_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context of a scan results dump.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiNl80211_BssHandlerFunc_t handlerPtr; ///< Handler called for each BSS.
+    void                           *contextPtr; ///< Handler context.
+}
+ScanDump_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context of a survey dump.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_wifiNl80211_SurveyHandlerFunc_t handlerPtr;  ///< Handler called for each channel.
+    void                              *contextPtr;  ///< Handler context.
+}
+SurveyDump_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context of a wiphy request.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    enum nl80211_band                     band;         ///< Band to get.
+    bool                                  isFound;      ///< The radio supports the band.
+    pa_wifiNl80211_BandCapa_t            *capaPtr;      ///< Capabilities of the band, or NULL.
+    pa_wifiNl80211_FrequencyHandlerFunc_t handlerPtr;   ///< Frequency handler, or NULL.
+    void                                 *contextPtr;   ///< Frequency handler context.
+}
+WiphyRequest_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generic netlink family id of nl80211, -1 until resolved.
+ */
+//--------------------------------------------------------------------------------------------------
+static int FamilyId = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Multicast group id of the nl80211 scan events, 0 if unknown.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ScanGroupId = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the last request.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SequenceNumber = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static char ReceiveBuffer[RECEIVE_BUFFER_BYTES] __attribute__((aligned(NLMSG_ALIGNTO)));
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the payload of an attribute.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ATTRIBUTE_DATA(attrPtr)     ((const char *)(attrPtr) + NLA_HDRLEN)
+#define ATTRIBUTE_LENGTH(attrPtr)   ((int)(attrPtr)->nla_len - NLA_HDRLEN)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an unsigned attribute of up to 64 bits. Attributes are only 4-byte aligned.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetUnsignedAttribute
+(
+    const struct nlattr *attrPtr
+)
+{
+    uint8_t  value8;
+    uint16_t value16;
+    uint32_t value32;
+    uint64_t value64;
+
+    switch (ATTRIBUTE_LENGTH(attrPtr))
+    {
+        case sizeof(value8):
+            memcpy(&value8, ATTRIBUTE_DATA(attrPtr), sizeof(value8));
+            return value8;
+        case sizeof(value16):
+            memcpy(&value16, ATTRIBUTE_DATA(attrPtr), sizeof(value16));
+            return value16;
+        case sizeof(value32):
+            memcpy(&value32, ATTRIBUTE_DATA(attrPtr), sizeof(value32));
+            return value32;
+        case sizeof(value64):
+            memcpy(&value64, ATTRIBUTE_DATA(attrPtr), sizeof(value64));
+            return value64;
+        default:
+            return 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index a list of attributes by type. The attributes whose type is above maxType are ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseAttributes
+(
+    const struct nlattr **tablePtr,
+    int maxType,
+    const void *dataPtr,
+    int length
+)
+{
+    const struct nlattr *attrPtr = dataPtr;
+
+    memset(tablePtr, 0, (maxType + 1) * sizeof(*tablePtr));
+
+    while ((length >= NLA_HDRLEN) &&
+           (attrPtr->nla_len >= NLA_HDRLEN) &&
+           (attrPtr->nla_len <= length))
+    {
+        int type = attrPtr->nla_type & NLA_TYPE_MASK;
+
+        if (type <= maxType)
+        {
+            tablePtr[type] = attrPtr;
+        }
+        length -= NLA_ALIGN(attrPtr->nla_len);
+        attrPtr = (const struct nlattr *)((const char *)attrPtr + NLA_ALIGN(attrPtr->nla_len));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitRequest
+(
+    Request_t *requestPtr,
+    uint16_t type,
+    uint16_t flags,
+    uint8_t command,
+    uint8_t version
+)
+{
+    memset(requestPtr, 0, sizeof(Request_t));
+    requestPtr->header.nlmsg_len   = NLMSG_LENGTH(GENL_HDRLEN);
+    requestPtr->header.nlmsg_type  = type;
+    requestPtr->header.nlmsg_flags = NLM_F_REQUEST | flags;
+    requestPtr->header.nlmsg_seq   = ++SequenceNumber;
+    requestPtr->genHeader.cmd      = command;
+    requestPtr->genHeader.version  = version;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append an attribute to a request. A flag attribute has no data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddAttribute
+(
+    Request_t *requestPtr,
+    uint16_t type,
+    const void *dataPtr,
+    uint16_t length
+)
+{
+    struct nlattr *attrPtr = (struct nlattr *)((char *)requestPtr +
+                                               NLMSG_ALIGN(requestPtr->header.nlmsg_len));
+
+    LE_ASSERT(NLMSG_ALIGN(requestPtr->header.nlmsg_len) + NLA_HDRLEN + NLA_ALIGN(length) <=
+              sizeof(Request_t));
+
+    attrPtr->nla_type = type;
+    attrPtr->nla_len  = NLA_HDRLEN + length;
+    if (0 != length)
+    {
+        memcpy((char *)attrPtr + NLA_HDRLEN, dataPtr, length);
+    }
+    requestPtr->header.nlmsg_len = NLMSG_ALIGN(requestPtr->header.nlmsg_len) +
+                                   NLA_ALIGN(attrPtr->nla_len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a generic netlink socket.
+ *
+ * @return The socket, or -1 on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenSocket
+(
+    void
+)
+{
+    struct timeval timeout = { RECEIVE_TIMEOUT_SEC, 0 };
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to open generic netlink socket, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+        return -1;
+    }
+
+    if (-1 == setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)))
+    {
+        LE_WARN("Unable to set netlink receive timeout, errno %d (%s)",
+                errno, LE_ERRNO_TXT(errno));
+    }
+    return fd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request and pass the messages of its response to a handler, up to the end of a dump or
+ * the acknowledgement.
+ *
+ * @return
+ *      - LE_OK             The request succeeded.
+ *      - LE_NOT_FOUND      The kernel returned ENODEV or ENOENT.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendRequest
+(
+    int fd,
+    Request_t *requestPtr,
+    MessageHandlerFunc_t handlerFunc,
+    void *contextPtr
+)
+{
+    struct sockaddr_nl kernelAddr;
+
+    memset(&kernelAddr, 0, sizeof(kernelAddr));
+    kernelAddr.nl_family = AF_NETLINK;
+
+    if (-1 == sendto(fd, requestPtr, requestPtr->header.nlmsg_len, 0,
+                     (struct sockaddr *)&kernelAddr, sizeof(kernelAddr)))
+    {
+        LE_ERROR("Unable to send netlink request, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+        return LE_FAULT;
+    }
+
+    for (;;)
+    {
+        ssize_t length = recv(fd, ReceiveBuffer, sizeof(ReceiveBuffer), 0);
+        const struct nlmsghdr *headerPtr;
+
+        if (-1 == length)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Unable to receive netlink response, errno %d (%s)",
+                     errno, LE_ERRNO_TXT(errno));
+            return LE_FAULT;
+        }
+
+        for (headerPtr = (const struct nlmsghdr *)ReceiveBuffer;
+             NLMSG_OK(headerPtr, length);
+             headerPtr = NLMSG_NEXT(headerPtr, length))
+        {
+            if (headerPtr->nlmsg_seq != requestPtr->header.nlmsg_seq)
+            {
+                continue;
+            }
+
+            if (NLMSG_DONE == headerPtr->nlmsg_type)
+            {
+                return LE_OK;
+            }
+
+            if (NLMSG_ERROR == headerPtr->nlmsg_type)
+            {
+                const struct nlmsgerr *errorPtr = NLMSG_DATA(headerPtr);
+
+                if (0 == errorPtr->error)
+                {
+                    return LE_OK;
+                }
+                LE_ERROR("Netlink request %d failed, error %d (%s)",
+                         requestPtr->genHeader.cmd,
+                         -errorPtr->error,
+                         LE_ERRNO_TXT(-errorPtr->error));
+                return ((-ENODEV == errorPtr->error) || (-ENOENT == errorPtr->error)) ?
+                       LE_NOT_FOUND : LE_FAULT;
+            }
+
+            if (NULL != handlerFunc)
+            {
+                handlerFunc(headerPtr, contextPtr);
+            }
+
+            if (!(headerPtr->nlmsg_flags & NLM_F_MULTI))
+            {
+                return LE_OK;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the family id from a CTRL_CMD_GETFAMILY response, and the id of the scan multicast group.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FamilyHandler
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+)
+{
+    const struct nlattr *attrs[CTRL_ATTR_MCAST_GROUPS + 1];
+
+    ParseAttributes(attrs, CTRL_ATTR_MCAST_GROUPS,
+                    (const char *)NLMSG_DATA(headerPtr) + GENL_HDRLEN,
+                    (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+
+    if (NULL != attrs[CTRL_ATTR_FAMILY_ID])
+    {
+        *(int *)contextPtr = (int)GetUnsignedAttribute(attrs[CTRL_ATTR_FAMILY_ID]);
+    }
+
+    if (NULL != attrs[CTRL_ATTR_MCAST_GROUPS])
+    {
+        // Nested list of groups, each one a nested list of name and id.
+        const struct nlattr *groupPtr = (const struct nlattr *)
+                                        ATTRIBUTE_DATA(attrs[CTRL_ATTR_MCAST_GROUPS]);
+        int length = ATTRIBUTE_LENGTH(attrs[CTRL_ATTR_MCAST_GROUPS]);
+
+        while ((length >= NLA_HDRLEN) &&
+               (groupPtr->nla_len >= NLA_HDRLEN) &&
+               (groupPtr->nla_len <= length))
+        {
+            const struct nlattr *groupAttrs[CTRL_ATTR_MCAST_GRP_MAX + 1];
+
+            ParseAttributes(groupAttrs, CTRL_ATTR_MCAST_GRP_MAX,
+                            ATTRIBUTE_DATA(groupPtr), ATTRIBUTE_LENGTH(groupPtr));
+            if ((NULL != groupAttrs[CTRL_ATTR_MCAST_GRP_NAME]) &&
+                (NULL != groupAttrs[CTRL_ATTR_MCAST_GRP_ID]) &&
+                (0 == strncmp(ATTRIBUTE_DATA(groupAttrs[CTRL_ATTR_MCAST_GRP_NAME]),
+                              NL80211_MULTICAST_GROUP_SCAN,
+                              ATTRIBUTE_LENGTH(groupAttrs[CTRL_ATTR_MCAST_GRP_NAME]))))
+            {
+                ScanGroupId = (uint32_t)GetUnsignedAttribute(groupAttrs[CTRL_ATTR_MCAST_GRP_ID]);
+            }
+            length -= NLA_ALIGN(groupPtr->nla_len);
+            groupPtr = (const struct nlattr *)((const char *)groupPtr +
+                                               NLA_ALIGN(groupPtr->nla_len));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resolve the nl80211 family id, once.
+ *
+ * @return LE_OK if the family id is known.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ResolveFamily
+(
+    int fd
+)
+{
+    Request_t request;
+    int       familyId = -1;
+
+    if (-1 != FamilyId)
+    {
+        return LE_OK;
+    }
+
+    InitRequest(&request, GENL_ID_CTRL, 0, CTRL_CMD_GETFAMILY, 1);
+    AddAttribute(&request, CTRL_ATTR_FAMILY_NAME, NL80211_GENL_NAME, sizeof(NL80211_GENL_NAME));
+
+    if ((LE_OK != SendRequest(fd, &request, FamilyHandler, &familyId)) || (-1 == familyId))
+    {
+        LE_ERROR("nl80211 family not found");
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("nl80211 family id %d", familyId);
+    FamilyId = familyId;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a NL80211_CMD_NEW_STATION message of a station dump.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StationHandler
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+)
+{
+    StationDump_t        *dumpPtr = contextPtr;
+    const struct nlattr  *attrs[NL80211_ATTR_STA_INFO + 1];
+    const struct nlattr  *infoAttrs[NL80211_STA_INFO_MAX + 1];
+    const uint8_t        *macPtr;
+    pa_wifiAp_Station_t   station;
+
+    ParseAttributes(attrs, NL80211_ATTR_STA_INFO,
+                    (const char *)NLMSG_DATA(headerPtr) + GENL_HDRLEN,
+                    (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+
+    if ((NULL == attrs[NL80211_ATTR_MAC]) || (6 != ATTRIBUTE_LENGTH(attrs[NL80211_ATTR_MAC])) ||
+        (NULL == attrs[NL80211_ATTR_STA_INFO]))
+    {
+        LE_WARN("Incomplete station information");
+        return;
+    }
+
+    ParseAttributes(infoAttrs, NL80211_STA_INFO_MAX,
+                    ATTRIBUTE_DATA(attrs[NL80211_ATTR_STA_INFO]),
+                    ATTRIBUTE_LENGTH(attrs[NL80211_ATTR_STA_INFO]));
+
+    memset(&station, 0, sizeof(station));
+    macPtr = (const uint8_t *)ATTRIBUTE_DATA(attrs[NL80211_ATTR_MAC]);
+    snprintf(station.macAddress, sizeof(station.macAddress),
+             "%02x:%02x:%02x:%02x:%02x:%02x",
+             macPtr[0], macPtr[1], macPtr[2], macPtr[3], macPtr[4], macPtr[5]);
+    le_utf8_Copy(station.ifName, dumpPtr->ifNamePtr, sizeof(station.ifName), NULL);
+
+    if (NULL != infoAttrs[NL80211_STA_INFO_CONNECTED_TIME])
+    {
+        station.connectedSec =
+            (uint32_t)GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_CONNECTED_TIME]);
+    }
+    if (NULL != infoAttrs[NL80211_STA_INFO_INACTIVE_TIME])
+    {
+        station.inactiveMs =
+            (uint32_t)GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_INACTIVE_TIME]);
+    }
+    if (NULL != infoAttrs[NL80211_STA_INFO_SIGNAL])
+    {
+        station.signal = (int8_t)GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_SIGNAL]);
+    }
+
+    // The 32-bit byte counters wrap after 4 GB: prefer the 64-bit ones.
+    if (NULL != infoAttrs[NL80211_STA_INFO_RX_BYTES64])
+    {
+        station.rxBytes = GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_RX_BYTES64]);
+    }
+    else if (NULL != infoAttrs[NL80211_STA_INFO_RX_BYTES])
+    {
+        station.rxBytes = GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_RX_BYTES]);
+    }
+    if (NULL != infoAttrs[NL80211_STA_INFO_TX_BYTES64])
+    {
+        station.txBytes = GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_TX_BYTES64]);
+    }
+    else if (NULL != infoAttrs[NL80211_STA_INFO_TX_BYTES])
+    {
+        station.txBytes = GetUnsignedAttribute(infoAttrs[NL80211_STA_INFO_TX_BYTES]);
+    }
+
+    dumpPtr->handlerPtr(&station, dumpPtr->contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the stations associated with an interface (NL80211_CMD_GET_STATION).
+ *
+ * The handler is called for each station before the function returns.
+ *
+ * @return
+ *      - LE_OK             The dump succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetStations
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiAp_StationHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each station.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+)
+{
+    Request_t     request;
+    StationDump_t dump = { ifNamePtr, handlerPtr, contextPtr };
+    uint32_t      ifIndex = if_nametoindex(ifNamePtr);
+    le_result_t   result;
+    int           fd;
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", ifNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    fd = OpenSocket();
+    if (-1 == fd)
+    {
+        return LE_FAULT;
+    }
+
+    result = ResolveFamily(fd);
+    if (LE_OK == result)
+    {
+        InitRequest(&request, (uint16_t)FamilyId, NLM_F_DUMP, NL80211_CMD_GET_STATION, 0);
+        AddAttribute(&request, NL80211_ATTR_IFINDEX, &ifIndex, sizeof(ifIndex));
+        result = SendRequest(fd, &request, StationHandler, &dump);
+    }
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a NL80211_CMD_NEW_SCAN_RESULTS message of a scan results dump.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BssHandler
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+)
+{
+    ScanDump_t           *dumpPtr = contextPtr;
+    const struct nlattr  *attrs[NL80211_ATTR_BSS + 1];
+    const struct nlattr  *bssAttrs[NL80211_BSS_MAX + 1];
+    pa_wifiNl80211_Bss_t  bss;
+
+    ParseAttributes(attrs, NL80211_ATTR_BSS,
+                    (const char *)NLMSG_DATA(headerPtr) + GENL_HDRLEN,
+                    (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+
+    if (NULL == attrs[NL80211_ATTR_BSS])
+    {
+        return;
+    }
+    ParseAttributes(bssAttrs, NL80211_BSS_MAX,
+                    ATTRIBUTE_DATA(attrs[NL80211_ATTR_BSS]),
+                    ATTRIBUTE_LENGTH(attrs[NL80211_ATTR_BSS]));
+    if (NULL == bssAttrs[NL80211_BSS_FREQUENCY])
+    {
+        return;
+    }
+
+    memset(&bss, 0, sizeof(bss));
+    bss.frequency = (uint32_t)GetUnsignedAttribute(bssAttrs[NL80211_BSS_FREQUENCY]);
+    if (NULL != bssAttrs[NL80211_BSS_SIGNAL_MBM])
+    {
+        bss.signalMbm = (int32_t)(uint32_t)GetUnsignedAttribute(bssAttrs[NL80211_BSS_SIGNAL_MBM]);
+    }
+    else
+    {
+        bss.signalMbm = PA_WIFINL80211_SIGNAL_UNKNOWN;
+    }
+
+    dumpPtr->handlerPtr(&bss, dumpPtr->contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a NL80211_CMD_NEW_SURVEY_RESULTS message of a survey dump.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SurveyHandler
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+)
+{
+    SurveyDump_t            *dumpPtr = contextPtr;
+    const struct nlattr     *attrs[NL80211_ATTR_SURVEY_INFO + 1];
+    const struct nlattr     *infoAttrs[NL80211_SURVEY_INFO_MAX + 1];
+    pa_wifiNl80211_Survey_t  survey;
+
+    ParseAttributes(attrs, NL80211_ATTR_SURVEY_INFO,
+                    (const char *)NLMSG_DATA(headerPtr) + GENL_HDRLEN,
+                    (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+
+    if (NULL == attrs[NL80211_ATTR_SURVEY_INFO])
+    {
+        return;
+    }
+    ParseAttributes(infoAttrs, NL80211_SURVEY_INFO_MAX,
+                    ATTRIBUTE_DATA(attrs[NL80211_ATTR_SURVEY_INFO]),
+                    ATTRIBUTE_LENGTH(attrs[NL80211_ATTR_SURVEY_INFO]));
+    if (NULL == infoAttrs[NL80211_SURVEY_INFO_FREQUENCY])
+    {
+        return;
+    }
+
+    memset(&survey, 0, sizeof(survey));
+    survey.frequency = (uint32_t)GetUnsignedAttribute(infoAttrs[NL80211_SURVEY_INFO_FREQUENCY]);
+    survey.inUse = (NULL != infoAttrs[NL80211_SURVEY_INFO_IN_USE]);
+    if (NULL != infoAttrs[NL80211_SURVEY_INFO_NOISE])
+    {
+        survey.noise = (int8_t)GetUnsignedAttribute(infoAttrs[NL80211_SURVEY_INFO_NOISE]);
+    }
+    // The CHANNEL_TIME names are kept by the recent kernel headers as aliases.
+    if (NULL != infoAttrs[NL80211_SURVEY_INFO_CHANNEL_TIME])
+    {
+        survey.activeMs = GetUnsignedAttribute(infoAttrs[NL80211_SURVEY_INFO_CHANNEL_TIME]);
+    }
+    if (NULL != infoAttrs[NL80211_SURVEY_INFO_CHANNEL_TIME_BUSY])
+    {
+        survey.busyMs = GetUnsignedAttribute(infoAttrs[NL80211_SURVEY_INFO_CHANNEL_TIME_BUSY]);
+    }
+
+    dumpPtr->handlerPtr(&survey, dumpPtr->contextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a socket listening to the nl80211 scan events.
+ *
+ * @return The socket, or -1 on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenScanEventSocket
+(
+    void
+)
+{
+    struct sockaddr_nl localAddr;
+    int fd;
+
+    if (0 == ScanGroupId)
+    {
+        LE_WARN("nl80211 scan group not found");
+        return -1;
+    }
+
+    fd = OpenSocket();
+    if (-1 == fd)
+    {
+        return -1;
+    }
+
+    memset(&localAddr, 0, sizeof(localAddr));
+    localAddr.nl_family = AF_NETLINK;
+    if ((-1 == bind(fd, (struct sockaddr *)&localAddr, sizeof(localAddr))) ||
+        (-1 == setsockopt(fd, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP,
+                          &ScanGroupId, sizeof(ScanGroupId))))
+    {
+        LE_ERROR("Unable to join nl80211 scan group, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the end of the scan of an interface.
+ *
+ * @return
+ *      - LE_OK             The scan results are available.
+ *      - LE_TIMEOUT        The scan did not end in time.
+ *      - LE_FAULT          The scan was aborted or the events could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitScanEnd
+(
+    int fd,
+    uint32_t ifIndex,
+    uint32_t timeoutMs
+)
+{
+    le_clk_Time_t timeout = { (time_t)(timeoutMs / 1000), (long)(timeoutMs % 1000) * 1000 };
+    le_clk_Time_t endTime = le_clk_Add(le_clk_GetRelativeTime(), timeout);
+
+    for (;;)
+    {
+        le_clk_Time_t          remaining = le_clk_Sub(endTime, le_clk_GetRelativeTime());
+        struct pollfd          pollFd = { fd, POLLIN, 0 };
+        const struct nlmsghdr *headerPtr;
+        ssize_t                length;
+        int                    waitMs;
+
+        if (remaining.sec < 0)
+        {
+            return LE_TIMEOUT;
+        }
+        waitMs = (int)((remaining.sec * 1000) + (remaining.usec / 1000));
+        if (0 == poll(&pollFd, 1, waitMs))
+        {
+            return LE_TIMEOUT;
+        }
+
+        length = recv(fd, ReceiveBuffer, sizeof(ReceiveBuffer), MSG_DONTWAIT);
+        if (-1 == length)
+        {
+            if ((EINTR == errno) || (EAGAIN == errno))
+            {
+                continue;
+            }
+            LE_ERROR("Unable to receive nl80211 event, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+            return LE_FAULT;
+        }
+
+        for (headerPtr = (const struct nlmsghdr *)ReceiveBuffer;
+             NLMSG_OK(headerPtr, length);
+             headerPtr = NLMSG_NEXT(headerPtr, length))
+        {
+            const struct genlmsghdr *genHeaderPtr = NLMSG_DATA(headerPtr);
+            const struct nlattr     *attrs[NL80211_ATTR_IFINDEX + 1];
+
+            if ((headerPtr->nlmsg_type != FamilyId) ||
+                ((NL80211_CMD_NEW_SCAN_RESULTS != genHeaderPtr->cmd) &&
+                 (NL80211_CMD_SCAN_ABORTED != genHeaderPtr->cmd)))
+            {
+                continue;
+            }
+            ParseAttributes(attrs, NL80211_ATTR_IFINDEX,
+                            (const char *)genHeaderPtr + GENL_HDRLEN,
+                            (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+            if ((NULL == attrs[NL80211_ATTR_IFINDEX]) ||
+                (ifIndex != GetUnsignedAttribute(attrs[NL80211_ATTR_IFINDEX])))
+            {
+                continue;
+            }
+            return (NL80211_CMD_NEW_SCAN_RESULTS == genHeaderPtr->cmd) ? LE_OK : LE_FAULT;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan on an interface (NL80211_CMD_TRIGGER_SCAN) and dump the BSS found
+ * (NL80211_CMD_GET_SCAN). If the scan can not be run, the results of the previous scan are
+ * dumped.
+ *
+ * The handler is called for each BSS before the function returns.
+ *
+ * @return
+ *      - LE_OK             The dump succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_Scan
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    uint32_t timeoutMs,
+        ///< [IN]
+        ///< Maximum duration of the scan, in ms.
+    pa_wifiNl80211_BssHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each BSS.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+)
+{
+    Request_t   request;
+    ScanDump_t  dump = { handlerPtr, contextPtr };
+    uint32_t    ifIndex = if_nametoindex(ifNamePtr);
+    le_result_t result;
+    int         fd;
+    int         eventFd;
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", ifNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    fd = OpenSocket();
+    if (-1 == fd)
+    {
+        return LE_FAULT;
+    }
+
+    result = ResolveFamily(fd);
+    if (LE_OK != result)
+    {
+        close(fd);
+        return result;
+    }
+
+    // Listen to the scan events before triggering the scan, not to miss its end.
+    eventFd = OpenScanEventSocket();
+    if (-1 != eventFd)
+    {
+        InitRequest(&request, (uint16_t)FamilyId, NLM_F_ACK, NL80211_CMD_TRIGGER_SCAN, 0);
+        AddAttribute(&request, NL80211_ATTR_IFINDEX, &ifIndex, sizeof(ifIndex));
+        result = SendRequest(fd, &request, NULL, NULL);
+        if (LE_OK == result)
+        {
+            result = WaitScanEnd(eventFd, ifIndex, timeoutMs);
+        }
+        if (LE_OK != result)
+        {
+            LE_WARN("Scan on %s failed (%s), using the previous results",
+                    ifNamePtr, LE_RESULT_TXT(result));
+        }
+        close(eventFd);
+    }
+
+    InitRequest(&request, (uint16_t)FamilyId, NLM_F_DUMP, NL80211_CMD_GET_SCAN, 0);
+    AddAttribute(&request, NL80211_ATTR_IFINDEX, &ifIndex, sizeof(ifIndex));
+    result = SendRequest(fd, &request, BssHandler, &dump);
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the channel survey of an interface (NL80211_CMD_GET_SURVEY).
+ *
+ * The handler is called for each channel before the function returns.
+ *
+ * @return
+ *      - LE_OK             The dump succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetSurvey
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    pa_wifiNl80211_SurveyHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each channel.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+)
+{
+    Request_t    request;
+    SurveyDump_t dump = { handlerPtr, contextPtr };
+    uint32_t     ifIndex = if_nametoindex(ifNamePtr);
+    le_result_t  result;
+    int          fd;
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", ifNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    fd = OpenSocket();
+    if (-1 == fd)
+    {
+        return LE_FAULT;
+    }
+
+    result = ResolveFamily(fd);
+    if (LE_OK == result)
+    {
+        InitRequest(&request, (uint16_t)FamilyId, NLM_F_DUMP, NL80211_CMD_GET_SURVEY, 0);
+        AddAttribute(&request, NL80211_ATTR_IFINDEX, &ifIndex, sizeof(ifIndex));
+        result = SendRequest(fd, &request, SurveyHandler, &dump);
+    }
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request on an interface, whose response has no payload or only one message.
+ *
+ * @return
+ *      - LE_OK             The request succeeded.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendInterfaceRequest
+(
+    uint8_t command,
+    uint32_t ifIndex,
+    const char *newIfNamePtr,
+    MessageHandlerFunc_t handlerFunc,
+    void *contextPtr
+)
+{
+    Request_t   request;
+    le_result_t result;
+    int         fd = OpenSocket();
+
+    if (-1 == fd)
+    {
+        return LE_FAULT;
+    }
+
+    result = ResolveFamily(fd);
+    if (LE_OK == result)
+    {
+        InitRequest(&request, (uint16_t)FamilyId, NLM_F_ACK, command, 0);
+        AddAttribute(&request, NL80211_ATTR_IFINDEX, &ifIndex, sizeof(ifIndex));
+        if (NULL != newIfNamePtr)
+        {
+            uint32_t ifType = NL80211_IFTYPE_AP;
+
+            AddAttribute(&request, NL80211_ATTR_IFNAME, newIfNamePtr,
+                         (uint16_t)(strlen(newIfNamePtr) + 1));
+            AddAttribute(&request, NL80211_ATTR_IFTYPE, &ifType, sizeof(ifType));
+        }
+        result = SendRequest(fd, &request, handlerFunc, contextPtr);
+    }
+
+    close(fd);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an access point interface on the radio of another interface (NL80211_CMD_NEW_INTERFACE).
+ * The new interface is down.
+ *
+ * @return
+ *      - LE_OK             The interface is created.
+ *      - LE_NOT_FOUND      The parent interface does not exist.
+ *      - LE_DUPLICATE      The interface already exists.
+ *      - LE_FAULT          The request failed, ex: the driver does not support the interface type.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_AddApInterface
+(
+    const char *parentIfNamePtr,
+        ///< [IN]
+        ///< WLAN interface of the radio.
+    const char *ifNamePtr
+        ///< [IN]
+        ///< Name of the new interface.
+)
+{
+    uint32_t ifIndex = if_nametoindex(parentIfNamePtr);
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", parentIfNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    if (0 != if_nametoindex(ifNamePtr))
+    {
+        return LE_DUPLICATE;
+    }
+
+    return SendInterfaceRequest(NL80211_CMD_NEW_INTERFACE, ifIndex, ifNamePtr, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an interface (NL80211_CMD_DEL_INTERFACE).
+ *
+ * @return
+ *      - LE_OK             The interface is deleted.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_DelInterface
+(
+    const char *ifNamePtr
+        ///< [IN]
+        ///< WLAN interface name.
+)
+{
+    uint32_t ifIndex = if_nametoindex(ifNamePtr);
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", ifNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    return SendInterfaceRequest(NL80211_CMD_DEL_INTERFACE, ifIndex, NULL, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the operating frequency from a NL80211_CMD_NEW_INTERFACE message, 0 if the interface has
+ * none.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InterfaceHandler
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+)
+{
+    const struct nlattr *attrs[NL80211_ATTR_WIPHY_FREQ + 1];
+
+    ParseAttributes(attrs, NL80211_ATTR_WIPHY_FREQ,
+                    (const char *)NLMSG_DATA(headerPtr) + GENL_HDRLEN,
+                    (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+
+    if (NULL != attrs[NL80211_ATTR_WIPHY_FREQ])
+    {
+        *(uint32_t *)contextPtr = (uint32_t)GetUnsignedAttribute(attrs[NL80211_ATTR_WIPHY_FREQ]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frequency an interface operates on (NL80211_CMD_GET_INTERFACE), ex: the frequency of
+ * the access point a station interface is associated with.
+ *
+ * @return
+ *      - LE_OK             The frequency is returned.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The interface does not operate on any frequency.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetFrequency
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    uint32_t *frequencyPtr
+        ///< [OUT]
+        ///< Frequency (MHz).
+)
+{
+    uint32_t    ifIndex = if_nametoindex(ifNamePtr);
+    uint32_t    frequency = 0;
+    le_result_t result;
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", ifNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    result = SendInterfaceRequest(NL80211_CMD_GET_INTERFACE, ifIndex, NULL, InterfaceHandler,
+                                  &frequency);
+    if (LE_OK != result)
+    {
+        return result;
+    }
+    if (0 == frequency)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    *frequencyPtr = frequency;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the frequencies of the nested NL80211_BAND_ATTR_FREQS list of a band.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportFrequencies
+(
+    const WiphyRequest_t *requestPtr,
+    const struct nlattr *freqsPtr
+)
+{
+    const struct nlattr *freqPtr = (const struct nlattr *)ATTRIBUTE_DATA(freqsPtr);
+    int                  length = ATTRIBUTE_LENGTH(freqsPtr);
+
+    while ((length >= NLA_HDRLEN) &&
+           (freqPtr->nla_len >= NLA_HDRLEN) &&
+           (freqPtr->nla_len <= length))
+    {
+        const struct nlattr *freqAttrs[NL80211_FREQUENCY_ATTR_RADAR + 1];
+
+        ParseAttributes(freqAttrs, NL80211_FREQUENCY_ATTR_RADAR,
+                        ATTRIBUTE_DATA(freqPtr), ATTRIBUTE_LENGTH(freqPtr));
+        if (NULL != freqAttrs[NL80211_FREQUENCY_ATTR_FREQ])
+        {
+            pa_wifiNl80211_Frequency_t frequency;
+
+            memset(&frequency, 0, sizeof(frequency));
+            frequency.frequency =
+                (uint32_t)GetUnsignedAttribute(freqAttrs[NL80211_FREQUENCY_ATTR_FREQ]);
+            frequency.isDisabled = (NULL != freqAttrs[NL80211_FREQUENCY_ATTR_DISABLED]);
+            // Named PASSIVE_SCAN by the kernel headers older than 3.14.
+            frequency.isNoIr = (NULL != freqAttrs[NL80211_FREQUENCY_ATTR_NO_IR]);
+            frequency.isRadar = (NULL != freqAttrs[NL80211_FREQUENCY_ATTR_RADAR]);
+            requestPtr->handlerPtr(&frequency, requestPtr->contextPtr);
+        }
+        length -= NLA_ALIGN(freqPtr->nla_len);
+        freqPtr = (const struct nlattr *)((const char *)freqPtr + NLA_ALIGN(freqPtr->nla_len));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the HT and VHT capabilities and the frequencies of a band from a NL80211_CMD_NEW_WIPHY
+ * message of a wiphy dump.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WiphyHandler
+(
+    const struct nlmsghdr *headerPtr,
+    void *contextPtr
+)
+{
+    WiphyRequest_t      *requestPtr = contextPtr;
+    const struct nlattr *attrs[NL80211_ATTR_WIPHY_BANDS + 1];
+    const struct nlattr *bandPtr;
+    int                  length;
+
+    ParseAttributes(attrs, NL80211_ATTR_WIPHY_BANDS,
+                    (const char *)NLMSG_DATA(headerPtr) + GENL_HDRLEN,
+                    (int)headerPtr->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+
+    if (NULL == attrs[NL80211_ATTR_WIPHY_BANDS])
+    {
+        return;
+    }
+
+    // Nested list of bands, each one typed by its band number.
+    bandPtr = (const struct nlattr *)ATTRIBUTE_DATA(attrs[NL80211_ATTR_WIPHY_BANDS]);
+    length = ATTRIBUTE_LENGTH(attrs[NL80211_ATTR_WIPHY_BANDS]);
+    while ((length >= NLA_HDRLEN) &&
+           (bandPtr->nla_len >= NLA_HDRLEN) &&
+           (bandPtr->nla_len <= length))
+    {
+        if ((bandPtr->nla_type & NLA_TYPE_MASK) == requestPtr->band)
+        {
+            const struct nlattr *bandAttrs[NL80211_BAND_ATTR_VHT_CAPA + 1];
+
+            ParseAttributes(bandAttrs, NL80211_BAND_ATTR_VHT_CAPA,
+                            ATTRIBUTE_DATA(bandPtr), ATTRIBUTE_LENGTH(bandPtr));
+            requestPtr->isFound = true;
+            if (NULL != requestPtr->capaPtr)
+            {
+                if (NULL != bandAttrs[NL80211_BAND_ATTR_HT_CAPA])
+                {
+                    requestPtr->capaPtr->isHt = true;
+                    requestPtr->capaPtr->htCapa =
+                        (uint16_t)GetUnsignedAttribute(bandAttrs[NL80211_BAND_ATTR_HT_CAPA]);
+                }
+                if (NULL != bandAttrs[NL80211_BAND_ATTR_VHT_CAPA])
+                {
+                    requestPtr->capaPtr->isVht = true;
+                    requestPtr->capaPtr->vhtCapa =
+                        (uint32_t)GetUnsignedAttribute(bandAttrs[NL80211_BAND_ATTR_VHT_CAPA]);
+                }
+            }
+            // In a split dump, the frequencies of a band may come in several messages.
+            if ((NULL != requestPtr->handlerPtr) && (NULL != bandAttrs[NL80211_BAND_ATTR_FREQS]))
+            {
+                ReportFrequencies(requestPtr, bandAttrs[NL80211_BAND_ATTR_FREQS]);
+            }
+        }
+        length -= NLA_ALIGN(bandPtr->nla_len);
+        bandPtr = (const struct nlattr *)((const char *)bandPtr + NLA_ALIGN(bandPtr->nla_len));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump the wiphy of an interface (NL80211_CMD_GET_WIPHY) for a band.
+ *
+ * @return
+ *      - LE_OK             The band is found.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The radio does not support the band.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DumpWiphyBand
+(
+    const char *ifNamePtr,
+    WiphyRequest_t *wiphyPtr
+)
+{
+    Request_t   request;
+    uint32_t    ifIndex = if_nametoindex(ifNamePtr);
+    le_result_t result;
+    int         fd;
+
+    if (0 == ifIndex)
+    {
+        LE_DEBUG("Interface %s not found", ifNamePtr);
+        return LE_NOT_FOUND;
+    }
+
+    fd = OpenSocket();
+    if (-1 == fd)
+    {
+        return LE_FAULT;
+    }
+
+    result = ResolveFamily(fd);
+    if (LE_OK == result)
+    {
+        // A whole wiphy may not fit in one message: ask for a split dump, in which the
+        // capabilities of a band come with its first message.
+        InitRequest(&request, (uint16_t)FamilyId, NLM_F_DUMP, NL80211_CMD_GET_WIPHY, 0);
+        AddAttribute(&request, NL80211_ATTR_IFINDEX, &ifIndex, sizeof(ifIndex));
+        AddAttribute(&request, NL80211_ATTR_SPLIT_WIPHY_DUMP, NULL, 0);
+        result = SendRequest(fd, &request, WiphyHandler, wiphyPtr);
+    }
+
+    close(fd);
+    if (LE_OK != result)
+    {
+        return result;
+    }
+    return wiphyPtr->isFound ? LE_OK : LE_UNAVAILABLE;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the HT and VHT capabilities of a band of the radio of an interface (NL80211_CMD_GET_WIPHY).
+ *
+ * @return
+ *      - LE_OK             The capabilities are returned.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The radio does not support the band.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetBandCapa
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    bool is5GHz,
+        ///< [IN]
+        ///< true for the 5 GHz band, false for the 2.4 GHz one.
+    pa_wifiNl80211_BandCapa_t *capaPtr
+        ///< [OUT]
+        ///< Capabilities of the band.
+)
+{
+    WiphyRequest_t wiphy;
+
+    memset(capaPtr, 0, sizeof(*capaPtr));
+    memset(&wiphy, 0, sizeof(wiphy));
+    wiphy.band = is5GHz ? NL80211_BAND_5GHZ : NL80211_BAND_2GHZ;
+    wiphy.capaPtr = capaPtr;
+
+    return DumpWiphyBand(ifNamePtr, &wiphy);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frequencies of a band of the radio of an interface and their regulatory restrictions
+ * (NL80211_CMD_GET_WIPHY).
+ *
+ * The handler is called for each frequency before the function returns.
+ *
+ * @return
+ *      - LE_OK             The frequencies are reported.
+ *      - LE_NOT_FOUND      The interface does not exist.
+ *      - LE_UNAVAILABLE    The radio does not support the band.
+ *      - LE_FAULT          The request failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiNl80211_GetFrequencies
+(
+    const char *ifNamePtr,
+        ///< [IN]
+        ///< WLAN interface name.
+    bool is5GHz,
+        ///< [IN]
+        ///< true for the 5 GHz band, false for the 2.4 GHz one.
+    pa_wifiNl80211_FrequencyHandlerFunc_t handlerPtr,
+        ///< [IN]
+        ///< Handler called for each frequency.
+    void *contextPtr
+        ///< [IN]
+        ///< Associated context.
+)
+{
+    WiphyRequest_t wiphy;
+
+    memset(&wiphy, 0, sizeof(wiphy));
+    wiphy.band = is5GHz ? NL80211_BAND_5GHZ : NL80211_BAND_2GHZ;
+    wiphy.handlerPtr = handlerPtr;
+    wiphy.contextPtr = contextPtr;
+
+    return DumpWiphyBand(ifNamePtr, &wiphy);
+}
@@ -0,0 +1,322 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  WiFi Platform Adapter daemon processes
+ *
+ *  The exit of a process is waited for on a pidfd (Linux 5.3 and later), which also keeps the
+ *  process identifier from being reused while it is signaled. On older kernels, the process is
+ *  polled instead.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ *
+ */
+// -------------------------------------------------------------------------------------------------
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "legato.h"
+
+#include "pa_wifi_proc.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interval between two checks of the process, when pidfd is not supported, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define POLL_INTERVAL_MS    10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for a process to exit after SIGKILL, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KILL_TIMEOUT_MS     500
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetTimeMs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000) + ((uint64_t)now.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a pidfd on a process.
+ *
+ * @return The file descriptor, or -1 with errno set (ENOSYS if not supported, ESRCH if the process
+ *         does not exist).
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenPidFd
+(
+    pid_t pid
+)
+{
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a signal to a process, through its pidfd if open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendSignal
+(
+    int pidFd,
+    pid_t pid,
+    int sig
+)
+{
+#ifdef SYS_pidfd_send_signal
+    if ((-1 != pidFd) && (0 == syscall(SYS_pidfd_send_signal, pidFd, sig, NULL, 0)))
+    {
+        return;
+    }
+#endif
+    kill(pid, sig);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a process is running. A zombie is not: it only waits to be reaped by its parent.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRunning
+(
+    pid_t pid
+)
+{
+    char  path[PATH_MAX];
+    char  state = 'Z';
+    FILE *statPtr;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    statPtr = fopen(path, "re");
+    if (NULL == statPtr)
+    {
+        return false;
+    }
+    // Format: pid (comm) state ...
+    if (1 != fscanf(statPtr, "%*d (%*[^)]) %c", &state))
+    {
+        state = 'Z';
+    }
+    fclose(statPtr);
+    return ('Z' != state);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a process to exit, on its pidfd if open.
+ *
+ * @return
+ *      - LE_OK             The process exited.
+ *      - LE_TIMEOUT        The process is still running.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitExit
+(
+    int pidFd,
+    pid_t pid,
+    uint32_t timeoutMs
+)
+{
+    uint64_t deadlineMs = GetTimeMs() + timeoutMs;
+
+    for (;;)
+    {
+        uint64_t nowMs = GetTimeMs();
+        int      waitMs = (nowMs >= deadlineMs) ? 0 : (int)(deadlineMs - nowMs);
+
+        if (-1 != pidFd)
+        {
+            struct pollfd pollFd = { .fd = pidFd, .events = POLLIN };
+            int           count = poll(&pollFd, 1, waitMs);
+
+            if (count > 0)
+            {
+                return LE_OK;
+            }
+            if (0 == count)
+            {
+                return LE_TIMEOUT;
+            }
+            if (EINTR != errno)
+            {
+                // Poll the process instead, the caller closes the pidfd.
+                LE_WARN("poll failed, errno %d (%s)", errno, LE_ERRNO_TXT(errno));
+                pidFd = -1;
+            }
+            continue;
+        }
+
+        if (!IsRunning(pid))
+        {
+            return LE_OK;
+        }
+        if (0 == waitMs)
+        {
+            return LE_TIMEOUT;
+        }
+        usleep(((waitMs < POLL_INTERVAL_MS) ? waitMs : POLL_INTERVAL_MS) * 1000);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the pid file of a daemon and check that the process runs the expected program.
+ *
+ * @return
+ *      - LE_OK             The process is running.
+ *      - LE_NOT_FOUND      No pid file, or the process is no longer running the program.
+ *      - LE_FAULT          The pid file is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiProc_ReadPidFile
+(
+    const char *pathPtr,
+        ///< [IN]
+        ///< Path of the pid file.
+    const char *namePtr,
+        ///< [IN]
+        ///< Program name (ex: "hostapd").
+    pid_t *pidPtr
+        ///< [OUT]
+        ///< Process identifier.
+)
+{
+    char  commPath[PATH_MAX];
+    char  comm[32] = "";
+    int   pid = 0;
+    FILE *filePtr = fopen(pathPtr, "re");
+
+    if (NULL == filePtr)
+    {
+        return LE_NOT_FOUND;
+    }
+    if ((1 != fscanf(filePtr, "%d", &pid)) || (pid <= 1))
+    {
+        fclose(filePtr);
+        LE_WARN("Invalid pid file %s", pathPtr);
+        return LE_FAULT;
+    }
+    fclose(filePtr);
+
+    // A stale pid file may name a process identifier reused by another program.
+    snprintf(commPath, sizeof(commPath), "/proc/%d/comm", pid);
+    filePtr = fopen(commPath, "re");
+    if (NULL == filePtr)
+    {
+        return LE_NOT_FOUND;
+    }
+    if (NULL == fgets(comm, sizeof(comm), filePtr))
+    {
+        comm[0] = '\0';
+    }
+    fclose(filePtr);
+    comm[strcspn(comm, "\n")] = '\0';
+
+    if ((0 != strcmp(comm, namePtr)) || (!IsRunning(pid)))
+    {
+        LE_DEBUG("Process %d of %s is not %s", pid, pathPtr, namePtr);
+        return LE_NOT_FOUND;
+    }
+
+    *pidPtr = (pid_t)pid;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a process to exit.
+ *
+ * @return
+ *      - LE_OK             The process exited.
+ *      - LE_TIMEOUT        The process is still running.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiProc_Wait
+(
+    pid_t pid,
+        ///< [IN]
+        ///< Process identifier.
+    uint32_t timeoutMs
+        ///< [IN]
+        ///< Maximum time to wait, in ms.
+)
+{
+    int         pidFd = OpenPidFd(pid);
+    le_result_t result;
+
+    if ((-1 == pidFd) && (ESRCH == errno))
+    {
+        return LE_OK;
+    }
+
+    result = WaitExit(pidFd, pid, timeoutMs);
+    if (-1 != pidFd)
+    {
+        close(pidFd);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Terminate a process with SIGTERM and wait for it to exit. It is killed with SIGKILL if it does
+ * not exit in time.
+ *
+ * @return
+ *      - LE_OK             The process exited.
+ *      - LE_TIMEOUT        The process is still running after SIGKILL.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_wifiProc_Stop
+(
+    pid_t pid,
+        ///< [IN]
+        ///< Process identifier.
+    uint32_t timeoutMs
+        ///< [IN]
+        ///< Maximum time to wait after SIGTERM, in ms.
+)
+{
+    int         pidFd = OpenPidFd(pid);
+    le_result_t result;
+
+    if ((-1 == pidFd) && (ESRCH == errno))
+    {
+        return LE_OK;
+    }
+
+    SendSignal(pidFd, pid, SIGTERM);
+    result = WaitExit(pidFd, pid, timeoutMs);
+    if (LE_TIMEOUT == result)
+    {
+        LE_WARN("Process %d did not terminate in %u ms, killing it", (int)pid, timeoutMs);
+        SendSignal(pidFd, pid, SIGKILL);
+        result = WaitExit(pidFd, pid, KILL_TIMEOUT_MS);
+    }
+
+    if (-1 != pidFd)
+    {
+        close(pidFd);
+    }
+    return result;
+}
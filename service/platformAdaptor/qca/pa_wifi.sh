@@ -14,10 +14,14 @@ fi
 CMD=$1
 # WiFi interface
 IFACE=wlan0
+# Virtual interface of the access point, when it runs next to the client
+AP_VIRTUAL_IFACE=ap0
 # If WLAN interface does not exist but driver is installed, means WiFi hardware is absent
 HARDWAREABSENCE=50
 # QCA wifi module name
 QCAWIFIMOD=wlan
+# Seconds to wait for the interface after the driver loading
+QCAWIFI_IF_TIMEOUT=10
 # If wpa_supplicant is running already
 WPADUPLICATE=14
 # WiFi driver is not installed
@@ -27,6 +31,59 @@ SUCCESS=0
 ERROR=127
 # PATH
 export PATH=/legato/systems/current/bin:/usr/local/bin:/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin
+# DHCP server of the WLAN: configuration written by the WiFi service, link used when it is served by
+# the system dnsmasq, and default pid and lease files of its dedicated dnsmasq instance. The WiFi
+# service names them after the interface of the access point.
+DNSMASQ_WLAN_CONF=/tmp/dnsmasq.wlan.conf
+DNSMASQ_WLAN_LINK=/etc/dnsmasq.d/dnsmasq.wlan.conf
+DNSMASQ_WLAN_PID=/var/run/dnsmasq.${IFACE}.pid
+DNSMASQ_WLAN_LEASES=/tmp/dnsmasq.${IFACE}.leases
+# Pid file of the system dnsmasq
+DNSMASQ_SYSTEM_PID=/var/run/dnsmasq.pid
+# Pid file of the iw event process of the WiFi service
+IW_EVENT_PID=/var/run/wifi_iw_event.pid
+
+# Check that a process runs a program. A stale pid file may name a process identifier reused by
+# another program.
+# $1: pid, $2: program name, as in /proc/<pid>/comm
+IsProgram()
+{
+    [ "$(cat /proc/$1/comm 2>/dev/null)" = "$2" ]
+}
+
+# Terminate the daemon of a pid file, if running, and kill it if it does not exit in 1 s.
+# $1: pid file, $2: program name
+StopPidFile()
+{
+    [ -f "$1" ] || return 0
+    pid=$(cat "$1")
+    rm -f "$1"
+    [ -n "${pid}" ] || return 0
+    IsProgram "${pid}" "$2" || return 0
+    kill "${pid}" 2>/dev/null || return 0
+    # Poll every 100 ms. Without sub-second sleep, a single wait of 1 s is done.
+    waited=0
+    while [ ${waited} -lt 10 ]
+    do
+        IsProgram "${pid}" "$2" || return 0
+        if usleep 100000 2>/dev/null || sleep 0.1 2>/dev/null; then
+            waited=$((waited + 1))
+        else
+            sleep 1
+            waited=10
+        fi
+    done
+    IsProgram "${pid}" "$2" && kill -9 "${pid}" 2>/dev/null
+    return 0
+}
+
+# Stop the dedicated dnsmasq instance of the WLAN, if running. Its leases stay in the lease file
+# and are reloaded by the next instance.
+# $1: pid file
+StopDnsmasqWlan()
+{
+    StopPidFile "${1:-${DNSMASQ_WLAN_PID}}" dnsmasq
+}
 
 # Check the connection on the WiFi network interface.
 # Exit with 0 if connected otherwise exit with 8 (time out)
@@ -49,131 +106,229 @@ CheckConnection()
     exit ${SUCCESS}
 }
 
-echo "${CMD}"
-case ${CMD} in
-    WIFI_START)
-        retries=10
+# Run a command
+# $1: Command
+# $2: Command argument
+RunCommand()
+{
+    CMD=$1
+    echo "${CMD}"
+    case ${CMD} in
+        WIFI_START)
+            retries=${QCAWIFI_IF_TIMEOUT}
+            # Do clean up, even just after reboot
+            /usr/bin/qca9377 wifi client stop > /dev/null 2>&1
+            sleep 1
+            # Run wifi start background
+            /usr/bin/qca9377 wifi client init > /dev/null 2>&1 &
+            for i in $(seq 1 ${retries})
+            do
+                echo "loop=${i}"
+                sleep 1
+                [ -e /sys/class/net/${IFACE} ] && break
+            done
+            if [ "${i}" -ne "${retries}" ]; then
+                /sbin/ifconfig ${IFACE} up
+                exit ${SUCCESS}
+            fi
+            moduleString=$(/sbin/lsmod | grep ${QCAWIFIMOD}) > /dev/null
+            if [ -n "${moduleString}" ]; then
+                ret=${HARDWAREABSENCE}
+            else
+                ret=${ERROR}
+            fi
+            # Do clean up
+            /usr/bin/qca9377 wifi client stop > /dev/null 2>&1
+            exit ${ret} ;;
+
+      WIFI_STOP)
+        # If wpa_supplicant is still running, terminate it
+        (/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
+        && /sbin/wpa_cli -i${IFACE} terminate
+        # Unmount the WiFi network interface
+        /usr/bin/qca9377 wifi client stop > /dev/null 2>&1 || exit ${ERROR}
+        ;;
+
+      WIFI_SET_EVENT)
+        # The pid is kept to stop this iw process only, see WIFI_UNSET_EVENT
+        /usr/sbin/iw event &
+        echo $! > ${IW_EVENT_PID}
+        wait $! || exit ${ERROR}
+        ;;
+
+      WIFI_UNSET_EVENT)
+        # Only the iw process started by WIFI_SET_EVENT
+        StopPidFile ${IW_EVENT_PID} iw
+        ;;
+
+      WIFI_CHECK_HWSTATUS)
+        #Client request disconnection if interface in up
+        /sbin/ifconfig | grep ${IFACE} > /dev/null 2>&1
+        [ $? -eq 0 ] && exit ${SUCCESS}
+        sleep 1
+        #Check WiFi stop called or not
+        /sbin/lsmod | grep ${QCAWIFIMOD} > /dev/null 2>&1
+        #Driver stays, hardware removed
+        [ $? -eq 0 ] && exit ${HARDWAREABSENCE}
+        #WiFi stop called
+        exit ${NODRIVER} ;;
+
+      WIFIAP_HOSTAPD_START)
+        # The access point may run on a virtual interface, next to the client on ${IFACE}. On
+        # failure, the hardware is stopped by the WiFi service, once no other role uses it.
+        AP_IFACE=${2:-${IFACE}}
+        HOSTAPD_PID=/var/run/hostapd.${AP_IFACE}.pid
+        (/bin/hostapd /tmp/hostapd.conf -i${AP_IFACE} -B -P ${HOSTAPD_PID}) && exit ${SUCCESS}
+        exit ${ERROR} ;;
+
+      WIFIAP_WLAN_UP)
+        AP_IP=$2
+        AP_IFACE=${3:-${IFACE}}
+        /sbin/ifconfig | grep ${AP_IFACE} || exit ${ERROR}
+        /sbin/ifconfig ${AP_IFACE} "${AP_IP}" up || exit ${ERROR}
+        ;;
+
+      WIFIAP_BSS_UP)
+        # Address of the interface of an additional BSS, created by hostapd, and DHCP and DNS ports
+        BSS_IFACE=$2
+        BSS_IP=$3
+        [ -e /sys/class/net/${BSS_IFACE} ] || exit ${ERROR}
+        /sbin/ifconfig ${BSS_IFACE} "${BSS_IP}" up || exit ${ERROR}
+        /usr/sbin/iptables -C INPUT -i ${BSS_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT 2>/dev/null \
+        || /usr/sbin/iptables -I INPUT -i ${BSS_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT || exit ${ERROR}
+        /usr/sbin/iptables -C INPUT -i ${BSS_IFACE} -p udp -m udp --dport 53 -j ACCEPT 2>/dev/null \
+        || /usr/sbin/iptables -I INPUT -i ${BSS_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+        || exit ${ERROR}
+        ;;
+
+      WIFIAP_BSS_DOWN)
+        # DHCP and DNS ports of an additional BSS, its interface is removed by hostapd
+        BSS_IFACE=$2
+        /usr/sbin/iptables -D INPUT -i ${BSS_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT || exit ${ERROR}
+        /usr/sbin/iptables -D INPUT -i ${BSS_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+         || exit ${ERROR}
+        ;;
+
+      DNSMASQ_WLAN_START)
+        # Restart the dedicated DHCP and DNS server of the WLAN only, the leases are kept in the
+        # lease file. It listens on the interfaces of the configuration file, not on the loopback
+        # one used by the system dnsmasq. The interfaces of the additional BSS may be created after
+        # it starts (bind-dynamic).
+        # $2: pid file, $3: lease file
+        WLAN_PID=${2:-${DNSMASQ_WLAN_PID}}
+        WLAN_LEASES=${3:-${DNSMASQ_WLAN_LEASES}}
+        StopDnsmasqWlan "${WLAN_PID}"
+        /usr/bin/dnsmasq --conf-file=${DNSMASQ_WLAN_CONF} --pid-file="${WLAN_PID}" \
+            --dhcp-leasefile="${WLAN_LEASES}" --bind-dynamic --except-interface=lo \
+            || exit ${ERROR}
+        ;;
+
+      DNSMASQ_WLAN_STOP)
+        # $2: pid file
+        StopDnsmasqWlan "$2"
+        ;;
+
+      DNSMASQ_RESTART)
+        # Serve the WLAN by the system dnsmasq
+        /etc/init.d/dnsmasq stop
+        StopPidFile ${DNSMASQ_SYSTEM_PID} dnsmasq
+        /etc/init.d/dnsmasq start || exit ${ERROR}
+        ;;
+
+      WIFICLIENT_START_SCAN)
+        (/usr/sbin/iw dev ${IFACE} scan | grep 'BSS\|SSID\|signal') || exit ${ERROR}
+        ;;
+
+      WIFICLIENT_CONNECT)
+        WPA_CFG=$2
+        [ -f "${WPA_CFG}" ] || exit ${ERROR}
+        # wpa_supplicant is running, return duplicated request
+        /bin/ps -A | grep wpa_supplicant && exit ${WPADUPLICATE}
+        /sbin/wpa_supplicant -d -Dnl80211 -c "${WPA_CFG}" -i${IFACE} -B || exit ${ERROR}
+        CheckConnection ;;
+
+      WIFICLIENT_DISCONNECT)
+        /sbin/wpa_cli -i${IFACE} terminate || exit ${ERROR}
+        echo "WiFi client disconnected."
+        ;;
+
+      IPTABLE_DHCP_INSERT)
+        AP_IFACE=${2:-${IFACE}}
+        /usr/sbin/iptables -I INPUT -i ${AP_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT  || exit ${ERROR}
+        # DNS, answered by the dedicated dnsmasq instance
+        /usr/sbin/iptables -I INPUT -i ${AP_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+         || exit ${ERROR}
+        ;;
+
+      IPTABLE_DHCP_DELETE)
+        AP_IFACE=${2:-${IFACE}}
+        /usr/sbin/iptables -D INPUT -i ${AP_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT  || exit ${ERROR}
+        # DNS, answered by the dedicated dnsmasq instance
+        /usr/sbin/iptables -D INPUT -i ${AP_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+         || exit ${ERROR}
+        ;;
+
+      HW_INFO)
+        # Parameters of the native PA, which runs the commands above that do not need the shell
+        echo "IFACE=${IFACE}"
+        echo "AP_IFACE=${AP_VIRTUAL_IFACE}"
+        echo "MODULE=${QCAWIFIMOD}"
+        echo "IFACE_TIMEOUT=${QCAWIFI_IF_TIMEOUT}"
+        echo "RESET_RETRIES=0"
+        ;;
+
+      HW_MODULE_LOAD)
+        # Driver loading, the native PA waits for the interface and brings it up
         # Do clean up, even just after reboot
         /usr/bin/qca9377 wifi client stop > /dev/null 2>&1
         sleep 1
         # Run wifi start background
         /usr/bin/qca9377 wifi client init > /dev/null 2>&1 &
-        for i in $(seq 1 ${retries})
-        do
-            echo "loop=${i}"
-            sleep 1
-            [ -e /sys/class/net/${IFACE} ] && break
-        done
-        if [ "${i}" -ne "${retries}" ]; then
-            /sbin/ifconfig ${IFACE} up
-            exit ${SUCCESS}
-        fi
-        moduleString=$(/sbin/lsmod | grep ${QCAWIFIMOD}) > /dev/null
-        if [ -n "${moduleString}" ]; then
-            ret=${HARDWAREABSENCE}
-        else
-            ret=${ERROR}
-        fi
-        # Do clean up
-        /usr/bin/qca9377 wifi client stop > /dev/null 2>&1
-        exit ${ret} ;;
-
-  WIFI_STOP)
-    # If wpa_supplicant is still running, terminate it
-    (/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
-    && /sbin/wpa_cli -i${IFACE} terminate
-    # Unmount the WiFi network interface
-    /usr/bin/qca9377 wifi client stop > /dev/null 2>&1 || exit ${ERROR}
-    ;;
-
-  WIFI_SET_EVENT)
-    /usr/sbin/iw event || exit ${ERROR}
-    ;;
-
-  WIFI_UNSET_EVENT)
-    count=$(/usr/bin/pgrep -c iw)
-    [ "${count}" -eq 0 ] && exit ${SUCCESS}
-    for i in $(seq 1 "${count}")
+        ;;
+
+      HW_MODULE_UNLOAD)
+        # Driver unloading, the interface is already down
+        /usr/bin/qca9377 wifi client stop > /dev/null 2>&1 || exit ${ERROR}
+        ;;
+
+      PING)
+        # No operation, measures the command overhead
+        ;;
+
+      *)
+        echo "Parameter not valid"
+        exit ${ERROR} ;;
+    esac
+    exit ${SUCCESS}
+}
+
+# Command server mode: read one command per line on stdin and answer on stdout with the command
+# output lines prefixed by '.', then a line with '=' and the exit status. Each command runs in a
+# subshell, so that it can exit without ending the server, but no new interpreter is started.
+SERVE_OUT=/tmp/pa_wifi_serve.$$
+ServeCommands()
+{
+    set -f
+    echo "=READY"
+    while IFS= read -r request
     do
-        pid=$(/usr/bin/pgrep -n iw)
-        /bin/kill -9 "${pid}"
+        ( RunCommand ${request} ) </dev/null >${SERVE_OUT} 2>&1
+        status=$?
+        while IFS= read -r line || [ -n "${line}" ]
+        do
+            echo ".${line}"
+        done <${SERVE_OUT}
+        echo "=${status}"
     done
-    count=$(/usr/bin/pgrep -c iw)
-    [ "${count}" -eq 0 ] || exit ${ERROR}
-    ;;
-
-  WIFI_CHECK_HWSTATUS)
-    #Client request disconnection if interface in up
-    /sbin/ifconfig | grep ${IFACE} > /dev/null 2>&1
-    [ $? -eq 0 ] && exit ${SUCCESS}
-    sleep 1
-    #Check WiFi stop called or not
-    /sbin/lsmod | grep ${QCAWIFIMOD} > /dev/null 2>&1
-    #Driver stays, hardware removed
-    [ $? -eq 0 ] && exit ${HARDWAREABSENCE}
-    #WiFi stop called
-    exit ${NODRIVER} ;;
-
-  WIFIAP_HOSTAPD_START)
-    (/bin/hostapd /tmp/hostapd.conf -i${IFACE} -B) && exit ${SUCCESS}
-    # Fail to start hostapd, do cleanup
-    /usr/bin/qca9377 wifi client stop
-    exit ${ERROR} ;;
-
-  WIFIAP_HOSTAPD_STOP)
-    rm -f /tmp/dnsmasq.wlan.conf
-    /usr/bin/unlink /etc/dnsmasq.d/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
-    killall hostapd
-    sleep 1;
-    pidof hostapd && (kill -9 "$(pidof hostapd)" || exit ${ERROR})
-    pidof dnsmasq && (kill -9 "$(pidof dnsmasq)" || exit ${ERROR})
-    /etc/init.d/dnsmasq start || exit ${ERROR}
-    ;;
-
-  WIFIAP_WLAN_UP)
-    AP_IP=$2
-    /sbin/ifconfig | grep ${IFACE} || exit ${ERROR}
-    /sbin/ifconfig ${IFACE} "${AP_IP}" up || exit ${ERROR}
-    ;;
-
-  DNSMASQ_RESTART)
-    echo "interface=${IFACE}" >> /tmp/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
-    pidof dnsmasq && (kill -9 `pidof dnsmasq` || exit 127)
-    /etc/init.d/dnsmasq start || exit ${ERROR}
-    ;;
-
-  WIFICLIENT_START_SCAN)
-    (/usr/sbin/iw dev ${IFACE} scan | grep 'BSS\|SSID\|signal') || exit ${ERROR}
-    ;;
-
-  WIFICLIENT_CONNECT)
-    WPA_CFG=$2
-    [ -f "${WPA_CFG}" ] || exit ${ERROR}
-    # wpa_supplicant is running, return duplicated request
-    /bin/ps -A | grep wpa_supplicant && exit ${WPADUPLICATE}
-    /sbin/wpa_supplicant -d -Dnl80211 -c "${WPA_CFG}" -i${IFACE} -B || exit ${ERROR}
-    CheckConnection ;;
-
-  WIFICLIENT_DISCONNECT)
-    /sbin/wpa_cli -i${IFACE} terminate || exit ${ERROR}
-    echo "WiFi client disconnected."
-    ;;
-
-  IPTABLE_DHCP_INSERT)
-    /usr/sbin/iptables -I INPUT -i ${IFACE} -p udp -m udp \
-     --sport 67:68 --dport 67:68 -j ACCEPT  || exit ${ERROR}
-    ;;
-
-  IPTABLE_DHCP_DELETE)
-    /usr/sbin/iptables -D INPUT -i ${IFACE} -p udp -m udp \
-     --sport 67:68 --dport 67:68 -j ACCEPT  || exit ${ERROR}
-    ;;
-
-  *)
-    echo "Parameter not valid"
-    exit ${ERROR} ;;
-esac
-exit ${SUCCESS}
+    rm -f ${SERVE_OUT}
+    exit 0
+}
+
+[ "${CMD}" = "SERVE" ] && ServeCommands
+RunCommand "$@"
 
@@ -0,0 +1,149 @@
+#!/bin/sh
+# Copyright (C) Sierra Wireless Inc.
+#
+# Replay PA script: answers the commands of the WiFi service from a scenario, with the output,
+# exit status and timing captured on a target by pa_wifi_record.sh, so that the service runs and
+# can be benchmarked without WiFi hardware. It is selected by the WIFI_PA_SCRIPT environment
+# variable of the service.
+#
+# The scenario file has one rule per line, '#' starts a comment:
+#   <command> <exit status> <delay in ms> <transcript> [hold]
+#  - command:    command name, its arguments are ignored. '*' matches the commands without rule,
+#                except HW_INFO: without an HW_INFO rule, no command is run natively by the service.
+#  - delay:      time before the transcript is output, emulating the command duration.
+#  - transcript: file output by the command, relative to the scenario directory, '-' for none. A
+#                line "@<ms>" is a pause; a line starting with "@@" is output without its first '@'.
+#  - hold:       after the transcript, the output stays open until WIFI_UNSET_EVENT, as iw event.
+# The rules of a command are used in turn and the last one repeats (ex: a failed scan, then
+# successful ones). The rule counts are reset when the command server starts, with the service.
+#
+# WIFI_REPLAY_SCENARIO: scenario file (default: /tmp/pa_wifi_replay/scenario)
+# WIFI_REPLAY_STATE:    directory of the rule counts and of the held outputs
+#                       (default: /tmp/pa_wifi_replay.state)
+
+SCENARIO=${WIFI_REPLAY_SCENARIO:-/tmp/pa_wifi_replay/scenario}
+SCENARIO_DIR=$(dirname "${SCENARIO}")
+STATE_DIR=${WIFI_REPLAY_STATE:-/tmp/pa_wifi_replay.state}
+SUCCESS=0
+ERROR=127
+# Set in command server mode, where a command runs in a subshell and can not hold its output
+SERVING=
+
+# Sleep for some milliseconds
+# $1: Delay in ms
+SleepMs()
+{
+    [ "$1" -gt 0 ] 2>/dev/null || return 0
+    sleep "$(( $1 / 1000 )).$(printf '%03d' $(( $1 % 1000 )))"
+}
+
+# Print the rule of a command for its next run: exit status, delay, transcript and hold flag
+# $1: Command
+FindRule()
+{
+    countFile=${STATE_DIR}/$1.count
+    count=$(cat "${countFile}" 2>/dev/null) || count=0
+    echo $(( count + 1 )) >"${countFile}"
+    awk -v cmd="$1" -v run="${count}" '
+        /^[ \t]*(#|$)/ { next }
+        $1 == cmd { rules[n++] = $2 " " $3 " " $4 " " $5 }
+        $1 == "*" && any == "" { any = $2 " " $3 " " $4 " " $5 }
+        END {
+            if (n > 0) { print rules[(run < n) ? run : n - 1] }
+            else if ((any != "") && (cmd != "HW_INFO")) { print any }
+        }' "${SCENARIO}"
+}
+
+# Output a transcript, with its pauses
+# $1: Transcript file
+PlayTranscript()
+{
+    while IFS= read -r line || [ -n "${line}" ]
+    do
+        case "${line}" in
+            @@*) printf '%s\n' "${line#@}" ;;
+            @*)  SleepMs "${line#@}" ;;
+            *)   printf '%s\n' "${line}" ;;
+        esac
+    done <"$1"
+}
+
+# Close the held outputs
+StopHeld()
+{
+    set +f
+    for holdFile in "${STATE_DIR}"/hold.*
+    do
+        [ -f "${holdFile}" ] || continue
+        kill "$(cat "${holdFile}")" 2>/dev/null
+        rm -f "${holdFile}"
+    done
+}
+
+# Replay a command
+# $1: Command
+RunCommand()
+{
+    CMD=$1
+    case ${CMD} in
+        PING)
+            # No operation, measures the command overhead
+            exit ${SUCCESS} ;;
+
+        WIFI_UNSET_EVENT)
+            StopHeld ;;
+    esac
+
+    rule=$(FindRule "${CMD}")
+    if [ -z "${rule}" ]; then
+        echo "Parameter not valid"
+        exit ${ERROR}
+    fi
+    set -- ${rule}
+    status=$1
+
+    SleepMs "$2"
+    if [ "$3" != "-" ]; then
+        [ -f "${SCENARIO_DIR}/$3" ] || exit ${ERROR}
+        PlayTranscript "${SCENARIO_DIR}/$3"
+    fi
+    if [ "$4" = "hold" ] && [ -z "${SERVING}" ]; then
+        # The process identifier is kept by exec, for StopHeld
+        echo $$ >"${STATE_DIR}/hold.$$"
+        exec sleep 2147483647
+    fi
+    exit "${status}"
+}
+
+# Command server mode, same frames as the PA scripts: read one command per line on stdin and
+# answer on stdout with the command output lines prefixed by '.', then a line with '=' and the
+# exit status.
+SERVE_OUT=/tmp/pa_wifi_serve.$$
+ServeCommands()
+{
+    rm -f "${STATE_DIR}"/*.count
+    set -f
+    SERVING=1
+    echo "=READY"
+    while IFS= read -r request
+    do
+        ( RunCommand ${request} ) </dev/null >${SERVE_OUT} 2>&1
+        status=$?
+        while IFS= read -r line || [ -n "${line}" ]
+        do
+            echo ".${line}"
+        done <${SERVE_OUT}
+        echo "=${status}"
+    done
+    rm -f ${SERVE_OUT}
+    exit 0
+}
+
+if [ ! -f "${SCENARIO}" ]; then
+    echo "Scenario ${SCENARIO} not found"
+    exit ${ERROR}
+fi
+mkdir -p "${STATE_DIR}" || exit ${ERROR}
+
+[ "$1" = "SERVE" ] && ServeCommands
+RunCommand "$@"
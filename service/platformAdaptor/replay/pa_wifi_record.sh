@@ -0,0 +1,74 @@
+#!/bin/sh
+# Copyright (C) Sierra Wireless Inc.
+#
+# Recorder of the PA script commands, for the replay script (pa_wifi.sh of this directory). It is
+# selected on the target by the WIFI_PA_SCRIPT environment variable of the service: each command
+# is run by the PA script, and its output, exit status and timing are appended to a scenario.
+#
+# HW_INFO and the command server mode are answered with an error, so that the service runs every
+# command in a new instance of the script, where it is recorded. The transcripts are timed with
+# "@<ms>" pause lines, and WIFI_SET_EVENT is recorded as held until WIFI_UNSET_EVENT.
+#
+# WIFI_RECORD_SCRIPT: PA script (default: the script of the wifiService app)
+# WIFI_RECORD_DIR:    scenario directory (default: /tmp/pa_wifi_record), replayed with
+#                     WIFI_REPLAY_SCENARIO=<directory>/scenario
+
+PA_SCRIPT=${WIFI_RECORD_SCRIPT:-/legato/systems/current/apps/wifiService/read-only/pa_wifi}
+RECORD_DIR=${WIFI_RECORD_DIR:-/tmp/pa_wifi_record}
+ERROR=127
+
+# Set NOW to the current time in ms, with the 10 ms resolution of /proc/uptime
+Now()
+{
+    read -r uptime _ </proc/uptime
+    # The leading 1 keeps the hundredths from being read as an octal number
+    NOW=$(( ${uptime%.*} * 1000 + 1${uptime#*.} * 10 - 1000 ))
+}
+
+# Record the output lines of the command and forward them
+# $1: Transcript file
+RecordOutput()
+{
+    Now
+    last=${NOW}
+    while IFS= read -r line || [ -n "${line}" ]
+    do
+        Now
+        [ ${NOW} -gt ${last} ] && echo "@$(( NOW - last ))" >>"$1"
+        last=${NOW}
+        case "${line}" in
+            @*) printf '@%s\n' "${line}" >>"$1" ;;
+            *)  printf '%s\n' "${line}" >>"$1" ;;
+        esac
+        printf '%s\n' "${line}"
+    done
+    # Time from the last line to the exit
+    Now
+    [ ${NOW} -gt ${last} ] && echo "@$(( NOW - last ))" >>"$1"
+}
+
+CMD=$1
+case ${CMD} in
+    HW_INFO|SERVE)
+        exit ${ERROR} ;;
+esac
+
+if [ ! -x "${PA_SCRIPT}" ]; then
+    echo "PA script ${PA_SCRIPT} not found"
+    exit ${ERROR}
+fi
+mkdir -p "${RECORD_DIR}" || exit ${ERROR}
+
+transcript=${CMD}.$$.txt
+statusFile=${RECORD_DIR}/.status.$$
+: >"${RECORD_DIR}/${transcript}"
+
+# The status is written before the pipe is closed, so before the output is fully recorded
+{ "${PA_SCRIPT}" "$@"; echo $? >"${statusFile}"; } | RecordOutput "${RECORD_DIR}/${transcript}"
+status=$(cat "${statusFile}" 2>/dev/null) || status=${ERROR}
+rm -f "${statusFile}"
+
+hold=
+[ "${CMD}" = "WIFI_SET_EVENT" ] && hold=hold
+echo "${CMD} ${status} 0 ${transcript}${hold:+ ${hold}}" >>"${RECORD_DIR}/scenario"
+exit "${status}"
@@ -14,6 +14,8 @@ fi
 CMD=$1
 # WiFi interface
 IFACE=wlan0
+# Virtual interface of the access point, when it runs next to the client
+AP_VIRTUAL_IFACE=ap0
 # If WLAN interface exists but can not be brought up, means WiFi hardware is inserted,
 # drivers are loaded successfully, but firmware failed to boot
 FIRMWAREFAILURE=100
@@ -24,6 +26,59 @@ NODRIVER=100
 TIMEOUT=8
 # PATH
 export PATH=/legato/systems/current/bin:/usr/local/bin:/usr/bin:/bin:/usr/local/sbin:/usr/sbin:/sbin
+# DHCP server of the WLAN: configuration written by the WiFi service, link used when it is served by
+# the system dnsmasq, and default pid and lease files of its dedicated dnsmasq instance. The WiFi
+# service names them after the interface of the access point.
+DNSMASQ_WLAN_CONF=/tmp/dnsmasq.wlan.conf
+DNSMASQ_WLAN_LINK=/etc/dnsmasq.d/dnsmasq.wlan.conf
+DNSMASQ_WLAN_PID=/var/run/dnsmasq.${IFACE}.pid
+DNSMASQ_WLAN_LEASES=/tmp/dnsmasq.${IFACE}.leases
+# Pid file of the system dnsmasq
+DNSMASQ_SYSTEM_PID=/var/run/dnsmasq.pid
+# Pid file of the iw event process of the WiFi service
+IW_EVENT_PID=/var/run/wifi_iw_event.pid
+
+# Check that a process runs a program. A stale pid file may name a process identifier reused by
+# another program.
+# $1: pid, $2: program name, as in /proc/<pid>/comm
+IsProgram()
+{
+    [ "$(cat /proc/$1/comm 2>/dev/null)" = "$2" ]
+}
+
+# Terminate the daemon of a pid file, if running, and kill it if it does not exit in 1 s.
+# $1: pid file, $2: program name
+StopPidFile()
+{
+    [ -f "$1" ] || return 0
+    pid=$(cat "$1")
+    rm -f "$1"
+    [ -n "${pid}" ] || return 0
+    IsProgram "${pid}" "$2" || return 0
+    kill "${pid}" 2>/dev/null || return 0
+    # Poll every 100 ms. Without sub-second sleep, a single wait of 1 s is done.
+    waited=0
+    while [ ${waited} -lt 10 ]
+    do
+        IsProgram "${pid}" "$2" || return 0
+        if usleep 100000 2>/dev/null || sleep 0.1 2>/dev/null; then
+            waited=$((waited + 1))
+        else
+            sleep 1
+            waited=10
+        fi
+    done
+    IsProgram "${pid}" "$2" && kill -9 "${pid}" 2>/dev/null
+    return 0
+}
+
+# Stop the dedicated dnsmasq instance of the WLAN, if running. Its leases stay in the lease file
+# and are reloaded by the next instance.
+# $1: pid file
+StopDnsmasqWlan()
+{
+    StopPidFile "${1:-${DNSMASQ_WLAN_PID}}" dnsmasq
+}
 
 #init script from rootfs manages the start/stop functions.
 TI_WIFI_SH=/etc/init.d/tiwifi
@@ -40,6 +95,14 @@ fi
 # and managed before the SDIO/MMC module is inserted.
 # TI WIFI IoT conflicts with others devices using the SDIO/MMC bus
 
+# WiFi driver module
+TI_WIFI_MODULE=wlcore
+
+# Seconds to wait for the interface after the driver loading, and number of driver reloads when
+# the interface can not be brought up
+TI_WIFI_IF_TIMEOUT=6
+TI_WIFI_RESET_RETRIES=3
+
 # Interface does not exist
 TI_WIFI_PA_NO_IF_ERR=50
 
@@ -231,10 +294,9 @@ mangOH_cfg_wlan()
     esac
 }
 
-ti_wifi_start()
+# Board settings and driver loading, without bringing the interface up
+ti_wifi_load()
 {
-    echo "Starting TI Wifi module"
-
     # Add mdev rule for crda
     grep crda /etc/mdev.conf > /dev/null
     if [ $? -ne 0 ]; then
@@ -243,8 +305,7 @@ ti_wifi_start()
         echo "\$COUNTRY=.. root:root 0660 */sbin/crda" >> /etc/mdev.conf
     fi
 
-    lsmod | grep wlcore >/dev/null
-    if [ $? -ne 0 ]; then
+    if [ ! -d /sys/module/${TI_WIFI_MODULE} ]; then
         #Do the necessary hardware settings for wlan
         [ -z "$BOARD_CONFIG_WLAN" ] || ${BOARD_CONFIG_WLAN} SET_UP
 
@@ -253,7 +314,32 @@ ti_wifi_start()
         kmod load wlcore_sdio.ko || return 127
         kmod load wl18xx.ko || return 127
     fi
-    attempt=6
+    return 0
+}
+
+# Driver unloading and board settings revert
+ti_wifi_unload()
+{
+    # If module unloading fails, it may be for different reasons: someone is
+    # using it, cannot be unloaded because it crashed, etc. Since there is
+    # nothing we can do about it, we should just continue on.
+    if [ -d /sys/module/${TI_WIFI_MODULE} ]; then
+        kmod unload wl18xx.ko >/dev/null 2>&1
+        kmod unload wlcore_sdio.ko >/dev/null 2>&1
+        kmod unload wlcore.ko >/dev/null 2>&1
+
+        #Do the necessary hardware settings for wlan
+        [ -z "$BOARD_CONFIG_WLAN" ] || ${BOARD_CONFIG_WLAN} REVERT
+    fi
+    return 0
+}
+
+ti_wifi_start()
+{
+    echo "Starting TI Wifi module"
+
+    ti_wifi_load || return 127
+    attempt=${TI_WIFI_IF_TIMEOUT}
     for i in $(seq 1 ${attempt})
     do
         if [ $i -ne 1 ]; then
@@ -283,19 +369,7 @@ ti_wifi_stop()
     if [ $? -eq 0 ]; then
         ifconfig wlan0 down
     fi
-    lsmod | grep wlcore >/dev/null
-
-    # If module unloading fails, it may be for different reasons: someone is
-    # using it, cannot be unloaded because it crashed, etc. Since there is
-    # nothing we can do about it, we should just continue on.
-    if [ $? -eq 0 ]; then
-        kmod unload wl18xx.ko >/dev/null 2>&1
-        kmod unload wlcore_sdio.ko >/dev/null 2>&1
-        kmod unload wlcore.ko >/dev/null 2>&1
-
-        #Do the necessary hardware settings for wlan
-        [ -z "$BOARD_CONFIG_WLAN" ] || ${BOARD_CONFIG_WLAN} REVERT
-    fi
+    ti_wifi_unload
 
     echo "TI Wifi module stopped"
     return 0
@@ -353,142 +427,249 @@ WiFiReset()
     exit 127
 }
 
-case ${CMD} in
-  WIFI_START)
-    echo "WIFI_START"
-    # Mount the WiFi network interface
-    ${TI_WIFI_SH} start && exit 0
-    # Store failure reason
-    FAILUREREASON=$?
-    # If ti wifi start indicates firmware fails to boot, do reset
-    if [ ${FAILUREREASON} -eq ${FIRMWAREFAILURE} ]; then
-        WiFiReset && exit 0
-        echo "Reset fail, perform clean up"
-        ${TI_WIFI_SH} stop
-        exit ${FAILUREREASON}
-    fi
-    # Hardware is absent, do clean up
-    if [ ${FAILUREREASON} -eq ${HARDWAREABSENCE} ]; then
-        echo "Hardware is absent, perform clean up"
+# Run a command
+# $1: Command
+# $2: Command argument
+RunCommand()
+{
+    CMD=$1
+    case ${CMD} in
+      WIFI_START)
+        echo "WIFI_START"
+        # Mount the WiFi network interface
+        ${TI_WIFI_SH} start && exit 0
+        # Store failure reason
+        FAILUREREASON=$?
+        # If ti wifi start indicates firmware fails to boot, do reset
+        if [ ${FAILUREREASON} -eq ${FIRMWAREFAILURE} ]; then
+            WiFiReset && exit 0
+            echo "Reset fail, perform clean up"
+            ${TI_WIFI_SH} stop
+            exit ${FAILUREREASON}
+        fi
+        # Hardware is absent, do clean up
+        if [ ${FAILUREREASON} -eq ${HARDWAREABSENCE} ]; then
+            echo "Hardware is absent, perform clean up"
+            ${TI_WIFI_SH} stop
+            exit ${FAILUREREASON}
+        fi
+        echo "Clean up due to unknown error"
         ${TI_WIFI_SH} stop
-        exit ${FAILUREREASON}
-    fi
-    echo "Clean up due to unknown error"
-    ${TI_WIFI_SH} stop
-    exit ${FAILUREREASON} ;;
-
-  WIFI_STOP)
-    echo "WIFI_STOP"
-    # If wpa_supplicant is still running, terminate it
-    (/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
-    && /sbin/wpa_cli -i${IFACE} terminate
-    # Unmount the WiFi network interface
-    ${TI_WIFI_SH} stop || exit 127
-    exit 0 ;;
-
-  WIFI_GET_DATA)
-    echo "WIFI_GET_DATA"
-    /usr/sbin/iw ${IFACE} link || exit 127
-    exit 0 ;;
-
-  WIFI_SET_EVENT)
-    echo "WIFI_SET_EVENT"
-    /usr/sbin/iw event || exit 127
-    exit 0 ;;
-
-  WIFI_UNSET_EVENT)
-    echo "WIFI_UNSET_EVENT"
-    count=$(/usr/bin/pgrep -c iw)
-    [ "${count}" -eq 0 ] && exit 0
-    for i in $(seq 1 ${count})
+        exit ${FAILUREREASON} ;;
+
+      WIFI_STOP)
+        echo "WIFI_STOP"
+        # If wpa_supplicant is still running, terminate it
+        (/bin/ps -ax | grep wpa_supplicant | grep ${IFACE} >/dev/null 2>&1) \
+        && /sbin/wpa_cli -i${IFACE} terminate
+        # Unmount the WiFi network interface
+        ${TI_WIFI_SH} stop || exit 127
+        exit 0 ;;
+
+      WIFI_GET_DATA)
+        echo "WIFI_GET_DATA"
+        /usr/sbin/iw ${IFACE} link || exit 127
+        exit 0 ;;
+
+      WIFI_SET_EVENT)
+        echo "WIFI_SET_EVENT"
+        # The pid is kept to stop this iw process only, see WIFI_UNSET_EVENT
+        /usr/sbin/iw event &
+        echo $! > ${IW_EVENT_PID}
+        wait $! || exit 127
+        exit 0 ;;
+
+      WIFI_UNSET_EVENT)
+        echo "WIFI_UNSET_EVENT"
+        # Only the iw process started by WIFI_SET_EVENT
+        StopPidFile ${IW_EVENT_PID} iw
+        exit 0 ;;
+
+      WIFI_CHECK_HWSTATUS)
+        echo "WIFI_CHECK_HWSTATUS"
+        #Client request disconnection if interface in up
+        /sbin/ifconfig | grep ${IFACE} >/dev/null
+        [ $? -eq 0 ] && exit 0
+        sleep 1
+        #Check WiFi stop called or not
+        /sbin/lsmod | grep wlcore >/dev/null
+        #Driver stays, hardware removed
+        [ $? -eq 0 ] && exit ${HARDWAREABSENCE}
+        #WiFi stop called
+        exit ${NODRIVER} ;;
+
+      WIFIAP_HOSTAPD_START)
+        echo "WIFIAP_HOSTAPD_START"
+        # The access point may run on a virtual interface, next to the client on ${IFACE}. On
+        # failure, the hardware is stopped by the WiFi service, once no other role uses it.
+        AP_IFACE=${2:-${IFACE}}
+        HOSTAPD_PID=/var/run/hostapd.${AP_IFACE}.pid
+        (/bin/hostapd /tmp/hostapd.conf -i${AP_IFACE} -B -P ${HOSTAPD_PID}) && exit 0
+        exit 127 ;;
+
+      WIFIAP_WLAN_UP)
+        echo "WIFIAP_WLAN_UP"
+        AP_IP=$2
+        AP_IFACE=${3:-${IFACE}}
+        /sbin/ifconfig | grep ${AP_IFACE} || exit 127
+        /sbin/ifconfig ${AP_IFACE} ${AP_IP} up || exit 127
+        exit 0 ;;
+
+      WIFIAP_BSS_UP)
+        echo "WIFIAP_BSS_UP"
+        # Address of the interface of an additional BSS, created by hostapd, and DHCP and DNS ports
+        BSS_IFACE=$2
+        BSS_IP=$3
+        [ -e /sys/class/net/${BSS_IFACE} ] || exit 127
+        /sbin/ifconfig ${BSS_IFACE} ${BSS_IP} up || exit 127
+        /usr/sbin/iptables -C INPUT -i ${BSS_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT 2>/dev/null \
+        || /usr/sbin/iptables -I INPUT -i ${BSS_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT || exit 127
+        /usr/sbin/iptables -C INPUT -i ${BSS_IFACE} -p udp -m udp --dport 53 -j ACCEPT 2>/dev/null \
+        || /usr/sbin/iptables -I INPUT -i ${BSS_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+        || exit 127
+        exit 0 ;;
+
+      WIFIAP_BSS_DOWN)
+        echo "WIFIAP_BSS_DOWN"
+        # DHCP and DNS ports of an additional BSS, its interface is removed by hostapd
+        BSS_IFACE=$2
+        /usr/sbin/iptables -D INPUT -i ${BSS_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT || exit 127
+        /usr/sbin/iptables -D INPUT -i ${BSS_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+         || exit 127
+        exit 0 ;;
+
+      DNSMASQ_WLAN_START)
+        echo "DNSMASQ_WLAN_START"
+        # Restart the dedicated DHCP and DNS server of the WLAN only, the leases are kept in the
+        # lease file. It listens on the interfaces of the configuration file, not on the loopback
+        # one used by the system dnsmasq. The interfaces of the additional BSS may be created after
+        # it starts (bind-dynamic).
+        # $2: pid file, $3: lease file
+        WLAN_PID=${2:-${DNSMASQ_WLAN_PID}}
+        WLAN_LEASES=${3:-${DNSMASQ_WLAN_LEASES}}
+        StopDnsmasqWlan "${WLAN_PID}"
+        /usr/bin/dnsmasq --conf-file=${DNSMASQ_WLAN_CONF} --pid-file="${WLAN_PID}" \
+            --dhcp-leasefile="${WLAN_LEASES}" --bind-dynamic --except-interface=lo \
+            || exit 127
+        exit 0 ;;
+
+      DNSMASQ_WLAN_STOP)
+        echo "DNSMASQ_WLAN_STOP"
+        # $2: pid file
+        StopDnsmasqWlan "$2"
+        exit 0 ;;
+
+      DNSMASQ_RESTART)
+        echo "DNSMASQ_RESTART"
+        # Serve the WLAN by the system dnsmasq
+        /etc/init.d/dnsmasq stop
+        StopPidFile ${DNSMASQ_SYSTEM_PID} dnsmasq
+        /etc/init.d/dnsmasq start || exit 127
+        exit 0 ;;
+
+      WIFICLIENT_START_SCAN)
+        echo "WIFICLIENT_START_SCAN"
+        (/usr/sbin/iw dev ${IFACE} scan | grep 'BSS\|SSID\|signal') || exit 127
+        exit 0 ;;
+
+      WIFICLIENT_CONNECT)
+        echo "WIFICLIENT_CONNECT"
+        WPA_CFG=$2
+        [ -f ${WPA_CFG} ] || exit 127
+        # wpa_supplicant is running, return duplicated request
+        /bin/ps -A | grep wpa_supplicant && exit 14
+        /sbin/wpa_supplicant -d -Dnl80211 -c ${WPA_CFG} -i${IFACE} -B || exit 127
+        CheckConnection ${IFACE} ;;
+
+      WIFICLIENT_DISCONNECT)
+        echo "WIFICLIENT_DISCONNECT"
+        /sbin/wpa_cli -i${IFACE} terminate || exit 127
+        echo "WiFi client disconnected."
+        exit 0 ;;
+
+      IPTABLE_DHCP_INSERT)
+        echo "IPTABLE_DHCP_INSERT"
+        AP_IFACE=${2:-${IFACE}}
+        /usr/sbin/iptables -I INPUT -i ${AP_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT  || exit 127
+        # DNS, answered by the dedicated dnsmasq instance
+        /usr/sbin/iptables -I INPUT -i ${AP_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+         || exit 127
+        exit 0 ;;
+
+      IPTABLE_DHCP_DELETE)
+        echo "IPTABLE_DHCP_DELETE"
+        AP_IFACE=${2:-${IFACE}}
+        /usr/sbin/iptables -D INPUT -i ${AP_IFACE} -p udp -m udp \
+         --sport 67:68 --dport 67:68 -j ACCEPT  || exit 127
+        # DNS, answered by the dedicated dnsmasq instance
+        /usr/sbin/iptables -D INPUT -i ${AP_IFACE} -p udp -m udp --dport 53 -j ACCEPT \
+         || exit 127
+        exit 0 ;;
+
+      HW_INFO)
+        # Parameters of the native PA, which runs the commands above that do not need the shell
+        echo "IFACE=${IFACE}"
+        echo "AP_IFACE=${AP_VIRTUAL_IFACE}"
+        echo "MODULE=${TI_WIFI_MODULE}"
+        echo "IFACE_TIMEOUT=${TI_WIFI_IF_TIMEOUT}"
+        echo "RESET_RETRIES=${TI_WIFI_RESET_RETRIES}"
+        exit 0 ;;
+
+      HW_MODULE_LOAD)
+        # Board settings and driver loading, the native PA brings the interface up
+        if [ "${TI_WIFI_SH}" = "tiwifi_int" ]; then
+            ti_wifi_load || exit 127
+        else
+            # The rootfs script also brings the interface up, the native PA checks the result
+            ${TI_WIFI_SH} start
+        fi
+        exit 0 ;;
+
+      HW_MODULE_UNLOAD)
+        # Driver unloading and board settings revert, the interface is already down
+        if [ "${TI_WIFI_SH}" = "tiwifi_int" ]; then
+            ti_wifi_unload
+        else
+            ${TI_WIFI_SH} stop || exit 127
+        fi
+        exit 0 ;;
+
+      PING)
+        # No operation, measures the command overhead
+        exit 0 ;;
+
+      *)
+        echo "Parameter not valid"
+        exit 127 ;;
+    esac
+}
+
+# Command server mode: read one command per line on stdin and answer on stdout with the command
+# output lines prefixed by '.', then a line with '=' and the exit status. Each command runs in a
+# subshell, so that it can exit without ending the server, but no new interpreter is started.
+ServeCommands()
+{
+    local out=/tmp/pa_wifi_serve.$$
+    set -f
+    echo "=READY"
+    while IFS= read -r request
     do
-        pid=$(/usr/bin/pgrep -n iw)
-        /bin/kill -9 ${pid}
+        ( RunCommand ${request} ) </dev/null >${out} 2>&1
+        status=$?
+        while IFS= read -r line || [ -n "${line}" ]
+        do
+            echo ".${line}"
+        done <${out}
+        echo "=${status}"
     done
-    count=$(/usr/bin/pgrep -c iw)
-    [ "${count}" -eq 0 ] || exit 127
-    exit 0 ;;
-
-  WIFI_CHECK_HWSTATUS)
-    echo "WIFI_CHECK_HWSTATUS"
-    #Client request disconnection if interface in up
-    /sbin/ifconfig | grep ${IFACE} >/dev/null
-    [ $? -eq 0 ] && exit 0
-    sleep 1
-    #Check WiFi stop called or not
-    /sbin/lsmod | grep wlcore >/dev/null
-    #Driver stays, hardware removed
-    [ $? -eq 0 ] && exit ${HARDWAREABSENCE}
-    #WiFi stop called
-    exit ${NODRIVER} ;;
-
-  WIFIAP_HOSTAPD_START)
-    echo "WIFIAP_HOSTAPD_START"
-    (/bin/hostapd /tmp/hostapd.conf -i${IFACE} -B) && exit 0
-    # Fail to start hostapd, do cleanup
-    ${TI_WIFI_SH} stop
-    exit 127 ;;
-
-  WIFIAP_HOSTAPD_STOP)
-    echo "WIFIAP_HOSTAPD_STOP"
-    rm -f /tmp/dnsmasq.wlan.conf
-    /usr/bin/unlink /etc/dnsmasq.d/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
-    killall hostapd
-    sleep 1;
-    pidof hostapd && (kill -9 `pidof hostapd` || exit 127)
-    pidof dnsmasq && (kill -9 `pidof dnsmasq` || exit 127)
-    /etc/init.d/dnsmasq start || exit 127
-    exit 0 ;;
-
-  WIFIAP_WLAN_UP)
-    echo "WIFIAP_WLAN_UP"
-    AP_IP=$2
-    /sbin/ifconfig | grep ${IFACE} || exit 127
-    /sbin/ifconfig ${IFACE} ${AP_IP} up || exit 127
-    exit 0 ;;
-
-  DNSMASQ_RESTART)
-    echo "interface=${IFACE}" >> /tmp/dnsmasq.wlan.conf
-    /etc/init.d/dnsmasq stop
-    pidof dnsmasq && (kill -9 `pidof dnsmasq` || exit 127)
-    /etc/init.d/dnsmasq start || exit 127
-    exit 0 ;;
-
-  WIFICLIENT_START_SCAN)
-    echo "WIFICLIENT_START_SCAN"
-    (/usr/sbin/iw dev ${IFACE} scan | grep 'BSS\|SSID\|signal') || exit 127
-    exit 0 ;;
-
-  WIFICLIENT_CONNECT)
-    echo "WIFICLIENT_CONNECT"
-    WPA_CFG=$2
-    [ -f ${WPA_CFG} ] || exit 127
-    # wpa_supplicant is running, return duplicated request
-    /bin/ps -A | grep wpa_supplicant && exit 14
-    /sbin/wpa_supplicant -d -Dnl80211 -c ${WPA_CFG} -i${IFACE} -B || exit 127
-    CheckConnection ${IFACE} ;;
-
-  WIFICLIENT_DISCONNECT)
-    echo "WIFICLIENT_DISCONNECT"
-    /sbin/wpa_cli -i${IFACE} terminate || exit 127
-    echo "WiFi client disconnected."
-    exit 0 ;;
-
-  IPTABLE_DHCP_INSERT)
-    echo "IPTABLE_DHCP_INSERT"
-    /usr/sbin/iptables -I INPUT -i ${IFACE} -p udp -m udp \
-     --sport 67:68 --dport 67:68 -j ACCEPT  || exit 127
-    exit 0 ;;
-
-  IPTABLE_DHCP_DELETE)
-    echo "IPTABLE_DHCP_DELETE"
-    /usr/sbin/iptables -D INPUT -i ${IFACE} -p udp -m udp \
-     --sport 67:68 --dport 67:68 -j ACCEPT  || exit 127
-    exit 0 ;;
-
-  *)
-    echo "Parameter not valid"
-    exit 127 ;;
-esac
+    rm -f ${out}
+    exit 0
+}
+
+[ "${CMD}" = "SERVE" ] && ServeCommands
+RunCommand "$@"
 